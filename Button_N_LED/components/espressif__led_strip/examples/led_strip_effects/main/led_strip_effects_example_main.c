@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "led_strip.h"
+#include "sdkconfig.h"
+
+// 10MHz resolution, 1 tick = 0.1us (led strip needs a high resolution)
+#define EFFECTS_RMT_RES_HZ  (10 * 1000 * 1000)
+// seconds of the moving show, then of the still one
+#define EFFECTS_SHOW_S      10
+
+static const char *TAG = "example";
+
+static led_strip_handle_t configure_led(void)
+{
+    led_strip_config_t strip_config = {
+        .strip_gpio_num = CONFIG_EFFECTS_STRIP_GPIO,
+        .max_leds = CONFIG_EFFECTS_LED_COUNT,
+        .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+        .led_model = LED_MODEL_WS2812,
+    };
+    led_strip_rmt_config_t rmt_config = {
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+        .rmt_channel = 0,
+#else
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = EFFECTS_RMT_RES_HZ,
+#endif
+    };
+    led_strip_handle_t led_strip;
+    ESP_ERROR_CHECK(led_strip_new_rmt_device(&strip_config, &rmt_config, &led_strip));
+    ESP_LOGI(TAG, "Created LED strip object with RMT backend");
+    return led_strip;
+}
+
+// fire on the first half, a scrolling gradient on the second, sparkles and a comet over the whole strip
+static void set_show(led_strip_effects_handle_t effects)
+{
+    uint32_t half = CONFIG_EFFECTS_LED_COUNT / 2;
+    const led_effect_layer_config_t layers[] = {
+        {
+            .effect = LED_EFFECT_FIRE, .count = half ? half : 1,
+        },
+        {
+            .effect = LED_EFFECT_GRADIENT, .start = half, .opacity = 96,
+            .gradient = { .from = { .blue = 255 }, .to = { .red = 160, .blue = 96 }, .speed = 20 },
+        },
+        {
+            .effect = LED_EFFECT_TWINKLE, .blend = LED_EFFECT_BLEND_ADD,
+            .twinkle = { .color = { .red = 255, .green = 255, .blue = 255 }, .rate = 20, .fade_ms = 400 },
+        },
+        {
+            .effect = LED_EFFECT_CHASE, .blend = LED_EFFECT_BLEND_MAX,
+            .chase = { .color = { .green = 255 }, .speed = 60, .tail = 8 },
+        },
+    };
+    for (size_t i = 0; i < sizeof(layers) / sizeof(layers[0]); i++) {
+        ESP_ERROR_CHECK(led_strip_effects_set_layer(effects, i, &layers[i]));
+    }
+}
+
+// a still gradient: rendered and sent once, the following steps refresh nothing
+static void set_still(led_strip_effects_handle_t effects)
+{
+    const led_effect_layer_config_t gradient = {
+        .effect = LED_EFFECT_GRADIENT,
+        .gradient = { .from = { .red = 32 }, .to = { .blue = 32 } },
+    };
+    ESP_ERROR_CHECK(led_strip_effects_set_layer(effects, 0, &gradient));
+    for (size_t i = 1; i < 4; i++) {
+        ESP_ERROR_CHECK(led_strip_effects_set_layer(effects, i, NULL));
+    }
+}
+
+void app_main(void)
+{
+    led_strip_handle_t led_strip = configure_led();
+    led_strip_effects_config_t effects_config = {
+        .max_leds = CONFIG_EFFECTS_LED_COUNT,
+        .fps = CONFIG_EFFECTS_FPS,
+        .max_layers = 4,
+    };
+    led_strip_effects_handle_t effects;
+    ESP_ERROR_CHECK(led_strip_new_effects(led_strip, &effects_config, &effects));
+    set_show(effects);
+    ESP_ERROR_CHECK(led_strip_effects_start(effects));
+    ESP_LOGI(TAG, "Start effects, %d LEDs at %d steps per second", CONFIG_EFFECTS_LED_COUNT, CONFIG_EFFECTS_FPS);
+
+    led_strip_effects_stats_t last = { 0 };
+    for (uint32_t seconds = 1; ; seconds++) {
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        led_strip_effects_stats_t stats;
+        led_strip_refresh_stats_t refresh;
+        ESP_ERROR_CHECK(led_strip_effects_get_stats(effects, &stats));
+        ESP_ERROR_CHECK(led_strip_get_refresh_stats(led_strip, &refresh));
+        printf("EFFECTS steps=%lu fps=%lu late=%lu render_us=%lu max_render_us=%lu frame_us=%lu\n",
+               (unsigned long)(stats.steps - last.steps), (unsigned long)(stats.frames - last.frames),
+               (unsigned long)(stats.late_steps - last.late_steps), (unsigned long)stats.render_time_us,
+               (unsigned long)stats.max_render_time_us, (unsigned long)refresh.frame_time_us);
+        last = stats;
+        if (seconds % EFFECTS_SHOW_S == 0) {
+            if ((seconds / EFFECTS_SHOW_S) % 2) {
+                ESP_LOGI(TAG, "Still gradient");
+                set_still(effects);
+            } else {
+                ESP_LOGI(TAG, "Moving show");
+                set_show(effects);
+            }
+        }
+    }
+}
@@ -0,0 +1,277 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "led_strip.h"
+#include "soc/soc_caps.h"
+#include "sdkconfig.h"
+
+// 10MHz resolution, 1 tick = 0.1us (led strip needs a high resolution)
+#define BENCH_RMT_RES_HZ  (10 * 1000 * 1000)
+// length of every strip of the group runs
+#define BENCH_GROUP_LEDS  300
+
+static const char *TAG = "example";
+
+typedef esp_err_t (*bench_new_strip_t)(uint32_t leds, led_strip_handle_t *ret_strip);
+
+typedef struct {
+    const char *name;
+    bench_new_strip_t new_strip;
+} bench_backend_t;
+
+static const uint32_t s_led_counts[] = { 100, 300, 1000, 2000 };
+
+static volatile uint32_t s_frames_done;
+
+static esp_err_t bench_new_rmt_strip_in(uint32_t leds, bool in_psram, led_strip_handle_t *ret_strip)
+{
+    led_strip_config_t strip_config = {
+        .strip_gpio_num = CONFIG_BENCH_STRIP_GPIO,
+        .max_leds = leds,
+        .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+        .led_model = LED_MODEL_WS2812,
+        .flags.frame_in_psram = in_psram,
+    };
+    led_strip_rmt_config_t rmt_config = {
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+        .rmt_channel = 0,
+#else
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = BENCH_RMT_RES_HZ,
+#endif
+    };
+    return led_strip_new_rmt_device(&strip_config, &rmt_config, ret_strip);
+}
+
+static esp_err_t bench_new_rmt_strip(uint32_t leds, led_strip_handle_t *ret_strip)
+{
+    return bench_new_rmt_strip_in(leds, false, ret_strip);
+}
+
+static esp_err_t bench_new_rmt_psram_strip(uint32_t leds, led_strip_handle_t *ret_strip)
+{
+    return bench_new_rmt_strip_in(leds, true, ret_strip);
+}
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+static esp_err_t bench_new_spi_strip_in(uint32_t leds, bool in_psram, led_strip_handle_t *ret_strip)
+{
+    led_strip_config_t strip_config = {
+        .strip_gpio_num = CONFIG_BENCH_STRIP_GPIO,
+        .max_leds = leds,
+        .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+        .led_model = LED_MODEL_WS2812,
+        .flags.frame_in_psram = in_psram,
+    };
+    led_strip_spi_config_t spi_config = {
+        .clk_src = SPI_CLK_SRC_DEFAULT,
+        .spi_bus = SPI2_HOST,
+        .flags.with_dma = true, // without DMA a transaction is limited to 64 bytes
+    };
+    return led_strip_new_spi_device(&strip_config, &spi_config, ret_strip);
+}
+
+static esp_err_t bench_new_spi_strip(uint32_t leds, led_strip_handle_t *ret_strip)
+{
+    return bench_new_spi_strip_in(leds, false, ret_strip);
+}
+
+static esp_err_t bench_new_spi_psram_strip(uint32_t leds, led_strip_handle_t *ret_strip)
+{
+    return bench_new_spi_strip_in(leds, true, ret_strip);
+}
+#endif
+
+static const bench_backend_t s_backends[] = {
+    { "rmt", bench_new_rmt_strip },
+    { "rmt_psram", bench_new_rmt_psram_strip },
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    { "spi", bench_new_spi_strip },
+    { "spi_psram", bench_new_spi_psram_strip },
+#endif
+};
+
+static bool IRAM_ATTR bench_refresh_done(led_strip_handle_t strip, void *user_ctx)
+{
+    s_frames_done++;
+    return false;
+}
+
+// A moving rainbow, plus CONFIG_BENCH_RENDER_US of busy time standing in for a real effect
+static void bench_render(uint8_t *rgb, uint32_t leds, uint32_t frame)
+{
+    for (uint32_t i = 0; i < leds; i++) {
+        uint8_t pos = (uint8_t)(i + frame);
+        rgb[i * 3 + 0] = pos;
+        rgb[i * 3 + 1] = 255 - pos;
+        rgb[i * 3 + 2] = pos ^ 0x80;
+    }
+    esp_rom_delay_us(CONFIG_BENCH_RENDER_US);
+}
+
+static void bench_run(const bench_backend_t *backend, uint32_t leds, bool async)
+{
+    led_strip_handle_t strip;
+    uint8_t *rgb = malloc(leds * 3);
+    // internal RAM taken by the strip: buffers, driver objects and, for SPI, the bus
+    size_t internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    if (rgb == NULL || backend->new_strip(leds, &strip) != ESP_OK) {
+        ESP_LOGE(TAG, "%s: can't create a strip of %lu LEDs", backend->name, (unsigned long)leds);
+        free(rgb);
+        return;
+    }
+    size_t internal_bytes = internal_free - heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    const led_strip_event_callbacks_t cbs = {
+        .on_refresh_done = bench_refresh_done,
+    };
+    // counted as a check that every refresh got its callback; backends without events report 0
+    led_strip_register_event_callbacks(strip, &cbs, NULL);
+    s_frames_done = 0;
+
+    uint32_t frames = 0;
+    int64_t refresh_us = 0;
+    int64_t start = esp_timer_get_time();
+    while (esp_timer_get_time() - start < CONFIG_BENCH_DURATION_MS * 1000LL) {
+        bench_render(rgb, leds, frames);
+        ESP_ERROR_CHECK(led_strip_set_pixels(strip, 0, leds, rgb, LED_BUFFER_FORMAT_RGB));
+        int64_t t0 = esp_timer_get_time();
+        ESP_ERROR_CHECK(async ? led_strip_refresh_async(strip) : led_strip_refresh(strip));
+        refresh_us += esp_timer_get_time() - t0;
+        frames++;
+    }
+    ESP_ERROR_CHECK(led_strip_wait_refresh_done(strip, -1));
+    int64_t elapsed_us = esp_timer_get_time() - start;
+    led_strip_refresh_stats_t stats = { 0 };
+    led_strip_get_refresh_stats(strip, &stats);
+
+    // refresh_us: time the rendering task spent inside the refresh call, per frame
+    printf("BENCH refresh backend=%s mode=%s leds=%lu render_us=%d fps=%.1f refresh_us=%lld frame_us=%lu missed=%lu cb_frames=%lu internal_bytes=%u\n",
+           backend->name, async ? "async" : "sync", (unsigned long)leds, CONFIG_BENCH_RENDER_US,
+           frames * 1e6 / elapsed_us, (long long)(refresh_us / frames), (unsigned long)stats.frame_time_us,
+           (unsigned long)stats.missed_frames, (unsigned long)s_frames_done, (unsigned)internal_bytes);
+
+    ESP_ERROR_CHECK(led_strip_clear(strip));
+    ESP_ERROR_CHECK(led_strip_del(strip));
+    free(rgb);
+}
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+// GPIOs from CONFIG_BENCH_GROUP_GPIOS, at most one per RMT TX channel
+static size_t bench_group_gpios(int *gpios, size_t max)
+{
+    size_t count = 0;
+    const char *p = CONFIG_BENCH_GROUP_GPIOS;
+    while (*p && count < max) {
+        char *end;
+        long gpio = strtol(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        gpios[count++] = (int)gpio;
+        p = end + strspn(end, ", ");
+    }
+    return count;
+}
+
+// Same frame on num_strips strips, refreshed one after the other or as a group; no render time, only the wire
+static void bench_group_run(const int *gpios, size_t num_strips, bool grouped)
+{
+    led_strip_config_t strip_configs[SOC_RMT_TX_CANDIDATES_PER_GROUP];
+    led_strip_handle_t strips[SOC_RMT_TX_CANDIDATES_PER_GROUP] = { 0 };
+    led_strip_rmt_group_handle_t group = NULL;
+    uint8_t *rgb = malloc(BENCH_GROUP_LEDS * 3);
+    if (rgb == NULL) {
+        ESP_LOGE(TAG, "no mem for a frame of %d LEDs", BENCH_GROUP_LEDS);
+        return;
+    }
+    const led_strip_rmt_config_t rmt_config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = BENCH_RMT_RES_HZ,
+    };
+    for (size_t i = 0; i < num_strips; i++) {
+        strip_configs[i] = (led_strip_config_t) {
+            .strip_gpio_num = gpios[i],
+            .max_leds = BENCH_GROUP_LEDS,
+            .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+            .led_model = LED_MODEL_WS2812,
+        };
+    }
+    if (grouped) {
+        ESP_ERROR_CHECK(led_strip_new_rmt_group(strip_configs, num_strips, &rmt_config, &group));
+        for (size_t i = 0; i < num_strips; i++) {
+            ESP_ERROR_CHECK(led_strip_rmt_group_get_strip(group, i, &strips[i]));
+        }
+    } else {
+        for (size_t i = 0; i < num_strips; i++) {
+            ESP_ERROR_CHECK(led_strip_new_rmt_device(&strip_configs[i], &rmt_config, &strips[i]));
+        }
+    }
+    bench_render(rgb, BENCH_GROUP_LEDS, 0);
+    for (size_t i = 0; i < num_strips; i++) {
+        ESP_ERROR_CHECK(led_strip_set_pixels(strips[i], 0, BENCH_GROUP_LEDS, rgb, LED_BUFFER_FORMAT_RGB));
+    }
+
+    uint32_t frames = 0;
+    int64_t start = esp_timer_get_time();
+    while (esp_timer_get_time() - start < CONFIG_BENCH_DURATION_MS * 1000LL) {
+        if (grouped) {
+            ESP_ERROR_CHECK(led_strip_rmt_group_refresh(group));
+        } else {
+            for (size_t i = 0; i < num_strips; i++) {
+                ESP_ERROR_CHECK(led_strip_refresh(strips[i]));
+            }
+        }
+        frames++;
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start;
+    double fps = frames * 1e6 / elapsed_us;
+    printf("BENCH group mode=%s strips=%u leds=%d fps=%.1f leds_per_s=%.0f\n",
+           grouped ? "group" : "sequential", (unsigned)num_strips, BENCH_GROUP_LEDS, fps, fps * num_strips * BENCH_GROUP_LEDS);
+
+    for (size_t i = 0; i < num_strips; i++) {
+        ESP_ERROR_CHECK(led_strip_clear(strips[i]));
+    }
+    if (grouped) {
+        ESP_ERROR_CHECK(led_strip_rmt_group_refresh(group));
+        ESP_ERROR_CHECK(led_strip_rmt_group_del(group));
+    } else {
+        for (size_t i = 0; i < num_strips; i++) {
+            ESP_ERROR_CHECK(led_strip_del(strips[i]));
+        }
+    }
+    free(rgb);
+}
+#endif
+
+void app_main(void)
+{
+    ESP_LOGI(TAG, "Refresh benchmark, %d ms per run", CONFIG_BENCH_DURATION_MS);
+    for (size_t b = 0; b < sizeof(s_backends) / sizeof(s_backends[0]); b++) {
+        for (size_t i = 0; i < sizeof(s_led_counts) / sizeof(s_led_counts[0]); i++) {
+            bench_run(&s_backends[b], s_led_counts[i], false);
+            bench_run(&s_backends[b], s_led_counts[i], true);
+        }
+    }
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    int gpios[SOC_RMT_TX_CANDIDATES_PER_GROUP];
+    size_t num_gpios = bench_group_gpios(gpios, SOC_RMT_TX_CANDIDATES_PER_GROUP);
+    for (size_t n = 1; n <= num_gpios; n++) {
+        bench_group_run(gpios, n, false);
+        bench_group_run(gpios, n, true);
+    }
+#endif
+    ESP_LOGI(TAG, "Done");
+}
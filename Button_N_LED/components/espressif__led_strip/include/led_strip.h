@@ -0,0 +1,324 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_rmt.h"
+#include "led_strip_effects.h"
+#include "esp_idf_version.h"
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+#include "led_strip_spi.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set RGB for a specific pixel
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param red: red part of color
+ * @param green: green part of color
+ * @param blue: blue part of color
+ *
+ * @return
+ *      - ESP_OK: Set RGB for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set RGB for a specific pixel failed because of invalid parameters
+ *      - ESP_FAIL: Set RGB for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue);
+
+/**
+ * @brief Set RGBW for a specific pixel
+ *
+ * @note Only call this function if your led strip does have the white component (e.g. SK6812-RGBW)
+ * @note Also see `led_strip_set_pixel` if you only want to specify the RGB part of the color and bypass the white component
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param red: red part of color
+ * @param green: green part of color
+ * @param blue: blue part of color
+ * @param white: separate white component
+ *
+ * @return
+ *      - ESP_OK: Set RGBW color for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set RGBW color for a specific pixel failed because of an invalid argument
+ *      - ESP_FAIL: Set RGBW color for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel_rgbw(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white);
+
+/**
+ * @brief Set a span of pixels from a contiguous buffer (e.g. a whole frame)
+ *
+ * @note The span is checked once and the pixels are converted into the strip's wire order in one pass,
+ *       which is much cheaper than calling `led_strip_set_pixel` for every LED.
+ * @note A GRBW strip gets white = 0 for RGB/GRB buffers. RGBW/GRBW buffers need a GRBW strip.
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param count: number of pixels to set
+ * @param pixels: pixel data, `count` pixels of 3 (RGB, GRB) or 4 (RGBW, GRBW) bytes
+ * @param format: layout of `pixels`
+ *
+ * @return
+ *      - ESP_OK: Set pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Set pixels failed because of an invalid argument (span out of the strip, unsupported format)
+ *      - ESP_FAIL: Set pixels failed because other error occurred
+ */
+esp_err_t led_strip_set_pixels(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint8_t *pixels, led_buffer_format_t format);
+
+/**
+ * @brief Set HSV for a specific pixel
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param hue: hue part of color (0 - 360)
+ * @param saturation: saturation part of color (0 - 255)
+ * @param value: value part of color (0 - 255)
+ *
+ * @return
+ *      - ESP_OK: Set HSV color for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set HSV color for a specific pixel failed because of an invalid argument
+ *      - ESP_FAIL: Set HSV color for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint16_t hue, uint8_t saturation, uint8_t value);
+
+/**
+ * @brief Set a span of pixels from HSV colors with a fixed point hue
+ *
+ * @note Integer only, without divisions: the hue runs over LED_STRIP_HUE_RANGE steps (256 per 60 degrees).
+ *       The colors are converted in chunks and uploaded with `led_strip_set_pixels`.
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param count: number of pixels to set
+ * @param pixels: `count` HSV colors
+ *
+ * @return
+ *      - ESP_OK: Set pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Set pixels failed because of an invalid argument (span out of the strip)
+ *      - ESP_FAIL: Set pixels failed because other error occurred
+ */
+esp_err_t led_strip_set_pixels_hsv(led_strip_handle_t strip, uint32_t start, uint32_t count, const led_color_hsv_t *pixels);
+
+/**
+ * @brief Precompute the hue ramp for one saturation and value
+ *
+ * @note With the ramp a hue costs one table lookup, see `led_strip_set_pixels_hue`.
+ *
+ * @param ramp: table to fill (258 bytes)
+ * @param saturation: saturation (0 - 255)
+ * @param value: value (0 - 255)
+ *
+ * @return
+ *      - ESP_OK: Fill the table successfully
+ *      - ESP_ERR_INVALID_ARG: Fill the table failed because of an invalid argument
+ */
+esp_err_t led_strip_hue_ramp_init(led_strip_hue_ramp_t *ramp, uint8_t saturation, uint8_t value);
+
+/**
+ * @brief Set a span of pixels from hues that share one saturation and value (e.g. a rainbow)
+ *
+ * @note Same colors as `led_strip_set_pixels_hsv` with the saturation and value of `ramp`.
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param count: number of pixels to set
+ * @param hues: `count` hues, 0 - LED_STRIP_HUE_RANGE-1
+ * @param ramp: ramp table filled by `led_strip_hue_ramp_init`
+ *
+ * @return
+ *      - ESP_OK: Set pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Set pixels failed because of an invalid argument (span out of the strip)
+ *      - ESP_FAIL: Set pixels failed because other error occurred
+ */
+esp_err_t led_strip_set_pixels_hue(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint16_t *hues, const led_strip_hue_ramp_t *ramp);
+
+/**
+ * @brief Refresh memory colors to LEDs
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Refresh successfully
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ *
+ * @note:
+ *      After updating the LED colors in the memory, a following invocation of this API is needed to flush colors to strip.
+ * @note RMT (IDF 5.x) and SPI backends send nothing if no pixel was written since the previous refresh (unless dithering),
+ *       and only re-encode the span of pixels that was written.
+ */
+esp_err_t led_strip_refresh(led_strip_handle_t strip);
+
+/**
+ * @brief Start refreshing memory colors to LEDs without waiting for the transmission to finish
+ *
+ * @note The current colors are taken as one frame, the application can go on setting pixels for the next frame
+ *       while this one is being sent. If the previous frame is still being sent, this function waits for it first.
+ * @note Completion is reported by `led_strip_wait_refresh_done` or the `on_refresh_done` callback.
+ *       A backend without asynchronous refresh sends the frame before returning.
+ * @note As with `led_strip_refresh`, an unchanged frame isn't sent again and no `on_refresh_done` follows.
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Refresh started successfully
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ */
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip);
+
+/**
+ * @brief Wait until the frame started by `led_strip_refresh_async` has been sent out
+ *
+ * @param strip: LED strip
+ * @param timeout_ms: maximum time to wait, -1 means wait forever
+ *
+ * @return
+ *      - ESP_OK: No refresh in progress any more
+ *      - ESP_ERR_TIMEOUT: The refresh is still in progress after `timeout_ms`
+ *      - ESP_FAIL: Wait failed because some other error occurred
+ */
+esp_err_t led_strip_wait_refresh_done(led_strip_handle_t strip, int timeout_ms);
+
+/**
+ * @brief Set the callbacks for LED strip events
+ *
+ * @note The callbacks run in ISR context. When the backend driver is configured to be IRAM safe
+ *       (e.g. CONFIG_RMT_ISR_IRAM_SAFE), they and the data they touch must be placed in internal RAM.
+ * @note Waits for a refresh in progress before replacing the callbacks. Pass NULL callbacks to unregister.
+ *
+ * @param strip: LED strip
+ * @param cbs: group of callback functions
+ * @param user_ctx: user data, passed to the callbacks
+ *
+ * @return
+ *      - ESP_OK: Set the callbacks successfully
+ *      - ESP_ERR_INVALID_ARG: Set the callbacks failed because of an invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: The backend doesn't report refresh events
+ */
+esp_err_t led_strip_register_event_callbacks(led_strip_handle_t strip, const led_strip_event_callbacks_t *cbs, void *user_ctx);
+
+/**
+ * @brief Get the refresh counters of a LED strip
+ *
+ * @note A frame is "missed" when the application wanted to start it while the previous one was still being sent,
+ *       i.e. the application renders faster than the strip can take the frames.
+ *
+ * @param strip: LED strip
+ * @param stats: returned counters
+ *
+ * @return
+ *      - ESP_OK: Get the counters successfully
+ *      - ESP_ERR_INVALID_ARG: Get the counters failed because of an invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: The backend doesn't keep refresh counters
+ */
+esp_err_t led_strip_get_refresh_stats(led_strip_handle_t strip, led_strip_refresh_stats_t *stats);
+
+/**
+ * @brief Set the color correction (gamma, brightness, white balance) of a LED strip
+ *
+ * @note The pixels keep the values they were set to. The correction is applied through one 256-entry table per color
+ *       when a refresh encodes the frame, so it takes effect with the next refresh and doesn't touch the frame in flight.
+ *
+ * @param strip: LED strip
+ * @param config: correction, NULL to send the pixel values unchanged
+ *
+ * @return
+ *      - ESP_OK: Set the color correction successfully
+ *      - ESP_ERR_INVALID_ARG: Set the color correction failed because of an invalid argument
+ *      - ESP_ERR_NO_MEM: Set the color correction failed because there is no memory for the tables
+ *      - ESP_ERR_NOT_SUPPORTED: The backend can't correct colors
+ */
+esp_err_t led_strip_set_color_correction(led_strip_handle_t strip, const led_strip_color_correction_t *config);
+
+/**
+ * @brief Set the global brightness of a LED strip
+ *
+ * @note Only the tables are rebuilt, the cost doesn't depend on the length of the strip. Without a color correction
+ *       set before, a linear one is set with this brightness.
+ *
+ * @param strip: LED strip
+ * @param brightness: brightness (0 - 255)
+ *
+ * @return
+ *      - ESP_OK: Set the brightness successfully
+ *      - ESP_ERR_INVALID_ARG: Set the brightness failed because of an invalid argument
+ *      - ESP_ERR_NO_MEM: Set the brightness failed because there is no memory for the tables
+ *      - ESP_ERR_NOT_SUPPORTED: The backend can't correct colors
+ */
+esp_err_t led_strip_set_brightness(led_strip_handle_t strip, uint8_t brightness);
+
+/**
+ * @brief Turn temporal dithering on or off
+ *
+ * @note With dithering the strip keeps 16 bits per color (plus 8 bits of error, 3 bytes per color in total) and every
+ *       refresh sends the next 8-bit approximation: each color alternates between the two nearest 8-bit values, so
+ *       that the average over consecutive frames is the 16-bit value. This smooths fades at low brightness, where
+ *       8-bit steps are visible, but needs a high frame rate, e.g. `led_strip_refresh_async` in a loop.
+ * @note Turning it on widens the current pixels, turning it off rounds them back to 8 bits.
+ *
+ * @param strip: LED strip
+ * @param enable: true to turn dithering on
+ *
+ * @return
+ *      - ESP_OK: Set dithering successfully
+ *      - ESP_ERR_INVALID_ARG: Set dithering failed because of an invalid argument
+ *      - ESP_ERR_NO_MEM: Set dithering failed because there is no memory for the 16-bit frame
+ *      - ESP_ERR_NOT_SUPPORTED: The backend can't dither
+ */
+esp_err_t led_strip_set_dithering(led_strip_handle_t strip, bool enable);
+
+/**
+ * @brief Set a span of pixels from 16-bit values, on a strip with dithering on
+ *
+ * @note The color correction (see `led_strip_set_color_correction`) applies to 16-bit values as to 8-bit ones,
+ *       65535 being the 16-bit 255. 8-bit pixels set while dithering is on are widened (v * 257).
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param count: number of pixels to set
+ * @param pixels: pixel data, `count` pixels of 3 (RGB, GRB) or 4 (RGBW, GRBW) 16-bit values
+ * @param format: layout of `pixels`
+ *
+ * @return
+ *      - ESP_OK: Set pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Set pixels failed because of an invalid argument (span out of the strip, unsupported format)
+ *      - ESP_ERR_INVALID_STATE: Set pixels failed because dithering is off
+ *      - ESP_ERR_NOT_SUPPORTED: The backend can't dither
+ */
+esp_err_t led_strip_set_pixels_16(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint16_t *pixels, led_buffer_format_t format);
+
+/**
+ * @brief Clear LED strip (turn off all LEDs)
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Clear LEDs successfully
+ *      - ESP_FAIL: Clear LEDs failed because some other error occurred
+ */
+esp_err_t led_strip_clear(led_strip_handle_t strip);
+
+/**
+ * @brief Free LED strip resources
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Free resources successfully
+ *      - ESP_FAIL: Free resources failed because error occurred
+ */
+esp_err_t led_strip_del(led_strip_handle_t strip);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Type of an effect engine driving a LED strip
+ */
+typedef struct led_strip_effects_t *led_strip_effects_handle_t;
+
+/**
+ * @brief Effect engine configuration
+ */
+typedef struct {
+    uint32_t max_leds;      /*!< LEDs of the strip, as in `led_strip_config_t` */
+    uint32_t fps;           /*!< Timesteps per second, the highest frame rate; 0: 60 */
+    size_t max_layers;      /*!< Number of layer slots; 0: 4 */
+    uint32_t seed;          /*!< Seed of the twinkle and fire layers; 0: fixed default */
+    uint32_t task_priority; /*!< Priority of the render task; 0: 5 */
+    uint32_t task_stack;    /*!< Stack of the render task in bytes; 0: 3072 */
+} led_strip_effects_config_t;
+
+/**
+ * @brief Counters of an effect engine, see `led_strip_effects_get_stats`
+ */
+typedef struct {
+    uint32_t steps;             /*!< Timesteps run since the engine was created */
+    uint32_t frames;            /*!< Frames rendered and refreshed */
+    uint32_t late_steps;        /*!< Steps run without a frame of their own, because the previous frame took longer than a step */
+    uint32_t render_time_us;    /*!< Time of the last step, render and refresh */
+    uint32_t max_render_time_us; /*!< Longest step, render and refresh since the engine was created */
+} led_strip_effects_stats_t;
+
+/**
+ * @brief Create an effect engine for a strip
+ *
+ * @note The engine renders its layers into one frame and hands it to the strip with `led_strip_set_pixels` and
+ *       `led_strip_refresh_async`, from a task woken every 1 / fps s by an esp_timer. Animations advance by a fixed
+ *       timestep: when a frame takes longer than a step, the missed steps are run without rendering, so the show
+ *       keeps its speed and the CPU spent on rendering stays at one frame per step at most. A scene that doesn't
+ *       move (fills, still gradients) is rendered once and not refreshed again until a layer changes.
+ * @note The engine owns the pixels of the strip while running; the strip itself is not deleted with the engine.
+ *
+ * @param strip: LED strip
+ * @param config: engine configuration
+ * @param ret_effects: Returned engine handle
+ * @return
+ *      - ESP_OK: create the engine successfully
+ *      - ESP_ERR_INVALID_ARG: create the engine failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create the engine failed because of out of memory
+ *      - ESP_FAIL: create the engine failed because some other error
+ */
+esp_err_t led_strip_new_effects(led_strip_handle_t strip, const led_strip_effects_config_t *config, led_strip_effects_handle_t *ret_effects);
+
+/**
+ * @brief Set or remove the layer of a slot
+ *
+ * @note Layers are drawn over black, slot 0 first. The change shows with the next step, also while running.
+ *       Twinkle and fire layers keep their state when only their parameters change.
+ *
+ * @param effects: effect engine
+ * @param index: slot, 0 - `max_layers`-1
+ * @param layer: layer configuration, NULL: remove the layer
+ * @return
+ *      - ESP_OK: set the layer successfully
+ *      - ESP_ERR_INVALID_ARG: set the layer failed because of invalid argument (slot, span, effect or blend mode)
+ */
+esp_err_t led_strip_effects_set_layer(led_strip_effects_handle_t effects, size_t index, const led_effect_layer_config_t *layer);
+
+/**
+ * @brief Start rendering and refreshing the strip
+ *
+ * @param effects: effect engine
+ * @return
+ *      - ESP_OK: start successfully
+ *      - ESP_ERR_INVALID_ARG: start failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: start failed because the engine is already running
+ *      - ESP_FAIL: start failed because some other error
+ */
+esp_err_t led_strip_effects_start(led_strip_effects_handle_t effects);
+
+/**
+ * @brief Stop rendering, return once the last frame is sent out
+ *
+ * @note The animation resumes where it stopped with `led_strip_effects_start`.
+ *
+ * @param effects: effect engine
+ * @return
+ *      - ESP_OK: stop successfully
+ *      - ESP_ERR_INVALID_ARG: stop failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: stop failed because the engine is not running
+ */
+esp_err_t led_strip_effects_stop(led_strip_effects_handle_t effects);
+
+/**
+ * @brief Get the counters of an effect engine
+ *
+ * @param effects: effect engine
+ * @param stats: Returned counters
+ * @return
+ *      - ESP_OK: get the counters successfully
+ *      - ESP_ERR_INVALID_ARG: get the counters failed because of invalid argument
+ */
+esp_err_t led_strip_effects_get_stats(led_strip_effects_handle_t effects, led_strip_effects_stats_t *stats);
+
+/**
+ * @brief Stop and delete an effect engine, the strip is kept
+ *
+ * @param effects: effect engine
+ * @return
+ *      - ESP_OK: delete successfully
+ *      - ESP_ERR_INVALID_ARG: delete failed because of invalid argument
+ */
+esp_err_t led_strip_effects_del(led_strip_effects_handle_t effects);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+#include "esp_idf_version.h"
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#include "driver/rmt_types.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief LED Strip RMT specific configuration
+ */
+typedef struct {
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+    uint8_t rmt_channel;        /*!< Specify the channel number, the legacy RMT driver doesn't support channel allocator */
+#else // new driver supports specify the clock source and clock resolution
+    rmt_clock_source_t clk_src; /*!< RMT clock source */
+    uint32_t resolution_hz;     /*!< RMT tick resolution, if set to zero, a default resolution (10MHz) will be applied */
+#endif
+    size_t mem_block_symbols;   /*!< How many RMT symbols can one RMT channel hold at one time. Set to 0 will fallback to use the default size (one channel block, or 1024 with DMA). */
+    struct {
+        uint32_t with_dma: 1;   /*!< Use DMA to transmit data, ignored on targets whose RMT has no DMA */
+    } flags;                    /*!< Extra driver flags */
+} led_strip_rmt_config_t;
+
+/**
+ * @brief Create LED strip based on RMT TX channel
+ *
+ * @param led_config LED strip configuration
+ * @param rmt_config RMT specific configuration
+ * @param ret_strip Returned LED strip handle
+ * @return
+ *      - ESP_OK: create LED strip handle successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip handle failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create LED strip handle failed because of out of memory
+ *      - ESP_FAIL: create LED strip handle failed because some other error
+ */
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config, led_strip_handle_t *ret_strip);
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+/**
+ * @brief Type of a group of LED strips refreshed together, one RMT channel per strip
+ */
+typedef struct led_strip_rmt_group_t *led_strip_rmt_group_handle_t;
+
+/**
+ * @brief Create a group of LED strips, each on its own RMT TX channel, that are refreshed together
+ *
+ * @note The channels of a group send their frames at the same time, so refreshing N strips of L LEDs takes the wire
+ *       time of L LEDs instead of N * L. On targets with RMT TX synchronization (all but ESP32) the channels are
+ *       managed by a sync manager and start on the same clock edge; on ESP32 they are started back to back.
+ * @note The strips are owned by the group: get them with `led_strip_rmt_group_get_strip` to set pixels, color
+ *       correction etc. `led_strip_refresh`, `led_strip_refresh_async` and `led_strip_del` on them return
+ *       ESP_ERR_INVALID_STATE, and `led_strip_clear` only clears the pixels, the LEDs go off with the next group refresh.
+ *
+ * @param led_configs: configuration of every strip, `num_strips` entries (GPIO, length, pixel format, model)
+ * @param num_strips: number of strips, at most the number of RMT TX channels of the target
+ * @param rmt_config: RMT configuration shared by all channels
+ * @param ret_group: Returned group handle
+ * @return
+ *      - ESP_OK: create the group successfully
+ *      - ESP_ERR_INVALID_ARG: create the group failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create the group failed because of out of memory
+ *      - ESP_ERR_NOT_FOUND: create the group failed because there are not enough free RMT channels
+ *      - ESP_FAIL: create the group failed because some other error
+ */
+esp_err_t led_strip_new_rmt_group(const led_strip_config_t *led_configs, size_t num_strips, const led_strip_rmt_config_t *rmt_config, led_strip_rmt_group_handle_t *ret_group);
+
+/**
+ * @brief Get a strip of a group
+ *
+ * @param group: strip group
+ * @param index: index of the strip, in the order of `led_configs`
+ * @param ret_strip: Returned LED strip handle
+ * @return
+ *      - ESP_OK: get the strip successfully
+ *      - ESP_ERR_INVALID_ARG: get the strip failed because of invalid argument
+ */
+esp_err_t led_strip_rmt_group_get_strip(led_strip_rmt_group_handle_t group, size_t index, led_strip_handle_t *ret_strip);
+
+/**
+ * @brief Refresh all strips of a group, return once every frame is on the wire
+ *
+ * @param group: strip group
+ * @return
+ *      - ESP_OK: refresh successfully
+ *      - ESP_ERR_INVALID_ARG: refresh failed because of invalid argument
+ *      - ESP_FAIL: refresh failed because some other error occurred
+ */
+esp_err_t led_strip_rmt_group_refresh(led_strip_rmt_group_handle_t group);
+
+/**
+ * @brief Start refreshing all strips of a group, return before the frames are sent
+ *
+ * @note Same as `led_strip_refresh_async` for every strip: the frames are copied into the front buffers first, the
+ *       application can fill the next frames while these are sent. Waits for the previous frames if they are still
+ *       being sent.
+ *
+ * @param group: strip group
+ * @return
+ *      - ESP_OK: refresh started successfully
+ *      - ESP_ERR_INVALID_ARG: refresh failed because of invalid argument
+ *      - ESP_FAIL: refresh failed because some other error occurred
+ */
+esp_err_t led_strip_rmt_group_refresh_async(led_strip_rmt_group_handle_t group);
+
+/**
+ * @brief Wait until the frames started by `led_strip_rmt_group_refresh_async` are sent
+ *
+ * @param group: strip group
+ * @param timeout_ms: timeout per strip in milliseconds, -1 to wait forever
+ * @return
+ *      - ESP_OK: all frames are sent
+ *      - ESP_ERR_INVALID_ARG: wait failed because of invalid argument
+ *      - ESP_ERR_TIMEOUT: wait timed out
+ */
+esp_err_t led_strip_rmt_group_wait_refresh_done(led_strip_rmt_group_handle_t group, int timeout_ms);
+
+/**
+ * @brief Delete a group and its strips
+ *
+ * @param group: strip group
+ * @return
+ *      - ESP_OK: delete the group successfully
+ *      - ESP_ERR_INVALID_ARG: delete the group failed because of invalid argument
+ *      - ESP_FAIL: delete the group failed because some other error occurred
+ */
+esp_err_t led_strip_rmt_group_del(led_strip_rmt_group_handle_t group);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
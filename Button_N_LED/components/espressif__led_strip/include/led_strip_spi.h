@@ -20,6 +20,7 @@ extern "C" {
 typedef struct {
     spi_clock_source_t clk_src; /*!< SPI clock source */
     spi_host_device_t spi_bus;  /*!< SPI bus ID. Which buses are available depends on the specific chip */
+    uint32_t resolution_hz;     /*!< SPI clock, e.g. 2.5, 3.2 or 4MHz; 0: 2.5MHz. The SPI bits per LED bit follow from the actual clock */
     struct {
         uint32_t with_dma: 1;   /*!< Use DMA to transmit data */
     } flags;                    /*!< Extra driver flags */
@@ -28,6 +29,12 @@ typedef struct {
 /**
  * @brief Create LED strip based on SPI MOSI channel
  * @note Although only the MOSI line is used for generating the signal, the whole SPI bus can't be used for other purposes.
+ * @note Every LED bit is sent as 3 to 8 SPI bits, chosen from the actual SPI clock so that the bit lasts about 1.25us
+ *       (3 at 2.5MHz, 4 at 3.2MHz, 5 at 4MHz). The DMA buffer takes that many bytes per color byte, i.e. 9 to 24 bytes
+ *       per RGB LED.
+ * @note A frame is sent as one SPI transaction from the DMA buffer, which stays internal with `frame_in_psram`. Split
+ *       into several transactions, the line would stay low between them for an unbounded time, and WS2812 LEDs
+ *       latch after 6 - 9 us of low.
  *
  * @param led_config LED strip configuration
  * @param spi_config SPI specific configuration
@@ -0,0 +1,202 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief LED strip pixel format
+ */
+typedef enum {
+    LED_PIXEL_FORMAT_GRB,    /*!< Pixel format: GRB */
+    LED_PIXEL_FORMAT_GRBW,   /*!< Pixel format: GRBW */
+    LED_PIXEL_FORMAT_INVALID /*!< Invalid pixel format */
+} led_pixel_format_t;
+
+/**
+ * @brief Layout of a caller's pixel buffer, see `led_strip_set_pixels`
+ */
+typedef enum {
+    LED_BUFFER_FORMAT_RGB,    /*!< 3 bytes per pixel: red, green, blue */
+    LED_BUFFER_FORMAT_GRB,    /*!< 3 bytes per pixel: green, red, blue (WS2812 wire order, copied as is) */
+    LED_BUFFER_FORMAT_RGBW,   /*!< 4 bytes per pixel: red, green, blue, white */
+    LED_BUFFER_FORMAT_GRBW,   /*!< 4 bytes per pixel: green, red, blue, white (SK6812 wire order, copied as is) */
+    LED_BUFFER_FORMAT_INVALID /*!< Invalid buffer format */
+} led_buffer_format_t;
+
+/**
+ * @brief Hue range of the fixed point HSV API: 6 sectors (red, yellow, green, cyan, blue, magenta) of 256 steps
+ */
+#define LED_STRIP_HUE_RANGE 1536
+
+/**
+ * @brief HSV color with a fixed point hue, see `led_strip_set_pixels_hsv`
+ */
+typedef struct {
+    uint16_t hue;       /*!< Hue, 0 - LED_STRIP_HUE_RANGE-1 (0: red, 512: green, 1024: blue) */
+    uint8_t saturation; /*!< Saturation, 0 - 255 */
+    uint8_t value;      /*!< Value, 0 - 255 */
+} led_color_hsv_t;
+
+/**
+ * @brief Hue ramp table for one saturation and value, see `led_strip_hue_ramp_init`
+ */
+typedef struct {
+    uint8_t max;        /*!< Largest channel value, the HSV value */
+    uint8_t min;        /*!< Smallest channel value */
+    uint8_t rise[256];  /*!< Rising channel for each of the 256 steps of a hue sector */
+} led_strip_hue_ramp_t;
+
+/**
+ * @brief LED strip model
+ * @note Different led model may have different timing parameters, so we need to distinguish them.
+ */
+typedef enum {
+    LED_MODEL_WS2812, /*!< LED strip model: WS2812 */
+    LED_MODEL_SK6812, /*!< LED strip model: SK6812 */
+    LED_MODEL_INVALID /*!< Invalid LED strip model */
+} led_model_t;
+
+/**
+ * @brief LED strip handle
+ */
+typedef struct led_strip_t *led_strip_handle_t;
+
+/**
+ * @brief Type of the callback invoked when a refresh has been sent out to the strip
+ *
+ * @note Called from the ISR context of the backend peripheral, keep it short (e.g. give a semaphore or a task notification)
+ *
+ * @param strip: LED strip
+ * @param user_ctx: user data passed to `led_strip_register_event_callbacks`
+ * @return Whether a high priority task has been woken up by this callback
+ */
+typedef bool (*led_strip_refresh_done_cb_t)(led_strip_handle_t strip, void *user_ctx);
+
+/**
+ * @brief LED strip event callbacks
+ */
+typedef struct {
+    led_strip_refresh_done_cb_t on_refresh_done; /*!< Invoked when a refresh has been sent out to the strip */
+} led_strip_event_callbacks_t;
+
+/**
+ * @brief Refresh counters of a LED strip, see `led_strip_get_refresh_stats`
+ */
+typedef struct {
+    uint32_t frames;        /*!< Frames sent out since the strip was created */
+    uint32_t missed_frames; /*!< Asynchronous refreshes that found the previous frame still being sent and had to wait for it */
+    uint32_t skipped_frames; /*!< Refreshes that sent nothing, because no pixel was written since the previous frame */
+    uint32_t frame_time_us; /*!< Time from starting the last frame until it was sent out */
+    uint32_t queue_depth;   /*!< Frames started but not sent out yet */
+} led_strip_refresh_stats_t;
+
+/**
+ * @brief Color correction applied when a frame is encoded, see `led_strip_set_color_correction`
+ */
+typedef struct {
+    float gamma;            /*!< Gamma exponent of the LED response, e.g. 2.2; 0 or 1: linear */
+    uint8_t brightness;     /*!< Global brightness, 0 - 255 (255: full) */
+    struct {
+        uint8_t red;        /*!< Red scale, 0 - 255 */
+        uint8_t green;      /*!< Green scale, 0 - 255 */
+        uint8_t blue;       /*!< Blue scale, 0 - 255 */
+    } white_balance;        /*!< Per channel scale, 0 or 255: unchanged. The white LED of GRBW strips isn't scaled */
+} led_strip_color_correction_t;
+
+/**
+ * @brief RGB color of an effect layer
+ */
+typedef struct {
+    uint8_t red;        /*!< Red, 0 - 255 */
+    uint8_t green;      /*!< Green, 0 - 255 */
+    uint8_t blue;       /*!< Blue, 0 - 255 */
+} led_color_rgb_t;
+
+/**
+ * @brief Effect drawn by a layer, see `led_strip_effects_set_layer`
+ */
+typedef enum {
+    LED_EFFECT_FILL,     /*!< One color */
+    LED_EFFECT_GRADIENT, /*!< Blend between two colors along the layer, optionally scrolling */
+    LED_EFFECT_CHASE,    /*!< Moving dots with a fading tail */
+    LED_EFFECT_TWINKLE,  /*!< Random pixels lighting up and fading out */
+    LED_EFFECT_FIRE,     /*!< Flames rising from the first pixel of the layer */
+    LED_EFFECT_INVALID   /*!< Invalid effect */
+} led_effect_t;
+
+/**
+ * @brief How a layer is combined with the layers below it
+ */
+typedef enum {
+    LED_EFFECT_BLEND_ALPHA,  /*!< Mix by `opacity`, an opaque layer hides the layers below, also where it is black */
+    LED_EFFECT_BLEND_ADD,    /*!< Add the layer scaled by `opacity`, saturating at 255 */
+    LED_EFFECT_BLEND_MAX,    /*!< Per channel maximum of the layer scaled by `opacity` and the layers below */
+    LED_EFFECT_BLEND_INVALID /*!< Invalid blend mode */
+} led_effect_blend_t;
+
+/**
+ * @brief Configuration of an effect layer, see `led_strip_effects_set_layer`
+ *
+ * @note Speeds are in pixels per second of animation time, i.e. counted in steps of the effect engine,
+ *       so the animation runs at the same speed whatever frame rate the strip reaches.
+ */
+typedef struct {
+    led_effect_t effect;        /*!< Effect drawn by the layer */
+    led_effect_blend_t blend;   /*!< How the layer is combined with the layers below */
+    uint8_t opacity;            /*!< Opacity, 1 - 255; 0: opaque, like 255 */
+    uint32_t start;             /*!< First pixel of the layer */
+    uint32_t count;             /*!< Pixels of the layer, 0: up to the end of the strip */
+    union {
+        struct {
+            led_color_rgb_t color;  /*!< Color */
+        } fill;                     /*!< Parameters of LED_EFFECT_FILL */
+        struct {
+            led_color_rgb_t from;   /*!< Color of the first pixel */
+            led_color_rgb_t to;     /*!< Color of the last pixel; when scrolling, `from` to `to` and back over the layer */
+            int16_t speed;          /*!< Pixels per second, negative: towards the first pixel; 0: still */
+        } gradient;                 /*!< Parameters of LED_EFFECT_GRADIENT */
+        struct {
+            led_color_rgb_t color;  /*!< Color of the heads */
+            int16_t speed;          /*!< Pixels per second, negative: towards the first pixel */
+            uint16_t tail;          /*!< Pixels fading out behind each head, 0: the head only */
+            uint16_t spacing;       /*!< Pixels from one head to the next, 0: one head over the layer */
+        } chase;                    /*!< Parameters of LED_EFFECT_CHASE */
+        struct {
+            led_color_rgb_t color;  /*!< Color of a pixel that lights up */
+            uint16_t rate;          /*!< Pixels lighting up per second over the layer */
+            uint16_t fade_ms;       /*!< Time for a pixel to fade out, 0: at the next step */
+        } twinkle;                  /*!< Parameters of LED_EFFECT_TWINKLE */
+        struct {
+            uint8_t cooling;        /*!< How fast the flames cool down, 20 - 100 (tall - short flames); 0: 55 */
+            uint8_t sparking;       /*!< Chance out of 255 of a new spark per step, 50 - 200 (calm - roaring); 0: 120 */
+        } fire;                     /*!< Parameters of LED_EFFECT_FIRE */
+    };
+} led_effect_layer_config_t;
+
+/**
+ * @brief LED Strip Configuration
+ */
+typedef struct {
+    int strip_gpio_num;      /*!< GPIO number that used by LED strip */
+    uint32_t max_leds;       /*!< Maximum LEDs in a single strip */
+    led_pixel_format_t led_pixel_format; /*!< LED pixel format */
+    led_model_t led_model;   /*!< LED model */
+
+    struct {
+        uint32_t invert_out: 1; /*!< Invert output signal */
+        uint32_t frame_in_psram: 1; /*!< Keep the pixel buffers in PSRAM when there is some, else in the ordinary heap (RMT on IDF 5.x and SPI backends) */
+    } flags;                    /*!< Extra driver flags */
+} led_strip_config_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,227 @@
+/*
+ * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct led_strip_t led_strip_t; /*!< Type of LED strip */
+
+/**
+ * @brief LED strip interface definition
+ */
+struct led_strip_t {
+    /**
+     * @brief Set RGB for a specific pixel
+     *
+     * @param strip: LED strip
+     * @param index: index of pixel to set
+     * @param red: red part of color
+     * @param green: green part of color
+     * @param blue: blue part of color
+     *
+     * @return
+     *      - ESP_OK: Set RGB for a specific pixel successfully
+     *      - ESP_ERR_INVALID_ARG: Set RGB for a specific pixel failed because of invalid parameters
+     *      - ESP_FAIL: Set RGB for a specific pixel failed because other error occurred
+     */
+    esp_err_t (*set_pixel)(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue);
+
+    /**
+     * @brief Set RGBW for a specific pixel. Similar to `set_pixel` but also set the white component
+     *
+     * @param strip: LED strip
+     * @param index: index of pixel to set
+     * @param red: red part of color
+     * @param green: green part of color
+     * @param blue: blue part of color
+     * @param white: separate white component
+     *
+     * @return
+     *      - ESP_OK: Set RGBW color for a specific pixel successfully
+     *      - ESP_ERR_INVALID_ARG: Set RGBW color for a specific pixel failed because of an invalid argument
+     *      - ESP_FAIL: Set RGBW color for a specific pixel failed because other error occurred
+     */
+    esp_err_t (*set_pixel_rgbw)(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white);
+
+    /**
+     * @brief Set a span of pixels from a caller's buffer
+     *
+     * @param strip: LED strip
+     * @param start: index of the first pixel to set
+     * @param count: number of pixels to set
+     * @param pixels: pixel data, `count` pixels laid out as `format`
+     * @param format: layout of `pixels`
+     *
+     * @return
+     *      - ESP_OK: Set pixels successfully
+     *      - ESP_ERR_INVALID_ARG: Set pixels failed because the span exceeds the strip, or the format needs a white component the strip does not have
+     *
+     * @note Optional, a backend may leave this NULL; `led_strip_set_pixels` then falls back to `set_pixel` / `set_pixel_rgbw`.
+     */
+    esp_err_t (*set_pixels)(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *pixels, led_buffer_format_t format);
+
+    /**
+     * @brief Refresh memory colors to LEDs
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: timeout value for refreshing task
+     *
+     * @return
+     *      - ESP_OK: Refresh successfully
+     *      - ESP_FAIL: Refresh failed because some other error occurred
+     *
+     * @note:
+     *      After updating the LED colors in the memory, a following invocation of this API is needed to flush colors to strip.
+     */
+    esp_err_t (*refresh)(led_strip_t *strip);
+
+    /**
+     * @brief Start refreshing memory colors to LEDs, return before the transmission has finished
+     *
+     * @param strip: LED strip
+     *
+     * @return
+     *      - ESP_OK: Refresh started successfully
+     *      - ESP_FAIL: Refresh failed because some other error occurred
+     *
+     * @note Optional, `led_strip_refresh_async` falls back to `refresh` if NULL.
+     */
+    esp_err_t (*refresh_async)(led_strip_t *strip);
+
+    /**
+     * @brief Wait for the refresh started by `refresh_async`
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: maximum time to wait, -1 means wait forever
+     *
+     * @return
+     *      - ESP_OK: No refresh in progress
+     *      - ESP_ERR_TIMEOUT: Refresh still in progress
+     *
+     * @note Optional, NULL if `refresh_async` is NULL.
+     */
+    esp_err_t (*wait_refresh_done)(led_strip_t *strip, int timeout_ms);
+
+    /**
+     * @brief Set the callbacks for LED strip events
+     *
+     * @param strip: LED strip
+     * @param cbs: group of callback functions, NULL members unregister
+     * @param user_ctx: user data, passed to the callbacks
+     *
+     * @return
+     *      - ESP_OK: Set the callbacks successfully
+     *
+     * @note Optional, `led_strip_register_event_callbacks` returns ESP_ERR_NOT_SUPPORTED if NULL.
+     */
+    esp_err_t (*register_event_callbacks)(led_strip_t *strip, const led_strip_event_callbacks_t *cbs, void *user_ctx);
+
+    /**
+     * @brief Get the refresh counters
+     *
+     * @param strip: LED strip
+     * @param stats: returned counters
+     *
+     * @return
+     *      - ESP_OK: Get the counters successfully
+     *
+     * @note Optional, `led_strip_get_refresh_stats` returns ESP_ERR_NOT_SUPPORTED if NULL.
+     */
+    esp_err_t (*get_refresh_stats)(led_strip_t *strip, led_strip_refresh_stats_t *stats);
+
+    /**
+     * @brief Set the color correction applied when a frame is encoded
+     *
+     * @param strip: LED strip
+     * @param config: correction, NULL to turn it off
+     *
+     * @return
+     *      - ESP_OK: Set the color correction successfully
+     *      - ESP_ERR_NO_MEM: No memory for the tables
+     *
+     * @note Optional, `led_strip_set_color_correction` returns ESP_ERR_NOT_SUPPORTED if NULL.
+     */
+    esp_err_t (*set_color_correction)(led_strip_t *strip, const led_strip_color_correction_t *config);
+
+    /**
+     * @brief Change the brightness of the color correction
+     *
+     * @param strip: LED strip
+     * @param brightness: brightness (0 - 255)
+     *
+     * @return
+     *      - ESP_OK: Set the brightness successfully
+     *      - ESP_ERR_NO_MEM: No memory for the tables
+     *
+     * @note Optional, NULL if `set_color_correction` is NULL.
+     */
+    esp_err_t (*set_brightness)(led_strip_t *strip, uint8_t brightness);
+
+    /**
+     * @brief Turn temporal dithering on or off
+     *
+     * @param strip: LED strip
+     * @param enable: true: keep a 16-bit frame and dither it at every refresh, false: back to 8-bit pixels
+     *
+     * @return
+     *      - ESP_OK: Set dithering successfully
+     *      - ESP_ERR_NO_MEM: No memory for the 16-bit frame
+     *
+     * @note Optional, `led_strip_set_dithering` returns ESP_ERR_NOT_SUPPORTED if NULL.
+     */
+    esp_err_t (*set_dithering)(led_strip_t *strip, bool enable);
+
+    /**
+     * @brief Set a span of pixels from a caller's buffer of 16-bit values
+     *
+     * @param strip: LED strip
+     * @param start: index of the first pixel to set
+     * @param count: number of pixels to set
+     * @param pixels: pixel data, `count` pixels laid out as `format`, 2 bytes per value
+     * @param format: layout of `pixels`
+     *
+     * @return
+     *      - ESP_OK: Set pixels successfully
+     *      - ESP_ERR_INVALID_ARG: Set pixels failed because the span exceeds the strip, or the format needs a white component the strip does not have
+     *      - ESP_ERR_INVALID_STATE: Dithering is off
+     *
+     * @note Optional, NULL if `set_dithering` is NULL.
+     */
+    esp_err_t (*set_pixels_16)(led_strip_t *strip, uint32_t start, uint32_t count, const uint16_t *pixels, led_buffer_format_t format);
+
+    /**
+     * @brief Clear LED strip (turn off all LEDs)
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: timeout value for clearing task
+     *
+     * @return
+     *      - ESP_OK: Clear LEDs successfully
+     *      - ESP_FAIL: Clear LEDs failed because some other error occurred
+     */
+    esp_err_t (*clear)(led_strip_t *strip);
+
+    /**
+     * @brief Free LED strip resources
+     *
+     * @param strip: LED strip
+     *
+     * @return
+     *      - ESP_OK: Free resources successfully
+     *      - ESP_FAIL: Free resources failed because error occurred
+     */
+    esp_err_t (*del)(led_strip_t *strip);
+};
+
+#ifdef __cplusplus
+}
+#endif
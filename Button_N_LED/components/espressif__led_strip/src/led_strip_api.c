@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_pixels.h"
+#include "led_strip_hsv.h"
+
+// pixels converted per chunk by the HSV batch functions, 192 bytes of stack
+#define HSV_CHUNK_PIXELS 64
+
+static const char *TAG = "led_strip";
+
+esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->set_pixel(strip, index, red, green, blue);
+}
+
+esp_err_t led_strip_set_pixels(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint8_t *pixels, led_buffer_format_t format)
+{
+    ESP_RETURN_ON_FALSE(strip && pixels && format < LED_BUFFER_FORMAT_INVALID, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->set_pixels) {
+        return strip->set_pixels(strip, start, count, pixels, format);
+    }
+    // backend without a bulk path: one call per pixel
+    bool rgb_first = (format == LED_BUFFER_FORMAT_RGB || format == LED_BUFFER_FORMAT_RGBW);
+    uint8_t src_bytes = led_buffer_format_bytes(format);
+    ESP_RETURN_ON_FALSE(src_bytes == 3 || strip->set_pixel_rgbw, ESP_ERR_NOT_SUPPORTED, TAG, "backend can't set a white component");
+    for (uint32_t i = 0; i < count; i++, pixels += src_bytes) {
+        uint32_t red = rgb_first ? pixels[0] : pixels[1];
+        uint32_t green = rgb_first ? pixels[1] : pixels[0];
+        esp_err_t ret = src_bytes == 4 ?
+                        strip->set_pixel_rgbw(strip, start + i, red, green, pixels[2], pixels[3]) :
+                        strip->set_pixel(strip, start + i, red, green, pixels[2]);
+        ESP_RETURN_ON_ERROR(ret, TAG, "set pixel %"PRIu32" failed", start + i);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint16_t hue, uint8_t saturation, uint8_t value)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    uint8_t rgb[3];
+    led_strip_hsv_to_rgb(hue, saturation, value, rgb);
+    return strip->set_pixel(strip, index, rgb[0], rgb[1], rgb[2]);
+}
+
+// Convert HSV colors chunk by chunk into an RGB buffer on the stack and upload each chunk in bulk.
+// The last chunk goes first: if it fits the strip, the whole span does, so nothing is written on a bad span.
+static esp_err_t led_strip_set_pixels_converted(led_strip_handle_t strip, uint32_t start, uint32_t count,
+                                                void (*convert)(const void *src, uint32_t offset, uint32_t n, uint8_t *rgb, const void *ctx),
+                                                const void *src, const void *ctx)
+{
+    uint8_t rgb[HSV_CHUNK_PIXELS * 3];
+    ESP_RETURN_ON_FALSE(count <= UINT32_MAX - start, ESP_ERR_INVALID_ARG, TAG, "pixel span out of the strip");
+    uint32_t end = count;
+    while (end > 0) {
+        uint32_t n = end % HSV_CHUNK_PIXELS ? end % HSV_CHUNK_PIXELS : HSV_CHUNK_PIXELS;
+        end -= n;
+        convert(src, end, n, rgb, ctx);
+        ESP_RETURN_ON_ERROR(led_strip_set_pixels(strip, start + end, n, rgb, LED_BUFFER_FORMAT_RGB), TAG, "set pixels failed");
+    }
+    return ESP_OK;
+}
+
+static void convert_hsv(const void *src, uint32_t offset, uint32_t n, uint8_t *rgb, const void *ctx)
+{
+    led_strip_hsv_fixed_to_rgb_n((const led_color_hsv_t *)src + offset, n, rgb);
+}
+
+static void convert_hue(const void *src, uint32_t offset, uint32_t n, uint8_t *rgb, const void *ctx)
+{
+    led_strip_hue_ramp_to_rgb_n((const led_strip_hue_ramp_t *)ctx, (const uint16_t *)src + offset, n, rgb);
+}
+
+esp_err_t led_strip_set_pixels_hsv(led_strip_handle_t strip, uint32_t start, uint32_t count, const led_color_hsv_t *pixels)
+{
+    ESP_RETURN_ON_FALSE(strip && pixels, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return led_strip_set_pixels_converted(strip, start, count, convert_hsv, pixels, NULL);
+}
+
+esp_err_t led_strip_hue_ramp_init(led_strip_hue_ramp_t *ramp, uint8_t saturation, uint8_t value)
+{
+    ESP_RETURN_ON_FALSE(ramp, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    led_strip_hue_ramp_fill(ramp, saturation, value);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_set_pixels_hue(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint16_t *hues, const led_strip_hue_ramp_t *ramp)
+{
+    ESP_RETURN_ON_FALSE(strip && hues && ramp, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return led_strip_set_pixels_converted(strip, start, count, convert_hue, hues, ramp);
+}
+
+esp_err_t led_strip_set_pixel_rgbw(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->set_pixel_rgbw(strip, index, red, green, blue, white);
+}
+
+esp_err_t led_strip_refresh(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->refresh(strip);
+}
+
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->refresh_async) {
+        return strip->refresh_async(strip);
+    }
+    return strip->refresh(strip);
+}
+
+esp_err_t led_strip_wait_refresh_done(led_strip_handle_t strip, int timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->wait_refresh_done) {
+        return strip->wait_refresh_done(strip, timeout_ms);
+    }
+    // a synchronous backend has nothing in flight
+    return ESP_OK;
+}
+
+esp_err_t led_strip_register_event_callbacks(led_strip_handle_t strip, const led_strip_event_callbacks_t *cbs, void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(strip && cbs, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->register_event_callbacks, ESP_ERR_NOT_SUPPORTED, TAG, "backend doesn't report events");
+    return strip->register_event_callbacks(strip, cbs, user_ctx);
+}
+
+esp_err_t led_strip_get_refresh_stats(led_strip_handle_t strip, led_strip_refresh_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(strip && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->get_refresh_stats, ESP_ERR_NOT_SUPPORTED, TAG, "backend doesn't keep refresh counters");
+    return strip->get_refresh_stats(strip, stats);
+}
+
+esp_err_t led_strip_set_color_correction(led_strip_handle_t strip, const led_strip_color_correction_t *config)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->set_color_correction, ESP_ERR_NOT_SUPPORTED, TAG, "backend can't correct colors");
+    ESP_RETURN_ON_FALSE(config == NULL || config->gamma >= 0, ESP_ERR_INVALID_ARG, TAG, "invalid gamma");
+    return strip->set_color_correction(strip, config);
+}
+
+esp_err_t led_strip_set_brightness(led_strip_handle_t strip, uint8_t brightness)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->set_brightness, ESP_ERR_NOT_SUPPORTED, TAG, "backend can't correct colors");
+    return strip->set_brightness(strip, brightness);
+}
+
+esp_err_t led_strip_set_dithering(led_strip_handle_t strip, bool enable)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->set_dithering, ESP_ERR_NOT_SUPPORTED, TAG, "backend can't dither");
+    return strip->set_dithering(strip, enable);
+}
+
+esp_err_t led_strip_set_pixels_16(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint16_t *pixels, led_buffer_format_t format)
+{
+    ESP_RETURN_ON_FALSE(strip && pixels && format < LED_BUFFER_FORMAT_INVALID, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->set_pixels_16, ESP_ERR_NOT_SUPPORTED, TAG, "backend can't dither");
+    return strip->set_pixels_16(strip, start, count, pixels, format);
+}
+
+esp_err_t led_strip_clear(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->clear(strip);
+}
+
+esp_err_t led_strip_del(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return strip->del(strip);
+}
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <math.h>
+#include "led_strip_color.h"
+
+void led_strip_color_lut_init(led_strip_color_lut_t *lut, const led_strip_color_correction_t *config)
+{
+    float gamma = config->gamma > 0 ? config->gamma : 1.0f;
+    for (int v = 0; v < 256; v++) {
+        lut->curve[v] = (uint16_t)lroundf(powf(v / 255.0f, gamma) * 65535.0f);
+    }
+    // 0 is taken as "unchanged", so a zeroed white_balance doesn't black out the strip
+    uint8_t red = config->white_balance.red ? config->white_balance.red : 255;
+    uint8_t green = config->white_balance.green ? config->white_balance.green : 255;
+    uint8_t blue = config->white_balance.blue ? config->white_balance.blue : 255;
+    lut->scale[0] = green;
+    lut->scale[1] = red;
+    lut->scale[2] = blue;
+    lut->scale[3] = 255;
+    led_strip_color_lut_set_brightness(lut, config->brightness);
+}
+
+void led_strip_color_lut_set_brightness(led_strip_color_lut_t *lut, uint8_t brightness)
+{
+    // curve / 65535 * scale / 255 * brightness / 255 * 255, rounded; at most 65535 * 65025 + full / 2, fits 32 bits
+    const uint32_t full = 65535UL * 255;
+    lut->brightness = brightness;
+    for (int c = 0; c < 4; c++) {
+        uint32_t k = (uint32_t)lut->scale[c] * brightness;
+        for (int v = 0; v < 256; v++) {
+            lut->table[c][v] = (uint8_t)((lut->curve[v] * k + full / 2) / full);
+        }
+    }
+}
+
+void led_strip_color_lut_apply(uint8_t *dst, const uint8_t *src, uint32_t count, uint8_t bytes_per_pixel,
+                               const led_strip_color_lut_t *lut)
+{
+    if (bytes_per_pixel == 3) {
+        for (uint32_t i = 0; i < count; i++, src += 3, dst += 3) {
+            dst[0] = lut->table[0][src[0]];
+            dst[1] = lut->table[1][src[1]];
+            dst[2] = lut->table[2][src[2]];
+        }
+    } else {
+        for (uint32_t i = 0; i < count; i++, src += 4, dst += 4) {
+            dst[0] = lut->table[0][src[0]];
+            dst[1] = lut->table[1][src[1]];
+            dst[2] = lut->table[2][src[2]];
+            dst[3] = lut->table[3][src[3]];
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Color correction of a strip, collapsed into one table per wire channel
+ */
+typedef struct {
+    uint16_t curve[256];    /*!< Gamma curve, 0 - 65535, kept so that a brightness change doesn't need powf */
+    uint8_t scale[4];       /*!< White balance in wire order: green, red, blue, white */
+    uint8_t brightness;     /*!< Global brightness */
+    uint8_t table[4][256];  /*!< Output value of every input value, wire order: green, red, blue, white */
+} led_strip_color_lut_t;
+
+/**
+ * @brief Build the tables for a correction config
+ *
+ * @param lut: tables to fill
+ * @param config: gamma, brightness and white balance
+ */
+void led_strip_color_lut_init(led_strip_color_lut_t *lut, const led_strip_color_correction_t *config);
+
+/**
+ * @brief Rebuild the tables for another brightness, keeping gamma and white balance
+ *
+ * @note 4 x 256 integer multiplications, whatever the length of the strip.
+ *
+ * @param lut: tables built by `led_strip_color_lut_init`
+ * @param brightness: global brightness (0 - 255)
+ */
+void led_strip_color_lut_set_brightness(led_strip_color_lut_t *lut, uint8_t brightness);
+
+/**
+ * @brief Map pixels in wire order through the tables
+ *
+ * @param dst: destination, `count * bytes_per_pixel` bytes, may be `src`
+ * @param src: pixels in wire order (GRB or GRBW)
+ * @param count: number of pixels
+ * @param bytes_per_pixel: bytes per pixel of the strip (3 or 4)
+ * @param lut: tables
+ */
+void led_strip_color_lut_apply(uint8_t *dst, const uint8_t *src, uint32_t count, uint8_t bytes_per_pixel,
+                               const led_strip_color_lut_t *lut);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pixels written since the last refresh, as one span [start, end)
+ *
+ * @note Two writes far apart make one span covering both, the pixels in between are encoded again.
+ *       One span keeps the check in the setters to two compares, and the encoders work on contiguous memory anyway.
+ */
+typedef struct {
+    uint32_t start;     /*!< First written pixel */
+    uint32_t end;       /*!< One past the last written pixel, `end <= start`: nothing written */
+} led_strip_dirty_t;
+
+/**
+ * @brief Nothing written yet
+ *
+ * @param dirty: span to reset
+ */
+static inline void led_strip_dirty_reset(led_strip_dirty_t *dirty)
+{
+    dirty->start = UINT32_MAX;
+    dirty->end = 0;
+}
+
+/**
+ * @brief Every pixel written, e.g. after a change of the color tables
+ *
+ * @param dirty: span to set
+ * @param strip_len: number of pixels of the strip
+ */
+static inline void led_strip_dirty_all(led_strip_dirty_t *dirty, uint32_t strip_len)
+{
+    dirty->start = 0;
+    dirty->end = strip_len;
+}
+
+/**
+ * @brief Add the pixels [start, start + count) to the span
+ *
+ * @param dirty: span to grow
+ * @param start: first written pixel
+ * @param count: number of written pixels
+ */
+static inline void led_strip_dirty_add(led_strip_dirty_t *dirty, uint32_t start, uint32_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    if (start < dirty->start) {
+        dirty->start = start;
+    }
+    if (start + count > dirty->end) {
+        dirty->end = start + count;
+    }
+}
+
+/**
+ * @brief Whether no pixel was written
+ *
+ * @param dirty: span to check
+ *
+ * @return true if the span is empty
+ */
+static inline bool led_strip_dirty_empty(const led_strip_dirty_t *dirty)
+{
+    return dirty->end <= dirty->start;
+}
+
+#ifdef __cplusplus
+}
+#endif
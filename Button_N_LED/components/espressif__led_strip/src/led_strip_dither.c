@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include "led_strip_dither.h"
+#include "led_strip_pixels.h"
+
+// index in the caller's pixel of every wire channel (green, red, blue, white), -1: not in the buffer (white = 0)
+static const int8_t s_wire_source[LED_BUFFER_FORMAT_INVALID][4] = {
+    [LED_BUFFER_FORMAT_RGB] = { 1, 0, 2, -1 },
+    [LED_BUFFER_FORMAT_GRB] = { 0, 1, 2, -1 },
+    [LED_BUFFER_FORMAT_RGBW] = { 1, 0, 2, 3 },
+    [LED_BUFFER_FORMAT_GRBW] = { 0, 1, 2, 3 },
+};
+
+led_strip_dither_t *led_strip_dither_new(uint32_t strip_len, uint8_t bytes_per_pixel, const uint8_t *pixels)
+{
+    uint32_t channels = strip_len * bytes_per_pixel;
+    led_strip_dither_t *dither = malloc(sizeof(led_strip_dither_t) + channels * (sizeof(uint16_t) + 1));
+    if (dither == NULL) {
+        return NULL;
+    }
+    dither->strip_len = strip_len;
+    dither->bytes_per_pixel = bytes_per_pixel;
+    dither->residual = (uint8_t *)&dither->level[channels];
+    for (uint32_t i = 0; i < channels; i++) {
+        dither->level[i] = pixels[i] * 257;
+        // start half way, so the first frame is the rounded level
+        dither->residual[i] = 128;
+    }
+    return dither;
+}
+
+void led_strip_dither_to_pixels(const led_strip_dither_t *dither, uint8_t *pixels)
+{
+    uint32_t channels = dither->strip_len * dither->bytes_per_pixel;
+    for (uint32_t i = 0; i < channels; i++) {
+        pixels[i] = (dither->level[i] + 128) / 257;
+    }
+}
+
+static void dither_store(led_strip_dither_t *dither, uint32_t start, uint32_t count, const void *pixels,
+                         led_buffer_format_t format, bool wide)
+{
+    const int8_t *source = s_wire_source[format];
+    uint8_t src_bytes = led_buffer_format_bytes(format);
+    uint8_t bpp = dither->bytes_per_pixel;
+    uint16_t *dst = &dither->level[start * bpp];
+    const uint8_t *src8 = pixels;
+    const uint16_t *src16 = pixels;
+    for (uint32_t i = 0; i < count; i++, dst += bpp) {
+        for (uint8_t c = 0; c < bpp; c++) {
+            int8_t s = source[c];
+            dst[c] = s < 0 ? 0 : wide ? src16[s] : src8[s] * 257;
+        }
+        src8 += src_bytes;
+        src16 += src_bytes;
+    }
+}
+
+void led_strip_dither_set_pixels(led_strip_dither_t *dither, uint32_t start, uint32_t count, const uint8_t *pixels,
+                                 led_buffer_format_t format)
+{
+    dither_store(dither, start, count, pixels, format, false);
+}
+
+void led_strip_dither_set_pixels_16(led_strip_dither_t *dither, uint32_t start, uint32_t count, const uint16_t *pixels,
+                                    led_buffer_format_t format)
+{
+    dither_store(dither, start, count, pixels, format, true);
+}
+
+void led_strip_dither_frame(led_strip_dither_t *dither, const led_strip_color_lut_t *lut, uint8_t *dst)
+{
+    // brightness and white balance as a 0.16 factor per wire channel, 65536: unchanged
+    uint32_t gain[4] = { 65536, 65536, 65536, 65536 };
+    if (lut) {
+        for (int c = 0; c < 4; c++) {
+            gain[c] = ((uint64_t)lut->scale[c] * lut->brightness * 65536 + 65025 / 2) / 65025;
+        }
+    }
+    uint32_t channels = dither->strip_len * dither->bytes_per_pixel;
+    uint8_t c = 0;
+    for (uint32_t i = 0; i < channels; i++) {
+        uint32_t x = dither->level[i];
+        if (lut) {
+            // the curve is sampled at the 8-bit values, x = v * 257; interpolate in between
+            uint32_t v = x / 257;
+            uint32_t f = x % 257;
+            x = lut->curve[v];
+            if (f) {
+                x += ((lut->curve[v + 1] - x) * f + 128) / 257;
+            }
+            x = (x * gain[c]) >> 16;
+            c = c + 1 == dither->bytes_per_pixel ? 0 : c + 1;
+        }
+        // target in 8.8 fixed point (x / 257 * 256), plus what the previous frames fell short of
+        uint32_t sum = (x * 256 + 128) / 257 + dither->residual[i];
+        dst[i] = sum >> 8;
+        dither->residual[i] = sum & 0xFF;
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "led_strip_types.h"
+#include "led_strip_color.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 16-bit frame of a dithered strip, 3 bytes per color channel
+ */
+typedef struct {
+    uint32_t strip_len;         /*!< Number of LEDs */
+    uint8_t bytes_per_pixel;    /*!< Channels per LED, 3 (GRB) or 4 (GRBW) */
+    uint8_t *residual;          /*!< Per channel: the part of the level the frames sent so far fell short of, 1/256 */
+    uint16_t level[];           /*!< Per channel, wire order: level 0 - 65535, followed by `residual` */
+} led_strip_dither_t;
+
+/**
+ * @brief Allocate the 16-bit frame, starting from the 8-bit pixels of the strip
+ *
+ * @param strip_len: number of LEDs
+ * @param bytes_per_pixel: bytes per pixel of the strip (3 or 4)
+ * @param pixels: current pixels in wire order, widened to 16 bits
+ *
+ * @return the frame, free() it; NULL if out of memory
+ */
+led_strip_dither_t *led_strip_dither_new(uint32_t strip_len, uint8_t bytes_per_pixel, const uint8_t *pixels);
+
+/**
+ * @brief Round the 16-bit frame back to 8-bit pixels in wire order, when dithering is turned off
+ *
+ * @param dither: frame
+ * @param pixels: destination, `strip_len * bytes_per_pixel` bytes
+ */
+void led_strip_dither_to_pixels(const led_strip_dither_t *dither, uint8_t *pixels);
+
+/**
+ * @brief Set a span of pixels from 8-bit values, widened to 16 bits (v * 257)
+ *
+ * @param dither: frame
+ * @param start: first pixel, the span must have been checked with `led_strip_pixels_valid`
+ * @param count: number of pixels
+ * @param pixels: 8-bit pixels
+ * @param format: layout of `pixels`
+ */
+void led_strip_dither_set_pixels(led_strip_dither_t *dither, uint32_t start, uint32_t count, const uint8_t *pixels,
+                                 led_buffer_format_t format);
+
+/**
+ * @brief Set a span of pixels from 16-bit values
+ *
+ * @param dither: frame
+ * @param start: first pixel, the span must have been checked with `led_strip_pixels_valid`
+ * @param count: number of pixels
+ * @param pixels: 16-bit pixels
+ * @param format: layout of `pixels`
+ */
+void led_strip_dither_set_pixels_16(led_strip_dither_t *dither, uint32_t start, uint32_t count, const uint16_t *pixels,
+                                    led_buffer_format_t format);
+
+/**
+ * @brief Emit the next 8-bit frame
+ *
+ * @note Every channel gets the floor or the ceiling of its level in 8 bits; which one is decided by the residual,
+ *       so that the average over consecutive frames converges to the level (error diffusion in time).
+ *
+ * @param dither: frame, the residuals are updated
+ * @param lut: color correction applied to the levels first (gamma interpolated between the 256 points, brightness
+ *             and white balance at 16 bits), NULL: none
+ * @param dst: 8-bit pixels in wire order, `strip_len * bytes_per_pixel` bytes
+ */
+void led_strip_dither_frame(led_strip_dither_t *dither, const led_strip_color_lut_t *lut, uint8_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,199 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "led_strip.h"
+#include "led_strip_effects.h"
+#include "led_strip_scene.h"
+
+#define LED_STRIP_EFFECTS_DEFAULT_FPS 60
+#define LED_STRIP_EFFECTS_DEFAULT_LAYERS 4
+#define LED_STRIP_EFFECTS_DEFAULT_TASK_PRIORITY 5
+#define LED_STRIP_EFFECTS_DEFAULT_TASK_STACK 3072
+// steps run at most to catch up after a long frame, the rest of the delay is dropped
+#define LED_STRIP_EFFECTS_MAX_CATCH_UP_STEPS 8
+
+static const char *TAG = "led_strip_effects";
+
+struct led_strip_effects_t {
+    led_strip_handle_t strip;
+    led_strip_scene_t *scene;
+    SemaphoreHandle_t lock;         // scene and frame, between the render task and the API
+    SemaphoreHandle_t exited;       // given by the render task when it exits
+    esp_timer_handle_t timer;       // wakes the render task every step while running
+    TaskHandle_t task;              // render task, lives as long as the engine
+    bool running;
+    volatile bool exiting;
+    uint32_t step_us;
+    led_strip_effects_stats_t stats;
+    uint8_t frame[];                // last render, GRB
+};
+
+static void led_strip_effects_tick(void *arg)
+{
+    led_strip_effects_handle_t effects = (led_strip_effects_handle_t)arg;
+    // counting notification: the task sees how many steps passed since it last woke up
+    xTaskNotifyGive(effects->task);
+}
+
+static void led_strip_effects_task(void *arg)
+{
+    led_strip_effects_handle_t effects = (led_strip_effects_handle_t)arg;
+    while (1) {
+        uint32_t steps = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (effects->exiting) {
+            break;
+        }
+        xSemaphoreTake(effects->lock, portMAX_DELAY);
+        if (!effects->running) {
+            // a tick from before led_strip_effects_stop
+            xSemaphoreGive(effects->lock);
+            continue;
+        }
+        int64_t begin = esp_timer_get_time();
+        if (steps > LED_STRIP_EFFECTS_MAX_CATCH_UP_STEPS) {
+            steps = LED_STRIP_EFFECTS_MAX_CATCH_UP_STEPS;
+        }
+        // fixed timestep: steps missed while the previous frame was rendered or sent run without a frame of their own
+        for (uint32_t i = 0; i < steps; i++) {
+            led_strip_scene_step(effects->scene);
+        }
+        bool changed = led_strip_scene_render(effects->scene, effects->frame);
+        effects->stats.steps += steps;
+        effects->stats.late_steps += steps - 1;
+        if (changed) {
+            // GRB is the wire order, the strip copies it as is; refresh_async waits if the previous frame is still out
+            esp_err_t ret = led_strip_set_pixels(effects->strip, 0, effects->scene->strip_len, effects->frame, LED_BUFFER_FORMAT_GRB);
+            if (ret == ESP_OK) {
+                ret = led_strip_refresh_async(effects->strip);
+            }
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "refresh failed: %s", esp_err_to_name(ret));
+            }
+            effects->stats.frames++;
+        }
+        uint32_t elapsed = esp_timer_get_time() - begin;
+        effects->stats.render_time_us = elapsed;
+        if (elapsed > effects->stats.max_render_time_us) {
+            effects->stats.max_render_time_us = elapsed;
+        }
+        xSemaphoreGive(effects->lock);
+    }
+    xSemaphoreGive(effects->exited);
+    vTaskDelete(NULL);
+}
+
+esp_err_t led_strip_new_effects(led_strip_handle_t strip, const led_strip_effects_config_t *config, led_strip_effects_handle_t *ret_effects)
+{
+    led_strip_effects_handle_t effects = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(strip && config && config->max_leds && ret_effects, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    uint32_t fps = config->fps ? config->fps : LED_STRIP_EFFECTS_DEFAULT_FPS;
+    ESP_GOTO_ON_FALSE(fps <= 1000, ESP_ERR_INVALID_ARG, err, TAG, "fps above 1000");
+    size_t max_layers = config->max_layers ? config->max_layers : LED_STRIP_EFFECTS_DEFAULT_LAYERS;
+    effects = calloc(1, sizeof(struct led_strip_effects_t) + config->max_leds * 3);
+    ESP_GOTO_ON_FALSE(effects, ESP_ERR_NO_MEM, err, TAG, "no mem for effect engine");
+    effects->scene = led_strip_scene_new(config->max_leds, fps, max_layers, config->seed);
+    ESP_GOTO_ON_FALSE(effects->scene, ESP_ERR_NO_MEM, err, TAG, "no mem for layers");
+    effects->lock = xSemaphoreCreateMutex();
+    effects->exited = xSemaphoreCreateBinary();
+    ESP_GOTO_ON_FALSE(effects->lock && effects->exited, ESP_ERR_NO_MEM, err, TAG, "no mem for semaphores");
+    esp_timer_create_args_t timer_args = {
+        .callback = led_strip_effects_tick,
+        .arg = effects,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "led_effects",
+    };
+    ESP_GOTO_ON_ERROR(esp_timer_create(&timer_args, &effects->timer), err, TAG, "create step timer failed");
+    effects->strip = strip;
+    effects->step_us = 1000000 / fps;
+    uint32_t priority = config->task_priority ? config->task_priority : LED_STRIP_EFFECTS_DEFAULT_TASK_PRIORITY;
+    uint32_t stack = config->task_stack ? config->task_stack : LED_STRIP_EFFECTS_DEFAULT_TASK_STACK;
+    ESP_GOTO_ON_FALSE(xTaskCreate(led_strip_effects_task, "led_effects", stack, effects, priority, &effects->task) == pdPASS,
+                      ESP_ERR_NO_MEM, err, TAG, "create render task failed");
+
+    *ret_effects = effects;
+    return ESP_OK;
+err:
+    if (effects) {
+        led_strip_effects_del(effects);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_effects_set_layer(led_strip_effects_handle_t effects, size_t index, const led_effect_layer_config_t *layer)
+{
+    ESP_RETURN_ON_FALSE(effects, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(effects->lock, portMAX_DELAY);
+    bool ok = led_strip_scene_set_layer(effects->scene, index, layer);
+    xSemaphoreGive(effects->lock);
+    ESP_RETURN_ON_FALSE(ok, ESP_ERR_INVALID_ARG, TAG, "invalid layer slot, span, effect or blend mode");
+    return ESP_OK;
+}
+
+esp_err_t led_strip_effects_start(led_strip_effects_handle_t effects)
+{
+    ESP_RETURN_ON_FALSE(effects, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!effects->running, ESP_ERR_INVALID_STATE, TAG, "already running");
+    ESP_RETURN_ON_ERROR(esp_timer_start_periodic(effects->timer, effects->step_us), TAG, "start step timer failed");
+    xSemaphoreTake(effects->lock, portMAX_DELAY);
+    effects->running = true;
+    xSemaphoreGive(effects->lock);
+    // the first frame goes out right away, then one step per tick
+    xTaskNotifyGive(effects->task);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_effects_stop(led_strip_effects_handle_t effects)
+{
+    ESP_RETURN_ON_FALSE(effects, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(effects->running, ESP_ERR_INVALID_STATE, TAG, "not running");
+    esp_timer_stop(effects->timer);
+    // once the lock is ours the render task is between two frames, and skips the ticks still pending
+    xSemaphoreTake(effects->lock, portMAX_DELAY);
+    effects->running = false;
+    xSemaphoreGive(effects->lock);
+    return led_strip_wait_refresh_done(effects->strip, -1);
+}
+
+esp_err_t led_strip_effects_get_stats(led_strip_effects_handle_t effects, led_strip_effects_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(effects && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(effects->lock, portMAX_DELAY);
+    *stats = effects->stats;
+    xSemaphoreGive(effects->lock);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_effects_del(led_strip_effects_handle_t effects)
+{
+    ESP_RETURN_ON_FALSE(effects, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (effects->running) {
+        ESP_RETURN_ON_ERROR(led_strip_effects_stop(effects), TAG, "stop failed");
+    }
+    if (effects->timer) {
+        esp_timer_delete(effects->timer);
+    }
+    if (effects->task) {
+        effects->exiting = true;
+        xTaskNotifyGive(effects->task);
+        xSemaphoreTake(effects->exited, portMAX_DELAY);
+    }
+    if (effects->lock) {
+        vSemaphoreDelete(effects->lock);
+    }
+    if (effects->exited) {
+        vSemaphoreDelete(effects->exited);
+    }
+    free(effects->scene);
+    free(effects);
+    return ESP_OK;
+}
@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "led_strip_hsv.h"
+
+// x / 255 for 0 <= x <= 65535, without a division
+static inline uint32_t div255(uint32_t x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+static inline uint8_t hsv_min(uint8_t saturation, uint8_t value)
+{
+    return div255((uint32_t)value * (255 - saturation));
+}
+
+// sectors 6 and 7 repeat 0 and 1, so a hue up to 2047 needs no range check
+static inline void hsv_sector_to_rgb(uint32_t sector, uint8_t max, uint8_t min, uint8_t rise, uint8_t *rgb)
+{
+    uint8_t fall = max + min - rise;
+    switch (sector & 7) {
+    case 0:
+    case 6:
+        rgb[0] = max, rgb[1] = rise, rgb[2] = min;  // red -> yellow
+        break;
+    case 1:
+    case 7:
+        rgb[0] = fall, rgb[1] = max, rgb[2] = min;  // yellow -> green
+        break;
+    case 2:
+        rgb[0] = min, rgb[1] = max, rgb[2] = rise;  // green -> cyan
+        break;
+    case 3:
+        rgb[0] = min, rgb[1] = fall, rgb[2] = max;  // cyan -> blue
+        break;
+    case 4:
+        rgb[0] = rise, rgb[1] = min, rgb[2] = max;  // blue -> magenta
+        break;
+    default:
+        rgb[0] = max, rgb[1] = min, rgb[2] = fall;  // magenta -> red
+        break;
+    }
+}
+
+void led_strip_hsv_to_rgb(uint16_t hue, uint8_t saturation, uint8_t value, uint8_t rgb[3])
+{
+    uint32_t rgb_max = value;
+    // same as the former rgb_max * (255 - saturation) / 255.0f: the quotient is never close enough
+    // to the next integer for the float to round up, so truncating integer division matches it
+    uint32_t rgb_min = hsv_min(saturation, value);
+    // divisions by a constant, the compiler turns them into multiplications
+    uint32_t i = hue / 60;
+    uint32_t diff = hue % 60;
+    uint32_t rgb_adj = (rgb_max - rgb_min) * diff / 60;
+
+    // hue 360 lands in sector 6, which the former switch handled as sector 5
+    hsv_sector_to_rgb(i < 6 ? i : 5, rgb_max, rgb_min, rgb_min + rgb_adj, rgb);
+}
+
+void led_strip_hsv_fixed_to_rgb(const led_color_hsv_t *hsv, uint8_t rgb[3])
+{
+    uint8_t max = hsv->value;
+    uint8_t min = hsv_min(hsv->saturation, hsv->value);
+    uint8_t rise = min + (((uint32_t)(max - min) * (hsv->hue & 0xFF)) >> 8);
+    hsv_sector_to_rgb(hsv->hue >> 8, max, min, rise, rgb);
+}
+
+void led_strip_hsv_fixed_to_rgb_n(const led_color_hsv_t *hsv, uint32_t count, uint8_t *rgb)
+{
+    for (uint32_t i = 0; i < count; i++, rgb += 3) {
+        led_strip_hsv_fixed_to_rgb(&hsv[i], rgb);
+    }
+}
+
+void led_strip_hue_ramp_to_rgb_n(const led_strip_hue_ramp_t *ramp, const uint16_t *hue, uint32_t count, uint8_t *rgb)
+{
+    for (uint32_t i = 0; i < count; i++, rgb += 3) {
+        hsv_sector_to_rgb(hue[i] >> 8, ramp->max, ramp->min, ramp->rise[hue[i] & 0xFF], rgb);
+    }
+}
+
+void led_strip_hue_ramp_fill(led_strip_hue_ramp_t *ramp, uint8_t saturation, uint8_t value)
+{
+    ramp->max = value;
+    ramp->min = hsv_min(saturation, value);
+    for (uint32_t f = 0; f < 256; f++) {
+        ramp->rise[f] = ramp->min + (((uint32_t)(ramp->max - ramp->min) * f) >> 8);
+    }
+}
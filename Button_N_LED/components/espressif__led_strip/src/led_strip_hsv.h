@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Convert HSV with the hue in degrees to RGB, integer only
+ *
+ * @note Gives exactly the colors `led_strip_set_pixel_hsv` has always produced.
+ *
+ * @param hue: hue in degrees (0 - 360)
+ * @param saturation: saturation (0 - 255)
+ * @param value: value (0 - 255)
+ * @param rgb: returned red, green, blue
+ */
+void led_strip_hsv_to_rgb(uint16_t hue, uint8_t saturation, uint8_t value, uint8_t rgb[3]);
+
+/**
+ * @brief Convert HSV with a fixed point hue (0 - LED_STRIP_HUE_RANGE-1) to RGB
+ *
+ * @note No division: 6 sectors of 256 steps, the ramp inside a sector is a shift.
+ *
+ * @param hsv: color, hue values from LED_STRIP_HUE_RANGE to 2047 wrap around
+ * @param rgb: returned red, green, blue
+ */
+void led_strip_hsv_fixed_to_rgb(const led_color_hsv_t *hsv, uint8_t rgb[3]);
+
+/**
+ * @brief Convert a run of fixed point HSV colors into an RGB buffer
+ *
+ * @param hsv: colors
+ * @param count: number of colors
+ * @param rgb: destination, `count * 3` bytes
+ */
+void led_strip_hsv_fixed_to_rgb_n(const led_color_hsv_t *hsv, uint32_t count, uint8_t *rgb);
+
+/**
+ * @brief Fill a hue ramp table for one saturation and value, see `led_strip_hue_ramp_init`
+ *
+ * @param ramp: table to fill
+ * @param saturation: saturation (0 - 255)
+ * @param value: value (0 - 255)
+ */
+void led_strip_hue_ramp_fill(led_strip_hue_ramp_t *ramp, uint8_t saturation, uint8_t value);
+
+/**
+ * @brief Convert a run of hues into an RGB buffer through a ramp table (see `led_strip_hue_ramp_init`)
+ *
+ * @note Same colors as `led_strip_hsv_fixed_to_rgb` with the saturation and value of the ramp.
+ *
+ * @param ramp: ramp table for one saturation and value
+ * @param hue: hues (0 - LED_STRIP_HUE_RANGE-1), values up to 2047 wrap around
+ * @param count: number of hues
+ * @param rgb: destination, `count * 3` bytes
+ */
+void led_strip_hue_ramp_to_rgb_n(const led_strip_hue_ramp_t *ramp, const uint16_t *hue, uint32_t count, uint8_t *rgb);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "led_strip_pixels.h"
+
+void led_strip_pixels_to_wire(uint8_t *dst, uint8_t bytes_per_pixel, const uint8_t *src, led_buffer_format_t format,
+                              uint32_t count)
+{
+    uint8_t src_bytes = led_buffer_format_bytes(format);
+    bool src_is_wire_order = (format == LED_BUFFER_FORMAT_GRB || format == LED_BUFFER_FORMAT_GRBW);
+
+    if (src_is_wire_order && src_bytes == bytes_per_pixel) {
+        memcpy(dst, src, (size_t)count * bytes_per_pixel);
+        return;
+    }
+    // reorder in one loop per layout, so the inner loop has no branches
+    if (bytes_per_pixel == 3) {
+        // only RGB gets here: GRB was copied and 4-byte sources need a GRBW strip
+        for (uint32_t i = 0; i < count; i++, src += 3, dst += 3) {
+            dst[0] = src[1];
+            dst[1] = src[0];
+            dst[2] = src[2];
+        }
+    } else if (format == LED_BUFFER_FORMAT_RGBW) {
+        for (uint32_t i = 0; i < count; i++, src += 4, dst += 4) {
+            dst[0] = src[1];
+            dst[1] = src[0];
+            dst[2] = src[2];
+            dst[3] = src[3];
+        }
+    } else if (format == LED_BUFFER_FORMAT_RGB) {
+        for (uint32_t i = 0; i < count; i++, src += 3, dst += 4) {
+            dst[0] = src[1];
+            dst[1] = src[0];
+            dst[2] = src[2];
+            dst[3] = 0;
+        }
+    } else { // GRB into a GRBW strip
+        for (uint32_t i = 0; i < count; i++, src += 3, dst += 4) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 0;
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Bytes per pixel of a caller's buffer
+ */
+static inline uint8_t led_buffer_format_bytes(led_buffer_format_t format)
+{
+    return (format == LED_BUFFER_FORMAT_RGBW || format == LED_BUFFER_FORMAT_GRBW) ? 4 : 3;
+}
+
+/**
+ * @brief Check a `set_pixels` request once for the whole span
+ *
+ * @param strip_len: number of LEDs of the strip
+ * @param bytes_per_pixel: bytes per pixel of the strip (3: GRB, 4: GRBW)
+ * @param start: first pixel
+ * @param count: number of pixels
+ * @param format: layout of the caller's buffer
+ *
+ * @return true if the span fits the strip and the format fits the pixel format
+ *         (a white component needs a GRBW strip)
+ */
+static inline bool led_strip_pixels_valid(uint32_t strip_len, uint8_t bytes_per_pixel, uint32_t start, uint32_t count,
+                                          led_buffer_format_t format)
+{
+    return format < LED_BUFFER_FORMAT_INVALID && count <= strip_len && start <= strip_len - count &&
+           (bytes_per_pixel == 4 || led_buffer_format_bytes(format) == 3);
+}
+
+/**
+ * @brief Convert pixels from the caller's layout into wire order (GRB or GRBW)
+ *
+ * @note A strip with a white component gets white = 0 from RGB and GRB buffers, like `set_pixel`.
+ *
+ * @param dst: destination, `count * bytes_per_pixel` bytes
+ * @param bytes_per_pixel: bytes per pixel of the strip (3 or 4)
+ * @param src: caller's pixels
+ * @param format: layout of `src`, must be valid for the strip (see `led_strip_pixels_valid`)
+ * @param count: number of pixels
+ */
+void led_strip_pixels_to_wire(uint8_t *dst, uint8_t bytes_per_pixel, const uint8_t *src, led_buffer_format_t format,
+                              uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
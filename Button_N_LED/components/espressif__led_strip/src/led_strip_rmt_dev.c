@@ -0,0 +1,567 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "driver/rmt_tx.h"
+#include "soc/soc_caps.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_rmt_encoder.h"
+#include "led_strip_pixels.h"
+#include "led_strip_color.h"
+#include "led_strip_dither.h"
+#include "led_strip_dirty.h"
+
+#define LED_STRIP_RMT_DEFAULT_RESOLUTION 10000000 // 10MHz resolution
+#define LED_STRIP_RMT_DEFAULT_TRANS_QUEUE_SIZE 4
+// the memory size of each RMT channel, in words (4 bytes)
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS 64
+#else
+#define LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS 48
+#endif
+// with DMA the symbols go through a buffer in RAM instead, 4 KB: refilled every 512 symbols (21 LEDs)
+#define LED_STRIP_RMT_DEFAULT_DMA_MEM_BLOCK_SYMBOLS 1024
+
+static const char *TAG = "led_strip_rmt";
+
+typedef struct {
+    led_strip_t base;
+    rmt_channel_handle_t rmt_chan;
+    rmt_encoder_handle_t strip_encoder;
+    led_strip_refresh_done_cb_t on_refresh_done;
+    void *user_ctx;
+    volatile bool sending;          // a frame is on the wire, cleared by the done callback
+    volatile uint32_t frames;
+    volatile uint32_t frame_time_us;
+    uint32_t missed_frames;
+    uint32_t skipped_frames;
+    int64_t frame_start_us;
+    led_strip_color_lut_t *lut;     // color correction, applied when a frame is copied into tx_buf; NULL: off
+    led_strip_dither_t *dither;     // 16-bit frame while dithering, the source of tx_buf instead of pixel_buf; NULL: off
+    led_strip_dirty_t dirty;        // pixels written since the last refresh, only these are copied again into tx_buf
+    uint32_t strip_len;
+    uint8_t bytes_per_pixel;
+    bool grouped;       // owned by a strip group, which refreshes and deletes it
+    uint8_t *tx_buf;    // front buffer, the frame on the wire; only refresh touches it
+    uint8_t *pixel_buf; // back buffer, set_pixel writes the next frame here
+} led_strip_rmt_obj;
+
+struct led_strip_rmt_group_t {
+    rmt_sync_manager_handle_t synchro;  // NULL: single strip or no TX sync on this chip, the channels are started back to back
+    size_t num_strips;
+    led_strip_rmt_obj *strips[];
+};
+
+static bool IRAM_ATTR led_strip_rmt_trans_done(rmt_channel_handle_t tx_chan, const rmt_tx_done_event_data_t *edata, void *user_ctx)
+{
+    led_strip_rmt_obj *rmt_strip = (led_strip_rmt_obj *)user_ctx;
+    rmt_strip->frame_time_us = esp_timer_get_time() - rmt_strip->frame_start_us;
+    rmt_strip->frames++;
+    rmt_strip->sending = false;
+    led_strip_refresh_done_cb_t cb = rmt_strip->on_refresh_done;
+    if (cb) {
+        return cb(&rmt_strip->base, rmt_strip->user_ctx);
+    }
+    return false;
+}
+
+static esp_err_t led_strip_rmt_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(index < rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    led_strip_dirty_add(&rmt_strip->dirty, index, 1);
+    if (rmt_strip->dither) {
+        const uint8_t rgb[3] = { red & 0xFF, green & 0xFF, blue & 0xFF };
+        led_strip_dither_set_pixels(rmt_strip->dither, index, 1, rgb, LED_BUFFER_FORMAT_RGB);
+        return ESP_OK;
+    }
+    uint32_t start = index * rmt_strip->bytes_per_pixel;
+    // In thr order of GRB, as LED strip like WS2812 sends out pixels in this order
+    rmt_strip->pixel_buf[start + 0] = green & 0xFF;
+    rmt_strip->pixel_buf[start + 1] = red & 0xFF;
+    rmt_strip->pixel_buf[start + 2] = blue & 0xFF;
+    if (rmt_strip->bytes_per_pixel > 3) {
+        rmt_strip->pixel_buf[start + 3] = 0;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(index < rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(rmt_strip->bytes_per_pixel == 4, ESP_ERR_INVALID_ARG, TAG, "wrong LED pixel format, expected 4 bytes per pixel");
+    led_strip_dirty_add(&rmt_strip->dirty, index, 1);
+    if (rmt_strip->dither) {
+        const uint8_t rgbw[4] = { red & 0xFF, green & 0xFF, blue & 0xFF, white & 0xFF };
+        led_strip_dither_set_pixels(rmt_strip->dither, index, 1, rgbw, LED_BUFFER_FORMAT_RGBW);
+        return ESP_OK;
+    }
+    uint8_t *buf_start = rmt_strip->pixel_buf + index * 4;
+    // SK6812 component order is GRBW
+    *buf_start = green & 0xFF;
+    *++buf_start = red & 0xFF;
+    *++buf_start = blue & 0xFF;
+    *++buf_start = white & 0xFF;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *pixels, led_buffer_format_t format)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(led_strip_pixels_valid(rmt_strip->strip_len, rmt_strip->bytes_per_pixel, start, count, format),
+                        ESP_ERR_INVALID_ARG, TAG, "pixel span out of the strip or wrong buffer format");
+    led_strip_dirty_add(&rmt_strip->dirty, start, count);
+    if (rmt_strip->dither) {
+        led_strip_dither_set_pixels(rmt_strip->dither, start, count, pixels, format);
+        return ESP_OK;
+    }
+    led_strip_pixels_to_wire(rmt_strip->pixel_buf + start * rmt_strip->bytes_per_pixel, rmt_strip->bytes_per_pixel, pixels, format, count);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_pixels_16(led_strip_t *strip, uint32_t start, uint32_t count, const uint16_t *pixels, led_buffer_format_t format)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(rmt_strip->dither, ESP_ERR_INVALID_STATE, TAG, "16-bit pixels need dithering");
+    ESP_RETURN_ON_FALSE(led_strip_pixels_valid(rmt_strip->strip_len, rmt_strip->bytes_per_pixel, start, count, format),
+                        ESP_ERR_INVALID_ARG, TAG, "pixel span out of the strip or wrong buffer format");
+    led_strip_dirty_add(&rmt_strip->dirty, start, count);
+    led_strip_dither_set_pixels_16(rmt_strip->dither, start, count, pixels, format);
+    return ESP_OK;
+}
+
+// Nothing to send: no pixel written since the last frame, and no dithering, whose every frame differs
+static bool led_strip_rmt_unchanged(const led_strip_rmt_obj *rmt_strip)
+{
+    return !rmt_strip->dither && led_strip_dirty_empty(&rmt_strip->dirty);
+}
+
+// Fill the front buffer with the next frame
+static esp_err_t led_strip_rmt_prepare(led_strip_rmt_obj *rmt_strip)
+{
+    // the front buffer is free again once the previous frame is out
+    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "wait for previous frame failed");
+    if (rmt_strip->dither) {
+        led_strip_dither_frame(rmt_strip->dither, rmt_strip->lut, rmt_strip->tx_buf);
+    } else if (!led_strip_dirty_empty(&rmt_strip->dirty)) {
+        // the front buffer still holds the previous frame, only the written pixels are copied again
+        uint32_t offset = rmt_strip->dirty.start * rmt_strip->bytes_per_pixel;
+        uint32_t count = rmt_strip->dirty.end - rmt_strip->dirty.start;
+        if (rmt_strip->lut) {
+            led_strip_color_lut_apply(rmt_strip->tx_buf + offset, rmt_strip->pixel_buf + offset, count, rmt_strip->bytes_per_pixel, rmt_strip->lut);
+        } else {
+            memcpy(rmt_strip->tx_buf + offset, rmt_strip->pixel_buf + offset, count * rmt_strip->bytes_per_pixel);
+        }
+    }
+    led_strip_dirty_reset(&rmt_strip->dirty);
+    return ESP_OK;
+}
+
+// Send the front buffer
+static esp_err_t led_strip_rmt_start(led_strip_rmt_obj *rmt_strip)
+{
+    size_t frame_size = rmt_strip->strip_len * rmt_strip->bytes_per_pixel;
+    rmt_transmit_config_t tx_conf = {
+        .loop_count = 0,
+    };
+
+    rmt_strip->frame_start_us = esp_timer_get_time();
+    rmt_strip->sending = true;
+    esp_err_t ret = rmt_transmit(rmt_strip->rmt_chan, rmt_strip->strip_encoder, rmt_strip->tx_buf, frame_size, &tx_conf);
+    if (ret != ESP_OK) {
+        rmt_strip->sending = false;
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "transmit pixels by RMT failed");
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_transmit(led_strip_rmt_obj *rmt_strip)
+{
+    ESP_RETURN_ON_ERROR(led_strip_rmt_prepare(rmt_strip), TAG, "prepare frame failed");
+    return led_strip_rmt_start(rmt_strip);
+}
+
+static esp_err_t led_strip_rmt_refresh_async(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(!rmt_strip->grouped, ESP_ERR_INVALID_STATE, TAG, "strip belongs to a group, refresh the group");
+    if (led_strip_rmt_unchanged(rmt_strip)) {
+        // the frame on the wire, or already shown, is this one
+        rmt_strip->skipped_frames++;
+        return ESP_OK;
+    }
+    if (rmt_strip->sending) {
+        rmt_strip->missed_frames++;
+    }
+    return led_strip_rmt_transmit(rmt_strip);
+}
+
+static esp_err_t led_strip_rmt_wait_refresh_done(led_strip_t *strip, int timeout_ms)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    return rmt_tx_wait_all_done(rmt_strip->rmt_chan, timeout_ms);
+}
+
+static esp_err_t led_strip_rmt_refresh(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(!rmt_strip->grouped, ESP_ERR_INVALID_STATE, TAG, "strip belongs to a group, refresh the group");
+    if (led_strip_rmt_unchanged(rmt_strip)) {
+        rmt_strip->skipped_frames++;
+    } else {
+        ESP_RETURN_ON_ERROR(led_strip_rmt_transmit(rmt_strip), TAG, "refresh failed");
+    }
+    // an unchanged frame may still be on the wire from an asynchronous refresh
+    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_register_event_callbacks(led_strip_t *strip, const led_strip_event_callbacks_t *cbs, void *user_ctx)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    // the RMT callback is registered once at creation and forwards to these, swap them while the channel is idle
+    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+    rmt_strip->on_refresh_done = cbs->on_refresh_done;
+    rmt_strip->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_get_refresh_stats(led_strip_t *strip, led_strip_refresh_stats_t *stats)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    stats->frames = rmt_strip->frames;
+    stats->missed_frames = rmt_strip->missed_frames;
+    stats->skipped_frames = rmt_strip->skipped_frames;
+    stats->frame_time_us = rmt_strip->frame_time_us;
+    stats->queue_depth = rmt_strip->sending ? 1 : 0;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_color_correction(led_strip_t *strip, const led_strip_color_correction_t *config)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    // the tables are only read by refresh, while filling tx_buf, so the frame in flight doesn't need them;
+    // every pixel changes with them
+    led_strip_dirty_all(&rmt_strip->dirty, rmt_strip->strip_len);
+    if (config == NULL) {
+        free(rmt_strip->lut);
+        rmt_strip->lut = NULL;
+        return ESP_OK;
+    }
+    if (rmt_strip->lut == NULL) {
+        rmt_strip->lut = malloc(sizeof(led_strip_color_lut_t));
+        ESP_RETURN_ON_FALSE(rmt_strip->lut, ESP_ERR_NO_MEM, TAG, "no mem for color tables");
+    }
+    led_strip_color_lut_init(rmt_strip->lut, config);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_brightness(led_strip_t *strip, uint8_t brightness)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    if (rmt_strip->lut == NULL) {
+        const led_strip_color_correction_t linear = {
+            .brightness = brightness,
+        };
+        return led_strip_rmt_set_color_correction(strip, &linear);
+    }
+    led_strip_color_lut_set_brightness(rmt_strip->lut, brightness);
+    led_strip_dirty_all(&rmt_strip->dirty, rmt_strip->strip_len);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_dithering(led_strip_t *strip, bool enable)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    if (!enable) {
+        if (rmt_strip->dither) {
+            // keep the frame, rounded to 8 bits; tx_buf holds the last dithered frame, copy it all again
+            led_strip_dither_to_pixels(rmt_strip->dither, rmt_strip->pixel_buf);
+            free(rmt_strip->dither);
+            rmt_strip->dither = NULL;
+            led_strip_dirty_all(&rmt_strip->dirty, rmt_strip->strip_len);
+        }
+        return ESP_OK;
+    }
+    if (rmt_strip->dither == NULL) {
+        rmt_strip->dither = led_strip_dither_new(rmt_strip->strip_len, rmt_strip->bytes_per_pixel, rmt_strip->pixel_buf);
+        ESP_RETURN_ON_FALSE(rmt_strip->dither, ESP_ERR_NO_MEM, TAG, "no mem for 16-bit frame");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_clear(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    // Write zero to turn off all leds
+    memset(rmt_strip->pixel_buf, 0, rmt_strip->strip_len * rmt_strip->bytes_per_pixel);
+    if (rmt_strip->dither) {
+        memset(rmt_strip->dither->level, 0, rmt_strip->strip_len * rmt_strip->bytes_per_pixel * sizeof(uint16_t));
+    }
+    led_strip_dirty_all(&rmt_strip->dirty, rmt_strip->strip_len);
+    if (rmt_strip->grouped) {
+        // the LEDs go off with the next refresh of the group
+        return ESP_OK;
+    }
+    return led_strip_rmt_refresh(strip);
+}
+
+// pixel buffer, in PSRAM if asked and there is some
+static uint8_t *led_strip_rmt_frame_alloc(size_t size, bool in_psram)
+{
+    if (in_psram) {
+        return heap_caps_calloc_prefer(1, size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_DEFAULT);
+    }
+    return calloc(1, size);
+}
+
+static esp_err_t led_strip_rmt_del(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(!rmt_strip->grouped, ESP_ERR_INVALID_STATE, TAG, "strip belongs to a group, delete the group");
+    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+    ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), TAG, "disable RMT channel failed");
+    ESP_RETURN_ON_ERROR(rmt_del_channel(rmt_strip->rmt_chan), TAG, "delete RMT channel failed");
+    ESP_RETURN_ON_ERROR(rmt_del_encoder(rmt_strip->strip_encoder), TAG, "delete strip encoder failed");
+    free(rmt_strip->lut);
+    free(rmt_strip->dither);
+    free(rmt_strip->pixel_buf);
+    free(rmt_strip->tx_buf);
+    free(rmt_strip);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config, led_strip_handle_t *ret_strip)
+{
+    led_strip_rmt_obj *rmt_strip = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config && rmt_config && ret_strip, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(led_config->led_pixel_format < LED_PIXEL_FORMAT_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led_pixel_format");
+    uint8_t bytes_per_pixel = 3;
+    if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRBW) {
+        bytes_per_pixel = 4;
+    } else if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRB) {
+        bytes_per_pixel = 3;
+    } else {
+        assert(false);
+    }
+    rmt_strip = calloc(1, sizeof(led_strip_rmt_obj));
+    ESP_GOTO_ON_FALSE(rmt_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for rmt strip");
+    // back and front buffer
+    bool in_psram = led_config->flags.frame_in_psram;
+    size_t frame_size = led_config->max_leds * bytes_per_pixel;
+    rmt_strip->pixel_buf = led_strip_rmt_frame_alloc(frame_size, in_psram);
+#if CONFIG_RMT_ISR_IRAM_SAFE
+    // the encoder reads the front buffer from the RMT interrupt, which must not depend on the cache then
+    rmt_strip->tx_buf = heap_caps_calloc(1, frame_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#else
+    rmt_strip->tx_buf = led_strip_rmt_frame_alloc(frame_size, in_psram);
+#endif
+    ESP_GOTO_ON_FALSE(rmt_strip->pixel_buf && rmt_strip->tx_buf, ESP_ERR_NO_MEM, err, TAG, "no mem for pixels");
+    uint32_t resolution = rmt_config->resolution_hz ? rmt_config->resolution_hz : LED_STRIP_RMT_DEFAULT_RESOLUTION;
+
+    // for backward compatibility, if the user does not set the clk_src, use the default value
+    rmt_clock_source_t clk_src = RMT_CLK_SRC_DEFAULT;
+    if (rmt_config->clk_src) {
+        clk_src = rmt_config->clk_src;
+    }
+#if SOC_RMT_SUPPORT_DMA
+    bool with_dma = rmt_config->flags.with_dma;
+#else
+    // so that the same config works on every target
+    if (rmt_config->flags.with_dma) {
+        ESP_LOGW(TAG, "RMT of this target has no DMA, sending from the channel memory");
+    }
+    bool with_dma = false;
+#endif
+    size_t mem_block_symbols = with_dma ? LED_STRIP_RMT_DEFAULT_DMA_MEM_BLOCK_SYMBOLS : LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS;
+    // override the default value if the user sets it
+    if (rmt_config->mem_block_symbols) {
+        mem_block_symbols = rmt_config->mem_block_symbols;
+    }
+    rmt_tx_channel_config_t rmt_chan_config = {
+        .clk_src = clk_src,
+        .gpio_num = led_config->strip_gpio_num,
+        .mem_block_symbols = mem_block_symbols,
+        .resolution_hz = resolution,
+        .trans_queue_depth = LED_STRIP_RMT_DEFAULT_TRANS_QUEUE_SIZE,
+        .flags.with_dma = with_dma,
+        .flags.invert_out = led_config->flags.invert_out,
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_tx_channel(&rmt_chan_config, &rmt_strip->rmt_chan), err, TAG, "create RMT TX channel failed");
+
+    led_strip_encoder_config_t strip_encoder_conf = {
+        .resolution = resolution,
+        .led_model = led_config->led_model
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_led_strip_encoder(&strip_encoder_conf, &rmt_strip->strip_encoder), err, TAG, "create LED strip encoder failed");
+
+    rmt_tx_event_callbacks_t rmt_cbs = {
+        .on_trans_done = led_strip_rmt_trans_done,
+    };
+    ESP_GOTO_ON_ERROR(rmt_tx_register_event_callbacks(rmt_strip->rmt_chan, &rmt_cbs, rmt_strip), err, TAG, "register RMT callbacks failed");
+    // the channel stays enabled for the lifetime of the strip, so a refresh only queues a transaction
+    ESP_GOTO_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), err, TAG, "enable RMT channel failed");
+
+    rmt_strip->bytes_per_pixel = bytes_per_pixel;
+    rmt_strip->strip_len = led_config->max_leds;
+    // nothing has been sent yet, the first refresh copies every pixel
+    led_strip_dirty_all(&rmt_strip->dirty, rmt_strip->strip_len);
+    rmt_strip->base.set_pixel = led_strip_rmt_set_pixel;
+    rmt_strip->base.set_pixel_rgbw = led_strip_rmt_set_pixel_rgbw;
+    rmt_strip->base.set_pixels = led_strip_rmt_set_pixels;
+    rmt_strip->base.refresh = led_strip_rmt_refresh;
+    rmt_strip->base.refresh_async = led_strip_rmt_refresh_async;
+    rmt_strip->base.wait_refresh_done = led_strip_rmt_wait_refresh_done;
+    rmt_strip->base.register_event_callbacks = led_strip_rmt_register_event_callbacks;
+    rmt_strip->base.get_refresh_stats = led_strip_rmt_get_refresh_stats;
+    rmt_strip->base.set_color_correction = led_strip_rmt_set_color_correction;
+    rmt_strip->base.set_brightness = led_strip_rmt_set_brightness;
+    rmt_strip->base.set_dithering = led_strip_rmt_set_dithering;
+    rmt_strip->base.set_pixels_16 = led_strip_rmt_set_pixels_16;
+    rmt_strip->base.clear = led_strip_rmt_clear;
+    rmt_strip->base.del = led_strip_rmt_del;
+
+    *ret_strip = &rmt_strip->base;
+    return ESP_OK;
+err:
+    if (rmt_strip) {
+        if (rmt_strip->rmt_chan) {
+            rmt_del_channel(rmt_strip->rmt_chan);
+        }
+        if (rmt_strip->strip_encoder) {
+            rmt_del_encoder(rmt_strip->strip_encoder);
+        }
+        free(rmt_strip->pixel_buf);
+        free(rmt_strip->tx_buf);
+        free(rmt_strip);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_rmt_group_del(led_strip_rmt_group_handle_t group)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_ERROR(led_strip_rmt_group_wait_refresh_done(group, -1), TAG, "flush RMT channels failed");
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    if (group->synchro) {
+        ESP_RETURN_ON_ERROR(rmt_del_sync_manager(group->synchro), TAG, "delete sync manager failed");
+        group->synchro = NULL;
+    }
+#endif
+    while (group->num_strips) {
+        led_strip_rmt_obj *rmt_strip = group->strips[group->num_strips - 1];
+        rmt_strip->grouped = false;
+        ESP_RETURN_ON_ERROR(led_strip_rmt_del(&rmt_strip->base), TAG, "delete strip failed");
+        group->num_strips--;
+    }
+    free(group);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_rmt_group(const led_strip_config_t *led_configs, size_t num_strips, const led_strip_rmt_config_t *rmt_config, led_strip_rmt_group_handle_t *ret_group)
+{
+    led_strip_rmt_group_handle_t group = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_configs && num_strips && rmt_config && ret_group, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(num_strips <= SOC_RMT_TX_CANDIDATES_PER_GROUP, ESP_ERR_INVALID_ARG, err, TAG, "more strips than RMT TX channels");
+    group = calloc(1, sizeof(struct led_strip_rmt_group_t) + num_strips * sizeof(led_strip_rmt_obj *));
+    ESP_GOTO_ON_FALSE(group, ESP_ERR_NO_MEM, err, TAG, "no mem for strip group");
+    rmt_channel_handle_t channels[SOC_RMT_TX_CANDIDATES_PER_GROUP];
+    for (size_t i = 0; i < num_strips; i++) {
+        led_strip_handle_t strip = NULL;
+        ESP_GOTO_ON_ERROR(led_strip_new_rmt_device(&led_configs[i], rmt_config, &strip), err, TAG, "create strip %u failed", (unsigned)i);
+        group->strips[i] = __containerof(strip, led_strip_rmt_obj, base);
+        group->strips[i]->grouped = true;
+        group->num_strips = i + 1;
+        channels[i] = group->strips[i]->rmt_chan;
+    }
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    if (num_strips > 1) {
+        // the channels are already enabled, which the sync manager requires
+        rmt_sync_manager_config_t sync_config = {
+            .tx_channel_array = channels,
+            .array_size = num_strips,
+        };
+        ESP_GOTO_ON_ERROR(rmt_new_sync_manager(&sync_config, &group->synchro), err, TAG, "create sync manager failed");
+    }
+#else
+    (void)channels;
+#endif
+
+    *ret_group = group;
+    return ESP_OK;
+err:
+    if (group) {
+        led_strip_rmt_group_del(group);
+    }
+    return ret;
+}
+
+esp_err_t led_strip_rmt_group_get_strip(led_strip_rmt_group_handle_t group, size_t index, led_strip_handle_t *ret_strip)
+{
+    ESP_RETURN_ON_FALSE(group && ret_strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(index < group->num_strips, ESP_ERR_INVALID_ARG, TAG, "index out of the group");
+    *ret_strip = &group->strips[index]->base;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_rmt_group_refresh_async(led_strip_rmt_group_handle_t group)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    // the sync manager starts the channels together only once all of them get a frame, so it is all strips or none
+    bool unchanged = true;
+    for (size_t i = 0; i < group->num_strips; i++) {
+        unchanged = unchanged && led_strip_rmt_unchanged(group->strips[i]);
+    }
+    if (unchanged) {
+        for (size_t i = 0; i < group->num_strips; i++) {
+            group->strips[i]->skipped_frames++;
+        }
+        return ESP_OK;
+    }
+    // fill every front buffer first, so that nothing runs between the starts of two channels
+    for (size_t i = 0; i < group->num_strips; i++) {
+        led_strip_rmt_obj *rmt_strip = group->strips[i];
+        if (rmt_strip->sending) {
+            rmt_strip->missed_frames++;
+        }
+        ESP_RETURN_ON_ERROR(led_strip_rmt_prepare(rmt_strip), TAG, "prepare frame of strip %u failed", (unsigned)i);
+    }
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    if (group->synchro) {
+        // all channels are idle now; once re-armed, they start together when the last one gets its frame
+        ESP_RETURN_ON_ERROR(rmt_sync_reset(group->synchro), TAG, "reset sync manager failed");
+    }
+#endif
+    for (size_t i = 0; i < group->num_strips; i++) {
+        ESP_RETURN_ON_ERROR(led_strip_rmt_start(group->strips[i]), TAG, "start strip %u failed", (unsigned)i);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_rmt_group_wait_refresh_done(led_strip_rmt_group_handle_t group, int timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    for (size_t i = 0; i < group->num_strips; i++) {
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(group->strips[i]->rmt_chan, timeout_ms), TAG, "wait for strip %u failed", (unsigned)i);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_rmt_group_refresh(led_strip_rmt_group_handle_t group)
+{
+    ESP_RETURN_ON_ERROR(led_strip_rmt_group_refresh_async(group), TAG, "refresh failed");
+    return led_strip_rmt_group_wait_refresh_done(group, -1);
+}
@@ -11,6 +11,7 @@
 #include "driver/rmt.h"
 #include "led_strip.h"
 #include "led_strip_interface.h"
+#include "led_strip_pixels.h"
 
 static const char *TAG = "led_strip_rmt";
 
@@ -93,6 +94,15 @@ static esp_err_t led_strip_rmt_set_pixel(led_strip_t *strip, uint32_t index, uin
     return ESP_OK;
 }
 
+static esp_err_t led_strip_rmt_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *pixels, led_buffer_format_t format)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(led_strip_pixels_valid(rmt_strip->strip_len, rmt_strip->bytes_per_pixel, start, count, format),
+                        ESP_ERR_INVALID_ARG, TAG, "pixel span out of the strip or wrong buffer format");
+    led_strip_pixels_to_wire(rmt_strip->buffer + start * rmt_strip->bytes_per_pixel, rmt_strip->bytes_per_pixel, pixels, format, count);
+    return ESP_OK;
+}
+
 static esp_err_t led_strip_rmt_refresh(led_strip_t *strip)
 {
     led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
@@ -179,6 +189,7 @@ esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const l
     rmt_strip->rmt_channel = (rmt_channel_t)dev_config->rmt_channel;
     rmt_strip->strip_len = led_config->max_leds;
     rmt_strip->base.set_pixel = led_strip_rmt_set_pixel;
+    rmt_strip->base.set_pixels = led_strip_rmt_set_pixels;
     rmt_strip->base.refresh = led_strip_rmt_refresh;
     rmt_strip->base.clear = led_strip_rmt_clear;
     rmt_strip->base.del = led_strip_rmt_del;
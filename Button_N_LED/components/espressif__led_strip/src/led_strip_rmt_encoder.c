@@ -4,19 +4,63 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include "esp_attr.h"
 #include "esp_check.h"
+#include "esp_idf_version.h"
 #include "led_strip_rmt_encoder.h"
+#include "led_strip_rmt_symbols.h"
+
+// the simple encoder (IDF >= 5.3) lets the strip encoder write symbols straight into the free RMT memory
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+#define LED_STRIP_RMT_STREAMING_ENCODER 1
+#else
+#define LED_STRIP_RMT_STREAMING_ENCODER 0
+#endif
 
 static const char *TAG = "led_rmt_encoder";
 
 typedef struct {
     rmt_encoder_t base;
+#if LED_STRIP_RMT_STREAMING_ENCODER
+    rmt_encoder_t *simple_encoder;
+    led_strip_rmt_symbols_t symbols;
+#else
     rmt_encoder_t *bytes_encoder;
     rmt_encoder_t *copy_encoder;
     int state;
     rmt_symbol_word_t reset_code;
+#endif
 } rmt_led_strip_encoder_t;
 
+#if LED_STRIP_RMT_STREAMING_ENCODER
+// Called by the simple encoder from the RMT interrupt whenever a part of the channel memory (or DMA buffer) is free
+static size_t IRAM_ATTR rmt_encode_led_strip_cb(const void *data, size_t data_size, size_t symbols_written, size_t symbols_free,
+                                                rmt_symbol_word_t *symbols, bool *done, void *arg)
+{
+    return led_strip_rmt_symbols_fill(arg, data, data_size, symbols_written, symbols_free, &symbols->val, done);
+}
+
+static size_t rmt_encode_led_strip(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primary_data, size_t data_size, rmt_encode_state_t *ret_state)
+{
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    rmt_encoder_handle_t simple_encoder = led_encoder->simple_encoder;
+    return simple_encoder->encode(simple_encoder, channel, primary_data, data_size, ret_state);
+}
+
+static esp_err_t rmt_del_led_strip_encoder(rmt_encoder_t *encoder)
+{
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    rmt_del_encoder(led_encoder->simple_encoder);
+    free(led_encoder);
+    return ESP_OK;
+}
+
+static esp_err_t rmt_led_strip_encoder_reset(rmt_encoder_t *encoder)
+{
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    return rmt_encoder_reset(led_encoder->simple_encoder);
+}
+#else
 static size_t rmt_encode_led_strip(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primary_data, size_t data_size, rmt_encode_state_t *ret_state)
 {
     rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
@@ -70,6 +114,7 @@ static esp_err_t rmt_led_strip_encoder_reset(rmt_encoder_t *encoder)
     led_encoder->state = 0;
     return ESP_OK;
 }
+#endif
 
 esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
 {
@@ -82,64 +127,76 @@ esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rm
     led_encoder->base.encode = rmt_encode_led_strip;
     led_encoder->base.del = rmt_del_led_strip_encoder;
     led_encoder->base.reset = rmt_led_strip_encoder_reset;
-    rmt_bytes_encoder_config_t bytes_encoder_config;
+    // both models send G7...G0R7...R0B7...B0(W7...W0), MSB first
+    uint32_t t0h, t0l, t1h, t1l;
     if (config->led_model == LED_MODEL_SK6812) {
-        bytes_encoder_config = (rmt_bytes_encoder_config_t) {
-            .bit0 = {
-                .level0 = 1,
-                .duration0 = 0.3 * config->resolution / 1000000, // T0H=0.3us
-                .level1 = 0,
-                .duration1 = 0.9 * config->resolution / 1000000, // T0L=0.9us
-            },
-            .bit1 = {
-                .level0 = 1,
-                .duration0 = 0.6 * config->resolution / 1000000, // T1H=0.6us
-                .level1 = 0,
-                .duration1 = 0.6 * config->resolution / 1000000, // T1L=0.6us
-            },
-            .flags.msb_first = 1 // SK6812 transfer bit order: G7...G0R7...R0B7...B0(W7...W0)
-        };
+        t0h = 0.3 * config->resolution / 1000000; // T0H=0.3us
+        t0l = 0.9 * config->resolution / 1000000; // T0L=0.9us
+        t1h = 0.6 * config->resolution / 1000000; // T1H=0.6us
+        t1l = 0.6 * config->resolution / 1000000; // T1L=0.6us
     } else if (config->led_model == LED_MODEL_WS2812) {
         // different led strip might have its own timing requirements, following parameter is for WS2812
-        bytes_encoder_config = (rmt_bytes_encoder_config_t) {
-            .bit0 = {
-                .level0 = 1,
-                .duration0 = 0.3 * config->resolution / 1000000, // T0H=0.3us
-                .level1 = 0,
-                .duration1 = 0.9 * config->resolution / 1000000, // T0L=0.9us
-            },
-            .bit1 = {
-                .level0 = 1,
-                .duration0 = 0.9 * config->resolution / 1000000, // T1H=0.9us
-                .level1 = 0,
-                .duration1 = 0.3 * config->resolution / 1000000, // T1L=0.3us
-            },
-            .flags.msb_first = 1 // WS2812 transfer bit order: G7...G0R7...R0B7...B0
-        };
+        t0h = 0.3 * config->resolution / 1000000; // T0H=0.3us
+        t0l = 0.9 * config->resolution / 1000000; // T0L=0.9us
+        t1h = 0.9 * config->resolution / 1000000; // T1H=0.9us
+        t1l = 0.3 * config->resolution / 1000000; // T1L=0.3us
     } else {
         assert(false);
     }
+    uint32_t reset_ticks = config->resolution / 1000000 * 280 / 2; // reset code duration defaults to 280us to accomodate WS2812B-V5
+
+#if LED_STRIP_RMT_STREAMING_ENCODER
+    led_strip_rmt_symbols_init(&led_encoder->symbols, LED_STRIP_RMT_SYMBOL(1, t0h, 0, t0l), LED_STRIP_RMT_SYMBOL(1, t1h, 0, t1l),
+                               LED_STRIP_RMT_SYMBOL(0, reset_ticks, 0, reset_ticks));
+    rmt_simple_encoder_config_t simple_encoder_config = {
+        .callback = rmt_encode_led_strip_cb,
+        .arg = &led_encoder->symbols,
+        .min_chunk_size = 8, // one color byte
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_simple_encoder(&simple_encoder_config, &led_encoder->simple_encoder), err, TAG, "create simple encoder failed");
+#else
+    rmt_bytes_encoder_config_t bytes_encoder_config = {
+        .bit0 = {
+            .level0 = 1,
+            .duration0 = t0h,
+            .level1 = 0,
+            .duration1 = t0l,
+        },
+        .bit1 = {
+            .level0 = 1,
+            .duration0 = t1h,
+            .level1 = 0,
+            .duration1 = t1l,
+        },
+        .flags.msb_first = 1
+    };
     ESP_GOTO_ON_ERROR(rmt_new_bytes_encoder(&bytes_encoder_config, &led_encoder->bytes_encoder), err, TAG, "create bytes encoder failed");
     rmt_copy_encoder_config_t copy_encoder_config = {};
     ESP_GOTO_ON_ERROR(rmt_new_copy_encoder(&copy_encoder_config, &led_encoder->copy_encoder), err, TAG, "create copy encoder failed");
 
-    uint32_t reset_ticks = config->resolution / 1000000 * 280 / 2; // reset code duration defaults to 280us to accomodate WS2812B-V5
     led_encoder->reset_code = (rmt_symbol_word_t) {
         .level0 = 0,
         .duration0 = reset_ticks,
         .level1 = 0,
         .duration1 = reset_ticks,
     };
+#endif
     *ret_encoder = &led_encoder->base;
     return ESP_OK;
 err:
     if (led_encoder) {
+#if LED_STRIP_RMT_STREAMING_ENCODER
+        if (led_encoder->simple_encoder) {
+            rmt_del_encoder(led_encoder->simple_encoder);
+        }
+#else
         if (led_encoder->bytes_encoder) {
             rmt_del_encoder(led_encoder->bytes_encoder);
         }
         if (led_encoder->copy_encoder) {
             rmt_del_encoder(led_encoder->copy_encoder);
         }
+#endif
         free(led_encoder);
     }
     return ret;
@@ -0,0 +1,16 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "led_strip_rmt_symbols.h"
+
+void led_strip_rmt_symbols_init(led_strip_rmt_symbols_t *table, uint32_t bit0, uint32_t bit1, uint32_t reset)
+{
+    for (int v = 0; v < 16; v++) {
+        for (int b = 0; b < 4; b++) {
+            table->nibble[v][b] = (v & (0x08 >> b)) ? bit1 : bit0;
+        }
+    }
+    table->reset = reset;
+}
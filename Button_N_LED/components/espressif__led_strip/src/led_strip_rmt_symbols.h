@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief RMT symbol word: duration0 (15 bits), level0, duration1 (15 bits), level1; same layout as `rmt_symbol_word_t`
+ */
+#define LED_STRIP_RMT_SYMBOL(level0, duration0, level1, duration1) \
+    ((uint32_t)(duration0) | (uint32_t)(level0) << 15 | (uint32_t)(duration1) << 16 | (uint32_t)(level1) << 31)
+
+/**
+ * @brief RMT symbols of every color bit pattern, so that a byte is expanded with two table lookups
+ */
+typedef struct {
+    uint32_t nibble[16][4];     /*!< Symbols of every 4-bit value, MSB first */
+    uint32_t reset;             /*!< Reset code sent after the last byte */
+} led_strip_rmt_symbols_t;
+
+/**
+ * @brief Build the table from the symbols of a 0 bit, a 1 bit and the reset code
+ *
+ * @param table: table to fill
+ * @param bit0: symbol of a 0 bit (see `LED_STRIP_RMT_SYMBOL`)
+ * @param bit1: symbol of a 1 bit
+ * @param reset: symbol of the reset code
+ */
+void led_strip_rmt_symbols_init(led_strip_rmt_symbols_t *table, uint32_t bit0, uint32_t bit1, uint32_t reset);
+
+/**
+ * @brief Expand color bytes into RMT symbols, 8 per byte, MSB first
+ *
+ * @param table: symbol table
+ * @param dst: destination, `count * 8` symbols
+ * @param src: color bytes in wire order
+ * @param count: number of bytes
+ */
+static inline __attribute__((always_inline)) void led_strip_rmt_symbols_encode(const led_strip_rmt_symbols_t *table, uint32_t *dst,
+                                                                              const uint8_t *src, size_t count)
+{
+    for (size_t i = 0; i < count; i++, dst += 8) {
+        memcpy(dst, table->nibble[src[i] >> 4], 4 * sizeof(uint32_t));
+        memcpy(dst + 4, table->nibble[src[i] & 0x0F], 4 * sizeof(uint32_t));
+    }
+}
+
+/**
+ * @brief Write the next part of a frame into the free RMT memory: whole bytes of `data`, then the reset code
+ *
+ * @note Has the shape of the callback of an RMT simple encoder: the driver calls it whenever there is room, from the
+ *       RMT interrupt once the transmission has started. 0 means "call again with more room", at least 8 symbols.
+ * @note Always inlined, together with `led_strip_rmt_symbols_encode`, so that it ends up in the IRAM_ATTR callback
+ *       instead of being emitted as a flash function, also when optimization is off.
+ *
+ * @param table: symbol table
+ * @param data: color bytes of the frame
+ * @param data_size: number of bytes
+ * @param symbols_written: symbols written so far for this frame
+ * @param symbols_free: room in `symbols`
+ * @param symbols: where to write
+ * @param done: set once the reset code is written
+ *
+ * @return number of symbols written
+ */
+static inline __attribute__((always_inline)) size_t led_strip_rmt_symbols_fill(const led_strip_rmt_symbols_t *table, const uint8_t *data,
+                                                                               size_t data_size, size_t symbols_written, size_t symbols_free,
+                                                                               uint32_t *symbols, bool *done)
+{
+    size_t next_byte = symbols_written / 8;
+    if (next_byte < data_size) {
+        size_t count = symbols_free / 8;
+        if (count > data_size - next_byte) {
+            count = data_size - next_byte;
+        }
+        led_strip_rmt_symbols_encode(table, symbols, data + next_byte, count);
+        return count * 8;
+    }
+    if (symbols_free == 0) {
+        return 0;
+    }
+    symbols[0] = table->reset;
+    *done = true;
+    return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,333 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "led_strip_scene.h"
+
+#define SCENE_DEFAULT_SEED      0x2545F491
+#define FIRE_DEFAULT_COOLING    55
+#define FIRE_DEFAULT_SPARKING   120
+
+static inline uint32_t scene_rand(led_strip_scene_t *scene)
+{
+    // xorshift32, good enough for sparks and flames
+    uint32_t x = scene->rand;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    scene->rand = x;
+    return x;
+}
+
+// v * s / 255, exact at s = 0 and s = 255
+static inline uint8_t scale8(uint8_t v, uint8_t s)
+{
+    return (v * (s + 1)) >> 8;
+}
+
+// a + (b - a) * t / 255, rounded
+static inline uint8_t mix8(uint8_t a, uint8_t b, uint8_t t)
+{
+    return (a * (255 - t) + b * t + 127) / 255;
+}
+
+static inline void put_grb(uint8_t *px, const led_color_rgb_t *color, uint8_t level)
+{
+    px[0] = scale8(color->green, level);
+    px[1] = scale8(color->red, level);
+    px[2] = scale8(color->blue, level);
+}
+
+// position of a moving pattern after `step` steps, in 1/256 pixel, reduced to [0, period)
+static uint32_t scene_position(const led_strip_scene_t *scene, int16_t speed, uint32_t period)
+{
+    int64_t pos = (int64_t)scene->step * speed * 256 / (int64_t)scene->fps;
+    pos %= period;
+    return pos < 0 ? pos + period : pos;
+}
+
+static bool layer_moves(const led_effect_layer_config_t *config)
+{
+    switch (config->effect) {
+    case LED_EFFECT_GRADIENT:
+        return config->gradient.speed != 0;
+    case LED_EFFECT_CHASE:
+        return config->chase.speed != 0;
+    case LED_EFFECT_TWINKLE:
+    case LED_EFFECT_FIRE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+led_strip_scene_t *led_strip_scene_new(uint32_t strip_len, uint32_t fps, size_t max_layers, uint32_t seed)
+{
+    size_t state_size = max_layers * strip_len;
+    led_strip_scene_t *scene = calloc(1, sizeof(led_strip_scene_t) + max_layers * sizeof(led_strip_scene_layer_t) +
+                                      state_size + strip_len * 3);
+    if (scene == NULL) {
+        return NULL;
+    }
+    scene->strip_len = strip_len;
+    scene->fps = fps;
+    scene->rand = seed ? seed : SCENE_DEFAULT_SEED;
+    scene->max_layers = max_layers;
+    uint8_t *state = (uint8_t *)&scene->layers[max_layers];
+    for (size_t i = 0; i < max_layers; i++) {
+        scene->layers[i].state = state + i * strip_len;
+    }
+    scene->scratch = state + state_size;
+    // the first render draws the black frame of an empty scene
+    scene->changed = true;
+    return scene;
+}
+
+bool led_strip_scene_set_layer(led_strip_scene_t *scene, size_t index, const led_effect_layer_config_t *config)
+{
+    if (index >= scene->max_layers) {
+        return false;
+    }
+    led_strip_scene_layer_t *layer = &scene->layers[index];
+    if (config == NULL) {
+        layer->used = false;
+        scene->changed = true;
+        return true;
+    }
+    if (config->effect >= LED_EFFECT_INVALID || config->blend >= LED_EFFECT_BLEND_INVALID || config->start >= scene->strip_len) {
+        return false;
+    }
+    uint32_t count = config->count ? config->count : scene->strip_len - config->start;
+    if (count > scene->strip_len - config->start) {
+        return false;
+    }
+    if (!layer->used || layer->config.effect != config->effect || layer->config.start != config->start ||
+            layer->config.count != count) {
+        // new pixels: no sparks, no heat
+        memset(layer->state, 0, count);
+        layer->spark_acc = 0;
+    }
+    layer->config = *config;
+    layer->config.count = count;
+    layer->used = true;
+    scene->changed = true;
+    return true;
+}
+
+static void twinkle_step(led_strip_scene_t *scene, led_strip_scene_layer_t *layer)
+{
+    const led_effect_layer_config_t *config = &layer->config;
+    // fade from 255 to 0 in fade_ms
+    uint32_t fade = 255;
+    if (config->twinkle.fade_ms) {
+        fade = 255 * 1000 / ((uint32_t)config->twinkle.fade_ms * scene->fps);
+        if (fade == 0) {
+            fade = 1;
+        }
+    }
+    for (uint32_t i = 0; i < config->count; i++) {
+        layer->state[i] = layer->state[i] > fade ? layer->state[i] - fade : 0;
+    }
+    // `rate` pixels per second, the fraction carried over to the next steps
+    layer->spark_acc += ((uint32_t)config->twinkle.rate << 16) / scene->fps;
+    while (layer->spark_acc >= 1 << 16) {
+        layer->spark_acc -= 1 << 16;
+        layer->state[scene_rand(scene) % config->count] = 255;
+    }
+}
+
+static void fire_step(led_strip_scene_t *scene, led_strip_scene_layer_t *layer)
+{
+    const led_effect_layer_config_t *config = &layer->config;
+    uint8_t *heat = layer->state;
+    uint32_t n = config->count;
+    uint32_t cooling = config->fire.cooling ? config->fire.cooling : FIRE_DEFAULT_COOLING;
+    uint32_t sparking = config->fire.sparking ? config->fire.sparking : FIRE_DEFAULT_SPARKING;
+    // every pixel cools down a little
+    uint32_t cool_max = cooling * 10 / n + 2;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t cool = scene_rand(scene) % cool_max;
+        heat[i] = heat[i] > cool ? heat[i] - cool : 0;
+    }
+    // heat rises and diffuses away from the first pixel
+    for (uint32_t k = n - 1; k >= 2; k--) {
+        heat[k] = (heat[k - 1] + 2 * heat[k - 2]) / 3;
+    }
+    // new sparks near the bottom
+    uint32_t r = scene_rand(scene);
+    if ((r & 0xFF) < sparking) {
+        uint32_t y = (r >> 8) % (n < 7 ? n : 7);
+        uint32_t h = heat[y] + 160 + (r >> 16) % 96;
+        heat[y] = h > 255 ? 255 : h;
+    }
+}
+
+void led_strip_scene_step(led_strip_scene_t *scene)
+{
+    scene->step++;
+    for (size_t l = 0; l < scene->max_layers; l++) {
+        led_strip_scene_layer_t *layer = &scene->layers[l];
+        if (!layer->used) {
+            continue;
+        }
+        if (layer->config.effect == LED_EFFECT_TWINKLE) {
+            twinkle_step(scene, layer);
+        } else if (layer->config.effect == LED_EFFECT_FIRE) {
+            fire_step(scene, layer);
+        }
+        if (layer_moves(&layer->config)) {
+            scene->changed = true;
+        }
+    }
+}
+
+static void gradient_draw(const led_strip_scene_t *scene, const led_effect_layer_config_t *config, uint8_t *dst)
+{
+    const led_color_rgb_t *from = &config->gradient.from;
+    const led_color_rgb_t *to = &config->gradient.to;
+    uint32_t n = config->count;
+    uint32_t period = n * 256;
+    uint32_t head = config->gradient.speed ? scene_position(scene, config->gradient.speed, period) : 0;
+    for (uint32_t i = 0; i < n; i++, dst += 3) {
+        uint32_t t;
+        if (config->gradient.speed == 0) {
+            t = n > 1 ? i * 255 / (n - 1) : 0;
+        } else {
+            // from - to - from over the layer, shifted by the distance travelled
+            int32_t x = (int32_t)(i * 256) - (int32_t)head;
+            if (x < 0) {
+                x += period;
+            }
+            uint32_t u = (uint32_t)x * 2 / n;     // 0 - 511
+            t = u < 256 ? u : 511 - u;
+        }
+        dst[0] = mix8(from->green, to->green, t);
+        dst[1] = mix8(from->red, to->red, t);
+        dst[2] = mix8(from->blue, to->blue, t);
+    }
+}
+
+static void chase_draw(const led_strip_scene_t *scene, const led_effect_layer_config_t *config, uint8_t *dst)
+{
+    uint32_t n = config->count;
+    uint32_t spacing = config->chase.spacing && config->chase.spacing < n ? config->chase.spacing : n;
+    uint32_t period = spacing * 256;
+    uint32_t length = ((uint32_t)config->chase.tail + 1) * 256;
+    uint32_t head = scene_position(scene, config->chase.speed, period);
+    bool forward = config->chase.speed >= 0;
+    uint32_t slot = 0;      // i % spacing
+    for (uint32_t i = 0; i < n; i++, dst += 3) {
+        // distance behind the nearest head ahead of the pixel
+        int32_t d = forward ? (int32_t)head - (int32_t)(slot * 256) : (int32_t)(slot * 256) - (int32_t)head;
+        if (d < 0) {
+            d += period;
+        }
+        uint8_t level = (uint32_t)d < length ? (length - d) * 255 / length : 0;
+        put_grb(dst, &config->chase.color, level);
+        if (++slot == spacing) {
+            slot = 0;
+        }
+    }
+}
+
+static void twinkle_draw(const led_strip_scene_layer_t *layer, uint8_t *dst)
+{
+    for (uint32_t i = 0; i < layer->config.count; i++, dst += 3) {
+        put_grb(dst, &layer->config.twinkle.color, layer->state[i]);
+    }
+}
+
+static void fire_draw(const led_strip_scene_layer_t *layer, uint8_t *dst)
+{
+    for (uint32_t i = 0; i < layer->config.count; i++, dst += 3) {
+        // black - red - yellow - white, 64 steps each
+        uint8_t t = scale8(layer->state[i], 191);
+        uint8_t ramp = (t & 0x3F) << 2;
+        uint8_t red = 255, green = 255, blue = ramp;
+        if (t < 0x40) {
+            red = ramp;
+            green = 0;
+            blue = 0;
+        } else if (t < 0x80) {
+            green = ramp;
+            blue = 0;
+        }
+        dst[0] = green;
+        dst[1] = red;
+        dst[2] = blue;
+    }
+}
+
+static void layer_blend(const led_effect_layer_config_t *config, const uint8_t *src, uint8_t *dst)
+{
+    uint32_t len = config->count * 3;
+    uint8_t opacity = config->opacity ? config->opacity : 255;
+    switch (config->blend) {
+    case LED_EFFECT_BLEND_ALPHA:
+        if (opacity == 255) {
+            memcpy(dst, src, len);
+            break;
+        }
+        for (uint32_t i = 0; i < len; i++) {
+            dst[i] = mix8(dst[i], src[i], opacity);
+        }
+        break;
+    case LED_EFFECT_BLEND_ADD:
+        for (uint32_t i = 0; i < len; i++) {
+            uint32_t v = dst[i] + scale8(src[i], opacity);
+            dst[i] = v > 255 ? 255 : v;
+        }
+        break;
+    case LED_EFFECT_BLEND_MAX:
+        for (uint32_t i = 0; i < len; i++) {
+            uint8_t v = scale8(src[i], opacity);
+            dst[i] = v > dst[i] ? v : dst[i];
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+bool led_strip_scene_render(led_strip_scene_t *scene, uint8_t *frame)
+{
+    if (!scene->changed) {
+        return false;
+    }
+    memset(frame, 0, scene->strip_len * 3);
+    for (size_t l = 0; l < scene->max_layers; l++) {
+        const led_strip_scene_layer_t *layer = &scene->layers[l];
+        if (!layer->used) {
+            continue;
+        }
+        const led_effect_layer_config_t *config = &layer->config;
+        uint8_t *src = scene->scratch;
+        switch (config->effect) {
+        case LED_EFFECT_FILL:
+            for (uint32_t i = 0; i < config->count; i++) {
+                put_grb(&src[i * 3], &config->fill.color, 255);
+            }
+            break;
+        case LED_EFFECT_GRADIENT:
+            gradient_draw(scene, config, src);
+            break;
+        case LED_EFFECT_CHASE:
+            chase_draw(scene, config, src);
+            break;
+        case LED_EFFECT_TWINKLE:
+            twinkle_draw(layer, src);
+            break;
+        case LED_EFFECT_FIRE:
+            fire_draw(layer, src);
+            break;
+        default:
+            continue;
+        }
+        layer_blend(config, src, frame + config->start * 3);
+    }
+    scene->changed = false;
+    return true;
+}
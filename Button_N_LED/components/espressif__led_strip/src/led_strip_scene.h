@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Layer slot of a scene
+ */
+typedef struct {
+    led_effect_layer_config_t config;   /*!< Effect, `count` resolved to the pixels of the layer */
+    bool used;                          /*!< The slot holds a layer */
+    uint32_t spark_acc;                 /*!< Twinkle: pixels to light up, 1/65536, carried over between steps */
+    uint8_t *state;                     /*!< Twinkle: level per pixel; fire: heat per pixel; `count` bytes */
+} led_strip_scene_layer_t;
+
+/**
+ * @brief Stack of effect layers rendered into one GRB frame, advanced by fixed timesteps
+ */
+typedef struct {
+    uint32_t strip_len;         /*!< Number of LEDs */
+    uint32_t fps;               /*!< Steps per second */
+    uint32_t step;              /*!< Steps since the scene was created, the clock of the moving effects */
+    uint32_t rand;              /*!< State of the random generator of twinkle and fire */
+    bool changed;               /*!< The next render differs from the previous one */
+    uint8_t *scratch;           /*!< One layer before blending, GRB */
+    size_t max_layers;          /*!< Number of layer slots */
+    led_strip_scene_layer_t layers[]; /*!< Layer slots, bottom first, followed by the twinkle / fire state and `scratch` */
+} led_strip_scene_t;
+
+/**
+ * @brief Allocate a scene without layers
+ *
+ * @param strip_len: number of LEDs
+ * @param fps: steps per second, the unit of time of the effects
+ * @param max_layers: number of layer slots
+ * @param seed: seed of the random generator, 0: fixed default
+ *
+ * @return the scene, free() it; NULL if out of memory
+ */
+led_strip_scene_t *led_strip_scene_new(uint32_t strip_len, uint32_t fps, size_t max_layers, uint32_t seed);
+
+/**
+ * @brief Set or remove the layer of a slot
+ *
+ * @note The twinkle and fire state is kept when only their parameters change, so they can be tuned while running.
+ *
+ * @param scene: scene
+ * @param index: slot, 0 is the bottom layer
+ * @param config: layer, NULL: remove it
+ *
+ * @return false if the slot, the span, the effect or the blend mode is invalid
+ */
+bool led_strip_scene_set_layer(led_strip_scene_t *scene, size_t index, const led_effect_layer_config_t *config);
+
+/**
+ * @brief Advance every layer by one timestep (1 / fps s)
+ *
+ * @param scene: scene
+ */
+void led_strip_scene_step(led_strip_scene_t *scene);
+
+/**
+ * @brief Render the layers into a frame
+ *
+ * @note Layers are drawn over black, bottom first.
+ *
+ * @param scene: scene
+ * @param frame: GRB, `strip_len * 3` bytes, holding the previous render
+ *
+ * @return false if nothing changed since the previous render, `frame` is left as it is
+ */
+bool led_strip_scene_render(led_strip_scene_t *scene, uint8_t *frame);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,456 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_rom_gpio.h"
+#include "soc/spi_periph.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "hal/spi_hal.h"
+#include "led_strip_spi_encode.h"
+#include "led_strip_pixels.h"
+#include "led_strip_color.h"
+#include "led_strip_dither.h"
+#include "led_strip_dirty.h"
+
+#define LED_STRIP_SPI_DEFAULT_RESOLUTION (2.5 * 1000 * 1000) // 2.5MHz resolution
+#define LED_STRIP_SPI_DEFAULT_TRANS_QUEUE_SIZE 4
+// low level sent after the pixels, the reset time of WS2812B-V5.
+// Frames queued back to back would otherwise run into each other.
+#define LED_STRIP_SPI_RESET_US 280
+// high time of a 0 and a 1, WS2812 and SK6812 alike
+#define LED_STRIP_SPI_T0H_NS 400
+#define LED_STRIP_SPI_T1H_NS 800
+
+static const char *TAG = "led_strip_spi";
+
+typedef struct {
+    led_strip_t base;
+    spi_host_device_t spi_host;
+    spi_device_handle_t spi_device;
+    spi_transaction_t trans;        // the frame being sent, from tx_buf
+    bool trans_queued;              // trans still has to be collected by spi_device_get_trans_result
+    led_strip_refresh_done_cb_t on_refresh_done;
+    void *user_ctx;
+    volatile bool sending;          // a frame is on the wire, cleared by the post transaction callback
+    volatile uint32_t frames;
+    volatile uint32_t frame_time_us;
+    uint32_t missed_frames;
+    uint32_t skipped_frames;
+    int64_t frame_start_us;
+    led_strip_color_lut_t *lut;     // color correction, applied when a frame is encoded into tx_buf; NULL: off
+    led_strip_dither_t *dither;     // 16-bit frame while dithering, the source of tx_buf instead of pixel_buf; NULL: off
+    led_strip_dirty_t dirty;        // pixels written since the last refresh, only these are encoded again into tx_buf
+    led_strip_spi_table_t table;    // SPI pattern of every color byte, for the timing of the actual clock
+    uint8_t *tx_buf;                // encoded frame followed by reset_bytes of zero, DMA capable with `with_dma`
+    uint32_t reset_bytes;
+    uint32_t strip_len;
+    uint8_t bytes_per_pixel;
+    uint8_t *pixel_buf;             // next frame in wire order (GRB or GRBW), set_pixel writes here; may be in PSRAM
+} led_strip_spi_obj;
+
+static void IRAM_ATTR led_strip_spi_trans_done(spi_transaction_t *trans)
+{
+    led_strip_spi_obj *spi_strip = (led_strip_spi_obj *)trans->user;
+    spi_strip->frame_time_us = esp_timer_get_time() - spi_strip->frame_start_us;
+    spi_strip->frames++;
+    spi_strip->sending = false;
+    led_strip_refresh_done_cb_t cb = spi_strip->on_refresh_done;
+    if (cb && cb(&spi_strip->base, spi_strip->user_ctx)) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static esp_err_t led_strip_spi_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(index < spi_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    led_strip_dirty_add(&spi_strip->dirty, index, 1);
+    if (spi_strip->dither) {
+        const uint8_t rgb[3] = { red & 0xFF, green & 0xFF, blue & 0xFF };
+        led_strip_dither_set_pixels(spi_strip->dither, index, 1, rgb, LED_BUFFER_FORMAT_RGB);
+        return ESP_OK;
+    }
+    // stored in wire order, the SPI expansion (3 to 8 bytes per color byte) is done by refresh
+    uint8_t *px = &spi_strip->pixel_buf[index * spi_strip->bytes_per_pixel];
+    px[0] = green & 0xFF;
+    px[1] = red & 0xFF;
+    px[2] = blue & 0xFF;
+    if (spi_strip->bytes_per_pixel > 3) {
+        px[3] = 0;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(index < spi_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(spi_strip->bytes_per_pixel == 4, ESP_ERR_INVALID_ARG, TAG, "wrong LED pixel format, expected 4 bytes per pixel");
+    led_strip_dirty_add(&spi_strip->dirty, index, 1);
+    if (spi_strip->dither) {
+        const uint8_t rgbw[4] = { red & 0xFF, green & 0xFF, blue & 0xFF, white & 0xFF };
+        led_strip_dither_set_pixels(spi_strip->dither, index, 1, rgbw, LED_BUFFER_FORMAT_RGBW);
+        return ESP_OK;
+    }
+    // SK6812 component order is GRBW
+    uint8_t *px = &spi_strip->pixel_buf[index * 4];
+    px[0] = green & 0xFF;
+    px[1] = red & 0xFF;
+    px[2] = blue & 0xFF;
+    px[3] = white & 0xFF;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *pixels, led_buffer_format_t format)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(led_strip_pixels_valid(spi_strip->strip_len, spi_strip->bytes_per_pixel, start, count, format),
+                        ESP_ERR_INVALID_ARG, TAG, "pixel span out of the strip or wrong buffer format");
+    led_strip_dirty_add(&spi_strip->dirty, start, count);
+    if (spi_strip->dither) {
+        led_strip_dither_set_pixels(spi_strip->dither, start, count, pixels, format);
+        return ESP_OK;
+    }
+    led_strip_pixels_to_wire(spi_strip->pixel_buf + start * spi_strip->bytes_per_pixel, spi_strip->bytes_per_pixel, pixels, format, count);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_pixels_16(led_strip_t *strip, uint32_t start, uint32_t count, const uint16_t *pixels, led_buffer_format_t format)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(spi_strip->dither, ESP_ERR_INVALID_STATE, TAG, "16-bit pixels need dithering");
+    ESP_RETURN_ON_FALSE(led_strip_pixels_valid(spi_strip->strip_len, spi_strip->bytes_per_pixel, start, count, format),
+                        ESP_ERR_INVALID_ARG, TAG, "pixel span out of the strip or wrong buffer format");
+    led_strip_dirty_add(&spi_strip->dirty, start, count);
+    led_strip_dither_set_pixels_16(spi_strip->dither, start, count, pixels, format);
+    return ESP_OK;
+}
+
+// collect the queued frame, ESP_ERR_TIMEOUT if it is still being sent after `ticks`
+static esp_err_t led_strip_spi_collect(led_strip_spi_obj *spi_strip, TickType_t ticks)
+{
+    if (!spi_strip->trans_queued) {
+        return ESP_OK;
+    }
+    spi_transaction_t *done = NULL;
+    esp_err_t ret = spi_device_get_trans_result(spi_strip->spi_device, &done, ticks);
+    if (ret == ESP_OK) {
+        spi_strip->trans_queued = false;
+    }
+    return ret;
+}
+
+// nothing to send: no pixel written since the last frame, and no dithering, whose every frame differs
+static bool led_strip_spi_unchanged(const led_strip_spi_obj *spi_strip)
+{
+    return !spi_strip->dither && led_strip_dirty_empty(&spi_strip->dirty);
+}
+
+// encode pixel_buf into tx_buf and queue it, the previous frame must have been collected
+static esp_err_t led_strip_spi_queue(led_strip_spi_obj *spi_strip)
+{
+    if (spi_strip->dither) {
+        // pixel_buf isn't the source while dithering, it takes the 8-bit frame before the expansion
+        led_strip_dither_frame(spi_strip->dither, spi_strip->lut, spi_strip->pixel_buf);
+        led_strip_spi_encode(&spi_strip->table, spi_strip->tx_buf, spi_strip->pixel_buf, spi_strip->strip_len * spi_strip->bytes_per_pixel);
+    } else if (!led_strip_dirty_empty(&spi_strip->dirty)) {
+        // tx_buf still holds the previous frame, only the written pixels are expanded again
+        uint32_t offset = spi_strip->dirty.start * spi_strip->bytes_per_pixel;
+        uint32_t count = spi_strip->dirty.end - spi_strip->dirty.start;
+        uint8_t *dst = spi_strip->tx_buf + offset * spi_strip->table.bytes;
+        if (spi_strip->lut) {
+            led_strip_spi_encode_lut(&spi_strip->table, dst, spi_strip->pixel_buf + offset, count, spi_strip->bytes_per_pixel, spi_strip->lut);
+        } else {
+            led_strip_spi_encode(&spi_strip->table, dst, spi_strip->pixel_buf + offset, count * spi_strip->bytes_per_pixel);
+        }
+    }
+    led_strip_dirty_reset(&spi_strip->dirty);
+    // one transaction for the whole frame: a gap between two transactions could outlast the LEDs' reset time
+    memset(&spi_strip->trans, 0, sizeof(spi_strip->trans));
+    spi_strip->trans.length = (spi_strip->strip_len * spi_strip->bytes_per_pixel * spi_strip->table.bytes + spi_strip->reset_bytes) * 8;
+    spi_strip->trans.tx_buffer = spi_strip->tx_buf;
+    spi_strip->trans.user = spi_strip;
+    spi_strip->frame_start_us = esp_timer_get_time();
+    spi_strip->sending = true;
+    esp_err_t ret = spi_device_queue_trans(spi_strip->spi_device, &spi_strip->trans, portMAX_DELAY);
+    if (ret != ESP_OK) {
+        spi_strip->sending = false;
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "queue pixels to SPI failed");
+    spi_strip->trans_queued = true;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_refresh(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_ERROR(led_strip_spi_collect(spi_strip, portMAX_DELAY), TAG, "wait for previous frame failed");
+    if (led_strip_spi_unchanged(spi_strip)) {
+        // the LEDs already show this frame
+        spi_strip->skipped_frames++;
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(led_strip_spi_queue(spi_strip), TAG, "transmit pixels by SPI failed");
+    ESP_RETURN_ON_ERROR(led_strip_spi_collect(spi_strip, portMAX_DELAY), TAG, "transmit pixels by SPI failed");
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_refresh_async(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    if (led_strip_spi_unchanged(spi_strip)) {
+        // the frame on the wire, or already shown, is this one
+        spi_strip->skipped_frames++;
+        return ESP_OK;
+    }
+    if (spi_strip->sending) {
+        spi_strip->missed_frames++;
+    }
+    // tx_buf is free again once the previous frame is collected; pixel_buf is the back buffer
+    ESP_RETURN_ON_ERROR(led_strip_spi_collect(spi_strip, portMAX_DELAY), TAG, "wait for previous frame failed");
+    return led_strip_spi_queue(spi_strip);
+}
+
+static esp_err_t led_strip_spi_wait_refresh_done(led_strip_t *strip, int timeout_ms)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    return led_strip_spi_collect(spi_strip, timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+}
+
+static esp_err_t led_strip_spi_register_event_callbacks(led_strip_t *strip, const led_strip_event_callbacks_t *cbs, void *user_ctx)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    // the post transaction callback forwards to these, swap them while the bus is idle
+    ESP_RETURN_ON_ERROR(led_strip_spi_collect(spi_strip, portMAX_DELAY), TAG, "wait for previous frame failed");
+    spi_strip->on_refresh_done = cbs->on_refresh_done;
+    spi_strip->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_get_refresh_stats(led_strip_t *strip, led_strip_refresh_stats_t *stats)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    stats->frames = spi_strip->frames;
+    stats->missed_frames = spi_strip->missed_frames;
+    stats->skipped_frames = spi_strip->skipped_frames;
+    stats->frame_time_us = spi_strip->frame_time_us;
+    stats->queue_depth = spi_strip->sending ? 1 : 0;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_color_correction(led_strip_t *strip, const led_strip_color_correction_t *config)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    // the tables are only read by refresh, while encoding tx_buf, so the frame in flight doesn't need them;
+    // every pixel changes with them
+    led_strip_dirty_all(&spi_strip->dirty, spi_strip->strip_len);
+    if (config == NULL) {
+        free(spi_strip->lut);
+        spi_strip->lut = NULL;
+        return ESP_OK;
+    }
+    if (spi_strip->lut == NULL) {
+        spi_strip->lut = malloc(sizeof(led_strip_color_lut_t));
+        ESP_RETURN_ON_FALSE(spi_strip->lut, ESP_ERR_NO_MEM, TAG, "no mem for color tables");
+    }
+    led_strip_color_lut_init(spi_strip->lut, config);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_brightness(led_strip_t *strip, uint8_t brightness)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    if (spi_strip->lut == NULL) {
+        const led_strip_color_correction_t linear = {
+            .brightness = brightness,
+        };
+        return led_strip_spi_set_color_correction(strip, &linear);
+    }
+    led_strip_color_lut_set_brightness(spi_strip->lut, brightness);
+    led_strip_dirty_all(&spi_strip->dirty, spi_strip->strip_len);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_set_dithering(led_strip_t *strip, bool enable)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    if (!enable) {
+        if (spi_strip->dither) {
+            // keep the frame, rounded to 8 bits; tx_buf holds the last dithered frame, encode it all again
+            led_strip_dither_to_pixels(spi_strip->dither, spi_strip->pixel_buf);
+            free(spi_strip->dither);
+            spi_strip->dither = NULL;
+            led_strip_dirty_all(&spi_strip->dirty, spi_strip->strip_len);
+        }
+        return ESP_OK;
+    }
+    if (spi_strip->dither == NULL) {
+        spi_strip->dither = led_strip_dither_new(spi_strip->strip_len, spi_strip->bytes_per_pixel, spi_strip->pixel_buf);
+        ESP_RETURN_ON_FALSE(spi_strip->dither, ESP_ERR_NO_MEM, TAG, "no mem for 16-bit frame");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_clear(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    //Write zero to turn off all leds
+    memset(spi_strip->pixel_buf, 0, spi_strip->strip_len * spi_strip->bytes_per_pixel);
+    if (spi_strip->dither) {
+        memset(spi_strip->dither->level, 0, spi_strip->strip_len * spi_strip->bytes_per_pixel * sizeof(uint16_t));
+    }
+    led_strip_dirty_all(&spi_strip->dirty, spi_strip->strip_len);
+
+    return led_strip_spi_refresh(strip);
+}
+
+static esp_err_t led_strip_spi_del(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+
+    ESP_RETURN_ON_ERROR(led_strip_spi_collect(spi_strip, portMAX_DELAY), TAG, "wait for last frame failed");
+    ESP_RETURN_ON_ERROR(spi_bus_remove_device(spi_strip->spi_device), TAG, "delete spi device failed");
+    ESP_RETURN_ON_ERROR(spi_bus_free(spi_strip->spi_host), TAG, "free spi bus failed");
+
+    free(spi_strip->lut);
+    free(spi_strip->dither);
+    led_strip_spi_table_free(&spi_strip->table);
+    free(spi_strip->tx_buf);
+    free(spi_strip->pixel_buf);
+    free(spi_strip);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_spi_device(const led_strip_config_t *led_config, const led_strip_spi_config_t *spi_config, led_strip_handle_t *ret_strip)
+{
+    led_strip_spi_obj *spi_strip = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config && spi_config && ret_strip, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(led_config->led_pixel_format < LED_PIXEL_FORMAT_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led_pixel_format");
+    uint8_t bytes_per_pixel = 3;
+    if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRBW) {
+        bytes_per_pixel = 4;
+    } else if (led_config->led_pixel_format == LED_PIXEL_FORMAT_GRB) {
+        bytes_per_pixel = 3;
+    } else {
+        assert(false);
+    }
+    uint32_t mem_caps = MALLOC_CAP_DEFAULT;
+    if (spi_config->flags.with_dma) {
+        // DMA buffer must be placed in internal SRAM
+        mem_caps |= MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+    }
+    uint32_t resolution_hz = spi_config->resolution_hz ? spi_config->resolution_hz : LED_STRIP_SPI_DEFAULT_RESOLUTION;
+    // the SPI bits per LED bit depend on the actual clock, known once the device is added: room for the most of them
+    size_t max_trans_size = led_config->max_leds * bytes_per_pixel * LED_STRIP_SPI_MAX_BITS_PER_LED_BIT +
+                            led_strip_spi_reset_bytes(resolution_hz, LED_STRIP_SPI_RESET_US);
+    spi_strip = calloc(1, sizeof(led_strip_spi_obj));
+    ESP_GOTO_ON_FALSE(spi_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for spi strip");
+    size_t frame_size = led_config->max_leds * bytes_per_pixel;
+    if (led_config->flags.frame_in_psram) {
+        spi_strip->pixel_buf = heap_caps_calloc_prefer(1, frame_size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_DEFAULT);
+    } else {
+        spi_strip->pixel_buf = calloc(1, frame_size);
+    }
+    ESP_GOTO_ON_FALSE(spi_strip->pixel_buf, ESP_ERR_NO_MEM, err, TAG, "no mem for pixels");
+
+    spi_strip->spi_host = spi_config->spi_bus;
+    // for backward compatibility, if the user does not set the clk_src, use the default value
+    spi_clock_source_t clk_src = SPI_CLK_SRC_DEFAULT;
+    if (spi_config->clk_src) {
+        clk_src = spi_config->clk_src;
+    }
+
+    spi_bus_config_t spi_bus_cfg = {
+        .mosi_io_num = led_config->strip_gpio_num,
+        //Only use MOSI to generate the signal, set -1 when other pins are not used.
+        .miso_io_num = -1,
+        .sclk_io_num = -1,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = max_trans_size,
+    };
+    ESP_GOTO_ON_ERROR(spi_bus_initialize(spi_strip->spi_host, &spi_bus_cfg, spi_config->flags.with_dma ? SPI_DMA_CH_AUTO : SPI_DMA_DISABLED), err, TAG, "create SPI bus failed");
+
+    if (led_config->flags.invert_out == true) {
+        esp_rom_gpio_connect_out_signal(led_config->strip_gpio_num, spi_periph_signal[spi_strip->spi_host].spid_out, true, false);
+    }
+
+    spi_device_interface_config_t spi_dev_cfg = {
+        .clock_source = clk_src,
+        .command_bits = 0,
+        .address_bits = 0,
+        .dummy_bits = 0,
+        .clock_speed_hz = resolution_hz,
+        .mode = 0,
+        //set -1 when CS is not used
+        .spics_io_num = -1,
+        .queue_size = LED_STRIP_SPI_DEFAULT_TRANS_QUEUE_SIZE,
+        .post_cb = led_strip_spi_trans_done,
+    };
+
+    ESP_GOTO_ON_ERROR(spi_bus_add_device(spi_strip->spi_host, &spi_dev_cfg, &spi_strip->spi_device), err, TAG, "Failed to add spi device");
+    //ensure the reset time is enough
+    esp_rom_delay_us(10);
+    int clock_resolution_khz = 0;
+    spi_device_get_actual_freq(spi_strip->spi_device, &clock_resolution_khz);
+    // the clock source may not divide down to the requested clock exactly, the timing is chosen for the one we got
+    uint32_t clock_hz = clock_resolution_khz * 1000;
+    led_strip_spi_timing_t timing;
+    ESP_GOTO_ON_FALSE(led_strip_spi_timing_select(clock_hz, LED_STRIP_SPI_T0H_NS, LED_STRIP_SPI_T1H_NS, &timing), ESP_ERR_NOT_SUPPORTED, err,
+                      TAG, "unsupported clock resolution:%dKHz", clock_resolution_khz);
+    ESP_GOTO_ON_FALSE(led_strip_spi_table_init(&spi_strip->table, &timing), ESP_ERR_NO_MEM, err, TAG, "no mem for spi patterns");
+    spi_strip->reset_bytes = led_strip_spi_reset_bytes(clock_hz, LED_STRIP_SPI_RESET_US);
+    size_t trans_size = frame_size * timing.bits + spi_strip->reset_bytes;
+    ESP_GOTO_ON_FALSE(trans_size <= max_trans_size, ESP_ERR_NOT_SUPPORTED, err, TAG, "clock resolution %dKHz above the requested one",
+                      clock_resolution_khz);
+    spi_strip->tx_buf = heap_caps_calloc(1, trans_size, mem_caps);
+    ESP_GOTO_ON_FALSE(spi_strip->tx_buf, ESP_ERR_NO_MEM, err, TAG, "no mem for spi transfer buffer");
+    ESP_LOGD(TAG, "clock %dKHz, %d SPI bits per LED bit (%d / %d high), %d bytes per LED", clock_resolution_khz, timing.bits,
+             timing.t0h, timing.t1h, bytes_per_pixel * timing.bits);
+
+    spi_strip->bytes_per_pixel = bytes_per_pixel;
+    spi_strip->strip_len = led_config->max_leds;
+    // tx_buf is all zero, not even a black frame: the first refresh encodes every pixel
+    led_strip_dirty_all(&spi_strip->dirty, spi_strip->strip_len);
+    spi_strip->base.set_pixel = led_strip_spi_set_pixel;
+    spi_strip->base.set_pixel_rgbw = led_strip_spi_set_pixel_rgbw;
+    spi_strip->base.set_pixels = led_strip_spi_set_pixels;
+    spi_strip->base.refresh = led_strip_spi_refresh;
+    spi_strip->base.refresh_async = led_strip_spi_refresh_async;
+    spi_strip->base.wait_refresh_done = led_strip_spi_wait_refresh_done;
+    spi_strip->base.register_event_callbacks = led_strip_spi_register_event_callbacks;
+    spi_strip->base.get_refresh_stats = led_strip_spi_get_refresh_stats;
+    spi_strip->base.set_color_correction = led_strip_spi_set_color_correction;
+    spi_strip->base.set_brightness = led_strip_spi_set_brightness;
+    spi_strip->base.set_dithering = led_strip_spi_set_dithering;
+    spi_strip->base.set_pixels_16 = led_strip_spi_set_pixels_16;
+    spi_strip->base.clear = led_strip_spi_clear;
+    spi_strip->base.del = led_strip_spi_del;
+
+    *ret_strip = &spi_strip->base;
+    return ESP_OK;
+err:
+    if (spi_strip) {
+        if (spi_strip->spi_device) {
+            spi_bus_remove_device(spi_strip->spi_device);
+        }
+        if (spi_strip->spi_host) {
+            spi_bus_free(spi_strip->spi_host);
+        }
+        led_strip_spi_table_free(&spi_strip->table);
+        free(spi_strip->tx_buf);
+        free(spi_strip->pixel_buf);
+        free(spi_strip);
+    }
+    return ret;
+}
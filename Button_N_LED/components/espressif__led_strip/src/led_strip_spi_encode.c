@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "led_strip_spi_encode.h"
+
+// WS2812: an LED bit lasts 1.25us +- 600ns, its high time is within 150ns of the nominal one
+#define LED_BIT_NS              1250
+#define LED_BIT_TOLERANCE_NS    600
+#define LED_HIGH_TOLERANCE_NS   150
+
+// 24-bit SPI pattern of a color byte: every bit becomes 1x0 (x = the color bit), MSB first
+#define SPI_PATTERN(d) (0x924924UL | (((d) & 0x01UL) << 1) | (((d) & 0x02UL) << 3) | (((d) & 0x04UL) << 5) | \
+                        (((d) & 0x08UL) << 7) | (((d) & 0x10UL) << 9) | (((d) & 0x20UL) << 11) | \
+                        (((d) & 0x40UL) << 13) | (((d) & 0x80UL) << 15))
+
+#define P1(d)   { (uint8_t)(SPI_PATTERN(d) >> 16), (uint8_t)(SPI_PATTERN(d) >> 8), (uint8_t)SPI_PATTERN(d) }
+#define P4(d)   P1(d), P1((d) + 1), P1((d) + 2), P1((d) + 3)
+#define P16(d)  P4(d), P4((d) + 4), P4((d) + 8), P4((d) + 12)
+#define P64(d)  P16(d), P16((d) + 16), P16((d) + 32), P16((d) + 48)
+
+const uint8_t led_strip_spi_pattern[256][LED_STRIP_SPI_BYTES_PER_COLOR_BYTE] = {
+    P64(0), P64(64), P64(128), P64(192)
+};
+
+static uint32_t ns_to_bits(uint32_t clock_hz, uint32_t ns)
+{
+    return ((uint64_t)ns * clock_hz + 500000000) / 1000000000;
+}
+
+static uint32_t bits_to_ns(uint32_t clock_hz, uint32_t bits)
+{
+    return (uint64_t)bits * 1000000000 / clock_hz;
+}
+
+static bool high_time_ok(uint32_t clock_hz, uint32_t bits, uint32_t ns)
+{
+    uint32_t actual = bits_to_ns(clock_hz, bits);
+    return (actual > ns ? actual - ns : ns - actual) <= LED_HIGH_TOLERANCE_NS;
+}
+
+bool led_strip_spi_timing_select(uint32_t clock_hz, uint32_t t0h_ns, uint32_t t1h_ns, led_strip_spi_timing_t *timing)
+{
+    if (clock_hz == 0) {
+        return false;
+    }
+    uint32_t best = UINT32_MAX;
+    for (uint32_t bits = LED_STRIP_SPI_MIN_BITS_PER_LED_BIT; bits <= LED_STRIP_SPI_MAX_BITS_PER_LED_BIT; bits++) {
+        uint32_t period = bits_to_ns(clock_hz, bits);
+        uint32_t error = period > LED_BIT_NS ? period - LED_BIT_NS : LED_BIT_NS - period;
+        if (error > LED_BIT_TOLERANCE_NS || error >= best) {
+            continue;
+        }
+        // at least one high bit for a 0, one more for a 1, and at least one low bit for both
+        uint32_t t0h = ns_to_bits(clock_hz, t0h_ns);
+        uint32_t t1h = ns_to_bits(clock_hz, t1h_ns);
+        t0h = t0h ? t0h : 1;
+        t1h = t1h > t0h ? t1h : t0h + 1;
+        if (t1h >= bits || !high_time_ok(clock_hz, t0h, t0h_ns) || !high_time_ok(clock_hz, t1h, t1h_ns)) {
+            continue;
+        }
+        timing->bits = bits;
+        timing->t0h = t0h;
+        timing->t1h = t1h;
+        best = error;
+    }
+    return best != UINT32_MAX;
+}
+
+uint32_t led_strip_spi_reset_bytes(uint32_t clock_hz, uint32_t reset_us)
+{
+    return ((uint64_t)clock_hz * reset_us + 8000000 - 1) / 8000000;
+}
+
+bool led_strip_spi_table_init(led_strip_spi_table_t *table, const led_strip_spi_timing_t *timing)
+{
+    table->bytes = timing->bits;
+    table->alloc = NULL;
+    if (timing->bits == LED_STRIP_SPI_BYTES_PER_COLOR_BYTE && timing->t0h == 1 && timing->t1h == 2) {
+        table->pattern = &led_strip_spi_pattern[0][0];
+        return true;
+    }
+    uint8_t *pattern = calloc(256, timing->bits);
+    if (pattern == NULL) {
+        return false;
+    }
+    for (uint32_t v = 0; v < 256; v++) {
+        uint8_t *out = pattern + v * timing->bits;
+        // every color bit, MSB first, is `bits` SPI bits: t0h or t1h of them high, then low
+        uint32_t pos = 0;
+        for (int b = 7; b >= 0; b--, pos += timing->bits) {
+            uint32_t high = (v >> b) & 0x01 ? timing->t1h : timing->t0h;
+            for (uint32_t k = pos; k < pos + high; k++) {
+                out[k / 8] |= 0x80 >> (k % 8);
+            }
+        }
+    }
+    table->pattern = pattern;
+    table->alloc = pattern;
+    return true;
+}
+
+void led_strip_spi_table_free(led_strip_spi_table_t *table)
+{
+    free(table->alloc);
+    table->alloc = NULL;
+    table->pattern = NULL;
+}
+
+// `n` is a constant at every call below, so the copy of a pattern becomes a few loads and stores
+static inline __attribute__((always_inline)) void encode_run(uint8_t *dst, const uint8_t *pattern, const uint8_t *src,
+                                                             size_t len, size_t n)
+{
+    for (size_t i = 0; i < len; i++, dst += n) {
+        memcpy(dst, pattern + src[i] * n, n);
+    }
+}
+
+static inline __attribute__((always_inline)) void encode_lut_run(uint8_t *dst, const uint8_t *pattern, const uint8_t *src,
+                                                                 uint32_t count, uint8_t bytes_per_pixel,
+                                                                 const led_strip_color_lut_t *lut, size_t n)
+{
+    const size_t stride = bytes_per_pixel * n;
+    for (uint32_t i = 0; i < count; i++, src += bytes_per_pixel, dst += stride) {
+        memcpy(dst, pattern + lut->table[0][src[0]] * n, n);
+        memcpy(dst + n, pattern + lut->table[1][src[1]] * n, n);
+        memcpy(dst + n * 2, pattern + lut->table[2][src[2]] * n, n);
+        if (bytes_per_pixel > 3) {
+            memcpy(dst + n * 3, pattern + lut->table[3][src[3]] * n, n);
+        }
+    }
+}
+
+void led_strip_spi_encode(const led_strip_spi_table_t *table, uint8_t *dst, const uint8_t *src, size_t len)
+{
+    switch (table->bytes) {
+    case 3:
+        encode_run(dst, table->pattern, src, len, 3);
+        break;
+    case 4:
+        encode_run(dst, table->pattern, src, len, 4);
+        break;
+    case 5:
+        encode_run(dst, table->pattern, src, len, 5);
+        break;
+    case 6:
+        encode_run(dst, table->pattern, src, len, 6);
+        break;
+    case 7:
+        encode_run(dst, table->pattern, src, len, 7);
+        break;
+    case 8:
+        encode_run(dst, table->pattern, src, len, 8);
+        break;
+    default:
+        break;
+    }
+}
+
+void led_strip_spi_encode_lut(const led_strip_spi_table_t *table, uint8_t *dst, const uint8_t *src, uint32_t count,
+                              uint8_t bytes_per_pixel, const led_strip_color_lut_t *lut)
+{
+    switch (table->bytes) {
+    case 3:
+        encode_lut_run(dst, table->pattern, src, count, bytes_per_pixel, lut, 3);
+        break;
+    case 4:
+        encode_lut_run(dst, table->pattern, src, count, bytes_per_pixel, lut, 4);
+        break;
+    case 5:
+        encode_lut_run(dst, table->pattern, src, count, bytes_per_pixel, lut, 5);
+        break;
+    case 6:
+        encode_lut_run(dst, table->pattern, src, count, bytes_per_pixel, lut, 6);
+        break;
+    case 7:
+        encode_lut_run(dst, table->pattern, src, count, bytes_per_pixel, lut, 7);
+        break;
+    case 8:
+        encode_lut_run(dst, table->pattern, src, count, bytes_per_pixel, lut, 8);
+        break;
+    default:
+        break;
+    }
+}
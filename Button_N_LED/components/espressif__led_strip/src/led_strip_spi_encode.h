@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "led_strip_color.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// SPI bytes per color byte of the default timing (2.5MHz, 3 SPI bits per LED bit)
+#define LED_STRIP_SPI_BYTES_PER_COLOR_BYTE 3
+// range of SPI bits per LED bit, i.e. of SPI bytes per color byte
+#define LED_STRIP_SPI_MIN_BITS_PER_LED_BIT 3
+#define LED_STRIP_SPI_MAX_BITS_PER_LED_BIT 8
+
+/**
+ * @brief How an LED bit is sent as SPI bits: `t0h` (0) or `t1h` (1) high bits followed by low bits up to `bits`
+ */
+typedef struct {
+    uint8_t bits;   /*!< SPI bits per LED bit, which is also the SPI bytes per color byte */
+    uint8_t t0h;    /*!< High SPI bits of a 0 */
+    uint8_t t1h;    /*!< High SPI bits of a 1 */
+} led_strip_spi_timing_t;
+
+/**
+ * @brief SPI bit patterns of every color byte value for one timing
+ */
+typedef struct {
+    uint8_t bytes;              /*!< SPI bytes per color byte */
+    const uint8_t *pattern;     /*!< 256 patterns of `bytes` bytes, most significant bit first */
+    uint8_t *alloc;             /*!< `pattern` if it was generated, NULL if it is the built-in table */
+} led_strip_spi_table_t;
+
+/**
+ * @brief SPI bit pattern of every color byte value, default timing
+ *
+ * @note Each color bit is sent as 3 SPI bits, low level: 100, high level: 110,
+ *       so a color byte occupies 3 bytes of SPI, most significant bit first.
+ */
+extern const uint8_t led_strip_spi_pattern[256][LED_STRIP_SPI_BYTES_PER_COLOR_BYTE];
+
+/**
+ * @brief Choose how many SPI bits make an LED bit at a given SPI clock
+ *
+ * @note The LED bit must last 1.25us +- 600ns and its high time must be within 150ns of
+ *       `t0h_ns` / `t1h_ns`. Of the bit counts that fit, the one closest to 1.25us is taken.
+ *
+ * @param clock_hz: actual SPI clock
+ * @param t0h_ns: high time of a 0
+ * @param t1h_ns: high time of a 1
+ * @param timing: Returned timing
+ *
+ * @return false if no bit count between LED_STRIP_SPI_MIN_BITS_PER_LED_BIT and LED_STRIP_SPI_MAX_BITS_PER_LED_BIT fits
+ */
+bool led_strip_spi_timing_select(uint32_t clock_hz, uint32_t t0h_ns, uint32_t t1h_ns, led_strip_spi_timing_t *timing);
+
+/**
+ * @brief Bytes of low level for the reset code after a frame
+ *
+ * @param clock_hz: actual SPI clock
+ * @param reset_us: reset time
+ *
+ * @return bytes of zero lasting at least `reset_us`
+ */
+uint32_t led_strip_spi_reset_bytes(uint32_t clock_hz, uint32_t reset_us);
+
+/**
+ * @brief Get the pattern table of a timing
+ *
+ * @note The default timing uses the built-in table, any other one has its 256 * `bits` bytes generated.
+ *
+ * @param table: table to set up, release it with `led_strip_spi_table_free`
+ * @param timing: timing
+ *
+ * @return false if out of memory
+ */
+bool led_strip_spi_table_init(led_strip_spi_table_t *table, const led_strip_spi_timing_t *timing);
+
+/**
+ * @brief Release a table set up by `led_strip_spi_table_init`
+ *
+ * @param table: table
+ */
+void led_strip_spi_table_free(led_strip_spi_table_t *table);
+
+/**
+ * @brief Expand a run of color bytes, e.g. a whole frame already in wire order (GRB or GRBW)
+ *
+ * @param table: pattern table
+ * @param dst: destination, `len * table->bytes` bytes
+ * @param src: color bytes
+ * @param len: number of color bytes
+ */
+void led_strip_spi_encode(const led_strip_spi_table_t *table, uint8_t *dst, const uint8_t *src, size_t len);
+
+/**
+ * @brief Expand pixels in wire order (GRB or GRBW), mapping every color byte through the color correction tables
+ *
+ * @param table: pattern table
+ * @param dst: destination, `count * bytes_per_pixel * table->bytes` bytes
+ * @param src: pixels in wire order
+ * @param count: number of pixels
+ * @param bytes_per_pixel: bytes per pixel of the strip (3 or 4)
+ * @param lut: color correction tables
+ */
+void led_strip_spi_encode_lut(const led_strip_spi_table_t *table, uint8_t *dst, const uint8_t *src, uint32_t count,
+                              uint8_t bytes_per_pixel, const led_strip_color_lut_t *lut);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,35 @@
+/*
+ ******************************************************************************
+ * @file           : test_bench.h
+ * @brief          : Timer and sizes shared by the host benchmarks
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Every benchmark measures a BENCH_LEDS strip over BENCH_FRAMES frames,
+ *   so the BENCH lines of the different tests can be compared.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define BENCH_LEDS          1000
+#define BENCH_FRAMES        2000
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Monotonic time in seconds.
+  */
+static inline double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,155 @@
+/*
+ ******************************************************************************
+ * @file           : test_button.c
+ * @brief          : Host test for the push button state machine
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - button_fsm.h: press and release follow the debounced level, a long press
+ *   comes once per press when it is due, a double click comes with the second
+ *   press of two short clicks, and a triple click is one double click.
+ * - The millisecond counter may wrap between press and release.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "unity.h"
+#include "button_fsm.h"
+
+/* Private define ------------------------------------------------------------*/
+#define LONG_MS     1000
+#define DOUBLE_MS   400
+
+/* Private variables ---------------------------------------------------------*/
+static const button_fsm_config_t s_config = { .long_press_ms = LONG_MS, .double_click_ms = DOUBLE_MS };
+static button_fsm_t s_fsm;
+static button_event_type_t s_events[BUTTON_FSM_MAX_EVENTS];
+
+/* Private functions ---------------------------------------------------------*/
+static size_t feed(bool pressed, uint32_t now_ms)
+{
+    return button_fsm_update(&s_fsm, pressed, now_ms, s_events);
+}
+
+static void expect_one(bool pressed, uint32_t now_ms, button_event_type_t type)
+{
+    TEST_ASSERT_EQUAL(1, feed(pressed, now_ms));
+    TEST_ASSERT_EQUAL(type, s_events[0]);
+}
+
+static void test_press_release(void)
+{
+    button_fsm_init(&s_fsm, &s_config, false);
+    TEST_ASSERT_EQUAL(0, feed(false, 10));
+    expect_one(true, 100, BUTTON_EVENT_PRESS);
+    TEST_ASSERT_EQUAL(0, feed(true, 150));
+    expect_one(false, 200, BUTTON_EVENT_RELEASE);
+    TEST_ASSERT_EQUAL(0, button_fsm_next_due_ms(&s_fsm, 200));
+}
+
+static void test_long_press(void)
+{
+    button_fsm_init(&s_fsm, &s_config, false);
+    expect_one(true, 100, BUTTON_EVENT_PRESS);
+    TEST_ASSERT_EQUAL(LONG_MS, button_fsm_next_due_ms(&s_fsm, 100));
+    TEST_ASSERT_EQUAL(LONG_MS - 300, button_fsm_next_due_ms(&s_fsm, 400));
+    /* an early timer gets nothing, the due time is still ahead */
+    TEST_ASSERT_EQUAL(0, feed(true, 100 + LONG_MS - 1));
+    TEST_ASSERT_EQUAL(1, button_fsm_next_due_ms(&s_fsm, 100 + LONG_MS - 1));
+    expect_one(true, 100 + LONG_MS, BUTTON_EVENT_LONG_PRESS);
+    TEST_ASSERT_EQUAL(0, button_fsm_next_due_ms(&s_fsm, 100 + LONG_MS));
+    TEST_ASSERT_EQUAL(0, feed(true, 100 + 3 * LONG_MS));
+    expect_one(false, 100 + 3 * LONG_MS, BUTTON_EVENT_RELEASE);
+    /* a long press isn't the first click of a double click */
+    expect_one(true, 200 + 3 * LONG_MS, BUTTON_EVENT_PRESS);
+}
+
+static void test_late_long_press(void)
+{
+    /* the hold timer ran late: the release sample finds the long press overdue */
+    button_fsm_init(&s_fsm, &s_config, false);
+    expect_one(true, 0, BUTTON_EVENT_PRESS);
+    TEST_ASSERT_EQUAL(2, feed(false, LONG_MS + 50));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_LONG_PRESS, s_events[0]);
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_RELEASE, s_events[1]);
+}
+
+static void test_double_click(void)
+{
+    button_fsm_init(&s_fsm, &s_config, false);
+    expect_one(true, 1000, BUTTON_EVENT_PRESS);
+    expect_one(false, 1100, BUTTON_EVENT_RELEASE);
+    TEST_ASSERT_EQUAL(2, feed(true, 1100 + DOUBLE_MS));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_PRESS, s_events[0]);
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_DOUBLE_CLICK, s_events[1]);
+    expect_one(false, 1600, BUTTON_EVENT_RELEASE);
+    /* the third click of a triple click is a plain press */
+    expect_one(true, 1700, BUTTON_EVENT_PRESS);
+    expect_one(false, 1800, BUTTON_EVENT_RELEASE);
+    /* and opens a new pair */
+    TEST_ASSERT_EQUAL(2, feed(true, 1900));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_DOUBLE_CLICK, s_events[1]);
+}
+
+static void test_double_click_too_slow(void)
+{
+    button_fsm_init(&s_fsm, &s_config, false);
+    expect_one(true, 0, BUTTON_EVENT_PRESS);
+    expect_one(false, 100, BUTTON_EVENT_RELEASE);
+    expect_one(true, 101 + DOUBLE_MS, BUTTON_EVENT_PRESS);
+}
+
+static void test_disabled(void)
+{
+    const button_fsm_config_t off = { 0 };
+    button_fsm_init(&s_fsm, &off, false);
+    expect_one(true, 0, BUTTON_EVENT_PRESS);
+    TEST_ASSERT_EQUAL(0, button_fsm_next_due_ms(&s_fsm, 0));
+    TEST_ASSERT_EQUAL(0, feed(true, 100000));
+    expect_one(false, 100000, BUTTON_EVENT_RELEASE);
+    expect_one(true, 100010, BUTTON_EVENT_PRESS);
+}
+
+static void test_held_at_start(void)
+{
+    /* held before the button was started: no long press, and its release opens no click */
+    button_fsm_init(&s_fsm, &s_config, true);
+    TEST_ASSERT_EQUAL(0, button_fsm_next_due_ms(&s_fsm, 5000));
+    TEST_ASSERT_EQUAL(0, feed(true, 5000));
+    expect_one(false, 5000, BUTTON_EVENT_RELEASE);
+    expect_one(true, 5100, BUTTON_EVENT_PRESS);
+}
+
+static void test_wrap(void)
+{
+    button_fsm_init(&s_fsm, &s_config, false);
+    uint32_t press = UINT32_MAX - 200;
+    expect_one(true, press, BUTTON_EVENT_PRESS);
+    TEST_ASSERT_EQUAL(LONG_MS - 400, button_fsm_next_due_ms(&s_fsm, press + 400));
+    expect_one(true, press + LONG_MS, BUTTON_EVENT_LONG_PRESS);
+    expect_one(false, press + LONG_MS + 10, BUTTON_EVENT_RELEASE);
+
+    press = UINT32_MAX - 50;
+    expect_one(true, press, BUTTON_EVENT_PRESS);
+    expect_one(false, press + 100, BUTTON_EVENT_RELEASE);
+    TEST_ASSERT_EQUAL(2, feed(true, press + 300));
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_DOUBLE_CLICK, s_events[1]);
+}
+
+
+void test_button_run(void)
+{
+    RUN_TEST(test_press_release);
+    RUN_TEST(test_long_press);
+    RUN_TEST(test_late_long_press);
+    RUN_TEST(test_double_click);
+    RUN_TEST(test_double_click_too_slow);
+    RUN_TEST(test_disabled);
+    RUN_TEST(test_held_at_start);
+    RUN_TEST(test_wrap);
+}
+
+/* ***** END OF FILE ******************************************************** */
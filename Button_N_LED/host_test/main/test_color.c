@@ -0,0 +1,193 @@
+/*
+ ******************************************************************************
+ * @file           : test_color.c
+ * @brief          : Host test and benchmark for the color correction tables
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - led_strip_color.c: the tables must match gamma, white balance and
+ *   brightness computed in double, a brightness change must give the same
+ *   tables as a full rebuild, and a neutral config must send pixels as set.
+ * - led_strip_spi_encode_lut() must equal the tables followed by the plain
+ *   SPI expansion.
+ * - Benchmark: cost of encoding a 1000-LED GRB frame at refresh without and
+ *   with the tables, for the RMT (copy into the front buffer) and the SPI
+ *   (expansion into the DMA buffer) backend. Plus the cost of a brightness
+ *   change: rebuilding the tables against the application scaling every
+ *   pixel itself.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "test_bench.h"
+#include "led_strip_color.h"
+#include "led_strip_spi_encode.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_BYTES           (BENCH_LEDS * 4)
+
+/* Private variables ---------------------------------------------------------*/
+/* pattern table of the default timing, 3 SPI bits per LED bit */
+static const led_strip_spi_table_t s_table = { .bytes = LED_STRIP_SPI_BYTES_PER_COLOR_BYTE, .pattern = &led_strip_spi_pattern[0][0] };
+static uint8_t s_pixels[MAX_BYTES];
+static uint8_t s_out[MAX_BYTES];
+static uint8_t s_ref[MAX_BYTES * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE];
+static uint8_t s_spi[MAX_BYTES * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE];
+static led_strip_color_lut_t s_lut;
+static volatile uint8_t s_brightness = 200;
+
+/* Private functions ---------------------------------------------------------*/
+static void fill_pixels(void)
+{
+    uint32_t x = 88172645u;
+    for (size_t i = 0; i < sizeof(s_pixels); i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        s_pixels[i] = (uint8_t)x;
+    }
+}
+
+static void test_neutral_is_identity(void)
+{
+    const led_strip_color_correction_t neutral = {
+        .brightness = 255,
+    };
+    led_strip_color_lut_init(&s_lut, &neutral);
+    fill_pixels();
+    for (uint8_t bpp = 3; bpp <= 4; bpp++) {
+        led_strip_color_lut_apply(s_out, s_pixels, BENCH_LEDS, bpp, &s_lut);
+        TEST_ASSERT_EQUAL_MEMORY(s_pixels, s_out, BENCH_LEDS * bpp);
+    }
+}
+
+static void test_tables_match_formula(void)
+{
+    const led_strip_color_correction_t config = {
+        .gamma = 2.2f,
+        .brightness = 128,
+        .white_balance = { .red = 255, .green = 200, .blue = 180 },
+    };
+    // wire order: green, red, blue, white (never scaled)
+    const double scale[4] = { 200, 255, 180, 255 };
+    led_strip_color_lut_init(&s_lut, &config);
+    for (int c = 0; c < 4; c++) {
+        TEST_ASSERT_EQUAL_UINT8(0, s_lut.table[c][0]);
+        for (int v = 0; v < 256; v++) {
+            double exact = 255.0 * pow(v / 255.0, config.gamma) * scale[c] / 255.0 * config.brightness / 255.0;
+            TEST_ASSERT_TRUE(fabs(s_lut.table[c][v] - exact) <= 0.5 + 1e-3);
+            if (v > 0) {
+                TEST_ASSERT_TRUE(s_lut.table[c][v] >= s_lut.table[c][v - 1]);
+            }
+        }
+    }
+
+    // a brightness change gives the tables a full rebuild would
+    led_strip_color_lut_t rebuilt;
+    led_strip_color_correction_t dimmed = config;
+    dimmed.brightness = 31;
+    led_strip_color_lut_init(&rebuilt, &dimmed);
+    led_strip_color_lut_set_brightness(&s_lut, 31);
+    TEST_ASSERT_EQUAL_MEMORY(rebuilt.table, s_lut.table, sizeof(rebuilt.table));
+}
+
+static void test_spi_encode_lut(void)
+{
+    const led_strip_color_correction_t config = {
+        .gamma = 2.8f,
+        .brightness = 77,
+        .white_balance = { .red = 240, .green = 0, .blue = 190 },
+    };
+    led_strip_color_lut_init(&s_lut, &config);
+    fill_pixels();
+    for (uint8_t bpp = 3; bpp <= 4; bpp++) {
+        led_strip_color_lut_apply(s_out, s_pixels, BENCH_LEDS, bpp, &s_lut);
+        led_strip_spi_encode(&s_table, s_ref, s_out, BENCH_LEDS * bpp);
+        led_strip_spi_encode_lut(&s_table, s_spi, s_pixels, BENCH_LEDS, bpp, &s_lut);
+        TEST_ASSERT_EQUAL_MEMORY(s_ref, s_spi, BENCH_LEDS * bpp * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE);
+    }
+}
+
+/* The paths a refresh takes to get pixel_buf into the buffer that is sent */
+static void encode_rmt_copy(void)
+{
+    memcpy(s_out, s_pixels, BENCH_LEDS * 3);
+}
+
+static void encode_rmt_lut(void)
+{
+    led_strip_color_lut_apply(s_out, s_pixels, BENCH_LEDS, 3, &s_lut);
+}
+
+static void encode_spi(void)
+{
+    led_strip_spi_encode(&s_table, s_spi, s_pixels, BENCH_LEDS * 3);
+}
+
+static void encode_spi_lut(void)
+{
+    led_strip_spi_encode_lut(&s_table, s_spi, s_pixels, BENCH_LEDS, 3, &s_lut);
+}
+
+static void bench_encode(const char *name, void (*encode)(void))
+{
+    encode();       // warm up
+    double start = now_s();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        s_pixels[i % (BENCH_LEDS * 3)] ^= 1;        // keep the compiler from hoisting the work
+        encode();
+    }
+    double elapsed = now_s() - start;
+    printf("BENCH color_lut path=%s leds=%d frames=%d us_per_frame=%.2f\n",
+           name, BENCH_LEDS, BENCH_FRAMES, elapsed * 1e6 / BENCH_FRAMES);
+}
+
+static void bench_color_lut(void)
+{
+    const led_strip_color_correction_t config = {
+        .gamma = 2.2f,
+        .brightness = 200,
+    };
+    led_strip_color_lut_init(&s_lut, &config);
+    fill_pixels();
+    bench_encode("rmt_copy", encode_rmt_copy);
+    bench_encode("rmt_lut", encode_rmt_lut);
+    bench_encode("spi", encode_spi);
+    bench_encode("spi_lut", encode_spi_lut);
+
+    // brightness change: the tables only, against every pixel scaled by the application
+    double start = now_s();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        led_strip_color_lut_set_brightness(&s_lut, s_brightness + (i & 1));
+    }
+    double lut_us = (now_s() - start) * 1e6 / BENCH_FRAMES;
+    start = now_s();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        float k = (s_brightness + (i & 1)) / 255.0f;
+        for (int j = 0; j < BENCH_LEDS * 3; j++) {
+            s_out[j] = (uint8_t)(s_pixels[j] * k);
+        }
+    }
+    double app_us = (now_s() - start) * 1e6 / BENCH_FRAMES;
+    printf("BENCH brightness leds=%d lut_rebuild_us=%.2f app_rescale_us=%.2f\n", BENCH_LEDS, lut_us, app_us);
+    TEST_ASSERT_EQUAL_UINT8(0, s_lut.table[0][0]);
+}
+
+
+void test_color_run(void)
+{
+    RUN_TEST(test_neutral_is_identity);
+    RUN_TEST(test_tables_match_formula);
+    RUN_TEST(test_spi_encode_lut);
+    RUN_TEST(bench_color_lut);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,184 @@
+/*
+ ******************************************************************************
+ * @file           : test_dirty.c
+ * @brief          : Host test and benchmark for the dirty span of a strip
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - led_strip_dirty.h: the span must grow to cover every write, stay empty
+ *   for writes of 0 pixels, and cover the whole strip after _all().
+ * - Re-encoding only the dirty span into the previous SPI frame, as the SPI
+ *   backend does at refresh, must give the same buffer as encoding the whole
+ *   frame, with and without color correction.
+ * - Benchmark: CPU time to encode a 1000-LED GRB frame for SPI when 1, 10,
+ *   100 or all 1000 LEDs changed, whole frame against the dirty span only.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "test_bench.h"
+#include "led_strip_dirty.h"
+#include "led_strip_spi_encode.h"
+#include "led_strip_color.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STRIP_LEDS          BENCH_LEDS
+#define BPP                 3
+#define FRAME_BYTES         (STRIP_LEDS * BPP)
+#define TX_BYTES            (FRAME_BYTES * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE)
+
+/* Private variables ---------------------------------------------------------*/
+/* pattern table of the default timing, 3 SPI bits per LED bit */
+static const led_strip_spi_table_t s_table = { .bytes = LED_STRIP_SPI_BYTES_PER_COLOR_BYTE, .pattern = &led_strip_spi_pattern[0][0] };
+static uint8_t s_pixels[FRAME_BYTES];
+static uint8_t s_tx[TX_BYTES];
+static uint8_t s_ref[TX_BYTES];
+static led_strip_color_lut_t s_lut;
+static led_strip_dirty_t s_dirty;
+static uint32_t s_rand = 2463534242u;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t next_rand(void)
+{
+    s_rand ^= s_rand << 13;
+    s_rand ^= s_rand >> 17;
+    s_rand ^= s_rand << 5;
+    return s_rand;
+}
+
+/* What set_pixels of the SPI backend does: store and mark */
+static void write_pixels(uint32_t start, uint32_t count)
+{
+    for (uint32_t i = start * BPP; i < (start + count) * BPP; i++) {
+        s_pixels[i] = (uint8_t)next_rand();
+    }
+    led_strip_dirty_add(&s_dirty, start, count);
+}
+
+/* What the SPI backend does at refresh: encode the dirty span into the previous frame */
+static void encode_dirty(const led_strip_color_lut_t *lut)
+{
+    if (!led_strip_dirty_empty(&s_dirty)) {
+        uint32_t offset = s_dirty.start * BPP;
+        uint32_t count = s_dirty.end - s_dirty.start;
+        if (lut) {
+            led_strip_spi_encode_lut(&s_table, s_tx + offset * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE, s_pixels + offset, count, BPP, lut);
+        } else {
+            led_strip_spi_encode(&s_table, s_tx + offset * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE, s_pixels + offset, count * BPP);
+        }
+    }
+    led_strip_dirty_reset(&s_dirty);
+}
+
+static void encode_full(uint8_t *dst, const led_strip_color_lut_t *lut)
+{
+    if (lut) {
+        led_strip_spi_encode_lut(&s_table, dst, s_pixels, STRIP_LEDS, BPP, lut);
+    } else {
+        led_strip_spi_encode(&s_table, dst, s_pixels, FRAME_BYTES);
+    }
+}
+
+static void test_span(void)
+{
+    led_strip_dirty_reset(&s_dirty);
+    TEST_ASSERT_TRUE(led_strip_dirty_empty(&s_dirty));
+    led_strip_dirty_add(&s_dirty, 7, 0);
+    TEST_ASSERT_TRUE(led_strip_dirty_empty(&s_dirty));
+    led_strip_dirty_add(&s_dirty, 10, 5);
+    TEST_ASSERT_EQUAL_UINT32(10, s_dirty.start);
+    TEST_ASSERT_EQUAL_UINT32(15, s_dirty.end);
+    led_strip_dirty_add(&s_dirty, 12, 1);
+    TEST_ASSERT_EQUAL_UINT32(10, s_dirty.start);
+    TEST_ASSERT_EQUAL_UINT32(15, s_dirty.end);
+    // far apart: one span over both
+    led_strip_dirty_add(&s_dirty, 100, 2);
+    led_strip_dirty_add(&s_dirty, 3, 1);
+    TEST_ASSERT_EQUAL_UINT32(3, s_dirty.start);
+    TEST_ASSERT_EQUAL_UINT32(102, s_dirty.end);
+    TEST_ASSERT_FALSE(led_strip_dirty_empty(&s_dirty));
+    led_strip_dirty_all(&s_dirty, STRIP_LEDS);
+    TEST_ASSERT_EQUAL_UINT32(0, s_dirty.start);
+    TEST_ASSERT_EQUAL_UINT32(STRIP_LEDS, s_dirty.end);
+    led_strip_dirty_reset(&s_dirty);
+    TEST_ASSERT_TRUE(led_strip_dirty_empty(&s_dirty));
+}
+
+static void check_partial_equals_full(const led_strip_color_lut_t *lut)
+{
+    memset(s_pixels, 0, sizeof(s_pixels));
+    memset(s_tx, 0, sizeof(s_tx));
+    led_strip_dirty_all(&s_dirty, STRIP_LEDS);
+    for (int frame = 0; frame < 200; frame++) {
+        // 0 to 3 writes of 1 to 16 pixels per frame, the first frame sends everything
+        int writes = next_rand() % 4;
+        for (int w = 0; w < writes; w++) {
+            uint32_t count = 1 + next_rand() % 16;
+            uint32_t start = next_rand() % (STRIP_LEDS - count + 1);
+            write_pixels(start, count);
+        }
+        encode_dirty(lut);
+        encode_full(s_ref, lut);
+        TEST_ASSERT_EQUAL_MEMORY(s_ref, s_tx, sizeof(s_tx));
+    }
+}
+
+static void test_partial_equals_full(void)
+{
+    check_partial_equals_full(NULL);
+}
+
+static void test_partial_equals_full_lut(void)
+{
+    const led_strip_color_correction_t config = {
+        .gamma = 2.2f,
+        .brightness = 128,
+        .white_balance = { .red = 255, .green = 200, .blue = 180 },
+    };
+    led_strip_color_lut_init(&s_lut, &config);
+    check_partial_equals_full(&s_lut);
+}
+
+static void bench_dirty(void)
+{
+    static const uint32_t changed[] = { 1, 10, 100, STRIP_LEDS };
+    for (size_t k = 0; k < sizeof(changed) / sizeof(changed[0]); k++) {
+        uint32_t n = changed[k];
+        encode_full(s_tx, NULL);     // warm up
+        double start = now_s();
+        for (int i = 0; i < BENCH_FRAMES; i++) {
+            write_pixels((i * 97) % (STRIP_LEDS - n + 1), n);
+            encode_full(s_tx, NULL);
+        }
+        double full_us = (now_s() - start) * 1e6 / BENCH_FRAMES;
+        led_strip_dirty_reset(&s_dirty);
+        start = now_s();
+        for (int i = 0; i < BENCH_FRAMES; i++) {
+            write_pixels((i * 97) % (STRIP_LEDS - n + 1), n);
+            encode_dirty(NULL);
+        }
+        double partial_us = (now_s() - start) * 1e6 / BENCH_FRAMES;
+        printf("BENCH dirty leds=%d changed=%u frames=%d full_us=%.2f partial_us=%.2f\n",
+               STRIP_LEDS, (unsigned)n, BENCH_FRAMES, full_us, partial_us);
+        encode_full(s_ref, NULL);
+        TEST_ASSERT_EQUAL_MEMORY(s_ref, s_tx, sizeof(s_tx));
+    }
+}
+
+
+void test_dirty_run(void)
+{
+    RUN_TEST(test_span);
+    RUN_TEST(test_partial_equals_full);
+    RUN_TEST(test_partial_equals_full_lut);
+    RUN_TEST(bench_dirty);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,197 @@
+/*
+ ******************************************************************************
+ * @file           : test_dither.c
+ * @brief          : Host test and benchmark for temporal dithering
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - led_strip_dither.c: over 256 frames the average output of every channel
+ *   must equal its 16-bit level (x / 257 in 8 bits), every frame must send
+ *   the floor or the ceiling of that level, and 8-bit levels must go out
+ *   unchanged in every frame (no flicker where there is nothing to dither).
+ * - With color correction the average must follow gamma, white balance and
+ *   brightness computed in double, also between the 256 table points.
+ * - 8-bit and 16-bit setters must map the caller's format to wire order.
+ * - Benchmark: cost of emitting one dithered 1000-LED GRB frame, without
+ *   and with color correction.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "test_bench.h"
+#include "led_strip_dither.h"
+
+/* Private define ------------------------------------------------------------*/
+#define AVG_FRAMES          256
+#define MAX_CHANNELS        4096
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t s_pixels[MAX_CHANNELS];
+static uint8_t s_out[MAX_CHANNELS];
+static uint32_t s_sum[MAX_CHANNELS];
+static led_strip_color_lut_t s_lut;
+
+/* Private functions ---------------------------------------------------------*/
+/* Runs AVG_FRAMES frames, summing the output per channel and checking that every one is the floor or the ceiling of its target */
+static void run_frames(led_strip_dither_t *dither, const led_strip_color_lut_t *lut, const double *target)
+{
+    uint32_t channels = dither->strip_len * dither->bytes_per_pixel;
+    memset(s_sum, 0, sizeof(s_sum));
+    for (int f = 0; f < AVG_FRAMES; f++) {
+        led_strip_dither_frame(dither, lut, s_out);
+        for (uint32_t i = 0; i < channels; i++) {
+            TEST_ASSERT_TRUE(s_out[i] >= floor(target[i] - 1e-3) && s_out[i] <= ceil(target[i] + 1e-3));
+            s_sum[i] += s_out[i];
+        }
+    }
+}
+
+static void test_average_equals_level(void)
+{
+    // all 65536 levels, MAX_CHANNELS at a time
+    static double target[MAX_CHANNELS];
+    memset(s_pixels, 0, sizeof(s_pixels));
+    led_strip_dither_t *dither = led_strip_dither_new(MAX_CHANNELS / 4, 4, s_pixels);
+    TEST_ASSERT_NOT_NULL(dither);
+    for (uint32_t base = 0; base < 65536; base += MAX_CHANNELS) {
+        for (uint32_t i = 0; i < MAX_CHANNELS; i++) {
+            dither->level[i] = base + i;
+            target[i] = (base + i) / 257.0;
+        }
+        run_frames(dither, NULL, target);
+        for (uint32_t i = 0; i < MAX_CHANNELS; i++) {
+            TEST_ASSERT_TRUE(fabs(s_sum[i] / (double)AVG_FRAMES - target[i]) <= 1.0 / 256 + 1e-9);
+        }
+    }
+    free(dither);
+}
+
+static void test_8bit_levels_are_steady(void)
+{
+    for (int i = 0; i < 256 * 3; i++) {
+        s_pixels[i] = (uint8_t)i;
+    }
+    led_strip_dither_t *dither = led_strip_dither_new(256, 3, s_pixels);
+    TEST_ASSERT_NOT_NULL(dither);
+    for (int f = 0; f < 16; f++) {
+        led_strip_dither_frame(dither, NULL, s_out);
+        TEST_ASSERT_EQUAL_MEMORY(s_pixels, s_out, 256 * 3);
+    }
+    uint8_t back[256 * 3];
+    led_strip_dither_to_pixels(dither, back);
+    TEST_ASSERT_EQUAL_MEMORY(s_pixels, back, sizeof(back));
+    free(dither);
+}
+
+static void test_average_with_correction(void)
+{
+    const led_strip_color_correction_t config = {
+        .gamma = 2.2f,
+        .brightness = 40,
+        .white_balance = { .red = 255, .green = 200, .blue = 180 },
+    };
+    const double scale[3] = { 200, 255, 180 };
+    static double target[1024 * 3];
+    led_strip_color_lut_init(&s_lut, &config);
+    memset(s_pixels, 0, sizeof(s_pixels));
+    led_strip_dither_t *dither = led_strip_dither_new(1024, 3, s_pixels);
+    TEST_ASSERT_NOT_NULL(dither);
+    // table points and the levels between them
+    for (uint32_t i = 0; i < 1024 * 3; i++) {
+        uint32_t level = (i / 3) * 64 + (i % 3) * 21;
+        dither->level[i] = level;
+        double curve = s_lut.curve[level / 257];
+        if (level % 257) {
+            curve += (s_lut.curve[level / 257 + 1] - curve) * (level % 257) / 257.0;
+        }
+        target[i] = curve / 65535.0 * scale[i % 3] / 255.0 * config.brightness;
+    }
+    run_frames(dither, &s_lut, target);
+    for (uint32_t i = 0; i < 1024 * 3; i++) {
+        // the interpolation and the 0.16 gain are rounded down, on top of the 1/256 of the dithering
+        TEST_ASSERT_TRUE(fabs(s_sum[i] / (double)AVG_FRAMES - target[i]) <= 2.0 / 256 + 1e-9);
+    }
+
+    // the first frame starts from half way, i.e. it is the level rounded: the 8-bit table at the table points
+    for (uint32_t i = 0; i < 256 * 3; i++) {
+        dither->level[i] = (i / 3) * 257;
+        dither->residual[i] = 128;
+    }
+    led_strip_dither_frame(dither, &s_lut, s_out);
+    for (uint32_t i = 0; i < 256 * 3; i++) {
+        TEST_ASSERT_INT_WITHIN(1, s_lut.table[i % 3][i / 3], s_out[i]);
+    }
+    free(dither);
+}
+
+static void test_set_pixels_formats(void)
+{
+    memset(s_pixels, 0, sizeof(s_pixels));
+    led_strip_dither_t *dither = led_strip_dither_new(4, 4, s_pixels);
+    TEST_ASSERT_NOT_NULL(dither);
+    const uint16_t rgbw[2 * 4] = { 0x1111, 0x2222, 0x3333, 0x4444, 0xAAAA, 0xBBBB, 0xCCCC, 0xDDDD };
+    led_strip_dither_set_pixels_16(dither, 1, 2, rgbw, LED_BUFFER_FORMAT_RGBW);
+    const uint16_t expect16[4 * 4] = {
+        0, 0, 0, 0,
+        0x2222, 0x1111, 0x3333, 0x4444,
+        0xBBBB, 0xAAAA, 0xCCCC, 0xDDDD,
+        0, 0, 0, 0,
+    };
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expect16, dither->level, 4 * 4);
+
+    // 8-bit RGB on a GRBW strip: widened, white off
+    const uint8_t rgb[3] = { 0x10, 0x20, 0x30 };
+    led_strip_dither_set_pixels(dither, 3, 1, rgb, LED_BUFFER_FORMAT_RGB);
+    const uint16_t expect8[4] = { 0x2020, 0x1010, 0x3030, 0 };
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expect8, &dither->level[3 * 4], 4);
+    free(dither);
+}
+
+static void bench_dither(void)
+{
+    const led_strip_color_correction_t config = {
+        .gamma = 2.2f,
+        .brightness = 200,
+    };
+    led_strip_color_lut_init(&s_lut, &config);
+    memset(s_pixels, 0, sizeof(s_pixels));
+    led_strip_dither_t *dither = led_strip_dither_new(BENCH_LEDS, 3, s_pixels);
+    TEST_ASSERT_NOT_NULL(dither);
+    for (uint32_t i = 0; i < BENCH_LEDS * 3; i++) {
+        dither->level[i] = (uint16_t)(i * 2654435761u >> 16);
+    }
+    const led_strip_color_lut_t *luts[2] = { NULL, &s_lut };
+    const char *names[2] = { "plain", "lut" };
+    for (int k = 0; k < 2; k++) {
+        led_strip_dither_frame(dither, luts[k], s_out);     // warm up
+        double start = now_s();
+        for (int i = 0; i < BENCH_FRAMES; i++) {
+            led_strip_dither_frame(dither, luts[k], s_out);
+        }
+        double elapsed = now_s() - start;
+        printf("BENCH dither path=%s leds=%d frames=%d us_per_frame=%.2f bytes_per_led=%u\n",
+               names[k], BENCH_LEDS, BENCH_FRAMES, elapsed * 1e6 / BENCH_FRAMES,
+               (unsigned)(3 * (sizeof(uint16_t) + 1)));
+    }
+    free(dither);
+}
+
+
+void test_dither_run(void)
+{
+    RUN_TEST(test_average_equals_level);
+    RUN_TEST(test_8bit_levels_are_steady);
+    RUN_TEST(test_average_with_correction);
+    RUN_TEST(test_set_pixels_formats);
+    RUN_TEST(bench_dither);
+}
+
+/* ***** END OF FILE ******************************************************** */
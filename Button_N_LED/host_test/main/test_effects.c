@@ -0,0 +1,289 @@
+/*
+ ******************************************************************************
+ * @file           : test_effects.c
+ * @brief          : Host test and benchmark for the effect layers
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - led_strip_scene.c: layers must blend bottom first (alpha, add, max), a
+ *   still gradient must run from its first to its last color, chase heads
+ *   must be where speed * time puts them, and a twinkle layer must light up
+ *   `rate` pixels per second.
+ * - Fixed timestep: stepping several times and rendering once must give the
+ *   frame of rendering at every step, and a scene that doesn't move must
+ *   not render again until a layer changes.
+ * - Benchmark: frames per second of each effect on a 1000-LED frame in
+ *   memory (step + render, no strip), and of a show of four layers.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "test_bench.h"
+#include "led_strip_scene.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STRIP_LEDS          100
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t s_frame[BENCH_LEDS * 3];
+static uint8_t s_other[BENCH_LEDS * 3];
+
+static const led_color_rgb_t s_red = { .red = 200 };
+static const led_color_rgb_t s_blue = { .blue = 100 };
+
+/* Private functions ---------------------------------------------------------*/
+static void assert_grb(const uint8_t *px, uint8_t red, uint8_t green, uint8_t blue)
+{
+    TEST_ASSERT_EQUAL_UINT8(green, px[0]);
+    TEST_ASSERT_EQUAL_UINT8(red, px[1]);
+    TEST_ASSERT_EQUAL_UINT8(blue, px[2]);
+}
+
+static void test_blend(void)
+{
+    led_strip_scene_t *scene = led_strip_scene_new(STRIP_LEDS, 100, 3, 0);
+    TEST_ASSERT_NOT_NULL(scene);
+    led_effect_layer_config_t base = { .effect = LED_EFFECT_FILL, .fill.color = s_red };
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &base));
+    // pixels 10 - 19 half blue over the red, 20 - 29 blue added, 30 - 39 the maximum
+    led_effect_layer_config_t alpha = {
+        .effect = LED_EFFECT_FILL, .blend = LED_EFFECT_BLEND_ALPHA, .opacity = 128, .start = 10, .count = 10, .fill.color = s_blue,
+    };
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 1, &alpha));
+    TEST_ASSERT_TRUE(led_strip_scene_render(scene, s_frame));
+    assert_grb(&s_frame[9 * 3], 200, 0, 0);
+    assert_grb(&s_frame[10 * 3], 100, 0, 50);
+    assert_grb(&s_frame[20 * 3], 200, 0, 0);
+
+    led_effect_layer_config_t add = { .effect = LED_EFFECT_FILL, .blend = LED_EFFECT_BLEND_ADD, .start = 20, .count = 10,
+                                      .fill.color = { .red = 100, .blue = 100 } };
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 1, &add));
+    led_effect_layer_config_t max = { .effect = LED_EFFECT_FILL, .blend = LED_EFFECT_BLEND_MAX, .start = 30, .count = 10,
+                                      .fill.color = { .red = 100, .green = 50 } };
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 2, &max));
+    TEST_ASSERT_TRUE(led_strip_scene_render(scene, s_frame));
+    assert_grb(&s_frame[10 * 3], 200, 0, 0);
+    assert_grb(&s_frame[20 * 3], 255, 0, 100);
+    assert_grb(&s_frame[30 * 3], 200, 50, 0);
+    assert_grb(&s_frame[40 * 3], 200, 0, 0);
+
+    // removed: back to the red fill
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 1, NULL));
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 2, NULL));
+    TEST_ASSERT_TRUE(led_strip_scene_render(scene, s_frame));
+    for (int i = 0; i < STRIP_LEDS; i++) {
+        assert_grb(&s_frame[i * 3], 200, 0, 0);
+    }
+    free(scene);
+}
+
+static void test_invalid_layers(void)
+{
+    led_strip_scene_t *scene = led_strip_scene_new(STRIP_LEDS, 100, 2, 0);
+    TEST_ASSERT_NOT_NULL(scene);
+    led_effect_layer_config_t layer = { .effect = LED_EFFECT_FILL, .start = 90, .count = 11 };
+    TEST_ASSERT_FALSE(led_strip_scene_set_layer(scene, 0, &layer));
+    layer.count = 10;
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &layer));
+    // 0: up to the end of the strip
+    layer.count = 0;
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &layer));
+    TEST_ASSERT_EQUAL_UINT32(10, scene->layers[0].config.count);
+    TEST_ASSERT_FALSE(led_strip_scene_set_layer(scene, 2, &layer));
+    layer.start = STRIP_LEDS;
+    TEST_ASSERT_FALSE(led_strip_scene_set_layer(scene, 0, &layer));
+    layer.start = 0;
+    layer.effect = LED_EFFECT_INVALID;
+    TEST_ASSERT_FALSE(led_strip_scene_set_layer(scene, 0, &layer));
+    layer.effect = LED_EFFECT_FILL;
+    layer.blend = LED_EFFECT_BLEND_INVALID;
+    TEST_ASSERT_FALSE(led_strip_scene_set_layer(scene, 0, &layer));
+    free(scene);
+}
+
+static void test_gradient(void)
+{
+    led_strip_scene_t *scene = led_strip_scene_new(STRIP_LEDS, 100, 1, 0);
+    TEST_ASSERT_NOT_NULL(scene);
+    led_effect_layer_config_t layer = {
+        .effect = LED_EFFECT_GRADIENT,
+        .gradient = { .from = { .red = 255, .green = 10 }, .to = { .blue = 255, .green = 110 } },
+    };
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &layer));
+    TEST_ASSERT_TRUE(led_strip_scene_render(scene, s_frame));
+    assert_grb(&s_frame[0], 255, 10, 0);
+    assert_grb(&s_frame[(STRIP_LEDS - 1) * 3], 0, 110, 255);
+    for (int i = 1; i < STRIP_LEDS; i++) {
+        TEST_ASSERT_TRUE(s_frame[i * 3 + 1] <= s_frame[(i - 1) * 3 + 1]);
+        TEST_ASSERT_TRUE(s_frame[i * 3 + 2] >= s_frame[(i - 1) * 3 + 2]);
+    }
+    // scrolling at 50 px/s: after 1 s the pattern has moved by 50 pixels, `from` is at pixel 50
+    layer.gradient.speed = 50;
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &layer));
+    for (int i = 0; i < 100; i++) {
+        led_strip_scene_step(scene);
+    }
+    TEST_ASSERT_TRUE(led_strip_scene_render(scene, s_frame));
+    assert_grb(&s_frame[50 * 3], 255, 10, 0);
+    assert_grb(&s_frame[0], 0, 110, 255);
+    free(scene);
+}
+
+static void test_chase_position(void)
+{
+    led_strip_scene_t *scene = led_strip_scene_new(STRIP_LEDS, 100, 1, 0);
+    TEST_ASSERT_NOT_NULL(scene);
+    // 50 px/s, a head every 10 pixels: after 0.1 s the heads are at 5, 15, 25...
+    led_effect_layer_config_t layer = { .effect = LED_EFFECT_CHASE, .chase = { .color = s_red, .speed = 50, .spacing = 10 } };
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &layer));
+    for (int i = 0; i < 10; i++) {
+        led_strip_scene_step(scene);
+    }
+    TEST_ASSERT_TRUE(led_strip_scene_render(scene, s_frame));
+    for (int i = 0; i < STRIP_LEDS; i++) {
+        assert_grb(&s_frame[i * 3], i % 10 == 5 ? 200 : 0, 0, 0);
+    }
+    // a tail of 3 pixels fades out behind the head; going backwards, the tail is on the other side
+    layer.chase.tail = 3;
+    layer.chase.speed = -50;
+    layer.chase.spacing = 0;
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &layer));
+    TEST_ASSERT_TRUE(led_strip_scene_render(scene, s_frame));
+    TEST_ASSERT_EQUAL_UINT8(200, s_frame[(STRIP_LEDS - 5) * 3 + 1]);
+    TEST_ASSERT_EQUAL_UINT8(150, s_frame[(STRIP_LEDS - 4) * 3 + 1]);
+    TEST_ASSERT_EQUAL_UINT8(100, s_frame[(STRIP_LEDS - 3) * 3 + 1]);
+    TEST_ASSERT_EQUAL_UINT8(50, s_frame[(STRIP_LEDS - 2) * 3 + 1]);
+    TEST_ASSERT_EQUAL_UINT8(0, s_frame[(STRIP_LEDS - 1) * 3 + 1]);
+    TEST_ASSERT_EQUAL_UINT8(0, s_frame[(STRIP_LEDS - 6) * 3 + 1]);
+    free(scene);
+}
+
+static void test_twinkle_rate(void)
+{
+    led_strip_scene_t *scene = led_strip_scene_new(STRIP_LEDS, 50, 1, 0);
+    TEST_ASSERT_NOT_NULL(scene);
+    // one pixel per step, gone by the next one
+    led_effect_layer_config_t layer = { .effect = LED_EFFECT_TWINKLE, .twinkle = { .color = s_blue, .rate = 50 } };
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &layer));
+    for (int s = 0; s < 100; s++) {
+        led_strip_scene_step(scene);
+        TEST_ASSERT_TRUE(led_strip_scene_render(scene, s_frame));
+        int lit = 0;
+        for (int i = 0; i < STRIP_LEDS; i++) {
+            lit += s_frame[i * 3 + 2] == 100;
+        }
+        TEST_ASSERT_EQUAL_INT(1, lit);
+    }
+    free(scene);
+}
+
+/* Four layers over the whole strip, on a scene of 4 slots */
+static void set_show(led_strip_scene_t *scene, uint32_t leds)
+{
+    const led_effect_layer_config_t layers[4] = {
+        { .effect = LED_EFFECT_GRADIENT, .gradient = { .from = { .blue = 40 }, .to = { .green = 40 }, .speed = 7 } },
+        { .effect = LED_EFFECT_FIRE, .blend = LED_EFFECT_BLEND_MAX, .count = leds / 4 },
+        { .effect = LED_EFFECT_TWINKLE, .blend = LED_EFFECT_BLEND_ADD, .twinkle = { .color = { 255, 255, 255 }, .rate = 200, .fade_ms = 300 } },
+        { .effect = LED_EFFECT_CHASE, .blend = LED_EFFECT_BLEND_ALPHA, .opacity = 160, .start = leds / 2, .chase = { .color = s_red, .speed = 30, .tail = 8, .spacing = 25 } },
+    };
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, i, &layers[i]));
+    }
+}
+
+static void test_fixed_timestep(void)
+{
+    // rendering at every step, or only every 7th, must give the same frames at the same steps
+    led_strip_scene_t *every = led_strip_scene_new(STRIP_LEDS, 60, 4, 1234);
+    led_strip_scene_t *late = led_strip_scene_new(STRIP_LEDS, 60, 4, 1234);
+    TEST_ASSERT_TRUE(every && late);
+    set_show(every, STRIP_LEDS);
+    set_show(late, STRIP_LEDS);
+    for (int s = 1; s <= 70; s++) {
+        led_strip_scene_step(every);
+        led_strip_scene_render(every, s_frame);
+        led_strip_scene_step(late);
+        if (s % 7 == 0) {
+            TEST_ASSERT_TRUE(led_strip_scene_render(late, s_other));
+            TEST_ASSERT_EQUAL_MEMORY(s_frame, s_other, STRIP_LEDS * 3);
+        }
+    }
+    free(every);
+    free(late);
+
+    // nothing moves: rendered once, until a layer changes
+    led_strip_scene_t *still = led_strip_scene_new(STRIP_LEDS, 60, 2, 0);
+    TEST_ASSERT_NOT_NULL(still);
+    led_effect_layer_config_t fill = { .effect = LED_EFFECT_FILL, .fill.color = s_red };
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(still, 0, &fill));
+    TEST_ASSERT_TRUE(led_strip_scene_render(still, s_frame));
+    led_strip_scene_step(still);
+    TEST_ASSERT_FALSE(led_strip_scene_render(still, s_frame));
+    fill.fill.color = s_blue;
+    TEST_ASSERT_TRUE(led_strip_scene_set_layer(still, 0, &fill));
+    led_strip_scene_step(still);
+    TEST_ASSERT_TRUE(led_strip_scene_render(still, s_frame));
+    assert_grb(&s_frame[0], 0, 0, 100);
+    free(still);
+}
+
+static void bench_one(const char *name, led_strip_scene_t *scene)
+{
+    led_strip_scene_step(scene);     // warm up
+    scene->changed = true;
+    led_strip_scene_render(scene, s_frame);
+    double start = now_s();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        led_strip_scene_step(scene);
+        // still layers are rendered once by the engine, measure them as if they moved
+        scene->changed = true;
+        led_strip_scene_render(scene, s_frame);
+    }
+    double us = (now_s() - start) * 1e6 / BENCH_FRAMES;
+    printf("BENCH effects effect=%s leds=%d frames=%d us_per_frame=%.2f fps=%.0f\n",
+           name, BENCH_LEDS, BENCH_FRAMES, us, 1e6 / us);
+    free(scene);
+}
+
+static void bench_effects(void)
+{
+    const led_effect_layer_config_t layers[] = {
+        { .effect = LED_EFFECT_FILL, .fill.color = s_red },
+        { .effect = LED_EFFECT_GRADIENT, .gradient = { .from = s_red, .to = s_blue, .speed = 20 } },
+        { .effect = LED_EFFECT_CHASE, .chase = { .color = s_red, .speed = 40, .tail = 10, .spacing = 50 } },
+        { .effect = LED_EFFECT_TWINKLE, .twinkle = { .color = s_blue, .rate = 500, .fade_ms = 500 } },
+        { .effect = LED_EFFECT_FIRE },
+    };
+    const char *names[] = { "fill", "gradient", "chase", "twinkle", "fire" };
+    for (size_t k = 0; k < sizeof(layers) / sizeof(layers[0]); k++) {
+        led_strip_scene_t *scene = led_strip_scene_new(BENCH_LEDS, 60, 1, 0);
+        TEST_ASSERT_NOT_NULL(scene);
+        TEST_ASSERT_TRUE(led_strip_scene_set_layer(scene, 0, &layers[k]));
+        bench_one(names[k], scene);
+    }
+    led_strip_scene_t *show = led_strip_scene_new(BENCH_LEDS, 60, 4, 1234);
+    TEST_ASSERT_NOT_NULL(show);
+    set_show(show, BENCH_LEDS);
+    bench_one("show4", show);
+}
+
+
+void test_effects_run(void)
+{
+    RUN_TEST(test_blend);
+    RUN_TEST(test_invalid_layers);
+    RUN_TEST(test_gradient);
+    RUN_TEST(test_chase_position);
+    RUN_TEST(test_twinkle_rate);
+    RUN_TEST(test_fixed_timestep);
+    RUN_TEST(bench_effects);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,219 @@
+/*
+ ******************************************************************************
+ * @file           : test_hsv.c
+ * @brief          : Host test and benchmark for led_strip_hsv.c
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - The integer conversion behind led_strip_set_pixel_hsv() is checked against
+ *   the former float implementation for every hue, saturation and value.
+ * - The fixed point conversion (hue 0..1535) must match it on the 15 degree
+ *   grid, stay within 1 of the exact HSV color everywhere, and the hue ramp
+ *   table must give the same colors as the fixed point conversion.
+ * - Benchmark: pixels/s for converting a 1000-LED rainbow with
+ *     float  : the former led_strip_set_pixel_hsv() math
+ *     int    : led_strip_hsv_to_rgb(), hue in degrees
+ *     fixed  : led_strip_hsv_fixed_to_rgb_n(), hue 0..1535
+ *     ramp   : led_strip_hue_ramp_to_rgb_n() with a precomputed ramp
+ *   One "BENCH" line is printed per path.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "test_bench.h"
+#include "led_strip_hsv.h"
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t s_rgb[BENCH_LEDS * 3];
+static uint16_t s_hue_deg[BENCH_LEDS];
+static uint16_t s_hue_fixed[BENCH_LEDS];
+static led_color_hsv_t s_hsv[BENCH_LEDS];
+static volatile uint8_t s_saturation = 255, s_value = 128;   /* not constants the compiler could fold */
+
+/* Private functions ---------------------------------------------------------*/
+/* The conversion led_strip_set_pixel_hsv() used before, kept as the reference.
+   Not inlined, like the library functions it is compared with. */
+static void __attribute__((noinline)) ref_hsv_float(uint32_t hue, uint32_t saturation, uint32_t value, uint8_t *rgb)
+{
+    uint32_t red, green, blue;
+    uint32_t rgb_max = value;
+    uint32_t rgb_min = rgb_max * (255 - saturation) / 255.0f;
+    uint32_t i = hue / 60;
+    uint32_t diff = hue % 60;
+    uint32_t rgb_adj = (rgb_max - rgb_min) * diff / 60;
+
+    switch (i) {
+    case 0:
+        red = rgb_max;
+        green = rgb_min + rgb_adj;
+        blue = rgb_min;
+        break;
+    case 1:
+        red = rgb_max - rgb_adj;
+        green = rgb_max;
+        blue = rgb_min;
+        break;
+    case 2:
+        red = rgb_min;
+        green = rgb_max;
+        blue = rgb_min + rgb_adj;
+        break;
+    case 3:
+        red = rgb_min;
+        green = rgb_max - rgb_adj;
+        blue = rgb_max;
+        break;
+    case 4:
+        red = rgb_min + rgb_adj;
+        green = rgb_min;
+        blue = rgb_max;
+        break;
+    default:
+        red = rgb_max;
+        green = rgb_min;
+        blue = rgb_max - rgb_adj;
+        break;
+    }
+    rgb[0] = red;
+    rgb[1] = green;
+    rgb[2] = blue;
+}
+
+/* Exact HSV, hue in sixths of the circle */
+static void exact_hsv(double sector_pos, double saturation, double value, double *rgb)
+{
+    double max = value, min = value * (255 - saturation) / 255;
+    int sector = (int)sector_pos;
+    double f = sector_pos - sector;
+    double rise = min + (max - min) * f, fall = max - (max - min) * f;
+    const double table[6][3] = {
+        { max, rise, min }, { fall, max, min }, { min, max, rise },
+        { min, fall, max }, { rise, min, max }, { max, min, fall },
+    };
+    memcpy(rgb, table[sector], sizeof(table[0]));
+}
+
+static void test_degrees_match_float(void)
+{
+    // up to 370: the former switch also gave defined colors for 360 and above
+    for (uint32_t hue = 0; hue <= 370; hue++) {
+        for (uint32_t s = 0; s < 256; s++) {
+            for (uint32_t v = 0; v < 256; v++) {
+                uint8_t ref[3], out[3];
+                ref_hsv_float(hue, s, v, ref);
+                led_strip_hsv_to_rgb(hue, s, v, out);
+                if (memcmp(ref, out, 3) != 0) {
+                    printf("hue=%lu s=%lu v=%lu\n", (unsigned long)hue, (unsigned long)s, (unsigned long)v);
+                    TEST_ASSERT_EQUAL_UINT8_ARRAY(ref, out, 3);
+                }
+            }
+        }
+    }
+}
+
+static void test_fixed_point(void)
+{
+    double max_err = 0;
+    led_strip_hue_ramp_t ramp;
+    for (uint32_t s = 0; s < 256; s++) {
+        for (uint32_t v = 0; v < 256; v++) {
+            // on the 15 degree grid the fixed point hue is exact and the colors are the same
+            for (uint32_t deg = 0; deg < 360; deg += 15) {
+                led_color_hsv_t hsv = { .hue = deg * LED_STRIP_HUE_RANGE / 360, .saturation = s, .value = v };
+                uint8_t ref[3], out[3];
+                led_strip_hsv_to_rgb(deg, s, v, ref);
+                led_strip_hsv_fixed_to_rgb(&hsv, out);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(ref, out, 3);
+            }
+            // everywhere else within 1 of the exact color, and the ramp table agrees
+            led_strip_hue_ramp_fill(&ramp, s, v);
+            for (uint32_t hue = 0; hue < 2048; hue++) {
+                led_color_hsv_t hsv = { .hue = hue, .saturation = s, .value = v };
+                uint16_t h16 = hue;
+                uint8_t out[3], via_ramp[3];
+                double exact[3];
+                led_strip_hsv_fixed_to_rgb(&hsv, out);
+                led_strip_hue_ramp_to_rgb_n(&ramp, &h16, 1, via_ramp);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(out, via_ramp, 3);
+                exact_hsv((hue % LED_STRIP_HUE_RANGE) / 256.0, s, v, exact);
+                for (int c = 0; c < 3; c++) {
+                    max_err = fmax(max_err, fabs(out[c] - exact[c]));
+                }
+            }
+        }
+    }
+    printf("max error against exact HSV: %.3f\n", max_err);
+    TEST_ASSERT_LESS_THAN(2.0, max_err);
+}
+
+static void bench_path(const char *name, void (*convert)(void))
+{
+    convert();          // warm up
+    double start = now_s();
+    for (int f = 0; f < BENCH_FRAMES; f++) {
+        s_hue_deg[f % BENCH_LEDS] ^= 1;      // keep the compiler from hoisting the work
+        s_hue_fixed[f % BENCH_LEDS] ^= 1;
+        s_hsv[f % BENCH_LEDS].hue ^= 1;
+        convert();
+    }
+    double elapsed = now_s() - start;
+    printf("BENCH hsv path=%s leds=%d frames=%d pixels_per_s=%.0f us_per_frame=%.1f\n",
+           name, BENCH_LEDS, BENCH_FRAMES, BENCH_LEDS * BENCH_FRAMES / elapsed, elapsed * 1e6 / BENCH_FRAMES);
+}
+
+static void convert_float(void)
+{
+    for (int i = 0; i < BENCH_LEDS; i++) {
+        ref_hsv_float(s_hue_deg[i], s_saturation, s_value, &s_rgb[i * 3]);
+    }
+}
+
+static void convert_int(void)
+{
+    for (int i = 0; i < BENCH_LEDS; i++) {
+        led_strip_hsv_to_rgb(s_hue_deg[i], s_saturation, s_value, &s_rgb[i * 3]);
+    }
+}
+
+static void convert_fixed(void)
+{
+    led_strip_hsv_fixed_to_rgb_n(s_hsv, BENCH_LEDS, s_rgb);
+}
+
+static led_strip_hue_ramp_t s_ramp;
+
+static void convert_ramp(void)
+{
+    led_strip_hue_ramp_to_rgb_n(&s_ramp, s_hue_fixed, BENCH_LEDS, s_rgb);
+}
+
+static void bench_rainbow(void)
+{
+    for (int i = 0; i < BENCH_LEDS; i++) {
+        s_hue_deg[i] = i * 360 / BENCH_LEDS;
+        s_hue_fixed[i] = i * LED_STRIP_HUE_RANGE / BENCH_LEDS;
+        s_hsv[i] = (led_color_hsv_t) { .hue = s_hue_fixed[i], .saturation = s_saturation, .value = s_value };
+    }
+    led_strip_hue_ramp_fill(&s_ramp, s_saturation, s_value);
+    bench_path("float", convert_float);
+    bench_path("int", convert_int);
+    bench_path("fixed", convert_fixed);
+    bench_path("ramp", convert_ramp);
+}
+
+
+void test_hsv_run(void)
+{
+    RUN_TEST(test_degrees_match_float);
+    RUN_TEST(test_fixed_point);
+    RUN_TEST(bench_rainbow);
+}
+
+/* ***** END OF FILE ******************************************************** */
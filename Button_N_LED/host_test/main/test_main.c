@@ -0,0 +1,43 @@
+/*
+ ******************************************************************************
+ * @file           : test_main.c
+ * @brief          : Host test entry point, runs all test groups
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include "unity.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+void test_spi_encode_run(void);
+void test_set_pixels_run(void);
+void test_hsv_run(void);
+void test_color_run(void);
+void test_dither_run(void);
+void test_rmt_symbols_run(void);
+void test_dirty_run(void);
+void test_effects_run(void);
+void test_button_run(void);
+
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    test_spi_encode_run();
+    test_set_pixels_run();
+    test_hsv_run();
+    test_color_run();
+    test_dither_run();
+    test_rmt_symbols_run();
+    test_dirty_run();
+    test_effects_run();
+    test_button_run();
+    UNITY_END();
+    exit(0);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,173 @@
+/*
+ ******************************************************************************
+ * @file           : test_rmt_symbols.c
+ * @brief          : Host test and benchmark for the RMT symbol table
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - led_strip_rmt_symbols.c: the symbol stream of a frame must be 8 symbols
+ *   per color byte, MSB first, with the WS2812 timings at 10 MHz
+ *   (T0H 0.3 us, T0L 0.9 us, T1H 0.9 us, T1L 0.3 us), followed by one
+ *   280 us reset symbol.
+ * - led_strip_rmt_symbols_fill() must give the same stream whatever the
+ *   sizes of the chunks of free RMT memory it is called with, and ask for
+ *   more room (return 0) instead of splitting a byte.
+ * - Benchmark: symbols of a 1000-LED GRB frame, bit by bit (what the generic
+ *   bytes encoder does) against the nibble table.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "test_bench.h"
+#include "led_strip_rmt_symbols.h"
+
+/* Private define ------------------------------------------------------------*/
+#define FRAME_BYTES         (BENCH_LEDS * 3)
+#define FRAME_SYMBOLS       (FRAME_BYTES * 8 + 1)
+/* WS2812 at 10 MHz, 0.1 us per tick */
+#define T0H                 3
+#define T0L                 9
+#define T1H                 9
+#define T1L                 3
+#define RESET_TICKS         1400
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t s_frame[FRAME_BYTES];
+static uint32_t s_ref[FRAME_SYMBOLS];
+static uint32_t s_out[FRAME_SYMBOLS];
+static led_strip_rmt_symbols_t s_table;
+
+/* Private functions ---------------------------------------------------------*/
+static void fill_frame(void)
+{
+    uint32_t x = 2463534242u;
+    for (size_t i = 0; i < sizeof(s_frame); i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        s_frame[i] = (uint8_t)x;
+    }
+}
+
+static void init_table(void)
+{
+    led_strip_rmt_symbols_init(&s_table, LED_STRIP_RMT_SYMBOL(1, T0H, 0, T0L), LED_STRIP_RMT_SYMBOL(1, T1H, 0, T1L),
+                               LED_STRIP_RMT_SYMBOL(0, RESET_TICKS, 0, RESET_TICKS));
+}
+
+/* Bit by bit, from the timings, as the generic bytes encoder produces it */
+static void encode_bitwise(uint32_t *dst, const uint8_t *src, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        for (int b = 7; b >= 0; b--) {
+            *dst++ = ((src[i] >> b) & 1) ? LED_STRIP_RMT_SYMBOL(1, T1H, 0, T1L) : LED_STRIP_RMT_SYMBOL(1, T0H, 0, T0L);
+        }
+    }
+}
+
+static void test_symbol_layout(void)
+{
+    // the same bit fields as rmt_symbol_word_t
+    uint32_t w = LED_STRIP_RMT_SYMBOL(1, 0x1234, 0, 0x7FFF);
+    TEST_ASSERT_EQUAL_UINT32(0x1234, w & 0x7FFF);
+    TEST_ASSERT_EQUAL_UINT32(1, (w >> 15) & 1);
+    TEST_ASSERT_EQUAL_UINT32(0x7FFF, (w >> 16) & 0x7FFF);
+    TEST_ASSERT_EQUAL_UINT32(0, w >> 31);
+}
+
+static void test_stream_matches_timings(void)
+{
+    init_table();
+    const uint8_t bytes[2] = { 0xA5, 0x0F };
+    uint32_t symbols[17];
+    bool done = false;
+    TEST_ASSERT_EQUAL_UINT32(16, led_strip_rmt_symbols_fill(&s_table, bytes, 2, 0, 17, symbols, &done));
+    TEST_ASSERT_FALSE(done);
+    TEST_ASSERT_EQUAL_UINT32(1, led_strip_rmt_symbols_fill(&s_table, bytes, 2, 16, 1, &symbols[16], &done));
+    TEST_ASSERT_TRUE(done);
+    for (int i = 0; i < 16; i++) {
+        int bit = (bytes[i / 8] >> (7 - i % 8)) & 1;
+        // high first, then low; 1.2 us per bit
+        TEST_ASSERT_EQUAL_UINT32(1, (symbols[i] >> 15) & 1);
+        TEST_ASSERT_EQUAL_UINT32(0, symbols[i] >> 31);
+        TEST_ASSERT_EQUAL_UINT32(bit ? T1H : T0H, symbols[i] & 0x7FFF);
+        TEST_ASSERT_EQUAL_UINT32(bit ? T1L : T0L, (symbols[i] >> 16) & 0x7FFF);
+    }
+    // 280 us low
+    TEST_ASSERT_EQUAL_UINT32(LED_STRIP_RMT_SYMBOL(0, RESET_TICKS, 0, RESET_TICKS), symbols[16]);
+}
+
+static void test_chunked_stream(void)
+{
+    init_table();
+    fill_frame();
+    encode_bitwise(s_ref, s_frame, FRAME_BYTES);
+    s_ref[FRAME_SYMBOLS - 1] = s_table.reset;
+
+    uint32_t x = 12345;
+    for (int round = 0; round < 20; round++) {
+        memset(s_out, 0, sizeof(s_out));
+        size_t written = 0;
+        bool done = false;
+        while (!done) {
+            // free room as the driver may report it: 0 to 99 symbols, never past the end of s_out
+            x = x * 1103515245u + 12345u;
+            size_t room = (x >> 16) % 100;
+            if (room > FRAME_SYMBOLS - written) {
+                room = FRAME_SYMBOLS - written;
+            }
+            size_t n = led_strip_rmt_symbols_fill(&s_table, s_frame, FRAME_BYTES, written, room, &s_out[written], &done);
+            TEST_ASSERT_TRUE(n <= room);
+            if (written < FRAME_BYTES * 8) {
+                // whole bytes only, and never 0 with room for a byte
+                TEST_ASSERT_EQUAL_UINT32(0, n % 8);
+                TEST_ASSERT_TRUE(n > 0 || room < 8);
+            }
+            written += n;
+        }
+        TEST_ASSERT_EQUAL_UINT32(FRAME_SYMBOLS, written);
+        TEST_ASSERT_EQUAL_MEMORY(s_ref, s_out, sizeof(s_ref));
+    }
+}
+
+static void bench_rmt_symbols(void)
+{
+    init_table();
+    fill_frame();
+    encode_bitwise(s_ref, s_frame, FRAME_BYTES);      // warm up
+    double start = now_s();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        s_frame[i % FRAME_BYTES] ^= 1;
+        encode_bitwise(s_ref, s_frame, FRAME_BYTES);
+    }
+    double bitwise_us = (now_s() - start) * 1e6 / BENCH_FRAMES;
+    led_strip_rmt_symbols_encode(&s_table, s_out, s_frame, FRAME_BYTES);
+    start = now_s();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        s_frame[i % FRAME_BYTES] ^= 1;
+        led_strip_rmt_symbols_encode(&s_table, s_out, s_frame, FRAME_BYTES);
+    }
+    double table_us = (now_s() - start) * 1e6 / BENCH_FRAMES;
+    printf("BENCH rmt_symbols leds=%d frames=%d bitwise_us=%.2f table_us=%.2f speedup=%.2f table_bytes=%u\n",
+           BENCH_LEDS, BENCH_FRAMES, bitwise_us, table_us, bitwise_us / table_us, (unsigned)sizeof(s_table));
+    encode_bitwise(s_ref, s_frame, FRAME_BYTES);
+    TEST_ASSERT_EQUAL_MEMORY(s_ref, s_out, FRAME_BYTES * 8 * sizeof(uint32_t));
+}
+
+
+void test_rmt_symbols_run(void)
+{
+    RUN_TEST(test_symbol_layout);
+    RUN_TEST(test_stream_matches_timings);
+    RUN_TEST(test_chunked_stream);
+    RUN_TEST(bench_rmt_symbols);
+}
+
+/* ***** END OF FILE ******************************************************** */
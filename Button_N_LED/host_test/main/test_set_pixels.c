@@ -0,0 +1,210 @@
+/*
+ ******************************************************************************
+ * @file           : test_set_pixels.c
+ * @brief          : Host test and benchmark for the bulk set_pixels path
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - led_strip_pixels_to_wire() must give the same buffer as one set_pixel /
+ *   set_pixel_rgbw per LED, for every buffer format on GRB and GRBW strips.
+ * - Benchmark: time to fill a whole frame of 300, 1000 and 4096 LEDs, once
+ *   with one indirect set_pixel call per LED (what led_strip_set_pixel does)
+ *   and once with one set_pixels call. Both backends keep the pixels in
+ *   wire order (GRB), the SPI expansion happens at refresh.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "test_bench.h"
+#include "led_strip_interface.h"
+#include "led_strip_pixels.h"
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_LEDS            4096
+#define BENCH_REPEAT_PIXELS (4 * 1000 * 1000)      /* pixels per measurement, split into frames */
+#define CONTAINER_OF(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+
+/* Private typedef -----------------------------------------------------------*/
+/* In-memory strip with the pixel handling of the RMT and SPI backends */
+typedef struct {
+    led_strip_t base;
+    uint32_t strip_len;
+    uint8_t bytes_per_pixel;
+    uint8_t *pixel_buf;
+} mem_strip_t;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t s_src[MAX_LEDS * 4];
+static uint8_t s_buf_a[MAX_LEDS * 4];
+static uint8_t s_buf_b[MAX_LEDS * 4];
+
+/* Private functions ---------------------------------------------------------*/
+static void store_wire(mem_strip_t *s, uint32_t index, const uint8_t *grbw)
+{
+    memcpy(&s->pixel_buf[index * s->bytes_per_pixel], grbw, s->bytes_per_pixel);
+}
+
+static esp_err_t mem_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    mem_strip_t *s = CONTAINER_OF(strip, mem_strip_t, base);
+    if (index >= s->strip_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint8_t grbw[4] = { green & 0xFF, red & 0xFF, blue & 0xFF, 0 };
+    store_wire(s, index, grbw);
+    return ESP_OK;
+}
+
+static esp_err_t mem_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    mem_strip_t *s = CONTAINER_OF(strip, mem_strip_t, base);
+    if (index >= s->strip_len || s->bytes_per_pixel != 4) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint8_t grbw[4] = { green & 0xFF, red & 0xFF, blue & 0xFF, white & 0xFF };
+    store_wire(s, index, grbw);
+    return ESP_OK;
+}
+
+static esp_err_t mem_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *pixels, led_buffer_format_t format)
+{
+    mem_strip_t *s = CONTAINER_OF(strip, mem_strip_t, base);
+    if (!led_strip_pixels_valid(s->strip_len, s->bytes_per_pixel, start, count, format)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    led_strip_pixels_to_wire(&s->pixel_buf[start * s->bytes_per_pixel], s->bytes_per_pixel, pixels, format, count);
+    return ESP_OK;
+}
+
+static void mem_strip_init(mem_strip_t *s, uint32_t len, uint8_t bytes_per_pixel, uint8_t *buf)
+{
+    memset(s, 0, sizeof(*s));
+    s->base.set_pixel = mem_set_pixel;
+    s->base.set_pixel_rgbw = mem_set_pixel_rgbw;
+    s->base.set_pixels = mem_set_pixels;
+    s->strip_len = len;
+    s->bytes_per_pixel = bytes_per_pixel;
+    s->pixel_buf = buf;
+}
+
+/* What led_strip_set_pixel() costs per LED: null check plus one indirect call */
+static esp_err_t __attribute__((noinline)) api_set_pixel(led_strip_t *strip, uint32_t index, uint32_t r, uint32_t g, uint32_t b)
+{
+    if (strip == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return strip->set_pixel(strip, index, r, g, b);
+}
+
+static void fill_src(void)
+{
+    uint32_t x = 2463534242u;
+    for (size_t i = 0; i < sizeof(s_src); i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        s_src[i] = (uint8_t)x;
+    }
+}
+
+/* Reference: one set_pixel / set_pixel_rgbw per LED */
+static esp_err_t fill_per_pixel(mem_strip_t *s, uint32_t start, uint32_t count, const uint8_t *src, led_buffer_format_t format)
+{
+    bool rgb_first = (format == LED_BUFFER_FORMAT_RGB || format == LED_BUFFER_FORMAT_RGBW);
+    uint8_t n = led_buffer_format_bytes(format);
+    for (uint32_t i = 0; i < count; i++, src += n) {
+        uint32_t r = rgb_first ? src[0] : src[1];
+        uint32_t g = rgb_first ? src[1] : src[0];
+        esp_err_t err = n == 4 ? s->base.set_pixel_rgbw(&s->base, start + i, r, g, src[2], src[3])
+                        : s->base.set_pixel(&s->base, start + i, r, g, src[2]);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+static void test_bulk_matches_per_pixel(void)
+{
+    mem_strip_t ref, bulk;
+    fill_src();
+    for (uint8_t bpp = 3; bpp <= 4; bpp++) {
+        for (led_buffer_format_t f = LED_BUFFER_FORMAT_RGB; f < LED_BUFFER_FORMAT_INVALID; f++) {
+            if (bpp == 3 && led_buffer_format_bytes(f) == 4) {
+                continue;
+            }
+            // odd span not starting at 0
+            const uint32_t len = 300, start = 7, count = 211;
+            memset(s_buf_a, 0xAB, sizeof(s_buf_a));
+            memset(s_buf_b, 0xAB, sizeof(s_buf_b));
+            mem_strip_init(&ref, len, bpp, s_buf_a);
+            mem_strip_init(&bulk, len, bpp, s_buf_b);
+            TEST_ASSERT_EQUAL(ESP_OK, fill_per_pixel(&ref, start, count, s_src, f));
+            TEST_ASSERT_EQUAL(ESP_OK, bulk.base.set_pixels(&bulk.base, start, count, s_src, f));
+            TEST_ASSERT_EQUAL_MEMORY(s_buf_a, s_buf_b, sizeof(s_buf_a));
+        }
+    }
+}
+
+static void test_span_is_validated(void)
+{
+    TEST_ASSERT_TRUE(led_strip_pixels_valid(10, 3, 0, 10, LED_BUFFER_FORMAT_RGB));
+    TEST_ASSERT_TRUE(led_strip_pixels_valid(10, 3, 10, 0, LED_BUFFER_FORMAT_GRB));
+    TEST_ASSERT_FALSE(led_strip_pixels_valid(10, 3, 1, 10, LED_BUFFER_FORMAT_RGB));
+    TEST_ASSERT_FALSE(led_strip_pixels_valid(10, 3, 11, 0, LED_BUFFER_FORMAT_RGB));
+    TEST_ASSERT_FALSE(led_strip_pixels_valid(10, 3, 5, UINT32_MAX, LED_BUFFER_FORMAT_RGB));   // no wrap-around
+    TEST_ASSERT_FALSE(led_strip_pixels_valid(10, 3, 0, 1, LED_BUFFER_FORMAT_RGBW));           // white needs GRBW
+    TEST_ASSERT_TRUE(led_strip_pixels_valid(10, 4, 0, 1, LED_BUFFER_FORMAT_GRBW));
+    TEST_ASSERT_FALSE(led_strip_pixels_valid(10, 4, 0, 1, LED_BUFFER_FORMAT_INVALID));
+}
+
+static void bench_fill(uint32_t leds)
+{
+    mem_strip_t strip;
+    mem_strip_init(&strip, leds, 3, s_buf_a);
+    uint32_t frames = BENCH_REPEAT_PIXELS / leds;
+
+    double start = now_s();
+    for (uint32_t f = 0; f < frames; f++) {
+        const uint8_t *p = s_src;
+        for (uint32_t i = 0; i < leds; i++, p += 3) {
+            api_set_pixel(&strip.base, i, p[0], p[1], p[2]);
+        }
+    }
+    double per_pixel_us = (now_s() - start) * 1e6 / frames;
+
+    start = now_s();
+    for (uint32_t f = 0; f < frames; f++) {
+        strip.base.set_pixels(&strip.base, 0, leds, s_src, LED_BUFFER_FORMAT_RGB);
+    }
+    double bulk_us = (now_s() - start) * 1e6 / frames;
+
+    printf("BENCH set_pixels leds=%lu per_pixel_us=%.1f bulk_us=%.1f speedup=%.1f\n",
+           (unsigned long)leds, per_pixel_us, bulk_us, per_pixel_us / bulk_us);
+}
+
+static void bench_frame_fill(void)
+{
+    static const uint32_t sizes[] = { 300, 1000, 4096 };
+    fill_src();
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_fill(sizes[i]);
+    }
+}
+
+
+void test_set_pixels_run(void)
+{
+    RUN_TEST(test_bulk_matches_per_pixel);
+    RUN_TEST(test_span_is_validated);
+    RUN_TEST(bench_frame_fill);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,290 @@
+/*
+ ******************************************************************************
+ * @file           : test_spi_encode.c
+ * @brief          : Host test and benchmark for led_strip_spi_encode.c
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - The pattern table is checked against the original bit-by-bit expansion
+ *   of the SPI backend for all 256 byte values.
+ * - Timing: the SPI bits per LED bit chosen for 2.2 - 6.4 MHz, the tables
+ *   generated for them, and a frame decoded back from the SPI bits the way
+ *   an LED does (high time above half a bit: 1).
+ * - Benchmark: pixels/s for encoding a 1000-LED GRB frame with
+ *     bit    : memset + 3 bit-by-bit expansions per pixel (the old set_pixel)
+ *     table  : 3 table lookups per pixel (the new set_pixel)
+ *     bulk   : led_strip_spi_encode() over the whole frame
+ *   One "BENCH" line is printed per path.
+ * - Benchmark per SPI clock: bits per LED bit, memory per LED (pixels and
+ *   DMA buffer), table size and time to encode a 1000-LED frame.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "test_bench.h"
+#include "led_strip_spi_encode.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BIT(n)              (1U << (n))
+#define BYTES_PER_PIXEL     3
+#define FRAME_SPI_BYTES     (BENCH_LEDS * BYTES_PER_PIXEL * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE)
+#define MAX_FRAME_SPI_BYTES (BENCH_LEDS * BYTES_PER_PIXEL * LED_STRIP_SPI_MAX_BITS_PER_LED_BIT)
+#define T0H_NS              400
+#define T1H_NS              800
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t s_colors[BENCH_LEDS * BYTES_PER_PIXEL];     /* GRB, wire order */
+static uint8_t s_frame_ref[FRAME_SPI_BYTES];
+static uint8_t s_frame[FRAME_SPI_BYTES];
+static uint8_t s_wide[MAX_FRAME_SPI_BYTES + 1];        /* + a guard byte */
+static uint8_t s_decoded[BENCH_LEDS * BYTES_PER_PIXEL];
+static const led_strip_spi_table_t s_table = { .bytes = LED_STRIP_SPI_BYTES_PER_COLOR_BYTE, .pattern = &led_strip_spi_pattern[0][0] };
+
+/* Private functions ---------------------------------------------------------*/
+/* The expansion the SPI backend used before the table, kept as the reference.
+   buf must be zeroed first. */
+static void ref_spi_bit(uint8_t data, uint8_t *buf)
+{
+    *(buf + 2) |= data & BIT(0) ? BIT(2) | BIT(1) : BIT(2);
+    *(buf + 2) |= data & BIT(1) ? BIT(5) | BIT(4) : BIT(5);
+    *(buf + 2) |= data & BIT(2) ? BIT(7) : 0x00;
+    *(buf + 1) |= BIT(0);
+    *(buf + 1) |= data & BIT(3) ? BIT(3) | BIT(2) : BIT(3);
+    *(buf + 1) |= data & BIT(4) ? BIT(6) | BIT(5) : BIT(6);
+    *(buf + 0) |= data & BIT(5) ? BIT(1) | BIT(0) : BIT(1);
+    *(buf + 0) |= data & BIT(6) ? BIT(4) | BIT(3) : BIT(4);
+    *(buf + 0) |= data & BIT(7) ? BIT(7) | BIT(6) : BIT(7);
+}
+
+/* One color byte through the default table, the way set_pixel did it per byte */
+static void encode_byte(uint8_t data, uint8_t *buf)
+{
+    memcpy(buf, led_strip_spi_pattern[data], LED_STRIP_SPI_BYTES_PER_COLOR_BYTE);
+}
+
+static void fill_colors(void)
+{
+    uint32_t x = 12345;
+    for (size_t i = 0; i < sizeof(s_colors); i++) {
+        x = x * 1103515245 + 12345;
+        s_colors[i] = (uint8_t)(x >> 16);
+    }
+}
+
+static void encode_frame_bit(uint8_t *frame)
+{
+    for (uint32_t led = 0; led < BENCH_LEDS; led++) {
+        uint8_t *px = &frame[led * BYTES_PER_PIXEL * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE];
+        const uint8_t *c = &s_colors[led * BYTES_PER_PIXEL];
+        memset(px, 0, BYTES_PER_PIXEL * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE);
+        ref_spi_bit(c[0], px);
+        ref_spi_bit(c[1], px + LED_STRIP_SPI_BYTES_PER_COLOR_BYTE);
+        ref_spi_bit(c[2], px + LED_STRIP_SPI_BYTES_PER_COLOR_BYTE * 2);
+    }
+}
+
+static void encode_frame_table(uint8_t *frame)
+{
+    for (uint32_t led = 0; led < BENCH_LEDS; led++) {
+        uint8_t *px = &frame[led * BYTES_PER_PIXEL * LED_STRIP_SPI_BYTES_PER_COLOR_BYTE];
+        const uint8_t *c = &s_colors[led * BYTES_PER_PIXEL];
+        encode_byte(c[0], px);
+        encode_byte(c[1], px + LED_STRIP_SPI_BYTES_PER_COLOR_BYTE);
+        encode_byte(c[2], px + LED_STRIP_SPI_BYTES_PER_COLOR_BYTE * 2);
+    }
+}
+
+static void encode_frame_bulk(uint8_t *frame)
+{
+    led_strip_spi_encode(&s_table, frame, s_colors, sizeof(s_colors));
+}
+
+static void bench_path(const char *name, void (*encode)(uint8_t *frame))
+{
+    encode(s_frame);       // warm up
+    double start = now_s();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        s_colors[i % sizeof(s_colors)] ^= 1;        // keep the compiler from hoisting the work
+        encode(s_frame);
+    }
+    double elapsed = now_s() - start;
+    printf("BENCH spi_encode path=%s leds=%d frames=%d pixels_per_s=%.0f us_per_frame=%.1f\n",
+           name, BENCH_LEDS, BENCH_FRAMES, BENCH_LEDS * BENCH_FRAMES / elapsed, elapsed * 1e6 / BENCH_FRAMES);
+}
+
+static void test_pattern_matches_bit_expansion(void)
+{
+    for (int v = 0; v < 256; v++) {
+        uint8_t ref[LED_STRIP_SPI_BYTES_PER_COLOR_BYTE] = { 0 };
+        uint8_t out[LED_STRIP_SPI_BYTES_PER_COLOR_BYTE] = { 0xA5, 0xA5, 0xA5 };   // no pre-zeroing needed
+        ref_spi_bit((uint8_t)v, ref);
+        encode_byte((uint8_t)v, out);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(ref, out, sizeof(ref));
+    }
+    // spot checks against the wire format: 0x00 -> 100 x 8, 0xFF -> 110 x 8
+    TEST_ASSERT_EQUAL_HEX8(0x92, led_strip_spi_pattern[0x00][0]);
+    TEST_ASSERT_EQUAL_HEX8(0x49, led_strip_spi_pattern[0x00][1]);
+    TEST_ASSERT_EQUAL_HEX8(0x24, led_strip_spi_pattern[0x00][2]);
+    TEST_ASSERT_EQUAL_HEX8(0xDB, led_strip_spi_pattern[0xFF][0]);
+    TEST_ASSERT_EQUAL_HEX8(0x6D, led_strip_spi_pattern[0xFF][1]);
+    TEST_ASSERT_EQUAL_HEX8(0xB6, led_strip_spi_pattern[0xFF][2]);
+}
+
+static void test_bulk(void)
+{
+    fill_colors();
+    encode_frame_bit(s_frame_ref);
+    memset(s_frame, 0, sizeof(s_frame));
+    led_strip_spi_encode(&s_table, s_frame, s_colors, sizeof(s_colors));
+    TEST_ASSERT_EQUAL_MEMORY(s_frame_ref, s_frame, sizeof(s_frame));
+}
+
+static void bench_frame_encode(void)
+{
+    fill_colors();
+    bench_path("bit", encode_frame_bit);
+    bench_path("table", encode_frame_table);
+    bench_path("bulk", encode_frame_bulk);
+
+    // the three paths must still agree on the (modified) colors
+    encode_frame_bit(s_frame_ref);
+    encode_frame_bulk(s_frame);
+    TEST_ASSERT_EQUAL_MEMORY(s_frame_ref, s_frame, sizeof(s_frame));
+    encode_frame_table(s_frame);
+    TEST_ASSERT_EQUAL_MEMORY(s_frame_ref, s_frame, sizeof(s_frame));
+}
+
+/* What the LED sees: every `bits` SPI bits are one LED bit, a 1 if the high time is over half of it */
+static void decode_frame(const uint8_t *spi, uint32_t bits, uint8_t *colors, size_t len)
+{
+    uint32_t pos = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t v = 0;
+        for (int b = 0; b < 8; b++, pos += bits) {
+            uint32_t high = 0;
+            while (high < bits && (spi[(pos + high) / 8] & (0x80 >> ((pos + high) % 8)))) {
+                high++;
+            }
+            // the rest of the LED bit must be low
+            for (uint32_t k = pos + high; k < pos + bits; k++) {
+                TEST_ASSERT_FALSE(spi[k / 8] & (0x80 >> (k % 8)));
+            }
+            v = (v << 1) | (high * 2 > bits);
+        }
+        colors[i] = v;
+    }
+}
+
+static void test_timing_select(void)
+{
+    static const struct {
+        uint32_t clock_hz;
+        led_strip_spi_timing_t timing;
+    } cases[] = {
+        { 2200000, { 3, 1, 2 } },
+        { 2500000, { 3, 1, 2 } },    // 400 / 800 / 1200 ns, the timing used so far
+        { 3200000, { 4, 1, 3 } },    // 312 / 937 / 1250 ns
+        { 4000000, { 5, 2, 3 } },    // 500 / 750 / 1250 ns
+        { 5000000, { 6, 2, 4 } },    // 400 / 800 / 1200 ns
+        { 6400000, { 8, 3, 5 } },    // 468 / 781 / 1250 ns
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        led_strip_spi_timing_t timing;
+        TEST_ASSERT_TRUE(led_strip_spi_timing_select(cases[i].clock_hz, T0H_NS, T1H_NS, &timing));
+        TEST_ASSERT_EQUAL_UINT8(cases[i].timing.bits, timing.bits);
+        TEST_ASSERT_EQUAL_UINT8(cases[i].timing.t0h, timing.t0h);
+        TEST_ASSERT_EQUAL_UINT8(cases[i].timing.t1h, timing.t1h);
+    }
+    led_strip_spi_timing_t timing;
+    // 1 MHz: 3 bits already last 3 us; 20 MHz: 8 bits are 400 ns
+    TEST_ASSERT_FALSE(led_strip_spi_timing_select(1000000, T0H_NS, T1H_NS, &timing));
+    TEST_ASSERT_FALSE(led_strip_spi_timing_select(20000000, T0H_NS, T1H_NS, &timing));
+    TEST_ASSERT_FALSE(led_strip_spi_timing_select(0, T0H_NS, T1H_NS, &timing));
+
+    // 280 us of low level
+    TEST_ASSERT_EQUAL_UINT32(88, led_strip_spi_reset_bytes(2500000, 280));
+    TEST_ASSERT_EQUAL_UINT32(140, led_strip_spi_reset_bytes(4000000, 280));
+}
+
+static void test_generated_tables(void)
+{
+    led_strip_spi_table_t table;
+    // the default timing keeps the built-in table
+    const led_strip_spi_timing_t timing_3 = { 3, 1, 2 };
+    TEST_ASSERT_TRUE(led_strip_spi_table_init(&table, &timing_3));
+    TEST_ASSERT_EQUAL_PTR(&led_strip_spi_pattern[0][0], table.pattern);
+    TEST_ASSERT_NULL(table.alloc);
+    led_strip_spi_table_free(&table);
+
+    fill_colors();
+    for (uint32_t bits = LED_STRIP_SPI_MIN_BITS_PER_LED_BIT; bits <= LED_STRIP_SPI_MAX_BITS_PER_LED_BIT; bits++) {
+        // every timing an LED can tell apart: a 0 high for less than half of the bit, a 1 for more
+        for (uint32_t t0h = 1; t0h * 2 < bits; t0h++) {
+            const led_strip_spi_timing_t timing = { bits, t0h, bits / 2 + 1 };
+            TEST_ASSERT_TRUE(led_strip_spi_table_init(&table, &timing));
+            TEST_ASSERT_EQUAL_UINT8(bits, table.bytes);
+            // 0x00: t0h high, the rest low, 8 times
+            uint64_t ref = 0;
+            for (uint32_t k = 0; k < 8 * bits; k++) {
+                ref = (ref << 1) | (k % bits < t0h);
+            }
+            for (uint32_t k = 0; k < bits; k++) {
+                TEST_ASSERT_EQUAL_HEX8((uint8_t)(ref >> (8 * (bits - 1 - k))), table.pattern[k]);
+            }
+            // a whole frame decodes back to the colors
+            memset(s_wide, 0xEE, sizeof(s_wide));
+            led_strip_spi_encode(&table, s_wide, s_colors, sizeof(s_colors));
+            TEST_ASSERT_EQUAL_HEX8(0xEE, s_wide[sizeof(s_colors) * bits]);
+            decode_frame(s_wide, bits, s_decoded, sizeof(s_colors));
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(s_colors, s_decoded, sizeof(s_colors));
+            led_strip_spi_table_free(&table);
+        }
+    }
+}
+
+static void bench_clocks(void)
+{
+    static const uint32_t clocks[] = { 2500000, 3200000, 4000000, 5000000, 6400000 };
+    fill_colors();
+    for (size_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++) {
+        led_strip_spi_timing_t timing;
+        led_strip_spi_table_t table;
+        TEST_ASSERT_TRUE(led_strip_spi_timing_select(clocks[c], T0H_NS, T1H_NS, &timing));
+        TEST_ASSERT_TRUE(led_strip_spi_table_init(&table, &timing));
+        led_strip_spi_encode(&table, s_wide, s_colors, sizeof(s_colors));      // warm up
+        double start = now_s();
+        for (int i = 0; i < BENCH_FRAMES; i++) {
+            s_colors[i % sizeof(s_colors)] ^= 1;
+            led_strip_spi_encode(&table, s_wide, s_colors, sizeof(s_colors));
+        }
+        double elapsed = now_s() - start;
+        decode_frame(s_wide, timing.bits, s_decoded, sizeof(s_colors));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(s_colors, s_decoded, sizeof(s_colors));
+        // per RGB LED: 3 bytes of pixels in wire order plus the expanded DMA buffer
+        printf("BENCH spi_timing clock_khz=%u bits=%u t0h_ns=%u t1h_ns=%u bit_ns=%u pixel_bytes_per_led=%d "
+               "dma_bytes_per_led=%u reset_bytes=%u table_bytes=%u us_per_frame=%.1f\n",
+               (unsigned)(clocks[c] / 1000), timing.bits, (unsigned)(timing.t0h * 1000000000ULL / clocks[c]),
+               (unsigned)(timing.t1h * 1000000000ULL / clocks[c]), (unsigned)(timing.bits * 1000000000ULL / clocks[c]),
+               BYTES_PER_PIXEL, BYTES_PER_PIXEL * timing.bits, (unsigned)led_strip_spi_reset_bytes(clocks[c], 280),
+               table.alloc ? 256 * timing.bits : 0, elapsed * 1e6 / BENCH_FRAMES);
+        led_strip_spi_table_free(&table);
+    }
+}
+
+void test_spi_encode_run(void)
+{
+    RUN_TEST(test_pattern_matches_bit_expansion);
+    RUN_TEST(test_bulk);
+    RUN_TEST(test_timing_select);
+    RUN_TEST(test_generated_tables);
+    RUN_TEST(bench_frame_encode);
+    RUN_TEST(bench_clocks);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -11,17 +11,30 @@
  *
  * Descriptions: On pressing the push button, LED turns OFF and on leaving the Button, the LED remains turned ON.
  *
+ * - Button input (menuconfig, 'Button input'):
+ *   - GPIO interrupt (default): button.c debounces the edges and sends press, release, long press and
+ *     double click events to a queue; app_main sleeps on the queue between presses.
+ *   - Polling loop: the original loop, reading the pin and logging without a pause. It keeps its core
+ *     busy and the task watchdog reports the idle task of that core. Kept to compare the two.
+ * - Every CONFIG_BUTTON_REPORT_PERIOD_MS a report task prints the CPU load and the latency from the
+ *   first edge at the pin to the LED following it (a 'BUTTON' line).
+ *
  ******************************************************************************
 */
 
 /* Includes ----------------------------------------------------------------- */
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "driver/gpio.h"		// For GPIOs
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "led_strip.h"
+#include "button.h"
 #include "sdkconfig.h"
 
 static const char *TAG = "example";
@@ -33,12 +46,37 @@ static const char *TAG = "example";
 #define BLINK_GPIO 21	// ESP32 pin GPIO21 connected to LED
 #define BUTTON_PIN 18	// ESP32 pin GPIO18 connected to Button
 
+#define BUTTON_DEBOUNCE_MS      30      // time the contacts get to settle
+#define BUTTON_LONG_PRESS_MS    1000
+#define BUTTON_DOUBLE_CLICK_MS  400     // from the release of the first click to the second press
+#define BUTTON_QUEUE_LEN        8
+
+/* Private types ------------------------------------------------------------ */
+// edge to LED latency over a report period; written by app_main, read and reset by the report task
+typedef struct {
+    uint32_t count;
+    uint64_t sum_us;
+    uint32_t max_us;
+} latency_window_t;
+
 static uint8_t s_led_state = 0;
+static latency_window_t s_latency;
+static portMUX_TYPE s_latency_lock = portMUX_INITIALIZER_UNLOCKED;
+#if CONFIG_BUTTON_INPUT_POLLING
+static int64_t s_edge_us;               // first edge since the loop last read the pin, 0: none
+static portMUX_TYPE s_edge_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
 
 /* Private function prototypes ---------------------------------------------- */
 static void configure_led(void);
 static void configure_button(void);
 static void blink_led(void);
+static void latency_add(int64_t edge_us);
+static void report_task(void *arg);
+#if CONFIG_BUTTON_INPUT_POLLING
+static void edge_probe_isr(void *arg);
+static int64_t edge_take(int64_t read_us, bool changed);
+#endif
 
 /**
   * @brief  The application entry point.
@@ -48,28 +86,70 @@ void app_main(void)
 {
     /* Configure the peripheral according to the LED type */
     configure_led();
+    xTaskCreate(report_task, "report", 3072, xTaskGetCurrentTaskHandle(), 2, NULL);
+
+#if CONFIG_BUTTON_INPUT_INTERRUPT
+    QueueHandle_t queue = xQueueCreate(BUTTON_QUEUE_LEN, sizeof(button_event_t));
+    const button_config_t button_config = {
+        .gpio = BUTTON_PIN,
+        .active_low = true,
+        .debounce_ms = BUTTON_DEBOUNCE_MS,
+        .long_press_ms = BUTTON_LONG_PRESS_MS,
+        .double_click_ms = BUTTON_DOUBLE_CLICK_MS,
+        .queue = queue,
+    };
+    ESP_ERROR_CHECK(queue ? ESP_OK : ESP_ERR_NO_MEM);
+    ESP_ERROR_CHECK(button_start(&button_config));
+    // the LED is on while the button is released
+    s_led_state = button_is_pressed() ? 0 : 1;
+    blink_led();
+
+    // main-while-loop: sleeps until the button does something
+    while (1) {
+        button_event_t event;
+        xQueueReceive(queue, &event, portMAX_DELAY);
+        if (event.type == BUTTON_EVENT_PRESS || event.type == BUTTON_EVENT_RELEASE) {
+            s_led_state = event.type == BUTTON_EVENT_RELEASE;
+            blink_led();
+            latency_add(event.edge_us);
+        }
+        ESP_LOGI(TAG, "Button %s, LED %s", button_event_name(event.type), s_led_state ? "ON" : "OFF");
+    }
+#else
     configure_button();
-    
+    // probe for the latency only: records the first edge, the loop below still polls
+    gpio_set_intr_type(BUTTON_PIN, GPIO_INTR_ANYEDGE);
+    gpio_install_isr_service(0);
+    gpio_isr_handler_add(BUTTON_PIN, edge_probe_isr, NULL);
+    int level = gpio_get_level(BUTTON_PIN);
+
 	// main-while-loop
     while (1) {
+        int64_t read_us = esp_timer_get_time();
         // Read Button state
         if (gpio_get_level(BUTTON_PIN)==1)
         {
 			ESP_LOGI(TAG, "Button pressed: %s!", "ON");
-			
+
 			s_led_state = 1;
 			blink_led();
 		}
 		else
 		{
 			ESP_LOGI(TAG, "Button pressed: %s!", "OFF");
-			
+
 			s_led_state = 0;
 			blink_led();
 		}
-        
+        int64_t edge_us = edge_take(read_us, s_led_state != level);
+        if (s_led_state != level) {
+            level = s_led_state;
+            latency_add(edge_us);
+        }
+
         //vTaskDelay(CONFIG_BLINK_PERIOD / portTICK_PERIOD_MS);
     }
+#endif
 }
 
 /* Configuring the LED */
@@ -81,7 +161,7 @@ static void configure_led(void)
     gpio_set_direction(BLINK_GPIO, GPIO_MODE_OUTPUT);
 }
 
-/* Configuring the Button */
+/* Configuring the Button (polling loop; button_start configures it for the interrupt) */
 static void configure_button(void)
 {
     ESP_LOGI(TAG, "Configuring Button!");
@@ -97,4 +177,122 @@ static void blink_led(void)
     gpio_set_level(BLINK_GPIO, s_led_state);
 }
 
+#if CONFIG_BUTTON_INPUT_POLLING
+/* Edge probe - time of the first edge the loop hasn't read yet */
+static void edge_probe_isr(void *arg)
+{
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&s_edge_lock);
+    if (s_edge_us == 0) {
+        s_edge_us = now_us;
+    }
+    portEXIT_CRITICAL_ISR(&s_edge_lock);
+}
+
+/* Helper function - the edge behind a change the loop read at read_us. Without a change, an edge from
+   before the read was a glitch the loop didn't see, and is dropped */
+static int64_t edge_take(int64_t read_us, bool changed)
+{
+    int64_t edge_us = 0;
+    portENTER_CRITICAL(&s_edge_lock);
+    // an edge after the read belongs to the next change
+    if (s_edge_us != 0 && s_edge_us < read_us) {
+        edge_us = s_edge_us;
+        s_edge_us = 0;
+    }
+    portEXIT_CRITICAL(&s_edge_lock);
+    return changed ? edge_us : 0;
+}
+#endif
+
+/* Helper function - one edge to LED latency; edge_us 0: no edge recorded */
+static void latency_add(int64_t edge_us)
+{
+    if (edge_us == 0) {
+        return;
+    }
+    uint32_t us = (uint32_t)(esp_timer_get_time() - edge_us);
+    portENTER_CRITICAL(&s_latency_lock);
+    s_latency.count++;
+    s_latency.sum_us += us;
+    if (us > s_latency.max_us) {
+        s_latency.max_us = us;
+    }
+    portEXIT_CRITICAL(&s_latency_lock);
+}
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+/* Helper function - run time counters of the idle tasks (all cores) and of one task, and the total */
+static bool cpu_sample(TaskHandle_t task, uint32_t *idle, uint32_t *task_time, uint32_t *total)
+{
+    UBaseType_t num_tasks = uxTaskGetNumberOfTasks();
+    TaskStatus_t *tasks = malloc(num_tasks * sizeof(TaskStatus_t));
+    if (tasks == NULL) {
+        return false;
+    }
+    configRUN_TIME_COUNTER_TYPE total_time = 0;
+    num_tasks = uxTaskGetSystemState(tasks, num_tasks, &total_time);
+    *idle = 0;
+    *task_time = 0;
+    for (UBaseType_t i = 0; i < num_tasks; i++) {
+        // the counters wrap, only their differences are used
+        if (strncmp(tasks[i].pcTaskName, "IDLE", 4) == 0) {
+            *idle += (uint32_t)tasks[i].ulRunTimeCounter;
+        }
+        if (tasks[i].xHandle == task) {
+            *task_time = (uint32_t)tasks[i].ulRunTimeCounter;
+        }
+    }
+    *total = (uint32_t)total_time;
+    free(tasks);
+    return num_tasks > 0;
+}
+#endif
+
+/* Report task - CPU load and latency of the last period */
+static void report_task(void *arg)
+{
+    TaskHandle_t main_task = (TaskHandle_t)arg;
+#if CONFIG_BUTTON_INPUT_INTERRUPT
+    const char *mode = "interrupt";
+#else
+    const char *mode = "polling";
+#endif
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    uint32_t last_idle = 0, last_main = 0, last_total = 0;
+    bool have_last = cpu_sample(main_task, &last_idle, &last_main, &last_total);
+#endif
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_BUTTON_REPORT_PERIOD_MS));
+        portENTER_CRITICAL(&s_latency_lock);
+        latency_window_t latency = s_latency;
+        memset(&s_latency, 0, sizeof(s_latency));
+        portEXIT_CRITICAL(&s_latency_lock);
+        uint32_t mean_us = latency.count ? (uint32_t)(latency.sum_us / latency.count) : 0;
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+        uint32_t idle, main_time, total;
+        if (cpu_sample(main_task, &idle, &main_time, &total)) {
+            bool valid = have_last && total != last_total;
+            // the total counts wall time once, the idle tasks run on every core
+            float elapsed = (float)(total - last_total);
+            float busy = valid ? 100.0f * (1.0f - (idle - last_idle) / (elapsed * portNUM_PROCESSORS)) : 0;
+            float main_load = valid ? 100.0f * (main_time - last_main) / elapsed : 0;
+            last_idle = idle;
+            last_main = main_time;
+            last_total = total;
+            have_last = true;
+            if (valid) {
+                printf("BUTTON mode=%s cpu_busy=%.1f%% main_task=%.1f%% changes=%lu latency_mean_us=%lu latency_max_us=%lu\n",
+                       mode, busy, main_load, (unsigned long)latency.count, (unsigned long)mean_us, (unsigned long)latency.max_us);
+                continue;
+            }
+        }
+#endif
+        (void)main_task;
+        printf("BUTTON mode=%s cpu_busy=n/a changes=%lu latency_mean_us=%lu latency_max_us=%lu\n",
+               mode, (unsigned long)latency.count, (unsigned long)mean_us, (unsigned long)latency.max_us);
+    }
+}
+
 /* ##### END OF FILE ############### */
@@ -0,0 +1,186 @@
+/*
+ ******************************************************************************
+ * @file           : button.c
+ * @brief          : Interrupt driven push button with a debouncing timer
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - The first edge of a bounce masks the pin interrupt and starts the
+ *   debounce timer; the bounces that follow cost nothing. When it expires,
+ *   the timer samples the level, feeds it to the state machine and unmasks
+ *   the pin. A pulse shorter than the debounce time that ends at the old
+ *   level is no change.
+ * - A second timer runs while the button is held, for the long press.
+ * - Both timers are FreeRTOS software timers: their callbacks run one after
+ *   the other in the timer service task, so the state machine needs no lock,
+ *   and the ISR can restart one with xTimerChangePeriodFromISR. They count in
+ *   ticks, so the debounce time is rounded up to the tick period.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "button.h"
+
+#include "freertos/timers.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+/* Private types -------------------------------------------------------------*/
+typedef struct {
+    button_config_t config;
+    button_fsm_t fsm;
+    TimerHandle_t debounce_timer;
+    TimerHandle_t hold_timer;
+    TickType_t debounce_ticks;
+    volatile int64_t edge_us;       /* first edge, written by the ISR while the pin is unmasked */
+    volatile uint32_t dropped;
+    bool started;
+} button_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "button";
+static button_t s_button;
+
+/* Private functions ---------------------------------------------------------*/
+/* at least one tick, rounded up: a timer must not expire before the time asked for */
+static TickType_t ms_to_ticks(uint32_t ms)
+{
+    TickType_t ticks = ((uint64_t)ms * configTICK_RATE_HZ + 999) / 1000;
+    return ticks ? ticks : 1;
+}
+
+static bool sample_pressed(void)
+{
+    return gpio_get_level(s_button.config.gpio) == (s_button.config.active_low ? 0 : 1);
+}
+
+static void send_events(const button_event_type_t *types, size_t count, int64_t edge_us)
+{
+    int64_t now_us = esp_timer_get_time();
+    for (size_t i = 0; i < count; i++) {
+        button_event_t event = {
+            .type = types[i],
+            .edge_us = types[i] == BUTTON_EVENT_LONG_PRESS ? 0 : edge_us,
+            .event_us = now_us,
+        };
+        if (xQueueSend(s_button.config.queue, &event, 0) != pdTRUE) {
+            s_button.dropped++;
+        }
+    }
+}
+
+/* start (or keep) timing the long press if the state machine waits for one, else stop */
+static void arm_hold_timer(uint32_t now_ms)
+{
+    uint32_t due_ms = button_fsm_next_due_ms(&s_button.fsm, now_ms);
+    if (due_ms) {
+        xTimerChangePeriod(s_button.hold_timer, ms_to_ticks(due_ms), 0);
+    } else {
+        xTimerStop(s_button.hold_timer, 0);
+    }
+}
+
+static void button_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    /* mask the bounces, the debounce timer samples the settled level */
+    gpio_intr_disable(s_button.config.gpio);
+    s_button.edge_us = esp_timer_get_time();
+    if (xTimerChangePeriodFromISR(s_button.debounce_timer, s_button.debounce_ticks, &woken) != pdPASS) {
+        /* timer command queue full: leave this edge, the next one tries again */
+        gpio_intr_enable(s_button.config.gpio);
+    }
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static void debounce_timer_cb(TimerHandle_t timer)
+{
+    /* the pin is masked, the ISR doesn't touch edge_us until it is unmasked again */
+    int64_t edge_us = s_button.edge_us;
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    button_event_type_t types[BUTTON_FSM_MAX_EVENTS];
+    size_t count = button_fsm_update(&s_button.fsm, sample_pressed(), now_ms, types);
+    send_events(types, count, edge_us);
+    arm_hold_timer(now_ms);
+
+    gpio_intr_enable(s_button.config.gpio);
+    /* a change between the sample and the unmask raised no interrupt */
+    if (sample_pressed() != s_button.fsm.pressed) {
+        gpio_intr_disable(s_button.config.gpio);
+        s_button.edge_us = esp_timer_get_time();
+        xTimerChangePeriod(s_button.debounce_timer, s_button.debounce_ticks, 0);
+    }
+}
+
+static void hold_timer_cb(TimerHandle_t timer)
+{
+    /* only the time moves on; a level change goes through the debounce timer */
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    button_event_type_t types[BUTTON_FSM_MAX_EVENTS];
+    size_t count = button_fsm_update(&s_button.fsm, s_button.fsm.pressed, now_ms, types);
+    send_events(types, count, 0);
+    arm_hold_timer(now_ms);
+}
+
+
+esp_err_t button_start(const button_config_t *config)
+{
+    if (s_button.started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_button.config = *config;
+    s_button.debounce_ticks = ms_to_ticks(config->debounce_ms);
+    s_button.debounce_timer = xTimerCreate("btn_debounce", s_button.debounce_ticks, pdFALSE, NULL, debounce_timer_cb);
+    s_button.hold_timer = xTimerCreate("btn_hold", 1, pdFALSE, NULL, hold_timer_cb);
+    if (s_button.debounce_timer == NULL || s_button.hold_timer == NULL) {
+        ESP_LOGE(TAG, "no mem for the timers");
+        return ESP_ERR_NO_MEM;
+    }
+
+    const gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << config->gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = config->active_low ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+        .pull_down_en = config->active_low ? GPIO_PULLDOWN_DISABLE : GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_ANYEDGE,
+    };
+    esp_err_t err = gpio_config(&io_conf);
+    if (err != ESP_OK) {
+        return err;
+    }
+    const button_fsm_config_t fsm_config = {
+        .long_press_ms = config->long_press_ms,
+        .double_click_ms = config->double_click_ms,
+    };
+    button_fsm_init(&s_button.fsm, &fsm_config, sample_pressed());
+
+    /* already installed by another driver is fine */
+    err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return err;
+    }
+    err = gpio_isr_handler_add(config->gpio, button_isr, NULL);
+    if (err != ESP_OK) {
+        return err;
+    }
+    s_button.started = true;
+    ESP_LOGI(TAG, "Button on GPIO %d, debounce %lu ms (%lu ticks)", config->gpio,
+             (unsigned long)config->debounce_ms, (unsigned long)s_button.debounce_ticks);
+    return ESP_OK;
+}
+
+bool button_is_pressed(void)
+{
+    return s_button.fsm.pressed;
+}
+
+uint32_t button_dropped_events(void)
+{
+    return s_button.dropped;
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,60 @@
+/*
+ ******************************************************************************
+ * @file           : button.h
+ * @brief          : Header for button.c (interrupt driven push button)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - One push button on a GPIO. Edges raise an interrupt, a timer samples the
+ *   level once the contacts have settled, and button_fsm.c turns it into
+ *   events, which are sent to a queue. Between presses nothing runs.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "driver/gpio.h"
+#include "esp_err.h"
+#include "button_fsm.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct {
+    button_event_type_t type;
+    int64_t edge_us;        /* first edge of the press or release (esp_timer_get_time), 0 for a long press */
+    int64_t event_us;       /* when the debouncer sent the event */
+} button_event_t;
+
+typedef struct {
+    gpio_num_t gpio;
+    bool active_low;        /* pressed connects the pin to GND, with the internal pull-up; else to 3V3, with the pull-down */
+    uint32_t debounce_ms;   /* time the contacts get to settle after the first edge */
+    uint32_t long_press_ms; /* 0: no long press */
+    uint32_t double_click_ms; /* 0: no double click */
+    QueueHandle_t queue;    /* receives button_event_t, never blocks: events that don't fit are counted as dropped */
+} button_config_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Configure the GPIO and its interrupt and start sending events. One button only.
+  * @retval ESP_OK, ESP_ERR_INVALID_STATE if already started, ESP_ERR_NO_MEM, or the GPIO driver's error
+  */
+esp_err_t button_start(const button_config_t *config);
+
+/**
+  * @brief  Debounced state, as of the last event.
+  */
+bool button_is_pressed(void);
+
+/**
+  * @brief  Events lost because the queue was full.
+  */
+uint32_t button_dropped_events(void);
+
+/* ***** END OF FILE ******************************************************** */
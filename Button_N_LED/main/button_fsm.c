@@ -0,0 +1,95 @@
+/*
+ ******************************************************************************
+ * @file           : button_fsm.c
+ * @brief          : Push button events from the debounced level
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - PRESS and RELEASE come right with the level change, DOUBLE_CLICK comes
+ *   together with the second PRESS, so no event waits for the double click
+ *   time to run out.
+ * - A press that became a long press or the second of a double click doesn't
+ *   start a new click: a triple click is one double click.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "button_fsm.h"
+
+/* Private functions ---------------------------------------------------------*/
+static bool long_press_due(const button_fsm_t *fsm, uint32_t now_ms)
+{
+    return fsm->pressed && fsm->config.long_press_ms && !fsm->long_sent &&
+           now_ms - fsm->press_ms >= fsm->config.long_press_ms;
+}
+
+
+void button_fsm_init(button_fsm_t *fsm, const button_fsm_config_t *config, bool pressed)
+{
+    fsm->config = *config;
+    fsm->pressed = pressed;
+    /* a button held at start is not timed, its release starts nothing */
+    fsm->long_sent = pressed;
+    fsm->double_sent = false;
+    fsm->click_open = false;
+    fsm->press_ms = 0;
+    fsm->release_ms = 0;
+}
+
+size_t button_fsm_update(button_fsm_t *fsm, bool pressed, uint32_t now_ms, button_event_type_t events[BUTTON_FSM_MAX_EVENTS])
+{
+    size_t count = 0;
+    /* a late sample may find the long press overdue: it still comes before the release */
+    if (long_press_due(fsm, now_ms)) {
+        events[count++] = BUTTON_EVENT_LONG_PRESS;
+        fsm->long_sent = true;
+    }
+    if (pressed == fsm->pressed) {
+        return count;
+    }
+    fsm->pressed = pressed;
+    if (pressed) {
+        events[count++] = BUTTON_EVENT_PRESS;
+        fsm->press_ms = now_ms;
+        fsm->long_sent = false;
+        fsm->double_sent = fsm->click_open && fsm->config.double_click_ms &&
+                           now_ms - fsm->release_ms <= fsm->config.double_click_ms;
+        if (fsm->double_sent) {
+            events[count++] = BUTTON_EVENT_DOUBLE_CLICK;
+        }
+        fsm->click_open = false;
+    } else {
+        events[count++] = BUTTON_EVENT_RELEASE;
+        fsm->release_ms = now_ms;
+        fsm->click_open = !fsm->long_sent && !fsm->double_sent;
+    }
+    return count;
+}
+
+uint32_t button_fsm_next_due_ms(const button_fsm_t *fsm, uint32_t now_ms)
+{
+    if (!fsm->pressed || !fsm->config.long_press_ms || fsm->long_sent) {
+        return 0;
+    }
+    uint32_t held = now_ms - fsm->press_ms;
+    return held < fsm->config.long_press_ms ? fsm->config.long_press_ms - held : 1;
+}
+
+const char *button_event_name(button_event_type_t type)
+{
+    switch (type) {
+    case BUTTON_EVENT_PRESS:
+        return "press";
+    case BUTTON_EVENT_RELEASE:
+        return "release";
+    case BUTTON_EVENT_LONG_PRESS:
+        return "long press";
+    case BUTTON_EVENT_DOUBLE_CLICK:
+        return "double click";
+    }
+    return "?";
+}
+
+/* ***** END OF FILE ******************************************************** */
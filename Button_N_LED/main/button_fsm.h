@@ -0,0 +1,77 @@
+/*
+ ******************************************************************************
+ * @file           : button_fsm.h
+ * @brief          : Header for button_fsm.c (press, release, long press and double click)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Turns the debounced level of a push button into events. It is fed the
+ *   level sampled after the debounce time and the time of the sample, and
+ *   knows nothing about GPIOs or timers, so it runs on the host too.
+ * - A long press is timed: button_fsm_next_due_ms() tells when to call
+ *   button_fsm_update() again with the same level.
+ * - Times are milliseconds of a free running counter; only differences are
+ *   used, so the counter may wrap.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define BUTTON_FSM_MAX_EVENTS   2       /* one update emits at most press + double click, or long press + release */
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+    BUTTON_EVENT_PRESS,
+    BUTTON_EVENT_RELEASE,
+    BUTTON_EVENT_LONG_PRESS,            /* held for long_press_ms, once per press */
+    BUTTON_EVENT_DOUBLE_CLICK,          /* pressed within double_click_ms of the release of a short press */
+} button_event_type_t;
+
+typedef struct {
+    uint32_t long_press_ms;             /* 0: no long press */
+    uint32_t double_click_ms;           /* 0: no double click */
+} button_fsm_config_t;
+
+typedef struct {
+    button_fsm_config_t config;
+    bool pressed;                       /* debounced state */
+    bool long_sent;                     /* the current press has had its LONG_PRESS */
+    bool double_sent;                   /* the current press was the second of a double click */
+    bool click_open;                    /* the last press was a short one, released at release_ms */
+    uint32_t press_ms;
+    uint32_t release_ms;
+} button_fsm_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Start in the given state, without an event for it.
+  */
+void button_fsm_init(button_fsm_t *fsm, const button_fsm_config_t *config, bool pressed);
+
+/**
+  * @brief  Feed the debounced level at 'now_ms'.
+  * @param  events  receives the events, in order
+  * @retval number of events, 0..BUTTON_FSM_MAX_EVENTS
+  */
+size_t button_fsm_update(button_fsm_t *fsm, bool pressed, uint32_t now_ms, button_event_type_t events[BUTTON_FSM_MAX_EVENTS]);
+
+/**
+  * @brief  Milliseconds from 'now_ms' until the long press is due (at least 1),
+  *         0 if there is none to wait for.
+  */
+uint32_t button_fsm_next_due_ms(const button_fsm_t *fsm, uint32_t now_ms);
+
+/**
+  * @brief  Name of an event, for logs.
+  */
+const char *button_event_name(button_event_type_t type);
+
+/* ***** END OF FILE ******************************************************** */
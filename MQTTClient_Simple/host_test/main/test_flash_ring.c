@@ -0,0 +1,363 @@
+/*
+ ******************************************************************************
+ * @file           : test_flash_ring.c
+ * @brief          : Host test of flash_ring.c on a file-backed partition image
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - The image behaves like NOR flash: writes can only clear bits, erase sets
+ *   a sector to 0xFF.
+ * - Power loss: after a byte budget is used up, the write in progress stops
+ *   half-way and every further access fails until the image is "rebooted"
+ *   (mounted again).
+ * - Records carry a running id so loss, duplicates and reordering are visible.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "flash_ring.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SECTOR_SIZE     256
+#define SECTORS         8
+#define IMAGE_SIZE      (SECTOR_SIZE * SECTORS)
+#define MAX_IDS         4096
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    FILE *f;
+    long budget;            /* bytes that can still be written, < 0 = unlimited */
+    bool dead;              /* power is gone */
+    uint32_t erases[SECTORS];
+} sim_flash_t;
+
+/* Private variables ---------------------------------------------------------*/
+static sim_flash_t s_flash;
+static flash_ring_t s_ring;
+static uint8_t s_buf[SECTOR_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+static esp_err_t sim_read(void *ctx, size_t offset, void *dst, size_t len)
+{
+    sim_flash_t *sim = ctx;
+    if (sim->dead || offset + len > IMAGE_SIZE) {
+        return ESP_FAIL;
+    }
+    fseek(sim->f, (long)offset, SEEK_SET);
+    return fread(dst, 1, len, sim->f) == len ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t sim_write(void *ctx, size_t offset, const void *src, size_t len)
+{
+    sim_flash_t *sim = ctx;
+    const uint8_t *p = src;
+    uint8_t cells[SECTOR_SIZE];
+    if (sim->dead || len > sizeof(cells) || offset + len > IMAGE_SIZE) {
+        return ESP_FAIL;
+    }
+
+    // Only the bytes within the budget reach the flash
+    size_t done = (sim->budget < 0 || (size_t)sim->budget >= len) ? len : (size_t)sim->budget;
+    fseek(sim->f, (long)offset, SEEK_SET);
+    TEST_ASSERT_EQUAL(done, fread(cells, 1, done, sim->f));
+    for (size_t i = 0; i < done; i++) {
+        cells[i] &= p[i];
+    }
+    fseek(sim->f, (long)offset, SEEK_SET);
+    fwrite(cells, 1, done, sim->f);
+    if (sim->budget >= 0) {
+        sim->budget -= (long)done;
+    }
+    if (done < len) {
+        sim->dead = true;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t sim_erase_sector(void *ctx, size_t offset)
+{
+    sim_flash_t *sim = ctx;
+    if (sim->dead || offset % SECTOR_SIZE != 0 || offset >= IMAGE_SIZE) {
+        return ESP_FAIL;
+    }
+    uint8_t ff[SECTOR_SIZE];
+    memset(ff, 0xFF, sizeof(ff));
+    fseek(sim->f, (long)offset, SEEK_SET);
+    fwrite(ff, 1, sizeof(ff), sim->f);
+    sim->erases[offset / SECTOR_SIZE]++;
+    return ESP_OK;
+}
+
+static const flash_ring_io_t s_io = {
+    .read = sim_read,
+    .write = sim_write,
+    .erase_sector = sim_erase_sector,
+    .ctx = &s_flash,
+    .size = IMAGE_SIZE,
+    .sector_size = SECTOR_SIZE,
+};
+
+/* Fresh image, fully erased */
+static void image_create(void)
+{
+    if (s_flash.f) {
+        fclose(s_flash.f);
+    }
+    memset(&s_flash, 0, sizeof(s_flash));
+    s_flash.f = tmpfile();
+    TEST_ASSERT_NOT_NULL(s_flash.f);
+    for (size_t s = 0; s < SECTORS; s++) {
+        sim_erase_sector(&s_flash, s * SECTOR_SIZE);
+    }
+    memset(s_flash.erases, 0, sizeof(s_flash.erases));
+    s_flash.budget = -1;
+}
+
+/* Power comes back: mount again from what is in the image */
+static void reboot(void)
+{
+    s_flash.dead = false;
+    s_flash.budget = -1;
+    TEST_ASSERT_EQUAL(ESP_OK, flash_ring_mount(&s_ring, &s_io));
+}
+
+/* Record for 'id': 4-byte id followed by a pattern, length varies with id */
+static size_t make_record(uint32_t id, uint8_t *buf)
+{
+    size_t len = 4 + (id * 7) % 40;
+    memcpy(buf, &id, 4);
+    for (size_t i = 4; i < len; i++) {
+        buf[i] = (uint8_t)(id + i);
+    }
+    return len;
+}
+
+static esp_err_t append_id(uint32_t id)
+{
+    uint8_t rec[64];
+    return flash_ring_append(&s_ring, rec, make_record(id, rec));
+}
+
+/* Peek the oldest record, check its content and return its id */
+static uint32_t peek_id(void)
+{
+    size_t len = 0;
+    uint8_t expect[64];
+    TEST_ASSERT_EQUAL(ESP_OK, flash_ring_peek(&s_ring, s_buf, sizeof(s_buf), &len));
+    uint32_t id;
+    memcpy(&id, s_buf, 4);
+    TEST_ASSERT_EQUAL(make_record(id, expect), len);
+    TEST_ASSERT_EQUAL_MEMORY(expect, s_buf, len);
+    return id;
+}
+
+static void test_empty_image_is_formatted(void)
+{
+    size_t len;
+    image_create();
+    reboot();
+    TEST_ASSERT_EQUAL(0, flash_ring_count(&s_ring));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, flash_ring_peek(&s_ring, s_buf, sizeof(s_buf), &len));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, flash_ring_pop(&s_ring));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, flash_ring_append(&s_ring, s_buf, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, flash_ring_append(&s_ring, s_buf, flash_ring_max_record(&s_ring) + 1));
+    TEST_ASSERT_EQUAL(ESP_OK, flash_ring_append(&s_ring, s_buf, flash_ring_max_record(&s_ring)));
+}
+
+static void test_fifo_order_survives_remount(void)
+{
+    image_create();
+    reboot();
+    for (uint32_t id = 0; id < 20; id++) {
+        TEST_ASSERT_EQUAL(ESP_OK, append_id(id));
+    }
+    for (uint32_t id = 0; id < 5; id++) {
+        TEST_ASSERT_EQUAL(id, peek_id());
+        TEST_ASSERT_EQUAL(ESP_OK, flash_ring_pop(&s_ring));
+    }
+
+    reboot();
+    TEST_ASSERT_EQUAL(15, flash_ring_count(&s_ring));
+    TEST_ASSERT_EQUAL(5, peek_id());
+    TEST_ASSERT_EQUAL(ESP_OK, append_id(20));
+
+    reboot();
+    for (uint32_t id = 5; id <= 20; id++) {
+        TEST_ASSERT_EQUAL(id, peek_id());
+        TEST_ASSERT_EQUAL(ESP_OK, flash_ring_pop(&s_ring));
+    }
+    TEST_ASSERT_EQUAL(0, flash_ring_count(&s_ring));
+}
+
+static void test_full_ring_pushes_back(void)
+{
+    image_create();
+    reboot();
+
+    uint32_t id = 0;
+    while (append_id(id) == ESP_OK) {
+        id++;
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, append_id(id));
+    TEST_ASSERT_EQUAL(id, flash_ring_count(&s_ring));
+    TEST_ASSERT_TRUE(id > (SECTORS - 2) * SECTOR_SIZE / 64);
+
+    // Nothing was overwritten, and the rejected record is accepted once a sector is drained
+    uint32_t next_out = 0;
+    while (append_id(id) == ESP_ERR_NO_MEM) {
+        TEST_ASSERT_EQUAL(next_out, peek_id());
+        TEST_ASSERT_EQUAL(ESP_OK, flash_ring_pop(&s_ring));
+        next_out++;
+    }
+    id++;
+
+    reboot();
+    while (flash_ring_count(&s_ring) > 0) {
+        TEST_ASSERT_EQUAL(next_out, peek_id());
+        TEST_ASSERT_EQUAL(ESP_OK, flash_ring_pop(&s_ring));
+        next_out++;
+    }
+    TEST_ASSERT_EQUAL(id, next_out);
+}
+
+static void test_wrap_around_wears_sectors_evenly(void)
+{
+    image_create();
+    reboot();
+    uint32_t next_out = 0;
+    for (uint32_t id = 0; id < 5000; id++) {
+        TEST_ASSERT_EQUAL(ESP_OK, append_id(id));
+        if (flash_ring_count(&s_ring) > 10) {
+            TEST_ASSERT_EQUAL(next_out++, peek_id());
+            TEST_ASSERT_EQUAL(ESP_OK, flash_ring_pop(&s_ring));
+        }
+    }
+
+    uint32_t min = UINT32_MAX, max = 0;
+    for (size_t s = 0; s < SECTORS; s++) {
+        min = s_flash.erases[s] < min ? s_flash.erases[s] : min;
+        max = s_flash.erases[s] > max ? s_flash.erases[s] : max;
+    }
+    TEST_ASSERT_TRUE(min > 50);
+    TEST_ASSERT_TRUE(max - min <= 1);
+}
+
+/* Producer/consumer with random disconnects (no draining) and reboots in between */
+static void test_disconnect_cycles_lose_nothing(void)
+{
+    image_create();
+    reboot();
+    srand(42);
+
+    uint32_t next_in = 0, next_out = 0;
+    bool held = false;      /* producer holds next_in because the ring was full */
+    for (int cycle = 0; cycle < 300; cycle++) {
+        bool connected = rand() % 2;
+        int steps = rand() % 60;
+        for (int i = 0; i < steps; i++) {
+            esp_err_t err = append_id(next_in);
+            TEST_ASSERT_TRUE(err == ESP_OK || err == ESP_ERR_NO_MEM);
+            held = (err == ESP_ERR_NO_MEM);
+            if (!held) {
+                next_in++;
+            }
+            // Drain at a lower rate than production while online
+            if (connected && i % 2 == 0 && flash_ring_count(&s_ring) > 0) {
+                TEST_ASSERT_EQUAL(next_out++, peek_id());
+                TEST_ASSERT_EQUAL(ESP_OK, flash_ring_pop(&s_ring));
+            }
+        }
+        if (rand() % 4 == 0) {
+            reboot();
+        }
+        TEST_ASSERT_EQUAL(next_in - next_out, flash_ring_count(&s_ring));
+    }
+    (void)held;
+
+    while (flash_ring_count(&s_ring) > 0) {
+        TEST_ASSERT_EQUAL(next_out++, peek_id());
+        TEST_ASSERT_EQUAL(ESP_OK, flash_ring_pop(&s_ring));
+    }
+    TEST_ASSERT_EQUAL(next_in, next_out);
+}
+
+/*
+ * Cut power after every possible number of written bytes during a fixed
+ * workload. After the reboot the ring must hold exactly the records whose
+ * append returned ESP_OK and whose pop did not, in order. Only the record
+ * whose pop was interrupted may either still be there or be gone.
+ */
+static void test_power_loss_at_every_byte(void)
+{
+    static uint32_t expected[MAX_IDS];
+    long cut;
+
+    for (cut = 0; ; cut++) {
+        image_create();
+        reboot();
+        s_flash.budget = cut;
+
+        size_t head = 0, tail = 0;  /* expected[tail..head) acknowledged and pending */
+        bool pop_in_flight = false;
+        uint32_t id = 0;
+        while (id < 150) {
+            esp_err_t err = append_id(id);
+            bool pop = false;
+            if (err == ESP_OK) {
+                expected[head++] = id++;
+                pop = (id % 3 == 0);
+            } else if (err == ESP_ERR_NO_MEM) {
+                pop = true;         /* drain to make room, then retry the same id */
+            } else {
+                break;              /* power lost during the append */
+            }
+            if (pop && tail < head) {
+                if (flash_ring_pop(&s_ring) != ESP_OK) {
+                    pop_in_flight = true;
+                    break;
+                }
+                tail++;
+            }
+        }
+        if (!s_flash.dead) {
+            break;      /* workload finished within the budget: every cut point was covered */
+        }
+
+        reboot();
+        if (pop_in_flight && flash_ring_count(&s_ring) == head - tail - 1) {
+            tail++;     /* the interrupted pop took effect */
+        }
+        TEST_ASSERT_EQUAL(head - tail, flash_ring_count(&s_ring));
+        for (size_t i = tail; i < head; i++) {
+            TEST_ASSERT_EQUAL(expected[i], peek_id());
+            TEST_ASSERT_EQUAL(ESP_OK, flash_ring_pop(&s_ring));
+        }
+
+        // The ring stays usable after the power loss
+        TEST_ASSERT_EQUAL(ESP_OK, append_id(9999));
+        reboot();
+        TEST_ASSERT_EQUAL(9999, peek_id());
+    }
+    TEST_ASSERT_TRUE(cut > 2 * IMAGE_SIZE);
+}
+
+void test_flash_ring_run(void)
+{
+    RUN_TEST(test_empty_image_is_formatted);
+    RUN_TEST(test_fifo_order_survives_remount);
+    RUN_TEST(test_full_ring_pushes_back);
+    RUN_TEST(test_wrap_around_wears_sectors_evenly);
+    RUN_TEST(test_disconnect_cycles_lose_nothing);
+    RUN_TEST(test_power_loss_at_every_byte);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,123 @@
+/*
+ ******************************************************************************
+ * @file           : test_latency_stats.c
+ * @brief          : Host test for latency_stats.c
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Percentiles are checked on hand-computed sets and against a brute-force
+ *   nearest-rank definition on random samples.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "latency_stats.h"
+
+/* Private define ------------------------------------------------------------*/
+#define RANDOM_SAMPLES      997
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t s_samples[RANDOM_SAMPLES];
+static uint32_t s_copy[RANDOM_SAMPLES];
+
+/* Private functions ---------------------------------------------------------*/
+/* Nearest rank by definition: smallest sample with at least pct% of all samples <= it */
+static uint32_t brute_force_percentile(const uint32_t *v, size_t n, unsigned int pct)
+{
+    uint32_t best = UINT32_MAX;
+    for (size_t i = 0; i < n; i++) {
+        size_t at_or_below = 0;
+        for (size_t j = 0; j < n; j++) {
+            at_or_below += v[j] <= v[i];
+        }
+        if (at_or_below * 100 >= (size_t)pct * n && v[i] < best) {
+            best = v[i];
+        }
+    }
+    return best;
+}
+
+static void test_empty_set_summarizes_to_zero(void)
+{
+    latency_stats_t stats;
+    latency_summary_t sum;
+    latency_stats_init(&stats, s_samples, 4);
+    latency_stats_summarize(&stats, &sum);
+    TEST_ASSERT_EQUAL(0, sum.count);
+    TEST_ASSERT_EQUAL(0, sum.p50_us);
+    TEST_ASSERT_EQUAL(0, sum.max_us);
+}
+
+static void test_known_percentiles(void)
+{
+    latency_stats_t stats;
+    latency_summary_t sum;
+    latency_stats_init(&stats, s_samples, RANDOM_SAMPLES);
+    for (uint32_t v = 100; v >= 1; v--) {      // 1..100, added in reverse
+        latency_stats_add(&stats, v);
+    }
+    latency_stats_summarize(&stats, &sum);
+    TEST_ASSERT_EQUAL(100, sum.count);
+    TEST_ASSERT_EQUAL(1, sum.min_us);
+    TEST_ASSERT_EQUAL(50, sum.mean_us);
+    TEST_ASSERT_EQUAL(50, sum.p50_us);
+    TEST_ASSERT_EQUAL(90, sum.p90_us);
+    TEST_ASSERT_EQUAL(99, sum.p99_us);
+    TEST_ASSERT_EQUAL(100, sum.max_us);
+
+    latency_stats_reset(&stats);
+    latency_stats_add(&stats, 7);
+    latency_stats_summarize(&stats, &sum);
+    TEST_ASSERT_EQUAL(1, sum.count);
+    TEST_ASSERT_EQUAL(7, sum.p50_us);
+    TEST_ASSERT_EQUAL(7, sum.p99_us);
+}
+
+static void test_random_samples_match_definition(void)
+{
+    latency_stats_t stats;
+    latency_summary_t sum;
+    srand(42);
+    for (size_t n = 1; n <= RANDOM_SAMPLES; n += 83) {
+        latency_stats_init(&stats, s_samples, RANDOM_SAMPLES);
+        for (size_t i = 0; i < n; i++) {
+            s_copy[i] = (uint32_t)(rand() % 500);     // plenty of duplicates
+            latency_stats_add(&stats, s_copy[i]);
+        }
+        latency_stats_summarize(&stats, &sum);
+        TEST_ASSERT_EQUAL(brute_force_percentile(s_copy, n, 50), sum.p50_us);
+        TEST_ASSERT_EQUAL(brute_force_percentile(s_copy, n, 90), sum.p90_us);
+        TEST_ASSERT_EQUAL(brute_force_percentile(s_copy, n, 99), sum.p99_us);
+        TEST_ASSERT_EQUAL(brute_force_percentile(s_copy, n, 100), sum.max_us);
+    }
+}
+
+static void test_full_buffer_counts_overflow(void)
+{
+    latency_stats_t stats;
+    latency_stats_init(&stats, s_samples, 3);
+    for (uint32_t v = 0; v < 5; v++) {
+        latency_stats_add(&stats, v);
+    }
+    TEST_ASSERT_EQUAL(3, stats.count);
+    TEST_ASSERT_EQUAL(2, stats.overflow);
+    latency_stats_reset(&stats);
+    TEST_ASSERT_EQUAL(0, stats.count);
+    TEST_ASSERT_EQUAL(0, stats.overflow);
+}
+
+
+void test_latency_stats_run(void)
+{
+    RUN_TEST(test_empty_set_summarizes_to_zero);
+    RUN_TEST(test_known_percentiles);
+    RUN_TEST(test_random_samples_match_definition);
+    RUN_TEST(test_full_buffer_counts_overflow);
+}
+
+/* ***** END OF FILE ******************************************************** */
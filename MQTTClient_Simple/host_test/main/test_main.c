@@ -0,0 +1,31 @@
+/*
+ ******************************************************************************
+ * @file           : test_main.c
+ * @brief          : Host test entry point, runs all test groups
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include "unity.h"
+
+/* Exported functions prototypes ---------------------------------------------*/
+void test_flash_ring_run(void);
+void test_topic_router_run(void);
+void test_latency_stats_run(void);
+
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    test_flash_ring_run();
+    test_topic_router_run();
+    test_latency_stats_run();
+    UNITY_END();
+    exit(0);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,354 @@
+/*
+ ******************************************************************************
+ * @file           : test_topic_router.c
+ * @brief          : Host test and match benchmark for topic_router.c
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Results are cross-checked against a straightforward filter-by-filter
+ *   matcher on random filters and topics.
+ * - The benchmark routes topics against thousands of subscriptions and prints
+ *   the throughput of the trie and of the linear matcher (no pass/fail limit).
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "unity.h"
+#include "topic_router.h"
+
+/* Private define ------------------------------------------------------------*/
+#define RANDOM_FILTERS      400
+#define RANDOM_TOPICS       20000
+#define BENCH_SUBS          5000
+#define BENCH_TOPICS        1000
+#define BENCH_ROUNDS        200
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    int calls;
+    char topic[32];
+    char data[128];
+    size_t data_len;
+    const char *last_data;
+    size_t last_offset;
+} capture_t;
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t s_hits[BENCH_SUBS];
+static char s_filters[BENCH_SUBS][40];
+static char s_topics[BENCH_TOPICS][40];
+
+/* Private functions ---------------------------------------------------------*/
+/* Reference matcher: one filter against one NUL-terminated topic */
+static bool naive_match(const char *f, const char *t)
+{
+    if (t[0] == '$' && (f[0] == '+' || f[0] == '#')) {
+        return false;
+    }
+    bool t_done = false;
+    for (;;) {
+        size_t flen = strcspn(f, "/");
+        if (flen == 1 && f[0] == '#') {
+            return true;
+        }
+        if (t_done) {
+            return false;
+        }
+        size_t tlen = strcspn(t, "/");
+        if (!(flen == 1 && f[0] == '+') && (flen != tlen || memcmp(f, t, flen) != 0)) {
+            return false;
+        }
+        const char *f_next = f[flen] == '/' ? f + flen + 1 : NULL;
+        const char *t_next = t[tlen] == '/' ? t + tlen + 1 : NULL;
+        if (f_next == NULL) {
+            return t_next == NULL;
+        }
+        if (t_next == NULL) {
+            t_done = true;
+        } else {
+            t = t_next;
+        }
+        f = f_next;
+    }
+}
+
+static void count_handler(const topic_router_msg_t *msg, void *ctx)
+{
+    (void)msg;
+    s_hits[(uintptr_t)ctx]++;
+}
+
+static void capture_handler(const topic_router_msg_t *msg, void *ctx)
+{
+    capture_t *cap = ctx;
+    cap->calls++;
+    snprintf(cap->topic, sizeof(cap->topic), "%.*s", (int)msg->topic_len, msg->topic);
+    TEST_ASSERT_TRUE(msg->offset + msg->data_len <= sizeof(cap->data));
+    memcpy(cap->data + msg->offset, msg->data, msg->data_len);
+    cap->data_len = msg->offset + msg->data_len;
+    cap->last_data = msg->data;
+    cap->last_offset = msg->offset;
+}
+
+static int dispatch_str(topic_router_t *router, const char *topic, const char *data)
+{
+    return topic_router_dispatch(router, topic, strlen(topic), data, strlen(data), 0, strlen(data));
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void test_spec_examples(void)
+{
+    static const struct {
+        const char *filter;
+        const char *topic;
+        bool match;
+    } cases[] = {
+        { "sport/tennis/player1/#", "sport/tennis/player1", true },
+        { "sport/tennis/player1/#", "sport/tennis/player1/ranking", true },
+        { "sport/tennis/player1/#", "sport/tennis/player1/score/wimbledon", true },
+        { "sport/#", "sport", true },
+        { "#", "sport/tennis", true },
+        { "sport/tennis/+", "sport/tennis/player1", true },
+        { "sport/tennis/+", "sport/tennis/player1/ranking", false },
+        { "sport/+", "sport", false },
+        { "sport/+", "sport/", true },
+        { "+/+", "/finance", true },
+        { "/+", "/finance", true },
+        { "+", "/finance", false },
+        { "#", "$SYS/uptime", false },
+        { "+/uptime", "$SYS/uptime", false },
+        { "$SYS/#", "$SYS/uptime", true },
+        { "$SYS/+", "$SYS/uptime", true },
+        { "a//b", "a//b", true },
+        { "a/+/b", "a//b", true },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        topic_router_t *router = topic_router_create(0);
+        TEST_ASSERT_NOT_NULL(router);
+        memset(s_hits, 0, sizeof(s_hits));
+        TEST_ASSERT_EQUAL(ESP_OK, topic_router_add(router, cases[i].filter, 0, count_handler, (void *)0));
+        TEST_ASSERT_EQUAL(cases[i].match ? 1 : 0, dispatch_str(router, cases[i].topic, "x"));
+        TEST_ASSERT_EQUAL(cases[i].match ? 1 : 0, s_hits[0]);
+        TEST_ASSERT_EQUAL(cases[i].match, naive_match(cases[i].filter, cases[i].topic));
+        topic_router_destroy(router);
+    }
+}
+
+static void test_invalid_filters_are_rejected(void)
+{
+    static const char *bad[] = { "", "a/#/b", "a+", "a/b#", "#/a", "a/++" };
+    topic_router_t *router = topic_router_create(0);
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, topic_router_add(router, bad[i], 0, count_handler, NULL));
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, topic_router_add(router, "a", 0, NULL, NULL));
+    TEST_ASSERT_EQUAL(0, dispatch_str(router, "a", "x"));
+    topic_router_destroy(router);
+}
+
+static void test_random_filters_match_reference(void)
+{
+    static const char *levels[] = { "a", "b", "cc", "", "$s" };
+    static uint32_t expect[RANDOM_FILTERS];
+    topic_router_t *router = topic_router_create(0);
+    srand(7);
+
+    for (int i = 0; i < RANDOM_FILTERS; i++) {
+        char *f = s_filters[i];
+        int n = 1 + rand() % 4;
+        f[0] = '\0';
+        for (int l = 0; l < n; l++) {
+            int r = rand() % 10;
+            const char *lvl = (r < 2) ? "+" : (r == 2 && l == n - 1) ? "#" : levels[rand() % 4];
+            strcat(f, lvl);
+            if (l < n - 1) {
+                strcat(f, "/");
+            }
+        }
+        if (f[0] == '\0') {
+            strcpy(f, "a");     /* a filter may not be empty */
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, topic_router_add(router, f, 0, count_handler, (void *)(uintptr_t)i));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, topic_router_compile(router));
+
+    memset(s_hits, 0, sizeof(s_hits));
+    memset(expect, 0, sizeof(expect));
+    for (int t = 0; t < RANDOM_TOPICS; t++) {
+        char topic[40] = "";
+        int n = 1 + rand() % 5;
+        for (int l = 0; l < n; l++) {
+            strcat(topic, levels[rand() % 5]);
+            if (l < n - 1) {
+                strcat(topic, "/");
+            }
+        }
+        int matched = 0;
+        for (int i = 0; i < RANDOM_FILTERS; i++) {
+            if (naive_match(s_filters[i], topic)) {
+                expect[i]++;
+                matched++;
+            }
+        }
+        TEST_ASSERT_EQUAL(matched, dispatch_str(router, topic, "x"));
+    }
+    for (int i = 0; i < RANDOM_FILTERS; i++) {
+        TEST_ASSERT_EQUAL(expect[i], s_hits[i]);
+    }
+    topic_router_destroy(router);
+}
+
+static void test_single_fragment_is_not_copied(void)
+{
+    capture_t stream = { 0 }, whole = { 0 };
+    topic_router_t *router = topic_router_create(64);
+    TEST_ASSERT_EQUAL(ESP_OK, topic_router_add(router, "dev/+/cmd", 0, capture_handler, &stream));
+    TEST_ASSERT_EQUAL(ESP_OK, topic_router_add(router, "dev/#", TOPIC_ROUTER_FLAG_WHOLE, capture_handler, &whole));
+
+    static const char payload[] = "on";
+    TEST_ASSERT_EQUAL(2, topic_router_dispatch(router, "dev/7/cmd", 9, payload, 2, 0, 2));
+    TEST_ASSERT_EQUAL(1, stream.calls);
+    TEST_ASSERT_EQUAL(1, whole.calls);
+    TEST_ASSERT_TRUE(stream.last_data == payload);
+    TEST_ASSERT_TRUE(whole.last_data == payload);
+    TEST_ASSERT_EQUAL_STRING("dev/7/cmd", whole.topic);
+    topic_router_destroy(router);
+}
+
+static void test_fragments_are_streamed_or_reassembled(void)
+{
+    capture_t stream = { 0 }, whole = { 0 }, other = { 0 };
+    topic_router_t *router = topic_router_create(64);
+    TEST_ASSERT_EQUAL(ESP_OK, topic_router_add(router, "big/+", 0, capture_handler, &stream));
+    TEST_ASSERT_EQUAL(ESP_OK, topic_router_add(router, "big/#", TOPIC_ROUTER_FLAG_WHOLE, capture_handler, &whole));
+    TEST_ASSERT_EQUAL(ESP_OK, topic_router_add(router, "small", 0, capture_handler, &other));
+
+    // Like MQTT_EVENT_DATA: later fragments carry no topic
+    const char *msg = "0123456789";
+    TEST_ASSERT_EQUAL(2, topic_router_dispatch(router, "big/1", 5, msg, 4, 0, 10));
+    TEST_ASSERT_EQUAL(2, topic_router_dispatch(router, NULL, 0, msg + 4, 3, 4, 10));
+    TEST_ASSERT_EQUAL(0, whole.calls);
+    TEST_ASSERT_EQUAL(2, topic_router_dispatch(router, NULL, 0, msg + 7, 3, 7, 10));
+
+    TEST_ASSERT_EQUAL(3, stream.calls);
+    TEST_ASSERT_TRUE(stream.last_data == msg + 7);
+    TEST_ASSERT_EQUAL(7, stream.last_offset);
+    TEST_ASSERT_EQUAL_STRING("big/1", stream.topic);
+    TEST_ASSERT_EQUAL(10, stream.data_len);
+    TEST_ASSERT_EQUAL_MEMORY(msg, stream.data, 10);
+
+    TEST_ASSERT_EQUAL(1, whole.calls);
+    TEST_ASSERT_EQUAL_STRING("big/1", whole.topic);
+    TEST_ASSERT_EQUAL(10, whole.data_len);
+    TEST_ASSERT_EQUAL_MEMORY(msg, whole.data, 10);
+    TEST_ASSERT_EQUAL(0, other.calls);
+
+    // Fragments of an unrouted topic are ignored, a gap in the offsets is reported
+    TEST_ASSERT_EQUAL(0, topic_router_dispatch(router, "nobody", 6, msg, 4, 0, 10));
+    TEST_ASSERT_EQUAL(0, topic_router_dispatch(router, NULL, 0, msg + 4, 6, 4, 10));
+    TEST_ASSERT_EQUAL(2, topic_router_dispatch(router, "big/2", 5, msg, 4, 0, 10));
+    TEST_ASSERT_EQUAL(-1, topic_router_dispatch(router, NULL, 0, msg + 5, 5, 5, 10));
+    TEST_ASSERT_EQUAL(1, whole.calls);
+
+    // Payloads above the reassembly limit only reach the streaming handlers, which is reported
+    static char big[100];
+    stream.calls = 0;
+    TEST_ASSERT_EQUAL(-1, topic_router_dispatch(router, "big/3", 5, big, 50, 0, 100));
+    TEST_ASSERT_EQUAL(2, topic_router_dispatch(router, NULL, 0, big + 50, 50, 50, 100));
+    TEST_ASSERT_EQUAL(1, whole.calls);
+    TEST_ASSERT_EQUAL(2, stream.calls);
+    topic_router_destroy(router);
+}
+
+static void test_benchmark_thousands_of_subscriptions(void)
+{
+    topic_router_t *router = topic_router_create(0);
+    srand(99);
+
+    for (int i = 0; i < BENCH_SUBS; i++) {
+        switch (i % 4) {
+        case 0:
+            snprintf(s_filters[i], sizeof(s_filters[i]), "site/%d/dev/%d/temp", i % 50, i);
+            break;
+        case 1:
+            snprintf(s_filters[i], sizeof(s_filters[i]), "site/%d/dev/%d/+", i % 50, i);
+            break;
+        case 2:
+            snprintf(s_filters[i], sizeof(s_filters[i]), "site/+/dev/%d/#", i);
+            break;
+        default:
+            snprintf(s_filters[i], sizeof(s_filters[i]), "fleet/%d/#", i);
+            break;
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, topic_router_add(router, s_filters[i], 0, count_handler, (void *)(uintptr_t)i));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, topic_router_compile(router));
+
+    for (int t = 0; t < BENCH_TOPICS; t++) {
+        int i = rand() % BENCH_SUBS;
+        switch (t % 4) {
+        case 0:
+            snprintf(s_topics[t], sizeof(s_topics[t]), "site/%d/dev/%d/temp", i % 50, i);
+            break;
+        case 1:
+            snprintf(s_topics[t], sizeof(s_topics[t]), "site/%d/dev/%d/status", rand() % 50, i);
+            break;
+        case 2:
+            snprintf(s_topics[t], sizeof(s_topics[t]), "fleet/%d/gps/fix", i);
+            break;
+        default:
+            snprintf(s_topics[t], sizeof(s_topics[t]), "other/%d", i);
+            break;
+        }
+    }
+
+    uint64_t trie_matches = 0, naive_matches = 0;
+    double t0 = now_s();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int t = 0; t < BENCH_TOPICS; t++) {
+            trie_matches += (uint64_t)dispatch_str(router, s_topics[t], "1");
+        }
+    }
+    double trie_s = now_s() - t0;
+
+    t0 = now_s();
+    for (int t = 0; t < BENCH_TOPICS; t++) {
+        for (int i = 0; i < BENCH_SUBS; i++) {
+            naive_matches += naive_match(s_filters[i], s_topics[t]);
+        }
+    }
+    double naive_s = now_s() - t0;
+
+    TEST_ASSERT_EQUAL(naive_matches * BENCH_ROUNDS, trie_matches);
+    printf("topic_router: %d subscriptions, trie %.0f topics/s (%.2f us/topic), linear %.0f topics/s (%.2f us/topic)\n",
+           BENCH_SUBS, BENCH_ROUNDS * BENCH_TOPICS / trie_s, trie_s * 1e6 / (BENCH_ROUNDS * BENCH_TOPICS),
+           BENCH_TOPICS / naive_s, naive_s * 1e6 / BENCH_TOPICS);
+    topic_router_destroy(router);
+}
+
+void test_topic_router_run(void)
+{
+    RUN_TEST(test_spec_examples);
+    RUN_TEST(test_invalid_filters_are_rejected);
+    RUN_TEST(test_random_filters_match_reference);
+    RUN_TEST(test_single_fragment_is_not_copied);
+    RUN_TEST(test_fragments_are_streamed_or_reassembled);
+    RUN_TEST(test_benchmark_thousands_of_subscriptions);
+}
+
+/* ***** END OF FILE ******************************************************** */
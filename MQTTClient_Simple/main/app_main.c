@@ -18,6 +18,17 @@
  * 		3. Open sdkconfig
  * 			|- Go to Example Configuration > set Broker URL to 'mqtt://mqtt.eclipseprojects.io'
  * 			|- Go to Example Connection Condifuration > set WiFi SSID and Password
+ * 			|- Go to Telemetry Configuration > set batch window, max samples and QoS
+ * - Telemetry: call telemetry_add_sample() from any task; samples are published
+ *   as one packed message per window (see telemetry.h for the format).
+ * - Offline store: batches produced while disconnected are kept on the
+ *   'mqtt_store' partition (partitions.csv) and drained after reconnecting.
+ * - Incoming data: add a filter (wildcards allowed) and handler to s_routes;
+ *   topic_router.c dispatches MQTT_EVENT_DATA to it.
+ * - Benchmark: Benchmark Configuration > enable to measure round trip/ack
+ *   latency and msgs/s per QoS through a loopback topic (see mqtt_bench.h).
+ * - Resources: MQTT Client Configuration selects a profile for buffer sizes,
+ *   outbox cap, task and keepalive; the heap/stack report shows what is left.
  ******************************************************************************
 */
 
@@ -28,6 +39,8 @@
 #include <string.h>
 #include "esp_wifi.h"
 #include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_idf_version.h"
 #include "nvs_flash.h"
 #include "esp_event.h"
 #include "esp_netif.h"
@@ -44,16 +57,57 @@
 
 #include "esp_log.h"
 #include "mqtt_client.h"
+#include "telemetry.h"
+#include "offline_store.h"
+#include "topic_router.h"
+#if CONFIG_MQTT_BENCH
+#include "mqtt_bench.h"
+#endif
+
+
+/* Private define ------------------------------------------------------------*/
+#define MQTT_REASSEMBLY_MAX     1024    /* largest payload reassembled for TOPIC_ROUTER_FLAG_WHOLE handlers */
+#define MQTT_HEADER_MAX         9       /* PUBLISH fixed header, topic length and packet id */
+
+/* Core of the client task, as set in ESP-MQTT Configurations (-1 = no affinity) */
+#if CONFIG_MQTT_USE_CORE_1
+#define MQTT_TASK_CORE          1
+#elif CONFIG_MQTT_TASK_CORE_SELECTION_ENABLED
+#define MQTT_TASK_CORE          0
+#else
+#define MQTT_TASK_CORE          -1
+#endif
+
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    const char *filter;
+    int qos;
+    uint32_t flags;
+    topic_router_handler_t handler;
+} mqtt_route_t;
 
 
 /* Private variables ---------------------------------------------------------*/
 static const char *TAG = "MQTT_EXAMPLE";
+static topic_router_t *s_router;
+static esp_mqtt_client_handle_t s_client;
 
 
 /* Private function prototypes -----------------------------------------------*/
 static void log_error_if_nonzero(const char *message, int error_code);
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data);
 static void mqtt_app_start(void);
+static void apply_client_profile(esp_mqtt_client_config_t *cfg);
+static void resource_report_task(void *arg);
+static int stack_high_water(const char *task_name);
+static void print_data_handler(const topic_router_msg_t *msg, void *ctx);
+
+/* Subscriptions: each filter is subscribed on connect and its handler gets the matching MQTT_EVENT_DATA */
+static const mqtt_route_t s_routes[] = {
+    { "/topic/qos0", 0, 0, print_data_handler },
+    { "/topic/qos1", 1, 0, print_data_handler },
+};
 
 
 /**
@@ -67,12 +121,14 @@ void app_main(void)
     ESP_LOGI(TAG, "[APP] IDF version: %s", esp_get_idf_version());
 
     esp_log_level_set("*", ESP_LOG_INFO);
+#if CONFIG_MQTT_CLIENT_VERBOSE_LOGS
     esp_log_level_set("mqtt_client", ESP_LOG_VERBOSE);
     esp_log_level_set("MQTT_EXAMPLE", ESP_LOG_VERBOSE);
     esp_log_level_set("TRANSPORT_BASE", ESP_LOG_VERBOSE);
     esp_log_level_set("esp-tls", ESP_LOG_VERBOSE);
     esp_log_level_set("TRANSPORT", ESP_LOG_VERBOSE);
     esp_log_level_set("outbox", ESP_LOG_VERBOSE);
+#endif
 
     ESP_ERROR_CHECK(nvs_flash_init());
     ESP_ERROR_CHECK(esp_netif_init());
@@ -110,23 +166,31 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     esp_mqtt_event_handle_t event = event_data;
     esp_mqtt_client_handle_t client = event->client;
     int msg_id;
+    int matched;
     switch ((esp_mqtt_event_id_t)event_id) {
     case MQTT_EVENT_CONNECTED:
         ESP_LOGI(TAG, "MQTT_EVENT_CONNECTED");
+        telemetry_set_connected(true);
+#if CONFIG_MQTT_OFFLINE_STORE
+        offline_store_set_connected(true);
+#endif
         msg_id = esp_mqtt_client_publish(client, "/topic/qos1", "data_3", 0, 1, 0);
         ESP_LOGI(TAG, "sent publish successful, msg_id=%d", msg_id);
 
-        msg_id = esp_mqtt_client_subscribe(client, "/topic/qos0", 0);
-        ESP_LOGI(TAG, "sent subscribe successful, msg_id=%d", msg_id);
-
-        msg_id = esp_mqtt_client_subscribe(client, "/topic/qos1", 1);
-        ESP_LOGI(TAG, "sent subscribe successful, msg_id=%d", msg_id);
+        for (size_t i = 0; i < sizeof(s_routes) / sizeof(s_routes[0]); i++) {
+            msg_id = esp_mqtt_client_subscribe(client, s_routes[i].filter, s_routes[i].qos);
+            ESP_LOGI(TAG, "sent subscribe successful, msg_id=%d", msg_id);
+        }
 
         msg_id = esp_mqtt_client_unsubscribe(client, "/topic/qos1");
         ESP_LOGI(TAG, "sent unsubscribe successful, msg_id=%d", msg_id);
         break;
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGI(TAG, "MQTT_EVENT_DISCONNECTED");
+        telemetry_set_connected(false);
+#if CONFIG_MQTT_OFFLINE_STORE
+        offline_store_set_connected(false);
+#endif
         break;
 
     case MQTT_EVENT_SUBSCRIBED:
@@ -141,9 +205,16 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         ESP_LOGI(TAG, "MQTT_EVENT_PUBLISHED, msg_id=%d", event->msg_id);
         break;
     case MQTT_EVENT_DATA:
-        ESP_LOGI(TAG, "MQTT_EVENT_DATA");
-        printf("TOPIC=%.*s\r\n", event->topic_len, event->topic);
-        printf("DATA=%.*s\r\n", event->data_len, event->data);
+        // Large payloads arrive as several events; the router hands each fragment to the handlers
+        matched = topic_router_dispatch(s_router, event->topic, event->topic_len, event->data, event->data_len,
+                                        event->current_data_offset, event->total_data_len);
+        if (matched < 0) {
+            ESP_LOGW(TAG, "MQTT_EVENT_DATA not fully routed (offset %d of %d bytes, reassembly limit %d), topic=%.*s",
+                     event->current_data_offset, event->total_data_len, MQTT_REASSEMBLY_MAX,
+                     event->topic_len, event->topic);
+        } else if (matched == 0 && event->current_data_offset == 0) {
+            ESP_LOGD(TAG, "MQTT_EVENT_DATA without handler, topic=%.*s", event->topic_len, event->topic);
+        }
         break;
     case MQTT_EVENT_ERROR:
         ESP_LOGI(TAG, "MQTT_EVENT_ERROR");
@@ -161,6 +232,32 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     }
 }
 
+/* Apply the buffer/outbox/task/session settings of the selected CONFIG_MQTT_CLIENT_PROFILE_* */
+static void apply_client_profile(esp_mqtt_client_config_t *cfg)
+{
+    cfg->buffer.size = CONFIG_MQTT_CLIENT_BUFFER_SIZE;
+    cfg->buffer.out_size = CONFIG_MQTT_CLIENT_OUT_BUFFER_SIZE;
+    cfg->task.stack_size = CONFIG_MQTT_CLIENT_TASK_STACK_SIZE;
+    cfg->task.priority = CONFIG_MQTT_CLIENT_TASK_PRIORITY;
+    cfg->session.keepalive = CONFIG_MQTT_CLIENT_KEEPALIVE;
+    cfg->network.reconnect_timeout_ms = CONFIG_MQTT_CLIENT_RECONNECT_TIMEOUT_MS;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    cfg->outbox.limit = CONFIG_MQTT_CLIENT_OUTBOX_LIMIT;
+#elif CONFIG_MQTT_CLIENT_OUTBOX_LIMIT > 0
+    ESP_LOGW(TAG, "Outbox limit needs ESP-IDF 5.1, ignored");
+#endif
+
+    int batch_max = TELEMETRY_BATCH_HEADER_SIZE + TELEMETRY_BATCH_SAMPLE_SIZE * CONFIG_TELEMETRY_MAX_SAMPLES +
+                    (int)strlen(CONFIG_TELEMETRY_TOPIC) + MQTT_HEADER_MAX;
+    if (cfg->buffer.out_size < batch_max) {
+        ESP_LOGW(TAG, "Send buffer %d is smaller than a full telemetry batch (%d bytes)", cfg->buffer.out_size, batch_max);
+    }
+
+    ESP_LOGI(TAG, "Client profile: buffer=%d/%d outbox_limit=%d stack=%d prio=%d core=%d keepalive=%ds reconnect=%dms",
+             cfg->buffer.size, cfg->buffer.out_size, CONFIG_MQTT_CLIENT_OUTBOX_LIMIT, cfg->task.stack_size,
+             cfg->task.priority, MQTT_TASK_CORE, cfg->session.keepalive, cfg->network.reconnect_timeout_ms);
+}
+
 static void mqtt_app_start(void)
 {
     esp_mqtt_client_config_t mqtt_cfg = {
@@ -191,10 +288,91 @@ static void mqtt_app_start(void)
     }
 #endif /* CONFIG_BROKER_URL_FROM_STDIN */
 
+    s_router = topic_router_create(MQTT_REASSEMBLY_MAX);
+    if (s_router == NULL) {
+        ESP_LOGE(TAG, "Failed to create topic router");
+        abort();
+    }
+    for (size_t i = 0; i < sizeof(s_routes) / sizeof(s_routes[0]); i++) {
+        ESP_ERROR_CHECK(topic_router_add(s_router, s_routes[i].filter, s_routes[i].flags, s_routes[i].handler, NULL));
+    }
+#if CONFIG_MQTT_BENCH
+    ESP_ERROR_CHECK(mqtt_bench_register(s_router));
+#endif
+    ESP_ERROR_CHECK(topic_router_compile(s_router));
+
+    apply_client_profile(&mqtt_cfg);
+    size_t heap_before = esp_get_free_heap_size();
     esp_mqtt_client_handle_t client = esp_mqtt_client_init(&mqtt_cfg);
+    if (client == NULL) {
+        ESP_LOGE(TAG, "Failed to create MQTT client");
+        abort();
+    }
     /* The last argument may be used to pass data to the event handler, in this example mqtt_event_handler */
     esp_mqtt_client_register_event(client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
+#if CONFIG_MQTT_OFFLINE_STORE
+    // Publishes made while offline are kept on the 'mqtt_store' partition and sent after reconnecting.
+    // Mounted before the client starts, so the first MQTT_EVENT_CONNECTED already drains it
+    size_t heap_store = esp_get_free_heap_size();
+    ESP_ERROR_CHECK(offline_store_init(client));
+    heap_before -= heap_store - esp_get_free_heap_size();   // not part of the client's usage below
+#endif
+#if CONFIG_MQTT_BENCH
+    // Loopback latency/throughput run, results are printed as "BENCH ..." lines
+    ESP_ERROR_CHECK(mqtt_bench_start(client));
+#endif
     esp_mqtt_client_start(client);
+    ESP_LOGI(TAG, "MQTT client uses %d bytes of heap (buffers, task stack)", (int)(heap_before - esp_get_free_heap_size()));
+    s_client = client;
+
+    // Sensor samples go through the batched publisher instead of one publish per value
+    ESP_ERROR_CHECK(telemetry_start(client));
+
+#if CONFIG_MQTT_CLIENT_REPORT_INTERVAL_S > 0
+    if (xTaskCreate(resource_report_task, "mqtt_report", 2560, NULL, 1, NULL) != pdPASS) {
+        ESP_LOGW(TAG, "Failed to start resource report");
+    }
+#endif
+}
+
+/* Stack high-water mark of a task in bytes, -1 if there is no task with that name */
+static int stack_high_water(const char *task_name)
+{
+    TaskHandle_t task = xTaskGetHandle(task_name);
+    if (task == NULL) {
+        return -1;
+    }
+    return (int)(uxTaskGetStackHighWaterMark(task) * sizeof(StackType_t));
+}
+
+/**
+  * @brief  Log heap and stack high-water marks every CONFIG_MQTT_CLIENT_REPORT_INTERVAL_S.
+  *         The minimum free heap is what is left for other components (e.g. a web server).
+  */
+static void resource_report_task(void *arg)
+{
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_MQTT_CLIENT_REPORT_INTERVAL_S * 1000));
+        ESP_LOGI(TAG, "Heap: free=%u min_free=%u largest_block=%u internal_min_free=%u outbox=%d",
+                 (unsigned int)esp_get_free_heap_size(), (unsigned int)esp_get_minimum_free_heap_size(),
+                 (unsigned int)heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT),
+                 (unsigned int)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+                 esp_mqtt_client_get_outbox_size(s_client));
+        ESP_LOGI(TAG, "Stack free (high-water): mqtt_task=%d telemetry=%d offline_drain=%d mqtt_report=%d",
+                 stack_high_water("mqtt_task"), stack_high_water("telemetry"),
+                 stack_high_water("offline_drain"), stack_high_water("mqtt_report"));
+    }
+}
+
+/**
+  * @brief  Example handler: prints topic and data like the original example did.
+  */
+static void print_data_handler(const topic_router_msg_t *msg, void *ctx)
+{
+    if (msg->offset == 0) {
+        printf("TOPIC=%.*s\r\n", (int)msg->topic_len, msg->topic);
+    }
+    printf("DATA=%.*s\r\n", (int)msg->data_len, msg->data);
 }
 
 /* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,365 @@
+/*
+ ******************************************************************************
+ * @file           : flash_ring.c
+ * @brief          : Append-only record ring on raw flash
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Layout: every sector starts with { magic, seq }. The sector being written
+ *   has the highest seq; the pending data lives in the chain of sectors with
+ *   consecutive seq ending at it.
+ * - Record: { state, len, reserved, crc32 } followed by len bytes, padded to 4.
+ *   Append writes header (state erased), payload, then state VALID. Pop
+ *   overwrites state with CONSUMED. Both only clear bits, so no erase is
+ *   needed until the writer wraps around into the sector again.
+ * - A full ring rejects appends; the oldest data is never overwritten.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "flash_ring.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define SECTOR_MAGIC        0x4252514DU     /* "MQRB" */
+#define SECTOR_HDR_SIZE     sizeof(sector_hdr_t)
+#define REC_HDR_SIZE        sizeof(rec_hdr_t)
+#define REC_STATE_ERASED    0xFFFFFFFFU
+#define REC_STATE_VALID     0x0000FFFFU
+#define REC_STATE_CONSUMED  0x00000000U
+#define REC_LEN_ERASED      0xFFFFU
+#define ALIGN4(x)           (((x) + 3U) & ~(size_t)3U)
+#define REC_SIZE(len)       (REC_HDR_SIZE + ALIGN4(len))
+#define CRC_CHUNK           64
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+} sector_hdr_t;
+
+typedef struct {
+    uint32_t state;
+    uint16_t len;
+    uint16_t reserved;
+    uint32_t crc;
+} rec_hdr_t;
+
+typedef enum {
+    REC_VALID,      /* committed, not consumed */
+    REC_SKIP,       /* consumed or torn by power loss, size is known */
+    REC_END,        /* erased space: end of the data in this sector */
+    REC_BAD,        /* unreadable header: rest of the sector is unusable */
+} rec_kind_t;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, size_t len);
+static size_t sector_addr(const flash_ring_t *ring, size_t sector);
+static esp_err_t read_sector_hdr(const flash_ring_t *ring, size_t sector, sector_hdr_t *hdr);
+static esp_err_t open_sector(flash_ring_t *ring, size_t sector, uint32_t seq);
+static esp_err_t read_rec(const flash_ring_t *ring, size_t sector, size_t off, rec_hdr_t *hdr, rec_kind_t *kind);
+static esp_err_t advance_tail(flash_ring_t *ring);
+
+
+esp_err_t flash_ring_mount(flash_ring_t *ring, const flash_ring_io_t *io)
+{
+    if (ring == NULL || io == NULL || io->read == NULL || io->write == NULL || io->erase_sector == NULL ||
+        io->sector_size < 64 || io->sector_size % 4 != 0 || io->size % io->sector_size != 0 ||
+        io->size / io->sector_size < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    ring->io = *io;
+    ring->sectors = io->size / io->sector_size;
+
+    // The head is the valid sector with the newest sequence number
+    bool found = false;
+    sector_hdr_t shdr;
+    for (size_t s = 0; s < ring->sectors; s++) {
+        esp_err_t err = read_sector_hdr(ring, s, &shdr);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (shdr.magic == SECTOR_MAGIC && (!found || (int32_t)(shdr.seq - ring->head_seq) > 0)) {
+            found = true;
+            ring->head_sector = s;
+            ring->head_seq = shdr.seq;
+        }
+    }
+    if (!found) {
+        esp_err_t err = open_sector(ring, 0, 1);
+        if (err == ESP_OK) {
+            ring->tail_off = ring->head_off;
+        }
+        return err;
+    }
+
+    // Walk back over sectors written just before the head to find the oldest one
+    size_t first = ring->head_sector;
+    for (size_t k = 1; k < ring->sectors; k++) {
+        size_t s = (ring->head_sector + ring->sectors - k) % ring->sectors;
+        esp_err_t err = read_sector_hdr(ring, s, &shdr);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (shdr.magic != SECTOR_MAGIC || shdr.seq != ring->head_seq - k) {
+            break;
+        }
+        first = s;
+    }
+
+    // Count pending records oldest first and find the write position in the head sector.
+    // CRCs are checked lazily by flash_ring_peek().
+    for (size_t s = first; ; s = (s + 1) % ring->sectors) {
+        size_t off = SECTOR_HDR_SIZE;
+        for (;;) {
+            rec_hdr_t hdr;
+            rec_kind_t kind;
+            esp_err_t err = read_rec(ring, s, off, &hdr, &kind);
+            if (err != ESP_OK) {
+                return err;
+            }
+            if (kind == REC_END || kind == REC_BAD) {
+                if (s == ring->head_sector) {
+                    ring->head_off = (kind == REC_END) ? off : ring->io.sector_size;
+                }
+                break;
+            }
+            if (kind == REC_VALID) {
+                if (ring->count == 0) {
+                    ring->tail_sector = s;
+                    ring->tail_off = off;
+                }
+                ring->count++;
+            }
+            off += REC_SIZE(hdr.len);
+        }
+        if (s == ring->head_sector) {
+            break;
+        }
+    }
+
+    if (ring->count == 0) {
+        ring->tail_sector = ring->head_sector;
+        ring->tail_off = ring->head_off;
+    }
+    return ESP_OK;
+}
+
+esp_err_t flash_ring_append(flash_ring_t *ring, const void *data, size_t len)
+{
+    if (len == 0 || len > flash_ring_max_record(ring)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (ring->head_off + REC_SIZE(len) > ring->io.sector_size) {
+        size_t next = (ring->head_sector + 1) % ring->sectors;
+        if (ring->count > 0 && ring->tail_sector == next) {
+            return ESP_ERR_NO_MEM;
+        }
+        esp_err_t err = open_sector(ring, next, ring->head_seq + 1);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    size_t off = ring->head_off;
+    size_t addr = sector_addr(ring, ring->head_sector) + off;
+    // The space is used up even if a write below fails, so the next record never overlaps it
+    ring->head_off += REC_SIZE(len);
+
+    rec_hdr_t hdr = {
+        .state = REC_STATE_ERASED,
+        .len = (uint16_t)len,
+        .reserved = 0xFFFF,
+        .crc = crc32_update(0, data, len),
+    };
+    esp_err_t err = ring->io.write(ring->io.ctx, addr, &hdr, sizeof(hdr));
+    if (err == ESP_OK) {
+        err = ring->io.write(ring->io.ctx, addr + REC_HDR_SIZE, data, len);
+    }
+    if (err == ESP_OK) {
+        // Commit: only now does the record survive a reboot
+        uint32_t state = REC_STATE_VALID;
+        err = ring->io.write(ring->io.ctx, addr, &state, sizeof(state));
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (ring->count == 0) {
+        ring->tail_sector = ring->head_sector;
+        ring->tail_off = off;
+    }
+    ring->count++;
+    return ESP_OK;
+}
+
+esp_err_t flash_ring_peek(flash_ring_t *ring, void *buf, size_t buf_size, size_t *len)
+{
+    while (ring->count > 0) {
+        rec_hdr_t hdr;
+        size_t addr = sector_addr(ring, ring->tail_sector) + ring->tail_off;
+        esp_err_t err = ring->io.read(ring->io.ctx, addr, &hdr, sizeof(hdr));
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (hdr.len > buf_size) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        err = ring->io.read(ring->io.ctx, addr + REC_HDR_SIZE, buf, hdr.len);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (crc32_update(0, buf, hdr.len) == hdr.crc) {
+            *len = hdr.len;
+            return ESP_OK;
+        }
+        // Corrupted record: drop it and try the next one
+        err = flash_ring_pop(ring);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t flash_ring_pop(flash_ring_t *ring)
+{
+    if (ring->count == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint32_t state = REC_STATE_CONSUMED;
+    esp_err_t err = ring->io.write(ring->io.ctx, sector_addr(ring, ring->tail_sector) + ring->tail_off,
+                                   &state, sizeof(state));
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    ring->count--;
+    if (ring->count == 0) {
+        ring->tail_sector = ring->head_sector;
+        ring->tail_off = ring->head_off;
+        return ESP_OK;
+    }
+    return advance_tail(ring);
+}
+
+uint32_t flash_ring_count(const flash_ring_t *ring)
+{
+    return ring->count;
+}
+
+size_t flash_ring_max_record(const flash_ring_t *ring)
+{
+    size_t max = ring->io.sector_size - SECTOR_HDR_SIZE - REC_HDR_SIZE;
+    return max < REC_LEN_ERASED ? max : REC_LEN_ERASED - 1;
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, size_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+static size_t sector_addr(const flash_ring_t *ring, size_t sector)
+{
+    return sector * ring->io.sector_size;
+}
+
+static esp_err_t read_sector_hdr(const flash_ring_t *ring, size_t sector, sector_hdr_t *hdr)
+{
+    return ring->io.read(ring->io.ctx, sector_addr(ring, sector), hdr, sizeof(*hdr));
+}
+
+static esp_err_t open_sector(flash_ring_t *ring, size_t sector, uint32_t seq)
+{
+    esp_err_t err = ring->io.erase_sector(ring->io.ctx, sector_addr(ring, sector));
+    if (err != ESP_OK) {
+        return err;
+    }
+    // Magic last, so a header torn by power loss is never taken for a valid one
+    sector_hdr_t hdr = { .magic = SECTOR_MAGIC, .seq = seq };
+    err = ring->io.write(ring->io.ctx, sector_addr(ring, sector) + offsetof(sector_hdr_t, seq), &hdr.seq, sizeof(hdr.seq));
+    if (err == ESP_OK) {
+        err = ring->io.write(ring->io.ctx, sector_addr(ring, sector), &hdr.magic, sizeof(hdr.magic));
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    ring->head_sector = sector;
+    ring->head_seq = seq;
+    ring->head_off = SECTOR_HDR_SIZE;
+    return ESP_OK;
+}
+
+static esp_err_t read_rec(const flash_ring_t *ring, size_t sector, size_t off, rec_hdr_t *hdr, rec_kind_t *kind)
+{
+    if (off + REC_HDR_SIZE > ring->io.sector_size) {
+        *kind = REC_END;
+        return ESP_OK;
+    }
+    esp_err_t err = ring->io.read(ring->io.ctx, sector_addr(ring, sector) + off, hdr, sizeof(*hdr));
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (hdr->len == REC_LEN_ERASED && hdr->state == REC_STATE_ERASED) {
+        *kind = REC_END;
+    } else if (hdr->len == 0 || hdr->len > flash_ring_max_record(ring) ||
+               off + REC_SIZE(hdr->len) > ring->io.sector_size) {
+        *kind = REC_BAD;
+    } else if (hdr->state == REC_STATE_VALID) {
+        *kind = REC_VALID;
+    } else {
+        *kind = REC_SKIP;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t advance_tail(flash_ring_t *ring)
+{
+    size_t sector = ring->tail_sector;
+    rec_hdr_t hdr;
+    rec_kind_t kind;
+    esp_err_t err = ring->io.read(ring->io.ctx, sector_addr(ring, sector) + ring->tail_off, &hdr, sizeof(hdr));
+    if (err != ESP_OK) {
+        return err;
+    }
+    size_t off = ring->tail_off + REC_SIZE(hdr.len);
+
+    // count > 0, so a valid record exists between here and the head
+    for (size_t visited = 0; visited <= ring->sectors; ) {
+        err = read_rec(ring, sector, off, &hdr, &kind);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (kind == REC_VALID) {
+            ring->tail_sector = sector;
+            ring->tail_off = off;
+            return ESP_OK;
+        }
+        if (kind == REC_SKIP) {
+            off += REC_SIZE(hdr.len);
+        } else {
+            sector = (sector + 1) % ring->sectors;
+            off = SECTOR_HDR_SIZE;
+            visited++;
+        }
+    }
+    return ESP_ERR_INVALID_STATE;
+}
+
+/* ***** END OF FILE ******************************************************** */
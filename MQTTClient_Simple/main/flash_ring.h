@@ -0,0 +1,90 @@
+/*
+ ******************************************************************************
+ * @file           : flash_ring.h
+ * @brief          : Header for flash_ring.c (append-only record ring on raw flash)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - FIFO of variable-length records stored in a flash region (e.g. a data
+ *   partition). Storage is accessed through flash_ring_io_t only, so the same
+ *   code runs on a partition on target and on a file image in the host test.
+ * - Sectors are used strictly in turn, so every sector is erased equally often.
+ * - Each record carries a CRC. A record torn by power loss is skipped on the
+ *   next mount; a record counts as stored only once flash_ring_append() returned ESP_OK.
+ * - Not thread-safe, callers serialize access.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Flash access. Writes may only clear bits (NOR semantics), erase sets a sector to 0xFF. */
+typedef struct {
+    esp_err_t (*read)(void *ctx, size_t offset, void *dst, size_t len);
+    esp_err_t (*write)(void *ctx, size_t offset, const void *src, size_t len);
+    esp_err_t (*erase_sector)(void *ctx, size_t offset);
+    void *ctx;
+    size_t size;            /* multiple of sector_size, at least 2 sectors */
+    size_t sector_size;
+} flash_ring_io_t;
+
+typedef struct {
+    flash_ring_io_t io;
+    size_t sectors;
+    uint32_t head_seq;      /* sequence number of the sector being written */
+    size_t head_sector;
+    size_t head_off;        /* next free byte in head_sector */
+    size_t tail_sector;     /* oldest pending record, valid if count > 0 */
+    size_t tail_off;
+    uint32_t count;         /* pending records */
+} flash_ring_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Scan the region and restore head/tail; formats it if it holds no ring.
+  * @param  ring  ring object to initialise
+  * @param  io    storage access, copied into the ring
+  * @retval ESP_OK, ESP_ERR_INVALID_ARG or the io error
+  */
+esp_err_t flash_ring_mount(flash_ring_t *ring, const flash_ring_io_t *io);
+
+/**
+  * @brief  Append one record.
+  * @retval ESP_OK, ESP_ERR_INVALID_SIZE (0 or > flash_ring_max_record()),
+  *         ESP_ERR_NO_MEM (ring full, nothing is overwritten) or the io error
+  */
+esp_err_t flash_ring_append(flash_ring_t *ring, const void *data, size_t len);
+
+/**
+  * @brief  Copy the oldest record without removing it. Records failing their CRC are discarded.
+  * @param  buf       destination
+  * @param  buf_size  size of buf
+  * @param  len       set to the record length
+  * @retval ESP_OK, ESP_ERR_NOT_FOUND (empty), ESP_ERR_INVALID_SIZE (buf too small) or the io error
+  */
+esp_err_t flash_ring_peek(flash_ring_t *ring, void *buf, size_t buf_size, size_t *len);
+
+/**
+  * @brief  Remove the oldest record (the one returned by flash_ring_peek()).
+  * @retval ESP_OK, ESP_ERR_NOT_FOUND (empty) or the io error
+  */
+esp_err_t flash_ring_pop(flash_ring_t *ring);
+
+/**
+  * @brief  Number of pending records.
+  */
+uint32_t flash_ring_count(const flash_ring_t *ring);
+
+/**
+  * @brief  Largest record flash_ring_append() accepts.
+  */
+size_t flash_ring_max_record(const flash_ring_t *ring);
+
+/* ***** END OF FILE ******************************************************** */
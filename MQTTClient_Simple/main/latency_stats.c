@@ -0,0 +1,80 @@
+/*
+ ******************************************************************************
+ * @file           : latency_stats.c
+ * @brief          : Latency samples and percentiles for the MQTT benchmark
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Samples are kept raw (a few hundred per run) and sorted once for the
+ *   summary, so percentiles are exact, not bucketed.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "latency_stats.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Private functions ---------------------------------------------------------*/
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+
+void latency_stats_init(latency_stats_t *stats, uint32_t *buf, size_t capacity)
+{
+    stats->samples = buf;
+    stats->capacity = capacity;
+    latency_stats_reset(stats);
+}
+
+void latency_stats_reset(latency_stats_t *stats)
+{
+    stats->count = 0;
+    stats->overflow = 0;
+}
+
+void latency_stats_add(latency_stats_t *stats, uint32_t us)
+{
+    if (stats->count < stats->capacity) {
+        stats->samples[stats->count++] = us;
+    } else {
+        stats->overflow++;
+    }
+}
+
+uint32_t latency_stats_percentile(const uint32_t *sorted, size_t count, unsigned int pct)
+{
+    size_t rank = ((size_t)pct * count + 99) / 100;      /* ceil(pct / 100 * count) */
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+void latency_stats_summarize(latency_stats_t *stats, latency_summary_t *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    size_t n = stats->count;
+    if (n == 0) {
+        return;
+    }
+
+    qsort(stats->samples, n, sizeof(uint32_t), cmp_u32);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += stats->samples[i];
+    }
+    summary->count = n;
+    summary->min_us = stats->samples[0];
+    summary->max_us = stats->samples[n - 1];
+    summary->mean_us = (uint32_t)(sum / n);
+    summary->p50_us = latency_stats_percentile(stats->samples, n, 50);
+    summary->p90_us = latency_stats_percentile(stats->samples, n, 90);
+    summary->p99_us = latency_stats_percentile(stats->samples, n, 99);
+}
+
+/* ***** END OF FILE ******************************************************** */
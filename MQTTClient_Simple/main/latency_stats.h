@@ -0,0 +1,70 @@
+/*
+ ******************************************************************************
+ * @file           : latency_stats.h
+ * @brief          : Header for latency_stats.c (latency samples and percentiles)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Collects latency samples (microseconds) in a caller-provided buffer and
+ *   summarizes them as min/mean/max and nearest-rank percentiles.
+ * - No locking: the caller serializes add and summarize.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct {
+    uint32_t *samples;
+    size_t capacity;
+    size_t count;
+    uint32_t overflow;      /* samples not stored because the buffer was full */
+} latency_stats_t;
+
+typedef struct {
+    size_t count;
+    uint32_t min_us;
+    uint32_t mean_us;
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} latency_summary_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Start an empty sample set on 'buf' (capacity entries).
+  */
+void latency_stats_init(latency_stats_t *stats, uint32_t *buf, size_t capacity);
+
+/**
+  * @brief  Drop all samples, keep the buffer.
+  */
+void latency_stats_reset(latency_stats_t *stats);
+
+/**
+  * @brief  Add one sample; counted in 'overflow' if the buffer is full.
+  */
+void latency_stats_add(latency_stats_t *stats, uint32_t us);
+
+/**
+  * @brief  Summarize the samples. Sorts the buffer in place; all fields are 0 if it is empty.
+  */
+void latency_stats_summarize(latency_stats_t *stats, latency_summary_t *summary);
+
+/**
+  * @brief  Nearest-rank percentile of sorted samples (the smallest value with at
+  *         least 'pct' percent of the samples at or below it).
+  * @param  sorted  samples in ascending order
+  * @param  count   number of samples, > 0
+  * @param  pct     1..100
+  */
+uint32_t latency_stats_percentile(const uint32_t *sorted, size_t count, unsigned int pct);
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,352 @@
+/*
+ ******************************************************************************
+ * @file           : mqtt_bench.c
+ * @brief          : MQTT loopback latency probe and throughput benchmark
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Echoes arrive through the topic router and acks through the client event
+ *   loop, both in the MQTT task. They are timestamped there and the benchmark
+ *   task is woken with a task notification.
+ * - Every phase gets a new run id, so late echoes of an earlier phase (or an
+ *   earlier QoS) are ignored.
+ * - Needs a broker that forwards to the publishing client itself (any real
+ *   broker, or telemetry_broker_stub.py on the host for CI).
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "mqtt_bench.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "latency_stats.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_MAGIC             0x5042514DU     /* "MQBP" */
+#define BENCH_NOTIFY_ECHO       (1U << 0)
+#define BENCH_NOTIFY_ACK        (1U << 1)
+#define BENCH_NOTIFY_CONNECTED  (1U << 2)
+#define BENCH_SETTLE_MS         1000            /* let the example's own subscribes finish first */
+#define BENCH_WARMUP_TRIES      5
+#define BENCH_RETRY_MS          10
+#define BENCH_TIMEOUT_TICKS     pdMS_TO_TICKS(CONFIG_MQTT_BENCH_TIMEOUT_MS)
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "mqtt_bench";
+static esp_mqtt_client_handle_t s_client;
+static TaskHandle_t s_task;
+static SemaphoreHandle_t s_lock;
+static atomic_bool s_connected;
+static uint8_t *s_payload;
+static uint32_t s_run_counter;
+
+/* Current phase, written by the benchmark task and read by the MQTT task (s_lock) */
+static uint32_t s_run;                  /* 0 = no phase running */
+static bool s_record_rtt;
+static uint32_t s_received;             /* echoes of the current run */
+static uint32_t s_last_seq;
+static int64_t s_last_rx_us;
+static int s_acked_msg_id = -1;         /* last MQTT_EVENT_PUBLISHED */
+static int64_t s_acked_us;
+static latency_stats_t s_rtt;
+static latency_stats_t s_ack;
+
+/* Private function prototypes -----------------------------------------------*/
+static void bench_echo_handler(const topic_router_msg_t *msg, void *ctx);
+static void bench_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data);
+static void mqtt_bench_task(void *param);
+static uint32_t bench_begin_phase(bool record_rtt);
+static void bench_end_phase(void);
+static int bench_publish_probe(uint32_t run, uint32_t seq, int qos, int64_t *sent_us);
+static bool bench_warmup(int qos);
+static void bench_latency(int qos);
+static void bench_throughput(int qos);
+static void bench_print_summary(int qos, const char *what, latency_stats_t *stats, uint32_t lost);
+
+
+esp_err_t mqtt_bench_register(topic_router_t *router)
+{
+    return topic_router_add(router, CONFIG_MQTT_BENCH_TOPIC, 0, bench_echo_handler, NULL);
+}
+
+esp_err_t mqtt_bench_start(esp_mqtt_client_handle_t client)
+{
+    s_client = client;
+    s_lock = xSemaphoreCreateMutex();
+    s_payload = calloc(1, CONFIG_MQTT_BENCH_PAYLOAD_SIZE);
+    uint32_t *rtt_buf = malloc(CONFIG_MQTT_BENCH_PROBES * sizeof(uint32_t));
+    uint32_t *ack_buf = malloc(CONFIG_MQTT_BENCH_PROBES * sizeof(uint32_t));
+    if (s_lock == NULL || s_payload == NULL || rtt_buf == NULL || ack_buf == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    latency_stats_init(&s_rtt, rtt_buf, CONFIG_MQTT_BENCH_PROBES);
+    latency_stats_init(&s_ack, ack_buf, CONFIG_MQTT_BENCH_PROBES);
+
+    if (xTaskCreate(mqtt_bench_task, "mqtt_bench", 4096, NULL, 5, &s_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_mqtt_client_register_event(client, ESP_EVENT_ANY_ID, bench_event_handler, NULL);
+    return ESP_OK;
+}
+
+/* Topic router handler (MQTT task): timestamp the echo of a probe */
+static void bench_echo_handler(const topic_router_msg_t *msg, void *ctx)
+{
+    int64_t now = esp_timer_get_time();
+    if (msg->offset != 0 || msg->data_len < MQTT_BENCH_PROBE_HEADER_SIZE) {
+        return;
+    }
+    uint32_t magic, run, seq;
+    int64_t sent_us;
+    memcpy(&magic, &msg->data[0], sizeof(magic));
+    memcpy(&run, &msg->data[4], sizeof(run));
+    memcpy(&seq, &msg->data[8], sizeof(seq));
+    memcpy(&sent_us, &msg->data[12], sizeof(sent_us));
+    if (magic != BENCH_MAGIC) {
+        return;
+    }
+
+    bool notify = false;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (run != 0 && run == s_run) {
+        s_received++;
+        s_last_seq = seq;
+        s_last_rx_us = now;
+        if (s_record_rtt) {
+            latency_stats_add(&s_rtt, (uint32_t)(now - sent_us));
+        }
+        notify = true;
+    }
+    xSemaphoreGive(s_lock);
+    if (notify) {
+        xTaskNotify(s_task, BENCH_NOTIFY_ECHO, eSetBits);
+    }
+}
+
+/* Client event handler (MQTT task): connection state and publish acks */
+static void bench_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    esp_mqtt_event_handle_t event = event_data;
+    switch ((esp_mqtt_event_id_t)event_id) {
+    case MQTT_EVENT_CONNECTED:
+        atomic_store(&s_connected, true);
+        xTaskNotify(s_task, BENCH_NOTIFY_CONNECTED, eSetBits);
+        break;
+    case MQTT_EVENT_DISCONNECTED:
+        atomic_store(&s_connected, false);
+        break;
+    case MQTT_EVENT_PUBLISHED:
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_acked_msg_id = event->msg_id;
+        s_acked_us = esp_timer_get_time();
+        xSemaphoreGive(s_lock);
+        xTaskNotify(s_task, BENCH_NOTIFY_ACK, eSetBits);
+        break;
+    default:
+        break;
+    }
+}
+
+static void mqtt_bench_task(void *param)
+{
+    while (!atomic_load(&s_connected)) {
+        xTaskNotifyWait(0, UINT32_MAX, NULL, portMAX_DELAY);
+    }
+    vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+    printf("BENCH start topic=%s payload=%d probes=%d window=%d duration=%ds\n", CONFIG_MQTT_BENCH_TOPIC,
+           CONFIG_MQTT_BENCH_PAYLOAD_SIZE, CONFIG_MQTT_BENCH_PROBES, CONFIG_MQTT_BENCH_WINDOW,
+           CONFIG_MQTT_BENCH_DURATION_S);
+
+    for (int qos = 0; qos <= 2; qos++) {
+        // Subscribing with the probe QoS makes the echo use it too (the broker delivers at min(pub, sub))
+        if (esp_mqtt_client_subscribe(s_client, CONFIG_MQTT_BENCH_TOPIC, qos) < 0 || !bench_warmup(qos)) {
+            ESP_LOGE(TAG, "QoS %d: no echo from broker, skipped", qos);
+            printf("BENCH qos=%d error=no_echo\n", qos);
+            continue;
+        }
+        bench_latency(qos);
+        bench_throughput(qos);
+    }
+
+    esp_mqtt_client_unsubscribe(s_client, CONFIG_MQTT_BENCH_TOPIC);
+    printf("BENCH done\n");
+    vTaskDelete(NULL);
+}
+
+static uint32_t bench_begin_phase(bool record_rtt)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_run = ++s_run_counter;
+    s_record_rtt = record_rtt;
+    s_received = 0;
+    s_last_seq = UINT32_MAX;
+    s_last_rx_us = 0;
+    latency_stats_reset(&s_rtt);
+    latency_stats_reset(&s_ack);
+    uint32_t run = s_run;
+    xSemaphoreGive(s_lock);
+    xTaskNotifyWait(0, UINT32_MAX, NULL, 0);
+    return run;
+}
+
+static void bench_end_phase(void)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_run = 0;
+    xSemaphoreGive(s_lock);
+}
+
+/* Stamp and publish one probe; returns the msg_id of esp_mqtt_client_publish() */
+static int bench_publish_probe(uint32_t run, uint32_t seq, int qos, int64_t *sent_us)
+{
+    const uint32_t magic = BENCH_MAGIC;
+    int64_t now = esp_timer_get_time();
+    memcpy(&s_payload[0], &magic, sizeof(magic));
+    memcpy(&s_payload[4], &run, sizeof(run));
+    memcpy(&s_payload[8], &seq, sizeof(seq));
+    memcpy(&s_payload[12], &now, sizeof(now));
+    if (sent_us != NULL) {
+        *sent_us = now;
+    }
+    return esp_mqtt_client_publish(s_client, CONFIG_MQTT_BENCH_TOPIC, (const char *)s_payload,
+                                   CONFIG_MQTT_BENCH_PAYLOAD_SIZE, qos, 0);
+}
+
+/* Wait until a probe comes back, which also confirms the subscription is active */
+static bool bench_warmup(int qos)
+{
+    uint32_t run = bench_begin_phase(false);
+    bool ok = false;
+    for (int i = 0; i < BENCH_WARMUP_TRIES && !ok; i++) {
+        bench_publish_probe(run, i, qos, NULL);
+        uint32_t bits = 0;
+        ok = xTaskNotifyWait(0, BENCH_NOTIFY_ECHO, &bits, BENCH_TIMEOUT_TICKS) == pdTRUE && (bits & BENCH_NOTIFY_ECHO);
+    }
+    bench_end_phase();
+    return ok;
+}
+
+/* One probe at a time: round trip (and ack) latency per probe */
+static void bench_latency(int qos)
+{
+    uint32_t run = bench_begin_phase(true);
+    uint32_t lost = 0;
+
+    for (uint32_t seq = 0; seq < CONFIG_MQTT_BENCH_PROBES; seq++) {
+        int64_t sent_us;
+        int msg_id = bench_publish_probe(run, seq, qos, &sent_us);
+        if (msg_id < 0) {
+            lost++;
+            vTaskDelay(pdMS_TO_TICKS(BENCH_RETRY_MS));
+            continue;
+        }
+
+        bool echoed = false;
+        bool acked = (qos == 0);    // QoS 0 has no ack
+        TickType_t start = xTaskGetTickCount();
+        while (!(echoed && acked)) {
+            TickType_t waited = xTaskGetTickCount() - start;
+            if (waited >= BENCH_TIMEOUT_TICKS ||
+                xTaskNotifyWait(0, BENCH_NOTIFY_ECHO | BENCH_NOTIFY_ACK, NULL, BENCH_TIMEOUT_TICKS - waited) != pdTRUE) {
+                break;
+            }
+            xSemaphoreTake(s_lock, portMAX_DELAY);
+            echoed = echoed || s_last_seq == seq;
+            if (!acked && s_acked_msg_id == msg_id) {
+                latency_stats_add(&s_ack, (uint32_t)(s_acked_us - sent_us));
+                acked = true;
+            }
+            xSemaphoreGive(s_lock);
+        }
+        if (!echoed) {
+            lost++;
+        }
+    }
+
+    bench_end_phase();
+    bench_print_summary(qos, "rtt", &s_rtt, lost);
+    if (qos > 0) {
+        bench_print_summary(qos, "ack", &s_ack, CONFIG_MQTT_BENCH_PROBES - (uint32_t)s_ack.count);
+    }
+}
+
+/* Keep CONFIG_MQTT_BENCH_WINDOW probes in flight for CONFIG_MQTT_BENCH_DURATION_S */
+static void bench_throughput(int qos)
+{
+    uint32_t run = bench_begin_phase(false);
+    uint32_t sent = 0;
+    uint32_t failed = 0;
+    uint32_t written_off = 0;   // probes given up on so the window does not stall
+    uint32_t received = 0;
+    int64_t last_rx_us = 0;
+    int64_t start_us = esp_timer_get_time();
+    int64_t end_us = start_us + (int64_t)CONFIG_MQTT_BENCH_DURATION_S * 1000000;
+
+    while (esp_timer_get_time() < end_us && atomic_load(&s_connected)) {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        received = s_received;
+        xSemaphoreGive(s_lock);
+        int32_t in_flight = (int32_t)(sent - received - written_off);    // < 0 once written-off probes arrive late
+        if (in_flight >= CONFIG_MQTT_BENCH_WINDOW) {
+            if (xTaskNotifyWait(0, BENCH_NOTIFY_ECHO, NULL, BENCH_TIMEOUT_TICKS) != pdTRUE) {
+                written_off = sent - received;
+            }
+            continue;
+        }
+        if (bench_publish_probe(run, sent, qos, NULL) < 0) {
+            failed++;   // disconnected or outbox limit reached
+            vTaskDelay(pdMS_TO_TICKS(BENCH_RETRY_MS));
+            continue;
+        }
+        sent++;
+    }
+
+    // Collect the probes still in flight
+    TickType_t drain_start = xTaskGetTickCount();
+    for (;;) {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        received = s_received;
+        last_rx_us = s_last_rx_us;
+        xSemaphoreGive(s_lock);
+        if (received >= sent || xTaskGetTickCount() - drain_start >= BENCH_TIMEOUT_TICKS) {
+            break;
+        }
+        xTaskNotifyWait(0, BENCH_NOTIFY_ECHO, NULL, pdMS_TO_TICKS(BENCH_RETRY_MS));
+    }
+    bench_end_phase();
+
+    double elapsed_s = (double)((last_rx_us > start_us ? last_rx_us : end_us) - start_us) / 1e6;
+    double rate = received / elapsed_s;
+    ESP_LOGI(TAG, "QoS %d throughput: %.1f msgs/s (%u sent, %u echoed)", qos, rate,
+             (unsigned int)sent, (unsigned int)received);
+    printf("BENCH qos=%d throughput sent=%u received=%u lost=%u failed=%u msgs_per_s=%.1f\n", qos,
+           (unsigned int)sent, (unsigned int)received, (unsigned int)(sent > received ? sent - received : 0),
+           (unsigned int)failed, rate);
+}
+
+static void bench_print_summary(int qos, const char *what, latency_stats_t *stats, uint32_t lost)
+{
+    latency_summary_t sum;
+    latency_stats_summarize(stats, &sum);
+    ESP_LOGI(TAG, "QoS %d %s: p50=%u p99=%u us (%u samples)", qos, what,
+             (unsigned int)sum.p50_us, (unsigned int)sum.p99_us, (unsigned int)sum.count);
+    printf("BENCH qos=%d %s n=%u lost=%u min=%u mean=%u p50=%u p90=%u p99=%u max=%u\n", qos, what,
+           (unsigned int)sum.count, (unsigned int)lost, (unsigned int)sum.min_us, (unsigned int)sum.mean_us,
+           (unsigned int)sum.p50_us, (unsigned int)sum.p90_us, (unsigned int)sum.p99_us, (unsigned int)sum.max_us);
+}
+
+/* ***** END OF FILE ******************************************************** */
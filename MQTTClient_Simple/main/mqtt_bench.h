@@ -0,0 +1,47 @@
+/*
+ ******************************************************************************
+ * @file           : mqtt_bench.h
+ * @brief          : Header for mqtt_bench.c (loopback latency/throughput benchmark)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - The client subscribes to CONFIG_MQTT_BENCH_TOPIC and publishes timestamped
+ *   probes to it, so every probe comes back through the broker.
+ * - For QoS 0, 1 and 2 in turn it measures:
+ *     round trip   : publish to echo, one probe at a time (percentiles)
+ *     ack          : publish to PUBACK/PUBCOMP (QoS 1/2 only, percentiles)
+ *     throughput   : echoed probes/s with CONFIG_MQTT_BENCH_WINDOW in flight
+ * - Results are printed as lines starting with "BENCH " (see README.md),
+ *   followed by "BENCH done".
+ * - Probe payload (little-endian): u32 magic, u32 run, u32 seq, i64 t_us, padding.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include "esp_err.h"
+#include "mqtt_client.h"
+#include "topic_router.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define MQTT_BENCH_PROBE_HEADER_SIZE    20
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Route the loopback topic to the benchmark. Call before topic_router_compile().
+  * @retval ESP_OK, ESP_ERR_NO_MEM
+  */
+esp_err_t mqtt_bench_register(topic_router_t *router);
+
+/**
+  * @brief  Start the benchmark task; it runs once after the client is connected.
+  *         Call before esp_mqtt_client_start() so the connect event is not missed.
+  * @param  client  initialized MQTT client
+  * @retval ESP_OK, ESP_ERR_NO_MEM
+  */
+esp_err_t mqtt_bench_start(esp_mqtt_client_handle_t client);
+
+/* ***** END OF FILE ******************************************************** */
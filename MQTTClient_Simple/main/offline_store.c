@@ -0,0 +1,209 @@
+/*
+ ******************************************************************************
+ * @file           : offline_store.c
+ * @brief          : Store-and-forward for MQTT publishes on a flash partition
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Record format in the ring: u8 qos, topic incl. '\0', payload.
+ * - The ring (flash_ring.c) is guarded by a mutex; only the drain task pops,
+ *   so the record it peeked is still the oldest one when it pops it.
+ * - Appends never overwrite old data. When the ring is full the caller gets
+ *   ESP_ERR_NO_MEM and is expected to hold its data (back-pressure).
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "offline_store.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_partition.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "flash_ring.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DRAIN_PERIOD_TICKS  ((1000 / CONFIG_MQTT_OFFLINE_STORE_DRAIN_RATE) / portTICK_PERIOD_MS > 0 ? \
+                             (1000 / CONFIG_MQTT_OFFLINE_STORE_DRAIN_RATE) / portTICK_PERIOD_MS : 1)
+#define DRAIN_RETRY_MS      1000
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "offline_store";
+static esp_mqtt_client_handle_t s_client;
+static flash_ring_t s_ring;
+static SemaphoreHandle_t s_lock;
+static TaskHandle_t s_drain_task;
+static atomic_bool s_connected;
+static uint8_t *s_append_buf;
+static uint8_t *s_drain_buf;
+static size_t s_buf_size;
+
+/* Private function prototypes -----------------------------------------------*/
+static esp_err_t partition_read(void *ctx, size_t offset, void *dst, size_t len);
+static esp_err_t partition_write(void *ctx, size_t offset, const void *src, size_t len);
+static esp_err_t partition_erase_sector(void *ctx, size_t offset);
+static void offline_store_drain_task(void *param);
+
+
+esp_err_t offline_store_init(esp_mqtt_client_handle_t client)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                           CONFIG_MQTT_OFFLINE_STORE_PARTITION_LABEL);
+    if (part == NULL) {
+        ESP_LOGE(TAG, "Partition '%s' not found", CONFIG_MQTT_OFFLINE_STORE_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const flash_ring_io_t io = {
+        .read = partition_read,
+        .write = partition_write,
+        .erase_sector = partition_erase_sector,
+        .ctx = (void *)part,
+        .size = part->size,
+        .sector_size = part->erase_size,
+    };
+    esp_err_t err = flash_ring_mount(&s_ring, &io);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Mount failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    s_client = client;
+    s_buf_size = flash_ring_max_record(&s_ring);
+    s_append_buf = malloc(s_buf_size);
+    s_drain_buf = malloc(s_buf_size);
+    s_lock = xSemaphoreCreateMutex();
+    if (s_append_buf == NULL || s_drain_buf == NULL || s_lock == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(offline_store_drain_task, "offline_drain", 3072, NULL, 4, &s_drain_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "%u KB on '%s', %u publishes pending", part->size / 1024, part->label, flash_ring_count(&s_ring));
+    return ESP_OK;
+}
+
+esp_err_t offline_store_append(const char *topic, const void *data, size_t len, int qos)
+{
+    if (s_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    size_t topic_size = strlen(topic) + 1;
+    size_t rec_len = 1 + topic_size + len;
+    if (rec_len > s_buf_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_append_buf[0] = (uint8_t)qos;
+    memcpy(&s_append_buf[1], topic, topic_size);
+    memcpy(&s_append_buf[1 + topic_size], data, len);
+    esp_err_t err = flash_ring_append(&s_ring, s_append_buf, rec_len);
+    xSemaphoreGive(s_lock);
+
+    if (err == ESP_OK && atomic_load(&s_connected)) {
+        xTaskNotifyGive(s_drain_task);
+    } else if (err != ESP_OK && err != ESP_ERR_NO_MEM) {
+        ESP_LOGW(TAG, "Append failed: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+uint32_t offline_store_pending(void)
+{
+    if (s_lock == NULL) {
+        return 0;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    uint32_t count = flash_ring_count(&s_ring);
+    xSemaphoreGive(s_lock);
+    return count;
+}
+
+void offline_store_set_connected(bool connected)
+{
+    atomic_store(&s_connected, connected);
+    if (connected && s_drain_task != NULL) {
+        xTaskNotifyGive(s_drain_task);
+    }
+}
+
+static esp_err_t partition_read(void *ctx, size_t offset, void *dst, size_t len)
+{
+    return esp_partition_read((const esp_partition_t *)ctx, offset, dst, len);
+}
+
+static esp_err_t partition_write(void *ctx, size_t offset, const void *src, size_t len)
+{
+    return esp_partition_write((const esp_partition_t *)ctx, offset, src, len);
+}
+
+static esp_err_t partition_erase_sector(void *ctx, size_t offset)
+{
+    const esp_partition_t *part = ctx;
+    return esp_partition_erase_range(part, offset, part->erase_size);
+}
+
+static void offline_store_drain_task(void *param)
+{
+    uint32_t drained = 0;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        TickType_t last_wake = xTaskGetTickCount();
+        while (atomic_load(&s_connected)) {
+            size_t len = 0;
+            xSemaphoreTake(s_lock, portMAX_DELAY);
+            esp_err_t err = flash_ring_peek(&s_ring, s_drain_buf, s_buf_size, &len);
+            xSemaphoreGive(s_lock);
+            if (err == ESP_ERR_NOT_FOUND) {
+                break;
+            }
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Read failed: %s", esp_err_to_name(err));
+                vTaskDelay(pdMS_TO_TICKS(DRAIN_RETRY_MS));
+                continue;
+            }
+
+            const char *topic = (const char *)&s_drain_buf[1];
+            size_t topic_size = (len > 1) ? strnlen(topic, len - 1) + 1 : 0;
+            int msg_id = 0;
+            if (topic_size == 0 || topic_size > len - 1) {
+                ESP_LOGW(TAG, "Dropping malformed record");
+            } else {
+                msg_id = esp_mqtt_client_enqueue(s_client, topic, (const char *)&s_drain_buf[1 + topic_size],
+                                                 len - 1 - topic_size, s_drain_buf[0], 0, true);
+            }
+            if (msg_id < 0) {
+                // Client refused (e.g. just disconnected): keep the record and retry later
+                vTaskDelay(pdMS_TO_TICKS(DRAIN_RETRY_MS));
+                last_wake = xTaskGetTickCount();
+                continue;
+            }
+
+            xSemaphoreTake(s_lock, portMAX_DELAY);
+            flash_ring_pop(&s_ring);
+            xSemaphoreGive(s_lock);
+            drained++;
+
+            vTaskDelayUntil(&last_wake, DRAIN_PERIOD_TICKS);
+        }
+        if (drained > 0) {
+            ESP_LOGI(TAG, "Drained %u stored publishes", drained);
+            drained = 0;
+        }
+    }
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,56 @@
+/*
+ ******************************************************************************
+ * @file           : offline_store.h
+ * @brief          : Header for offline_store.c (store-and-forward for MQTT publishes)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Publishes that cannot go out (client offline, outbox over its limit) are
+ *   appended to a flash_ring on the "mqtt_store" data partition and survive
+ *   a reboot.
+ * - After MQTT_EVENT_CONNECTED a drain task re-publishes them oldest first at
+ *   CONFIG_MQTT_OFFLINE_STORE_DRAIN_RATE messages per second.
+ * - Delivery is at-least-once: a record is removed after the client accepted it,
+ *   so a reset in between sends it again.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "mqtt_client.h"
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Mount the ring on the store partition and start the drain task.
+  * @param  client  MQTT client used for re-publishing
+  * @retval ESP_OK, ESP_ERR_NOT_FOUND (no partition), ESP_ERR_NO_MEM or a flash error
+  */
+esp_err_t offline_store_init(esp_mqtt_client_handle_t client);
+
+/**
+  * @brief  Store one publish for later delivery. Safe to call from any task.
+  * @retval ESP_OK,
+  *         ESP_ERR_NO_MEM (store full: the caller should hold the data and retry later),
+  *         ESP_ERR_INVALID_SIZE (topic + data does not fit one record),
+  *         ESP_ERR_INVALID_STATE (store not initialised)
+  */
+esp_err_t offline_store_append(const char *topic, const void *data, size_t len, int qos);
+
+/**
+  * @brief  Number of stored publishes not yet handed back to the client.
+  */
+uint32_t offline_store_pending(void);
+
+/**
+  * @brief  Start (connected) or pause (disconnected) draining. Call from the MQTT event handler.
+  */
+void offline_store_set_connected(bool connected);
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,302 @@
+/*
+ ******************************************************************************
+ * @file           : telemetry.c
+ * @brief          : Batched MQTT telemetry publisher
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Samples are collected from a FreeRTOS queue into a packed batch. The batch
+ *   is flushed once per CONFIG_TELEMETRY_WINDOW_MS (counted from its first
+ *   sample) or as soon as it holds CONFIG_TELEMETRY_MAX_SAMPLES samples.
+ * - Flushing uses esp_mqtt_client_enqueue(), so the publisher never blocks on
+ *   the socket; the MQTT task sends the message. One outbox entry per window
+ *   replaces one entry (and one TCP write) per sample.
+ * - While disconnected, or while the outbox holds more than
+ *   CONFIG_TELEMETRY_OUTBOX_LIMIT bytes, the batch goes to the offline store
+ *   (or is dropped if the store is disabled). If the store is full the batch is
+ *   held and the sample queue stops draining, so producers see ESP_ERR_TIMEOUT.
+ * - A batch is also sealed early when the next sample is more than 65535 ms
+ *   after its base, so the 16 bit sample offset never wraps.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "telemetry.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#if CONFIG_MQTT_OFFLINE_STORE
+#include "offline_store.h"
+#endif
+
+/* Private define ------------------------------------------------------------*/
+#define TELEMETRY_BUF_SIZE      (TELEMETRY_BATCH_HEADER_SIZE + CONFIG_TELEMETRY_MAX_SAMPLES * TELEMETRY_BATCH_SAMPLE_SIZE)
+#define TELEMETRY_STATS_LOG_MS  10000
+#define TELEMETRY_RETRY_MS      100
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint32_t timestamp_ms;
+    int32_t value;
+    uint8_t channel;
+} telemetry_sample_t;
+
+typedef struct {
+    uint8_t buf[TELEMETRY_BUF_SIZE];
+    uint16_t count;
+    uint32_t base_ms;
+} telemetry_batch_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "telemetry";
+static esp_mqtt_client_handle_t s_client;
+static QueueHandle_t s_sample_queue;
+static atomic_bool s_connected;
+static telemetry_batch_t s_batch;
+
+static uint32_t s_batches_sent;
+static uint32_t s_samples_sent;
+static uint32_t s_bytes_sent;
+static uint32_t s_batches_stored;
+static atomic_uint_fast32_t s_samples_dropped;
+
+/* Private function prototypes -----------------------------------------------*/
+static void put_le16(uint8_t *p, uint16_t v);
+static void put_le32(uint8_t *p, uint32_t v);
+static bool batch_fits(const telemetry_batch_t *batch, const telemetry_sample_t *sample);
+static void batch_append(telemetry_batch_t *batch, const telemetry_sample_t *sample);
+static bool batch_flush(telemetry_batch_t *batch);
+static void telemetry_publisher_task(void *param);
+#if CONFIG_TELEMETRY_SYNTHETIC_RATE_HZ > 0
+static void telemetry_synthetic_task(void *param);
+#endif
+
+
+esp_err_t telemetry_start(esp_mqtt_client_handle_t client)
+{
+    s_client = client;
+    s_sample_queue = xQueueCreate(CONFIG_TELEMETRY_QUEUE_LEN, sizeof(telemetry_sample_t));
+    if (s_sample_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create sample queue");
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (xTaskCreate(telemetry_publisher_task, "telemetry", 4096, NULL, 5, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start publisher task");
+        return ESP_ERR_NO_MEM;
+    }
+#if CONFIG_TELEMETRY_SYNTHETIC_RATE_HZ > 0
+    if (xTaskCreate(telemetry_synthetic_task, "telemetry_syn", 2048, NULL, 4, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start synthetic producer");
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+    ESP_LOGI(TAG, "Publishing to %s every %d ms (max %d samples, QoS %d)", CONFIG_TELEMETRY_TOPIC,
+             CONFIG_TELEMETRY_WINDOW_MS, CONFIG_TELEMETRY_MAX_SAMPLES, CONFIG_TELEMETRY_QOS);
+    return ESP_OK;
+}
+
+void telemetry_set_connected(bool connected)
+{
+    atomic_store(&s_connected, connected);
+}
+
+esp_err_t telemetry_add_sample(uint8_t channel, int32_t value)
+{
+    if (s_sample_queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    telemetry_sample_t sample = {
+        .timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000),
+        .value = value,
+        .channel = channel,
+    };
+    if (xQueueSend(s_sample_queue, &sample, 0) != pdTRUE) {
+        atomic_fetch_add(&s_samples_dropped, 1);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+void telemetry_get_stats(telemetry_stats_t *stats)
+{
+    // Sent counters are only written by the publisher task; a slightly torn snapshot is fine here
+    stats->batches_sent = s_batches_sent;
+    stats->samples_sent = s_samples_sent;
+    stats->bytes_sent = s_bytes_sent;
+    stats->batches_stored = s_batches_stored;
+    stats->samples_dropped = (uint32_t)atomic_load(&s_samples_dropped);
+}
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/* The 16 bit offset covers 65535 ms after base_ms; samples that waited in the
+ * queue (batch held, publisher starved) can be older than the window */
+static bool batch_fits(const telemetry_batch_t *batch, const telemetry_sample_t *sample)
+{
+    return batch->count == 0 || sample->timestamp_ms - batch->base_ms <= UINT16_MAX;
+}
+
+static void batch_append(telemetry_batch_t *batch, const telemetry_sample_t *sample)
+{
+    if (batch->count == 0) {
+        batch->base_ms = sample->timestamp_ms;
+    }
+
+    uint8_t *p = &batch->buf[TELEMETRY_BATCH_HEADER_SIZE + batch->count * TELEMETRY_BATCH_SAMPLE_SIZE];
+    // batch_fits() was checked by the caller
+    put_le16(p, (uint16_t)(sample->timestamp_ms - batch->base_ms));
+    p[2] = sample->channel;
+    put_le32(p + 3, (uint32_t)sample->value);
+    batch->count++;
+}
+
+/**
+  * @brief  Publish or store the batch and empty it.
+  * @retval false if the offline store is full and the batch must be kept for a retry
+  */
+static bool batch_flush(telemetry_batch_t *batch)
+{
+    if (batch->count == 0) {
+        return true;
+    }
+
+    batch->buf[0] = TELEMETRY_BATCH_VERSION;
+    batch->buf[1] = 0;
+    put_le16(&batch->buf[2], batch->count);
+    put_le32(&batch->buf[4], batch->base_ms);
+    int len = TELEMETRY_BATCH_HEADER_SIZE + batch->count * TELEMETRY_BATCH_SAMPLE_SIZE;
+
+    bool live = atomic_load(&s_connected) && esp_mqtt_client_get_outbox_size(s_client) <= CONFIG_TELEMETRY_OUTBOX_LIMIT;
+#if CONFIG_MQTT_OFFLINE_STORE
+    // Keep the order: while older batches wait in the store, new ones queue up behind them
+    live = live && offline_store_pending() == 0;
+#endif
+    int msg_id = -1;
+    if (live) {
+        msg_id = esp_mqtt_client_enqueue(s_client, CONFIG_TELEMETRY_TOPIC, (const char *)batch->buf, len,
+                                         CONFIG_TELEMETRY_QOS, 0, true);
+    }
+
+    if (msg_id >= 0) {
+        s_batches_sent++;
+        s_samples_sent += batch->count;
+        s_bytes_sent += len;
+    } else {
+#if CONFIG_MQTT_OFFLINE_STORE
+        esp_err_t err = offline_store_append(CONFIG_TELEMETRY_TOPIC, batch->buf, len, CONFIG_TELEMETRY_QOS);
+        if (err == ESP_ERR_NO_MEM) {
+            return false;
+        }
+        if (err == ESP_OK) {
+            s_batches_stored++;
+        } else {
+            atomic_fetch_add(&s_samples_dropped, batch->count);
+        }
+#else
+        atomic_fetch_add(&s_samples_dropped, batch->count);
+#endif
+    }
+    batch->count = 0;
+    return true;
+}
+
+static void telemetry_publisher_task(void *param)
+{
+    const TickType_t window_ticks = pdMS_TO_TICKS(CONFIG_TELEMETRY_WINDOW_MS);
+    TickType_t window_start = 0;
+    TickType_t last_log = xTaskGetTickCount();
+    telemetry_sample_t sample;
+    bool held = false;
+
+    for (;;) {
+        if (held) {
+            // Offline store full: stop taking samples until the batch could be stored
+            held = !batch_flush(&s_batch);
+            if (held) {
+                vTaskDelay(pdMS_TO_TICKS(TELEMETRY_RETRY_MS));
+                continue;
+            }
+        }
+
+        TickType_t wait = pdMS_TO_TICKS(TELEMETRY_STATS_LOG_MS);
+        if (s_batch.count > 0) {
+            TickType_t elapsed = xTaskGetTickCount() - window_start;
+            wait = (elapsed >= window_ticks) ? 0 : window_ticks - elapsed;
+        }
+
+        // Peek first: a sample that doesn't fit stays queued while the batch is sealed
+        if (xQueuePeek(s_sample_queue, &sample, wait) == pdTRUE) {
+            if (!batch_fits(&s_batch, &sample)) {
+                held = !batch_flush(&s_batch);
+            } else {
+                xQueueReceive(s_sample_queue, &sample, 0);
+                if (s_batch.count == 0) {
+                    window_start = xTaskGetTickCount();
+                }
+                batch_append(&s_batch, &sample);
+                if (s_batch.count >= CONFIG_TELEMETRY_MAX_SAMPLES) {
+                    held = !batch_flush(&s_batch);
+                }
+            }
+        } else if (s_batch.count > 0) {
+            held = !batch_flush(&s_batch);
+        }
+
+        if (xTaskGetTickCount() - last_log >= pdMS_TO_TICKS(TELEMETRY_STATS_LOG_MS)) {
+            last_log = xTaskGetTickCount();
+            telemetry_stats_t stats;
+            telemetry_get_stats(&stats);
+            ESP_LOGI(TAG, "batches=%u samples=%u bytes=%u stored=%u dropped=%u", stats.batches_sent,
+                     stats.samples_sent, stats.bytes_sent, stats.batches_stored, stats.samples_dropped);
+        }
+    }
+}
+
+#if CONFIG_TELEMETRY_SYNTHETIC_RATE_HZ > 0
+/**
+  * @brief  Benchmark producer: CONFIG_TELEMETRY_SYNTHETIC_RATE_HZ samples/s spread over 4 channels.
+  */
+static void telemetry_synthetic_task(void *param)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    uint32_t acc = 0;
+    int32_t value = 0;
+
+    for (;;) {
+        vTaskDelayUntil(&last_wake, 1);
+        // Spread the rate over ticks so rates above the tick rate still work
+        acc += CONFIG_TELEMETRY_SYNTHETIC_RATE_HZ;
+        while (acc >= configTICK_RATE_HZ) {
+            acc -= configTICK_RATE_HZ;
+            telemetry_add_sample((uint8_t)(value & 0x3), value);
+            value++;
+        }
+    }
+}
+#endif /* CONFIG_TELEMETRY_SYNTHETIC_RATE_HZ > 0 */
+
+/* ***** END OF FILE ******************************************************** */
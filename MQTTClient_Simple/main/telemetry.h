@@ -0,0 +1,71 @@
+/*
+ ******************************************************************************
+ * @file           : telemetry.h
+ * @brief          : Header for telemetry.c (batched MQTT telemetry publisher)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Producers push samples with telemetry_add_sample() (non-blocking).
+ * - A publisher task packs all samples of one window into a single binary
+ *   message and enqueues it on CONFIG_TELEMETRY_TOPIC.
+ * - Batch payload (all fields little-endian):
+ *     header (8 bytes) : u8 version (=1), u8 reserved, u16 count, u32 base_ms
+ *     sample (7 bytes) : u16 dt_ms (since base_ms), u8 channel, i32 value
+ *   A batch spans at most 65535 ms, later samples start the next batch.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "mqtt_client.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define TELEMETRY_BATCH_VERSION         1
+#define TELEMETRY_BATCH_HEADER_SIZE     8
+#define TELEMETRY_BATCH_SAMPLE_SIZE     7
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct {
+    uint32_t batches_sent;      /* messages handed to the MQTT outbox */
+    uint32_t samples_sent;
+    uint32_t bytes_sent;        /* payload bytes, without MQTT framing */
+    uint32_t batches_stored;    /* batches written to the offline store instead */
+    uint32_t samples_dropped;   /* producer queue full, or batch neither sent nor stored */
+} telemetry_stats_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Create the sample queue and start the publisher (and, if configured,
+  *         the synthetic benchmark producer).
+  * @param  client  started MQTT client used for publishing
+  * @retval ESP_OK, ESP_ERR_NO_MEM
+  */
+esp_err_t telemetry_start(esp_mqtt_client_handle_t client);
+
+/**
+  * @brief  Tell the publisher whether the client is connected (call from the MQTT event handler).
+  */
+void telemetry_set_connected(bool connected);
+
+/**
+  * @brief  Queue one sample without blocking. Safe to call from any task.
+  * @param  channel  sensor/channel id
+  * @param  value    raw sample value
+  * @retval ESP_OK, ESP_ERR_INVALID_STATE (not started),
+  *         ESP_ERR_TIMEOUT (queue full, sample dropped; also the back-pressure signal
+  *         while the offline store is full)
+  */
+esp_err_t telemetry_add_sample(uint8_t channel, int32_t value);
+
+/**
+  * @brief  Copy the publisher counters.
+  */
+void telemetry_get_stats(telemetry_stats_t *stats);
+
+/* ***** END OF FILE ******************************************************** */
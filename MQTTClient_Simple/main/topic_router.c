@@ -0,0 +1,462 @@
+/*
+ ******************************************************************************
+ * @file           : topic_router.c
+ * @brief          : MQTT topic to handler dispatch on a compiled topic trie
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - topic_router_compile() inserts all filters into a temporary linked trie
+ *   and flattens it breadth-first into one array. Exact children of a node are
+ *   contiguous and sorted by (length, bytes); the '+' and '#' children are
+ *   kept aside. Routes of a node are contiguous in a second array.
+ * - Matching walks the topic level by level without copying or splitting it.
+ *   Recursion depth is bounded by the deepest filter, not by the topic.
+ * - Topics starting with '$' are not matched by a leading '+' or '#'.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "topic_router.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define NO_NODE     (-1)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    char *filter;
+    uint32_t flags;
+    topic_router_handler_t handler;
+    void *ctx;
+} route_t;
+
+/* Compiled trie node */
+typedef struct {
+    const char *level;          /* points into a route's filter copy */
+    uint16_t level_len;
+    uint16_t child_count;
+    uint32_t child_first;       /* exact children: nodes[child_first .. +child_count) */
+    int32_t plus;               /* '+' child or NO_NODE */
+    int32_t hash;               /* '#' child or NO_NODE */
+    uint32_t route_first;       /* route_idx[route_first .. +route_count) */
+    uint32_t route_count;
+} node_t;
+
+/* Temporary trie used while compiling */
+typedef struct {
+    const char *level;
+    uint16_t level_len;
+    int32_t first_child;
+    int32_t next_sibling;
+    int32_t route_head;
+    int32_t route_tail;
+} bnode_t;
+
+typedef struct {
+    const char *level;
+    uint16_t level_len;
+    int32_t bnode;
+} child_ref_t;
+
+struct topic_router {
+    route_t *routes;
+    uint32_t route_num;
+    uint32_t route_cap;
+    bool dirty;
+
+    node_t *nodes;
+    uint32_t *route_idx;
+    uint32_t *matches;          /* routes matched by the current message */
+    uint32_t match_num;
+
+    /* Fragmented message in progress */
+    bool frag_active;
+    size_t frag_next;
+    size_t frag_total;
+    char *topic_buf;
+    size_t topic_len;
+    size_t topic_cap;
+    char *whole_buf;            /* reassembly for TOPIC_ROUTER_FLAG_WHOLE */
+    size_t max_reassembly;
+    bool whole_ok;
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static bool filter_is_valid(const char *filter);
+static int child_ref_cmp(const void *a, const void *b);
+static int level_cmp(const char *a, size_t a_len, const char *b, size_t b_len);
+static void match_node(topic_router_t *router, int32_t ni, const char *p, const char *end, bool first);
+static void collect_routes(topic_router_t *router, int32_t ni);
+
+
+topic_router_t *topic_router_create(size_t max_reassembly)
+{
+    topic_router_t *router = calloc(1, sizeof(*router));
+    if (router != NULL) {
+        router->max_reassembly = max_reassembly;
+        router->dirty = true;
+    }
+    return router;
+}
+
+void topic_router_destroy(topic_router_t *router)
+{
+    if (router == NULL) {
+        return;
+    }
+    for (uint32_t i = 0; i < router->route_num; i++) {
+        free(router->routes[i].filter);
+    }
+    free(router->routes);
+    free(router->nodes);
+    free(router->route_idx);
+    free(router->matches);
+    free(router->topic_buf);
+    free(router->whole_buf);
+    free(router);
+}
+
+esp_err_t topic_router_add(topic_router_t *router, const char *filter, uint32_t flags,
+                           topic_router_handler_t handler, void *ctx)
+{
+    if (router == NULL || handler == NULL || !filter_is_valid(filter)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (router->route_num == router->route_cap) {
+        uint32_t cap = router->route_cap ? router->route_cap * 2 : 8;
+        route_t *routes = realloc(router->routes, cap * sizeof(route_t));
+        if (routes == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        router->routes = routes;
+        router->route_cap = cap;
+    }
+    char *copy = strdup(filter);
+    if (copy == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    router->routes[router->route_num++] = (route_t) {
+        .filter = copy,
+        .flags = flags,
+        .handler = handler,
+        .ctx = ctx,
+    };
+    router->dirty = true;
+    return ESP_OK;
+}
+
+esp_err_t topic_router_compile(topic_router_t *router)
+{
+    esp_err_t err = ESP_ERR_NO_MEM;
+    uint32_t max_nodes = 1;
+    for (uint32_t i = 0; i < router->route_num; i++) {
+        const char *f = router->routes[i].filter;
+        max_nodes += 1;
+        while ((f = strchr(f, '/')) != NULL) {
+            max_nodes++;
+            f++;
+        }
+    }
+
+    bnode_t *bnodes = malloc(max_nodes * sizeof(bnode_t));
+    int32_t *route_next = malloc((router->route_num + 1) * sizeof(int32_t));
+    int32_t *queue = malloc(max_nodes * sizeof(int32_t));
+    child_ref_t *children = malloc(max_nodes * sizeof(child_ref_t));
+    node_t *nodes = malloc(max_nodes * sizeof(node_t));
+    uint32_t *route_idx = malloc((router->route_num + 1) * sizeof(uint32_t));
+    uint32_t *matches = malloc((router->route_num + 1) * sizeof(uint32_t));
+    if (!bnodes || !route_next || !queue || !children || !nodes || !route_idx || !matches) {
+        free(nodes);
+        free(route_idx);
+        free(matches);
+        goto out;
+    }
+
+    // 1. Linked trie, routes kept in registration order per node
+    uint32_t bnum = 1;
+    bnodes[0] = (bnode_t) { "", 0, NO_NODE, NO_NODE, NO_NODE, NO_NODE };
+    for (uint32_t i = 0; i < router->route_num; i++) {
+        int32_t cur = 0;
+        const char *p = router->routes[i].filter;
+        for (;;) {
+            const char *slash = strchr(p, '/');
+            size_t len = slash ? (size_t)(slash - p) : strlen(p);
+            int32_t c = bnodes[cur].first_child;
+            while (c != NO_NODE && level_cmp(bnodes[c].level, bnodes[c].level_len, p, len) != 0) {
+                c = bnodes[c].next_sibling;
+            }
+            if (c == NO_NODE) {
+                c = (int32_t)bnum++;
+                bnodes[c] = (bnode_t) { p, (uint16_t)len, NO_NODE, bnodes[cur].first_child, NO_NODE, NO_NODE };
+                bnodes[cur].first_child = c;
+            }
+            cur = c;
+            if (slash == NULL) {
+                break;
+            }
+            p = slash + 1;
+        }
+        route_next[i] = NO_NODE;
+        if (bnodes[cur].route_tail == NO_NODE) {
+            bnodes[cur].route_head = (int32_t)i;
+        } else {
+            route_next[bnodes[cur].route_tail] = (int32_t)i;
+        }
+        bnodes[cur].route_tail = (int32_t)i;
+    }
+
+    // 2. Flatten breadth-first; queue[k] is the temporary node that becomes nodes[k]
+    uint32_t head = 0, tail = 1, route_pos = 0;
+    queue[0] = 0;
+    while (head < tail) {
+        const bnode_t *b = &bnodes[queue[head]];
+        node_t *n = &nodes[head];
+        n->level = b->level;
+        n->level_len = b->level_len;
+        n->plus = NO_NODE;
+        n->hash = NO_NODE;
+
+        uint32_t nchild = 0;
+        int32_t plus = NO_NODE, hash = NO_NODE;
+        for (int32_t c = b->first_child; c != NO_NODE; c = bnodes[c].next_sibling) {
+            if (bnodes[c].level_len == 1 && bnodes[c].level[0] == '+') {
+                plus = c;
+            } else if (bnodes[c].level_len == 1 && bnodes[c].level[0] == '#') {
+                hash = c;
+            } else {
+                children[nchild++] = (child_ref_t) { bnodes[c].level, bnodes[c].level_len, c };
+            }
+        }
+        qsort(children, nchild, sizeof(child_ref_t), child_ref_cmp);
+        n->child_first = tail;
+        n->child_count = (uint16_t)nchild;
+        for (uint32_t k = 0; k < nchild; k++) {
+            queue[tail++] = children[k].bnode;
+        }
+        if (plus != NO_NODE) {
+            n->plus = (int32_t)tail;
+            queue[tail++] = plus;
+        }
+        if (hash != NO_NODE) {
+            n->hash = (int32_t)tail;
+            queue[tail++] = hash;
+        }
+
+        n->route_first = route_pos;
+        for (int32_t r = b->route_head; r != NO_NODE; r = route_next[r]) {
+            route_idx[route_pos++] = (uint32_t)r;
+        }
+        n->route_count = route_pos - n->route_first;
+        head++;
+    }
+
+    free(router->nodes);
+    free(router->route_idx);
+    free(router->matches);
+    router->nodes = nodes;
+    router->route_idx = route_idx;
+    router->matches = matches;
+    router->match_num = 0;
+    router->frag_active = false;
+    router->dirty = false;
+    err = ESP_OK;
+
+out:
+    free(bnodes);
+    free(route_next);
+    free(queue);
+    free(children);
+    return err;
+}
+
+int topic_router_dispatch(topic_router_t *router, const char *topic, size_t topic_len,
+                          const char *data, size_t data_len, size_t offset, size_t total_len)
+{
+    if (router->dirty && topic_router_compile(router) != ESP_OK) {
+        return -1;
+    }
+
+    if (offset == 0) {
+        router->frag_active = false;
+        router->match_num = 0;
+        match_node(router, 0, topic, topic + topic_len, true);
+
+        topic_router_msg_t msg = { topic, topic_len, data, data_len, 0, total_len };
+        bool fragmented = data_len < total_len;
+        bool need_whole = false;
+        for (uint32_t i = 0; i < router->match_num; i++) {
+            const route_t *route = &router->routes[router->matches[i]];
+            if (fragmented && (route->flags & TOPIC_ROUTER_FLAG_WHOLE)) {
+                need_whole = true;
+            } else {
+                route->handler(&msg, route->ctx);
+            }
+        }
+        if (!fragmented || router->match_num == 0) {
+            return (int)router->match_num;
+        }
+
+        // Later fragments carry no topic: keep a copy for the handlers
+        if (topic_len > router->topic_cap) {
+            char *buf = realloc(router->topic_buf, topic_len);
+            if (buf == NULL) {
+                return -1;
+            }
+            router->topic_buf = buf;
+            router->topic_cap = topic_len;
+        }
+        memcpy(router->topic_buf, topic, topic_len);
+        router->topic_len = topic_len;
+
+        router->whole_ok = false;
+        if (need_whole && total_len <= router->max_reassembly) {
+            if (router->whole_buf == NULL) {
+                router->whole_buf = malloc(router->max_reassembly);
+            }
+            if (router->whole_buf != NULL) {
+                memcpy(router->whole_buf, data, data_len);
+                router->whole_ok = true;
+            }
+        }
+        router->frag_active = true;
+        router->frag_next = data_len;
+        router->frag_total = total_len;
+        // Too large (or no buffer) for the WHOLE handlers: they will not be called, report it.
+        // The streaming handlers still get the following fragments.
+        return need_whole && !router->whole_ok ? -1 : (int)router->match_num;
+    }
+
+    if (!router->frag_active) {
+        return 0;       /* continuation of a message nobody subscribed to */
+    }
+    if (offset != router->frag_next || total_len != router->frag_total || offset + data_len > total_len) {
+        router->frag_active = false;
+        return -1;
+    }
+
+    topic_router_msg_t msg = { router->topic_buf, router->topic_len, data, data_len, offset, total_len };
+    for (uint32_t i = 0; i < router->match_num; i++) {
+        const route_t *route = &router->routes[router->matches[i]];
+        if (!(route->flags & TOPIC_ROUTER_FLAG_WHOLE)) {
+            route->handler(&msg, route->ctx);
+        }
+    }
+    if (router->whole_ok) {
+        memcpy(router->whole_buf + offset, data, data_len);
+    }
+
+    router->frag_next += data_len;
+    if (router->frag_next == total_len) {
+        router->frag_active = false;
+        if (router->whole_ok) {
+            topic_router_msg_t whole = { router->topic_buf, router->topic_len, router->whole_buf, total_len, 0, total_len };
+            for (uint32_t i = 0; i < router->match_num; i++) {
+                const route_t *route = &router->routes[router->matches[i]];
+                if (route->flags & TOPIC_ROUTER_FLAG_WHOLE) {
+                    route->handler(&whole, route->ctx);
+                }
+            }
+        }
+    }
+    return (int)router->match_num;
+}
+
+static bool filter_is_valid(const char *filter)
+{
+    if (filter == NULL || filter[0] == '\0') {
+        return false;
+    }
+    const char *p = filter;
+    for (;;) {
+        const char *slash = strchr(p, '/');
+        size_t len = slash ? (size_t)(slash - p) : strlen(p);
+        const char *plus = memchr(p, '+', len);
+        const char *hash = memchr(p, '#', len);
+        // Wildcards must fill a whole level, '#' only as the last one
+        if ((plus || hash) && len != 1) {
+            return false;
+        }
+        if (len > UINT16_MAX) {
+            return false;
+        }
+        if (hash && slash) {
+            return false;
+        }
+        if (slash == NULL) {
+            return true;
+        }
+        p = slash + 1;
+    }
+}
+
+static int level_cmp(const char *a, size_t a_len, const char *b, size_t b_len)
+{
+    if (a_len != b_len) {
+        return a_len < b_len ? -1 : 1;
+    }
+    return memcmp(a, b, a_len);
+}
+
+static int child_ref_cmp(const void *a, const void *b)
+{
+    const child_ref_t *ca = a, *cb = b;
+    return level_cmp(ca->level, ca->level_len, cb->level, cb->level_len);
+}
+
+static void collect_routes(topic_router_t *router, int32_t ni)
+{
+    const node_t *n = &router->nodes[ni];
+    for (uint32_t i = 0; i < n->route_count; i++) {
+        router->matches[router->match_num++] = router->route_idx[n->route_first + i];
+    }
+}
+
+/**
+  * @brief  Match the remaining topic levels [p, end) below node ni. p == NULL: all levels consumed.
+  */
+static void match_node(topic_router_t *router, int32_t ni, const char *p, const char *end, bool first)
+{
+    const node_t *n = &router->nodes[ni];
+    bool system_topic = first && p != NULL && p < end && *p == '$';
+
+    // "a/#" also matches "a" itself, so '#' is checked before looking at the next level
+    if (n->hash != NO_NODE && !system_topic) {
+        collect_routes(router, n->hash);
+    }
+    if (p == NULL) {
+        collect_routes(router, ni);
+        return;
+    }
+
+    const char *slash = memchr(p, '/', (size_t)(end - p));
+    size_t len = slash ? (size_t)(slash - p) : (size_t)(end - p);
+    const char *next = slash ? slash + 1 : NULL;
+
+    if (n->plus != NO_NODE && !system_topic) {
+        match_node(router, n->plus, next, end, false);
+    }
+
+    uint32_t lo = n->child_first, hi = n->child_first + n->child_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int c = level_cmp(router->nodes[mid].level, router->nodes[mid].level_len, p, len);
+        if (c == 0) {
+            match_node(router, (int32_t)mid, next, end, false);
+            break;
+        }
+        if (c < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,91 @@
+/*
+ ******************************************************************************
+ * @file           : topic_router.h
+ * @brief          : Header for topic_router.c (MQTT topic to handler dispatch)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Topic filters (with '+' and '#' wildcards) are registered with a handler
+ *   and compiled into a flat trie: one node per topic level, exact children
+ *   sorted for binary search.
+ * - topic_router_dispatch() is fed straight from MQTT_EVENT_DATA. Handlers
+ *   get pointer/length views into the event buffers, nothing is copied.
+ * - Fragmented payloads: the first fragment is matched; the following
+ *   fragments (no topic, current_data_offset > 0) go to the same handlers.
+ *   Handlers registered with TOPIC_ROUTER_FLAG_WHOLE get one call with the
+ *   reassembled payload instead (the only case that copies). A payload above
+ *   max_reassembly is not delivered to them; dispatch returns -1 for its first fragment.
+ * - Not thread-safe: register everything first, then dispatch from the MQTT task.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define TOPIC_ROUTER_FLAG_WHOLE     (1U << 0)   /* deliver fragmented payloads reassembled */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct topic_router topic_router_t;
+
+/* One (fragment of a) message; views are valid during the handler call only */
+typedef struct {
+    const char *topic;          /* topic of the message, also for later fragments */
+    size_t topic_len;
+    const char *data;           /* this fragment */
+    size_t data_len;
+    size_t offset;              /* position of this fragment in the payload */
+    size_t total_len;           /* full payload length */
+} topic_router_msg_t;
+
+typedef void (*topic_router_handler_t)(const topic_router_msg_t *msg, void *ctx);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Create an empty router.
+  * @param  max_reassembly  largest payload reassembled for TOPIC_ROUTER_FLAG_WHOLE handlers
+  * @retval router, NULL if out of memory
+  */
+topic_router_t *topic_router_create(size_t max_reassembly);
+
+/**
+  * @brief  Free the router and everything it allocated.
+  */
+void topic_router_destroy(topic_router_t *router);
+
+/**
+  * @brief  Register a handler for a topic filter. The filter string is copied.
+  * @param  filter   MQTT topic filter, e.g. "site/+/temp" or "site/#"
+  * @param  flags    0 or TOPIC_ROUTER_FLAG_WHOLE
+  * @retval ESP_OK, ESP_ERR_INVALID_ARG (malformed filter), ESP_ERR_NO_MEM
+  */
+esp_err_t topic_router_add(topic_router_t *router, const char *filter, uint32_t flags,
+                           topic_router_handler_t handler, void *ctx);
+
+/**
+  * @brief  Build the lookup trie. Called by topic_router_dispatch() if filters changed;
+  *         call it after the last topic_router_add() to keep allocation out of the data path.
+  * @retval ESP_OK, ESP_ERR_NO_MEM
+  */
+esp_err_t topic_router_compile(topic_router_t *router);
+
+/**
+  * @brief  Route one MQTT_EVENT_DATA event.
+  * @param  topic, topic_len  event->topic / topic_len (not NUL terminated; empty for later fragments)
+  * @param  data, data_len    event->data / data_len
+  * @param  offset            event->current_data_offset
+  * @param  total_len         event->total_data_len
+  * @retval number of handlers that matched, -1 on error (out of memory, unexpected fragment,
+  *         or first fragment of a payload above max_reassembly that TOPIC_ROUTER_FLAG_WHOLE
+  *         handlers matched: they are skipped, the other handlers still get every fragment)
+  */
+int topic_router_dispatch(topic_router_t *router, const char *topic, size_t topic_len,
+                          const char *data, size_t data_len, size_t offset, size_t total_len);
+
+/* ***** END OF FILE ******************************************************** */
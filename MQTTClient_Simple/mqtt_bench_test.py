@@ -0,0 +1,59 @@
+import re
+from threading import Thread
+
+import ttfw_idf
+from common_test_methods import get_host_ip4_by_dest_ip
+from tiny_test_fw import DUT
+
+from telemetry_broker_stub import run as run_broker_stub
+
+BENCH_LATENCY = re.compile(r'BENCH qos=(\d) (rtt|ack) n=(\d+) lost=(\d+) min=(\d+) mean=(\d+) p50=(\d+) p90=(\d+) p99=(\d+) max=(\d+)')
+BENCH_THROUGHPUT = re.compile(r'BENCH qos=(\d) throughput sent=(\d+) received=(\d+) lost=(\d+) failed=(\d+) msgs_per_s=([\d.]+)')
+
+
+def broker_stub_thread(my_ip, port, duration):
+    run_broker_stub(my_ip, port, '/topic/telemetry', duration, connect_timeout=60)
+
+
+@ttfw_idf.idf_example_test(env_tag='ethernet_router')
+def test_examples_protocol_mqtt_bench(env, extra_data):
+    """
+    steps: (loopback latency and throughput, sdkconfig.ci.bench)
+      1. start the broker stub on the host; it echoes publishes back to subscribers
+      2. DUT client connects, publishes probes to its own subscription for QoS 0, 1, 2
+      3. test collects the "BENCH" result lines and logs percentiles and msgs/s per QoS
+    """
+    dut1 = env.get_dut('mqtt_tcp', 'examples/protocols/mqtt/tcp', dut_class=ttfw_idf.ESP32DUT, app_config_name='bench')
+    dut1.start_app()
+    try:
+        ip_address = dut1.expect(re.compile(r'IPv4 address: (\d+\.\d+\.\d+\.\d+)[^\d]'), timeout=30)[0]
+        print('Connected to AP/Ethernet with IP: {}'.format(ip_address))
+    except DUT.ExpectTimeout:
+        raise ValueError('ENV_TEST_FAILURE: Cannot connect to AP/Ethernet')
+
+    host_ip = get_host_ip4_by_dest_ip(ip_address)
+    thread1 = Thread(target=broker_stub_thread, args=(host_ip, 1883, 60))
+    thread1.start()
+    dut1.write('mqtt://' + host_ip + '\n')
+
+    for qos in range(3):
+        lines = [dut1.expect(BENCH_LATENCY, timeout=60)]
+        if qos > 0:
+            lines.append(dut1.expect(BENCH_LATENCY, timeout=30))
+        for q, what, n, lost, _, mean, p50, p90, p99, max_us in lines:
+            print('QoS {} {}: n={} lost={} mean={} p50={} p90={} p99={} max={} us'.format(q, what, n, lost, mean, p50, p90, p99, max_us))
+            ttfw_idf.log_performance('mqtt_qos{}_{}_p50_us'.format(q, what), p50)
+            ttfw_idf.log_performance('mqtt_qos{}_{}_p99_us'.format(q, what), p99)
+            if int(n) == 0:
+                raise ValueError('Benchmark failure: no {} samples for QoS {}'.format(what, q))
+        q, sent, received, lost, failed, rate = dut1.expect(BENCH_THROUGHPUT, timeout=60)
+        print('QoS {} throughput: {} msgs/s ({} sent, {} received, {} lost)'.format(q, rate, sent, received, lost))
+        ttfw_idf.log_performance('mqtt_qos{}_msgs_per_sec'.format(q), rate)
+        if int(received) == 0:
+            raise ValueError('Benchmark failure: no probes echoed in the QoS {} throughput run'.format(q))
+    dut1.expect('BENCH done', timeout=30)
+    thread1.join()
+
+
+if __name__ == '__main__':
+    test_examples_protocol_mqtt_bench()
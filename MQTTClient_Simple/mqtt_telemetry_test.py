@@ -0,0 +1,55 @@
+import re
+from threading import Thread
+
+import ttfw_idf
+from common_test_methods import get_host_ip4_by_dest_ip
+from tiny_test_fw import DUT
+
+from telemetry_broker_stub import run as run_broker_stub
+
+result = None
+
+
+def broker_stub_thread(my_ip, port, duration):
+    global result
+    result = run_broker_stub(my_ip, port, '/topic/telemetry', duration, connect_timeout=60)
+
+
+@ttfw_idf.idf_example_test(env_tag='ethernet_router')
+def test_examples_protocol_mqtt_telemetry(env, extra_data):
+    """
+    steps: (batched telemetry throughput)
+      1. start the broker stub on the host
+      2. DUT client connects and publishes synthetic samples (sdkconfig.ci.telemetry: 1000 samples/s, 500 ms window)
+      3. broker stub decodes every batch and reports msgs/s, bytes/s and samples/s
+      4. test checks that batches arrived, all decoded, and roughly one message per window was sent
+    """
+    dut1 = env.get_dut('mqtt_tcp', 'examples/protocols/mqtt/tcp', dut_class=ttfw_idf.ESP32DUT, app_config_name='telemetry')
+    dut1.start_app()
+    try:
+        ip_address = dut1.expect(re.compile(r'IPv4 address: (\d+\.\d+\.\d+\.\d+)[^\d]'), timeout=30)[0]
+        print('Connected to AP/Ethernet with IP: {}'.format(ip_address))
+    except DUT.ExpectTimeout:
+        raise ValueError('ENV_TEST_FAILURE: Cannot connect to AP/Ethernet')
+
+    duration = 20
+    host_ip = get_host_ip4_by_dest_ip(ip_address)
+    thread1 = Thread(target=broker_stub_thread, args=(host_ip, 1883, duration))
+    thread1.start()
+    dut1.write('mqtt://' + host_ip + '\n')
+    thread1.join()
+
+    messages, nbytes, samples, bad = result
+    ttfw_idf.log_performance('mqtt_telemetry_msgs_per_sec', '{:.1f}'.format(messages / duration))
+    ttfw_idf.log_performance('mqtt_telemetry_bytes_per_sec', '{:.0f}'.format(nbytes / duration))
+    ttfw_idf.log_performance('mqtt_telemetry_samples_per_sec', '{:.0f}'.format(samples / duration))
+    if samples == 0 or bad != 0:
+        raise ValueError('Telemetry failure: {} samples received, {} bad batches'.format(samples, bad))
+    # 500 ms window -> about 2 batches/s; allow the demo publishes and some slack
+    if messages > duration * 4 + 10:
+        raise ValueError('Batching failure: {} messages for {} samples'.format(messages, samples))
+    print('PASS: {} samples in {} messages'.format(samples, messages))
+
+
+if __name__ == '__main__':
+    test_examples_protocol_mqtt_telemetry()
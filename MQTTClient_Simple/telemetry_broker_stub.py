@@ -0,0 +1,289 @@
+#!/usr/bin/env python
+#
+# Minimal MQTT 3.1.1 broker stand-in for measuring the telemetry publisher.
+#
+# Accepts any number of clients, acknowledges CONNECT/SUBSCRIBE/UNSUBSCRIBE/PING
+# and QoS 1/2 publishes, and counts PUBLISH messages and wire bytes per second.
+# Payloads on the telemetry topic are decoded as batches (see main/telemetry.h)
+# so the sample rate is reported as well. Publishes are forwarded to subscribed
+# clients (at the granted QoS), which is all the loopback benchmark
+# (main/mqtt_bench.c) needs. Only the Python standard library is used.
+#
+# Usage (device configured with Broker URL 'mqtt://<host-ip>'):
+#   python telemetry_broker_stub.py --port 1883 --duration 30
+#
+import argparse
+import socket
+import struct
+import threading
+import time
+
+BATCH_HEADER = struct.Struct('<BBHI')
+BATCH_SAMPLE = struct.Struct('<HBi')
+
+
+def decode_batch(payload):
+    """Return the list of (t_ms, channel, value) samples of one telemetry batch."""
+    if len(payload) < BATCH_HEADER.size:
+        raise ValueError('short batch: {} bytes'.format(len(payload)))
+    version, _, count, base_ms = BATCH_HEADER.unpack_from(payload, 0)
+    if version != 1:
+        raise ValueError('unknown batch version {}'.format(version))
+    if len(payload) != BATCH_HEADER.size + count * BATCH_SAMPLE.size:
+        raise ValueError('batch length {} does not match count {}'.format(len(payload), count))
+    samples = []
+    for i in range(count):
+        dt_ms, channel, value = BATCH_SAMPLE.unpack_from(payload, BATCH_HEADER.size + i * BATCH_SAMPLE.size)
+        samples.append((base_ms + dt_ms, channel, value))
+    return samples
+
+
+class Stats(object):
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.messages = 0
+        self.bytes = 0
+        self.samples = 0
+        self.bad_batches = 0
+
+    def add(self, wire_len, samples=0, bad=False):
+        with self.lock:
+            self.messages += 1
+            self.bytes += wire_len
+            self.samples += samples
+            self.bad_batches += int(bad)
+
+    def snapshot(self):
+        with self.lock:
+            return self.messages, self.bytes, self.samples, self.bad_batches
+
+
+def topic_matches(topic_filter, topic):
+    """MQTT filter match with '+' and '#' wildcards."""
+    if topic.startswith('$') and topic_filter[:1] in ('+', '#'):
+        return False
+    flevels = topic_filter.split('/')
+    tlevels = topic.split('/')
+    for i, f in enumerate(flevels):
+        if f == '#':
+            return True
+        if i >= len(tlevels) or (f != '+' and f != tlevels[i]):
+            return False
+    return len(flevels) == len(tlevels)
+
+
+def encode_length(n):
+    out = b''
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        out += bytes([b | 0x80 if n else b])
+        if not n:
+            return out
+
+
+class Session(object):
+    """One connected client: its subscriptions and a send lock (forwarding runs on other threads)."""
+
+    def __init__(self, conn):
+        self.conn = conn
+        self.lock = threading.Lock()
+        self.subs = {}
+        self.next_pid = 0
+
+    def send(self, data):
+        with self.lock:
+            self.conn.sendall(data)
+
+    def forward(self, topic, payload, qos):
+        granted = None
+        with self.lock:
+            for topic_filter, sub_qos in self.subs.items():
+                if topic_matches(topic_filter, topic):
+                    granted = max(granted if granted is not None else 0, sub_qos)
+        if granted is None:
+            return
+        qos = min(qos, granted)
+        tbytes = topic.encode('utf-8')
+        body = struct.pack('>H', len(tbytes)) + tbytes
+        if qos:
+            with self.lock:
+                self.next_pid = self.next_pid % 0xFFFF + 1
+                body += struct.pack('>H', self.next_pid)
+        body += payload
+        self.send(bytes([0x30 | (qos << 1)]) + encode_length(len(body)) + body)
+
+
+class Broker(object):
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.sessions = []
+
+    def add(self, session):
+        with self.lock:
+            self.sessions.append(session)
+
+    def remove(self, session):
+        with self.lock:
+            self.sessions.remove(session)
+
+    def publish(self, topic, payload, qos):
+        with self.lock:
+            sessions = list(self.sessions)
+        for session in sessions:
+            try:
+                session.forward(topic, payload, qos)
+            except OSError:
+                pass
+
+
+def recv_exact(conn, n):
+    buf = b''
+    while len(buf) < n:
+        chunk = conn.recv(n - len(buf))
+        if not chunk:
+            raise EOFError()
+        buf += chunk
+    return buf
+
+
+def read_packet(conn):
+    """Return (first header byte, body, bytes on the wire)."""
+    first = recv_exact(conn, 1)[0]
+    length = 0
+    shift = 0
+    header_len = 1
+    while True:
+        b = recv_exact(conn, 1)[0]
+        header_len += 1
+        length |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            break
+    return first, recv_exact(conn, length), header_len + length
+
+
+def serve_client(conn, broker, topic, stats, verbose):
+    session = Session(conn)
+    broker.add(session)
+    try:
+        while True:
+            first, body, wire_len = read_packet(conn)
+            ptype = first >> 4
+            if ptype == 1:      # CONNECT
+                session.send(bytes([0x20, 0x02, 0x00, 0x00]))
+            elif ptype == 3:    # PUBLISH
+                qos = (first >> 1) & 0x3
+                tlen = struct.unpack_from('>H', body, 0)[0]
+                ptopic = body[2:2 + tlen].decode('utf-8', 'replace')
+                pos = 2 + tlen
+                if qos:
+                    pid = body[pos:pos + 2]
+                    pos += 2
+                    session.send(bytes([0x40 if qos == 1 else 0x50, 0x02]) + pid)
+                payload = body[pos:]
+                broker.publish(ptopic, payload, qos)
+                if ptopic == topic:
+                    try:
+                        samples = decode_batch(payload)
+                        stats.add(wire_len, len(samples))
+                    except ValueError as e:
+                        print('bad batch: {}'.format(e))
+                        stats.add(wire_len, bad=True)
+                else:
+                    stats.add(wire_len)
+                if verbose:
+                    print('PUBLISH {} qos={} len={}'.format(ptopic, qos, len(payload)))
+            elif ptype == 5:    # PUBREC for a forwarded QoS 2 publish
+                session.send(bytes([0x62, 0x02]) + body[:2])
+            elif ptype == 6:    # PUBREL
+                session.send(bytes([0x70, 0x02]) + body[:2])
+            elif ptype == 8:    # SUBSCRIBE: grant the requested QoS, a new subscription replaces an old one
+                pos, granted = 2, b''
+                while pos < len(body):
+                    flen = struct.unpack_from('>H', body, pos)[0]
+                    topic_filter = body[pos + 2:pos + 2 + flen].decode('utf-8', 'replace')
+                    sub_qos = min(body[pos + 2 + flen] & 0x3, 2)
+                    with session.lock:
+                        session.subs[topic_filter] = sub_qos
+                    pos += 2 + flen + 1
+                    granted += bytes([sub_qos])
+                session.send(bytes([0x90, 2 + len(granted)]) + body[:2] + granted)
+            elif ptype == 10:   # UNSUBSCRIBE
+                pos = 2
+                while pos < len(body):
+                    flen = struct.unpack_from('>H', body, pos)[0]
+                    with session.lock:
+                        session.subs.pop(body[pos + 2:pos + 2 + flen].decode('utf-8', 'replace'), None)
+                    pos += 2 + flen
+                session.send(bytes([0xB0, 0x02]) + body[:2])
+            elif ptype == 12:   # PINGREQ
+                session.send(bytes([0xD0, 0x00]))
+            elif ptype == 14:   # DISCONNECT
+                break
+    except (EOFError, OSError):
+        pass
+    finally:
+        broker.remove(session)
+        conn.close()
+
+
+def run(host, port, topic, duration, verbose=False, connect_timeout=None):
+    """Serve for 'duration' seconds, print per-second rates and return the totals."""
+    stats = Stats()
+    broker = Broker()
+    srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    srv.bind((host, port))
+    srv.listen(4)
+    srv.settimeout(0.5)
+    print('Broker stub listening on {}:{}, telemetry topic {}'.format(host, port, topic))
+
+    start = None
+    last = (0, 0, 0, 0)
+    last_t = listen_t = time.time()
+    while start is None or time.time() - start < duration:
+        if start is None and connect_timeout is not None and time.time() - listen_t > connect_timeout:
+            srv.close()
+            raise RuntimeError('no client connected within {} s'.format(connect_timeout))
+        try:
+            conn, addr = srv.accept()
+            print('client connected from {}'.format(addr[0]))
+            # PUBACK and the forwarded PUBLISH are separate writes; without this Nagle delays the echo
+            conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            if start is None:
+                start = time.time()
+                last_t = start
+            threading.Thread(target=serve_client, args=(conn, broker, topic, stats, verbose), daemon=True).start()
+        except socket.timeout:
+            pass
+        now = time.time()
+        if start is not None and now - last_t >= 1.0:
+            cur = stats.snapshot()
+            dt = now - last_t
+            print('{:6.1f} msgs/s {:9.0f} bytes/s {:8.0f} samples/s'.format(
+                (cur[0] - last[0]) / dt, (cur[1] - last[1]) / dt, (cur[2] - last[2]) / dt))
+            last, last_t = cur, now
+    srv.close()
+
+    messages, nbytes, samples, bad = stats.snapshot()
+    elapsed = time.time() - start
+    print('Total: {} msgs, {} bytes, {} samples, {} bad batches in {:.1f} s'.format(messages, nbytes, samples, bad, elapsed))
+    print('Average: {:.1f} msgs/s, {:.0f} bytes/s, {:.0f} samples/s'.format(
+        messages / elapsed, nbytes / elapsed, samples / elapsed))
+    return messages, nbytes, samples, bad
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MQTT broker stand-in measuring telemetry throughput (also echoes publishes to subscribers)')
+    parser.add_argument('--host', default='0.0.0.0')
+    parser.add_argument('--port', type=int, default=1883)
+    parser.add_argument('--topic', default='/topic/telemetry', help='topic carrying packed batches')
+    parser.add_argument('-d', '--duration', type=float, default=30, help='seconds to measure after the first client connects')
+    parser.add_argument('-v', '--verbose', action='store_true', help='print every PUBLISH')
+    args = parser.parse_args()
+    run(args.host, args.port, args.topic, args.duration, args.verbose)
+
+
+if __name__ == '__main__':
+    main()
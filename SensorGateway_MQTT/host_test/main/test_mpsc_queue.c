@@ -0,0 +1,149 @@
+/*
+ ******************************************************************************
+ * @file           : test_mpsc_queue.c
+ * @brief          : Host test for mpsc_queue.c
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Single-thread checks for FIFO order, full/empty and wrap-around, then a
+ *   stress run with several pthread producers against one consumer: every
+ *   accepted element must come out exactly once and in per-producer order.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include "unity.h"
+#include "mpsc_queue.h"
+
+/* Private define ------------------------------------------------------------*/
+#define STRESS_PRODUCERS    4
+#define STRESS_PER_PRODUCER 50000
+#define STRESS_CAPACITY     64
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint32_t producer;
+    uint32_t seq;
+} stress_elem_t;
+
+typedef struct {
+    mpsc_queue_t *q;
+    uint32_t producer;
+} stress_arg_t;
+
+/* Private functions ---------------------------------------------------------*/
+static void test_init_rejects_bad_capacity(void)
+{
+    mpsc_queue_t q;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mpsc_queue_init(&q, 0, sizeof(int)));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mpsc_queue_init(&q, 12, sizeof(int)));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, mpsc_queue_init(&q, 8, 0));
+}
+
+static void test_fifo_full_and_empty(void)
+{
+    mpsc_queue_t q;
+    int v;
+    TEST_ASSERT_EQUAL(ESP_OK, mpsc_queue_init(&q, 4, sizeof(int)));
+    TEST_ASSERT_EQUAL(4, mpsc_queue_capacity(&q));
+    TEST_ASSERT_FALSE(mpsc_queue_pop(&q, &v));
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(mpsc_queue_push(&q, &i));
+    }
+    v = 99;
+    TEST_ASSERT_FALSE(mpsc_queue_push(&q, &v));
+    TEST_ASSERT_EQUAL(4, mpsc_queue_depth(&q));
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(mpsc_queue_pop(&q, &v));
+        TEST_ASSERT_EQUAL(i, v);
+    }
+    TEST_ASSERT_FALSE(mpsc_queue_pop(&q, &v));
+    TEST_ASSERT_EQUAL(0, mpsc_queue_depth(&q));
+    mpsc_queue_deinit(&q);
+}
+
+static void test_wraps_around(void)
+{
+    mpsc_queue_t q;
+    int next_in = 0, next_out = 0, v;
+    TEST_ASSERT_EQUAL(ESP_OK, mpsc_queue_init(&q, 8, sizeof(int)));
+    for (int i = 0; i < 1000; i++) {        // depth moves between 0 and 3, positions wrap many times
+        int burst = 1 + i % 3;
+        for (int j = 0; j < burst; j++) {
+            TEST_ASSERT_TRUE(mpsc_queue_push(&q, &next_in));
+            next_in++;
+        }
+        for (int j = 0; j < burst; j++) {
+            TEST_ASSERT_TRUE(mpsc_queue_pop(&q, &v));
+            TEST_ASSERT_EQUAL(next_out, v);
+            next_out++;
+        }
+    }
+    TEST_ASSERT_FALSE(mpsc_queue_pop(&q, &v));
+    mpsc_queue_deinit(&q);
+}
+
+static void *stress_producer(void *param)
+{
+    const stress_arg_t *arg = param;
+    stress_elem_t e = { .producer = arg->producer };
+    for (e.seq = 0; e.seq < STRESS_PER_PRODUCER; e.seq++) {
+        while (!mpsc_queue_push(arg->q, &e)) {      // full: spin until the consumer catches up
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_many_producers_one_consumer(void)
+{
+    mpsc_queue_t q;
+    pthread_t threads[STRESS_PRODUCERS];
+    stress_arg_t args[STRESS_PRODUCERS];
+    uint32_t next_seq[STRESS_PRODUCERS] = { 0 };
+
+    TEST_ASSERT_EQUAL(ESP_OK, mpsc_queue_init(&q, STRESS_CAPACITY, sizeof(stress_elem_t)));
+    for (uint32_t i = 0; i < STRESS_PRODUCERS; i++) {
+        args[i] = (stress_arg_t){ .q = &q, .producer = i };
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, stress_producer, &args[i]));
+    }
+
+    uint32_t received = 0;
+    while (received < STRESS_PRODUCERS * STRESS_PER_PRODUCER) {
+        stress_elem_t e;
+        if (!mpsc_queue_pop(&q, &e)) {
+            sched_yield();
+            continue;
+        }
+        TEST_ASSERT_LESS_THAN(STRESS_PRODUCERS, e.producer);
+        TEST_ASSERT_EQUAL(next_seq[e.producer], e.seq);     // no loss, no duplicate, no reorder
+        next_seq[e.producer]++;
+        received++;
+    }
+
+    for (uint32_t i = 0; i < STRESS_PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+        TEST_ASSERT_EQUAL(STRESS_PER_PRODUCER, next_seq[i]);
+    }
+    stress_elem_t e;
+    TEST_ASSERT_FALSE(mpsc_queue_pop(&q, &e));
+    mpsc_queue_deinit(&q);
+}
+
+
+void test_mpsc_queue_run(void)
+{
+    RUN_TEST(test_init_rejects_bad_capacity);
+    RUN_TEST(test_fifo_full_and_empty);
+    RUN_TEST(test_wraps_around);
+    RUN_TEST(test_many_producers_one_consumer);
+}
+
+/* ***** END OF FILE ******************************************************** */
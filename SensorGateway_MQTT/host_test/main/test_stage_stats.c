@@ -0,0 +1,108 @@
+/*
+ ******************************************************************************
+ * @file           : test_stage_stats.c
+ * @brief          : Host test for stage_stats.c
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Bucket percentiles, per-window deltas and the reset of max/depth on read.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "unity.h"
+#include "stage_stats.h"
+
+/* Private variables ---------------------------------------------------------*/
+static stage_stats_t s_stats;
+
+/* Private functions ---------------------------------------------------------*/
+static void test_empty_window_is_zero(void)
+{
+    stage_stats_window_t w;
+    stage_stats_init(&s_stats, "test");
+    stage_stats_read(&s_stats, &w);
+    TEST_ASSERT_EQUAL(0, w.count);
+    TEST_ASSERT_EQUAL(0, w.p50_us);
+    TEST_ASSERT_EQUAL(0, w.p99_us);
+    TEST_ASSERT_EQUAL(0, w.max_us);
+    TEST_ASSERT_EQUAL_STRING("test", s_stats.name);
+}
+
+static void test_percentiles_are_bucket_bounds(void)
+{
+    stage_stats_window_t w;
+    stage_stats_init(&s_stats, "test");
+    for (int i = 0; i < 98; i++) {
+        stage_stats_observe(&s_stats, 100);     // bucket <= 128 us
+    }
+    stage_stats_observe(&s_stats, 1000);        // bucket <= 1024 us
+    stage_stats_observe(&s_stats, 3000);        // bucket <= 4096 us
+    stage_stats_read(&s_stats, &w);
+    TEST_ASSERT_EQUAL(100, w.count);
+    TEST_ASSERT_EQUAL(128, w.p50_us);
+    TEST_ASSERT_EQUAL(1024, w.p99_us);
+    TEST_ASSERT_EQUAL(3000, w.max_us);
+    TEST_ASSERT_EQUAL((98 * 100 + 1000 + 3000) / 100, w.mean_us);
+}
+
+static void test_bucket_edges(void)
+{
+    stage_stats_window_t w;
+    stage_stats_init(&s_stats, "test");
+    stage_stats_observe(&s_stats, 16);          // exactly on the first bound
+    stage_stats_read(&s_stats, &w);
+    TEST_ASSERT_EQUAL(16, w.p50_us);
+
+    stage_stats_observe(&s_stats, 0);           // below the first bound: clamped to max
+    stage_stats_read(&s_stats, &w);
+    TEST_ASSERT_EQUAL(1, w.count);
+    TEST_ASSERT_EQUAL(16, w.p50_us);
+
+    stage_stats_observe(&s_stats, 17);          // just above: next bucket, clamped to max
+    stage_stats_read(&s_stats, &w);
+    TEST_ASSERT_EQUAL(17, w.p50_us);
+
+    stage_stats_observe(&s_stats, UINT32_MAX);  // +Inf bucket reports the max
+    stage_stats_read(&s_stats, &w);
+    TEST_ASSERT_EQUAL(UINT32_MAX, w.p99_us);
+}
+
+static void test_windows_are_deltas(void)
+{
+    stage_stats_window_t w;
+    stage_stats_init(&s_stats, "test");
+    stage_stats_observe(&s_stats, 5000);
+    stage_stats_drop(&s_stats);
+    stage_stats_depth(&s_stats, 7);
+    stage_stats_depth(&s_stats, 3);
+    stage_stats_read(&s_stats, &w);
+    TEST_ASSERT_EQUAL(1, w.count);
+    TEST_ASSERT_EQUAL(1, w.dropped);
+    TEST_ASSERT_EQUAL(7, w.depth_max);
+    TEST_ASSERT_EQUAL(5000, w.max_us);
+
+    stage_stats_observe(&s_stats, 20);
+    stage_stats_observe(&s_stats, 20);
+    stage_stats_read(&s_stats, &w);
+    TEST_ASSERT_EQUAL(2, w.count);
+    TEST_ASSERT_EQUAL(0, w.dropped);
+    TEST_ASSERT_EQUAL(0, w.depth_max);
+    TEST_ASSERT_EQUAL(20, w.max_us);            // max of this window only
+    TEST_ASSERT_EQUAL(20, w.mean_us);
+    TEST_ASSERT_EQUAL(20, w.p99_us);
+}
+
+
+void test_stage_stats_run(void)
+{
+    RUN_TEST(test_empty_window_is_zero);
+    RUN_TEST(test_percentiles_are_bucket_bounds);
+    RUN_TEST(test_bucket_edges);
+    RUN_TEST(test_windows_are_deltas);
+}
+
+/* ***** END OF FILE ******************************************************** */
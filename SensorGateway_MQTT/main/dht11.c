@@ -0,0 +1,104 @@
+/*
+ ******************************************************************************
+ * @file           : dht11.c
+ * @brief          : DHT11 single-wire reader
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Start: hold the line low for 18 ms, then the sensor answers low/high/low.
+ * - Data: 40 bits; each bit is a ~50 us low followed by a high pulse of
+ *   ~27 us (0) or ~70 us (1). Bytes: RH int, RH dec, T int, T dec, checksum.
+ * - The 40 bits (~4 ms) are sampled inside a critical section so an interrupt
+ *   or a task switch on this core cannot stretch a pulse measurement.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "dht11.h"
+
+#include <stdbool.h>
+
+#include "esp_log.h"
+#include "esp_rom_sys.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DHT11_START_LOW_US      18000
+#define DHT11_RETRY_DELAY_MS    20
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "dht11";
+static portMUX_TYPE s_dht11_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* Private function prototypes -----------------------------------------------*/
+static int wait_for_state(gpio_num_t pin, int state, int timeout_us);
+static bool handshake(gpio_num_t pin);
+
+
+esp_err_t dht11_read(gpio_num_t pin, int retries, dht11_reading_t *reading)
+{
+    bool answered = false;
+    for (int i = 0; i < retries && !answered; i++) {
+        answered = handshake(pin);
+        if (!answered) {
+            vTaskDelay(pdMS_TO_TICKS(DHT11_RETRY_DELAY_MS));
+        }
+    }
+    if (!answered) {
+        ESP_LOGE(TAG, "No response on GPIO %d", pin);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint8_t data[5] = { 0 };
+    portENTER_CRITICAL(&s_dht11_mux);
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 8; j++) {
+            int zero_duration = wait_for_state(pin, 1, 58);
+            int one_duration = wait_for_state(pin, 0, 74);
+            data[i] |= (one_duration > zero_duration) << (7 - j);
+        }
+    }
+    portEXIT_CRITICAL(&s_dht11_mux);
+
+    if (((data[0] + data[1] + data[2] + data[3]) & 0xFF) != data[4]) {
+        ESP_LOGE(TAG, "Wrong checksum");
+        return ESP_ERR_INVALID_CRC;
+    }
+    reading->humidity_x10 = data[0] * 10 + data[1];
+    reading->temperature_x10 = data[2] * 10 + data[3];
+    return ESP_OK;
+}
+
+/* Busy-wait until the line is at 'state'; returns the microseconds waited, -1 on timeout */
+static int wait_for_state(gpio_num_t pin, int state, int timeout_us)
+{
+    int count = 0;
+    while (gpio_get_level(pin) != state) {
+        if (count >= timeout_us) {
+            return -1;
+        }
+        count += 2;
+        esp_rom_delay_us(2);
+    }
+    return count;
+}
+
+/* Start signal and the sensor's low/high/low answer */
+static bool handshake(gpio_num_t pin)
+{
+    gpio_set_direction(pin, GPIO_MODE_OUTPUT);
+    gpio_set_level(pin, 0);
+    esp_rom_delay_us(DHT11_START_LOW_US);
+    gpio_set_level(pin, 1);
+    gpio_set_direction(pin, GPIO_MODE_INPUT);
+
+    return wait_for_state(pin, 0, 40) >= 0 &&
+           wait_for_state(pin, 1, 90) >= 0 &&
+           wait_for_state(pin, 0, 90) >= 0;
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,38 @@
+/*
+ ******************************************************************************
+ * @file           : dht11.h
+ * @brief          : Header for dht11.c (DHT11 single-wire reader)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Same protocol handling as DHT11/main/main.c, as a module with integer
+ *   results (tenths) so readings can be queued without floats.
+ * - A read busy-waits for about 25 ms; the sensor allows one read per second.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct {
+    int16_t temperature_x10;    /* degC * 10 */
+    uint16_t humidity_x10;      /* %RH * 10 */
+} dht11_reading_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Read temperature and humidity.
+  * @param  pin      data pin (open drain with pull-up)
+  * @param  retries  start handshakes tried before giving up
+  * @retval ESP_OK, ESP_ERR_TIMEOUT (no response), ESP_ERR_INVALID_CRC (bad checksum)
+  */
+esp_err_t dht11_read(gpio_num_t pin, int retries, dht11_reading_t *reading);
+
+/* ***** END OF FILE ******************************************************** */
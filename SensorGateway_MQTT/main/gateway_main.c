@@ -0,0 +1,141 @@
+/*
+ ******************************************************************************
+ * @file           : gateway_main.c
+ * @brief          : Main program body (DHT11 + ADC to MQTT gateway)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * script (this) related infos:
+ * 	- combines the DHT11, ADC_Potentiometer and MQTTClient_Simple examples
+ * 	- Related doc/file can be found at location '<git-repo-root-folder>/zz_docs/...'
+ ******************************************************************************
+ * Description:
+ * - MCU: ESP32-NodeMCU Dev Board
+ * - Pins: DHT11 data on GPIO 4, potentiometer on ADC1 channel 0 (GPIO 36)
+ * - Pipeline (one task per stage, each pinned to the core set in menuconfig):
+ * 		dht11 task ─┐
+ * 		            ├─> lock-free sample queue ─> serializer ─> batch queue ─> publisher ─> MQTT
+ * 		adc task ───┘
+ * - Steps:
+ * 		1. Build project
+ * 		2. Open sdkconfig
+ * 			|- Go to Gateway Configuration > set WiFi SSID/Password and Broker URL
+ * 			|- Go to Gateway Pipeline > set rates, batch window and task cores
+ * 		3. Flash and monitor; every GATEWAY_STATS_INTERVAL_S one line per stage is logged
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "mqtt_client.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "wifi_manager.h"
+#include "pipeline.h"
+#include "producers.h"
+
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "gateway";
+static esp_mqtt_client_handle_t s_client;
+
+
+/* Private function prototypes -----------------------------------------------*/
+static void on_wifi_ready(esp_netif_t *netif, wifi_manager_path_t path, uint32_t ready_ms, void *ctx);
+static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data);
+static void stats_task(void *param);
+
+
+/**
+  * @brief  The application entry point.
+  * @retval int
+  */
+void app_main(void)
+{
+    ESP_LOGI(TAG, "[APP] Startup..");
+    ESP_LOGI(TAG, "[APP] IDF version: %s", esp_get_idf_version());
+
+    // NVS, netif and the default event loop are brought up by the wifi manager
+    wifi_manager_config_t wifi_manager_config = {
+        .on_ready = on_wifi_ready,
+    };
+    ESP_ERROR_CHECK(wifi_manager_init(&wifi_manager_config));
+
+    // The client exists before the network so the pipeline can start right away;
+    // it connects once Wi-Fi is up, batches made until then are dropped
+    const esp_mqtt_client_config_t mqtt_cfg = {
+        .broker.address.uri = CONFIG_GATEWAY_BROKER_URL,
+    };
+    s_client = esp_mqtt_client_init(&mqtt_cfg);
+    if (s_client == NULL) {
+        ESP_LOGE(TAG, "Failed to create MQTT client");
+        abort();
+    }
+    esp_mqtt_client_register_event(s_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
+
+    ESP_ERROR_CHECK(pipeline_start(s_client));
+    ESP_ERROR_CHECK(producers_start());
+    if (xTaskCreate(stats_task, "gw_stats", 3072, NULL, 1, NULL) != pdPASS) {
+        ESP_LOGW(TAG, "Failed to start stats task");
+    }
+
+    wifi_config_t wifi_config = {
+        .sta = {
+            .ssid = CONFIG_GATEWAY_WIFI_SSID,
+            .password = CONFIG_GATEWAY_WIFI_PASSWORD,
+        },
+    };
+    ESP_ERROR_CHECK(wifi_manager_start_sta(&wifi_config));
+}
+
+static void on_wifi_ready(esp_netif_t *netif, wifi_manager_path_t path, uint32_t ready_ms, void *ctx)
+{
+    static bool started;
+    ESP_LOGI(TAG, "Network up %lu ms after boot", (unsigned long)ready_ms);
+    if (!started) {
+        started = true;
+        esp_mqtt_client_start(s_client);
+    }
+}
+
+/*
+ * @brief Event handler registered to receive MQTT events
+ */
+static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    switch ((esp_mqtt_event_id_t)event_id) {
+    case MQTT_EVENT_CONNECTED:
+        ESP_LOGI(TAG, "MQTT_EVENT_CONNECTED");
+        pipeline_set_connected(true);
+        break;
+    case MQTT_EVENT_DISCONNECTED:
+        ESP_LOGI(TAG, "MQTT_EVENT_DISCONNECTED");
+        pipeline_set_connected(false);
+        break;
+    case MQTT_EVENT_ERROR:
+        ESP_LOGI(TAG, "MQTT_EVENT_ERROR");
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+  * @brief  Log per-stage depth and latency every CONFIG_GATEWAY_STATS_INTERVAL_S.
+  */
+static void stats_task(void *param)
+{
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_GATEWAY_STATS_INTERVAL_S * 1000));
+        pipeline_log_stats();
+    }
+}
+
+/* ***** END OF FILE ******************************************************** */
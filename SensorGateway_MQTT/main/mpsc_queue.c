@@ -0,0 +1,117 @@
+/*
+ ******************************************************************************
+ * @file           : mpsc_queue.c
+ * @brief          : Lock-free bounded multi-producer, single-consumer queue
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Slot i starts with sequence i. A producer that claimed position pos
+ *   (enqueue_pos CAS) writes the element and publishes it with sequence
+ *   pos + 1. The consumer reads position pos once the sequence is pos + 1 and
+ *   frees the slot for the next lap with sequence pos + capacity.
+ * - Positions are free-running 32-bit counters; differences are taken as
+ *   signed, so wrap-around is fine for any capacity below 2^31.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "mpsc_queue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define CELL_SEQ_SIZE       sizeof(_Atomic uint32_t)
+
+/* Private functions ---------------------------------------------------------*/
+static inline _Atomic uint32_t *cell_seq(const mpsc_queue_t *q, uint32_t pos)
+{
+    return (_Atomic uint32_t *)&q->cells[(pos & q->mask) * q->cell_size];
+}
+
+static inline uint8_t *cell_data(const mpsc_queue_t *q, uint32_t pos)
+{
+    return &q->cells[(pos & q->mask) * q->cell_size + CELL_SEQ_SIZE];
+}
+
+
+esp_err_t mpsc_queue_init(mpsc_queue_t *q, size_t capacity, size_t elem_size)
+{
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0 || capacity > (1U << 30) || elem_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    q->elem_size = elem_size;
+    q->cell_size = (CELL_SEQ_SIZE + elem_size + 3) & ~(size_t)3;     // keep the sequence words aligned
+    q->mask = (uint32_t)capacity - 1;
+    q->cells = malloc(capacity * q->cell_size);
+    if (q->cells == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint32_t i = 0; i < capacity; i++) {
+        atomic_init(cell_seq(q, i), i);
+    }
+    atomic_init(&q->enqueue_pos, 0);
+    atomic_init(&q->dequeue_pos, 0);
+    return ESP_OK;
+}
+
+void mpsc_queue_deinit(mpsc_queue_t *q)
+{
+    free(q->cells);
+    q->cells = NULL;
+}
+
+bool mpsc_queue_push(mpsc_queue_t *q, const void *elem)
+{
+    uint32_t pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        uint32_t seq = atomic_load_explicit(cell_seq(q, pos), memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            // Slot is free for this lap; claim it (pos is reloaded if another producer won)
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   // slot still holds the element of the previous lap: full
+        } else {
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(cell_data(q, pos), elem, q->elem_size);
+    atomic_store_explicit(cell_seq(q, pos), pos + 1, memory_order_release);
+    return true;
+}
+
+bool mpsc_queue_pop(mpsc_queue_t *q, void *elem)
+{
+    uint32_t pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    uint32_t seq = atomic_load_explicit(cell_seq(q, pos), memory_order_acquire);
+    if ((int32_t)(seq - (pos + 1)) < 0) {
+        return false;       // claimed but not written yet, or nothing claimed
+    }
+
+    memcpy(elem, cell_data(q, pos), q->elem_size);
+    atomic_store_explicit(cell_seq(q, pos), pos + q->mask + 1, memory_order_release);
+    atomic_store_explicit(&q->dequeue_pos, pos + 1, memory_order_relaxed);
+    return true;
+}
+
+size_t mpsc_queue_depth(const mpsc_queue_t *q)
+{
+    uint32_t tail = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    int32_t depth = (int32_t)(head - tail);
+    return depth > 0 ? (size_t)depth : 0;
+}
+
+size_t mpsc_queue_capacity(const mpsc_queue_t *q)
+{
+    return (size_t)q->mask + 1;
+}
+
+/* ***** END OF FILE ******************************************************** */
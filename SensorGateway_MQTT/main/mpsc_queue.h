@@ -0,0 +1,74 @@
+/*
+ ******************************************************************************
+ * @file           : mpsc_queue.h
+ * @brief          : Header for mpsc_queue.c (lock-free multi-producer queue)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Bounded ring of fixed-size elements. Any number of tasks may push, one
+ *   task pops. No mutex and no critical section: producers claim a slot with
+ *   one compare-and-swap, every slot carries a sequence number that tells
+ *   producer and consumer whose turn it is.
+ * - Never blocks. A full queue makes mpsc_queue_push() fail, the caller
+ *   decides whether to drop or retry; an empty one makes mpsc_queue_pop() fail.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct {
+    uint8_t *cells;                 /* capacity cells: u32 sequence + element */
+    size_t cell_size;
+    size_t elem_size;
+    uint32_t mask;                  /* capacity - 1 */
+    _Atomic uint32_t enqueue_pos;   /* next slot a producer claims */
+    _Atomic uint32_t dequeue_pos;   /* next slot the consumer reads (written by the consumer only) */
+} mpsc_queue_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Allocate an empty queue.
+  * @param  capacity   number of elements, power of two
+  * @param  elem_size  size of one element in bytes
+  * @retval ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM
+  */
+esp_err_t mpsc_queue_init(mpsc_queue_t *q, size_t capacity, size_t elem_size);
+
+/**
+  * @brief  Free the queue storage.
+  */
+void mpsc_queue_deinit(mpsc_queue_t *q);
+
+/**
+  * @brief  Copy one element in. Safe from any number of tasks at once.
+  * @retval true, false if the queue is full
+  */
+bool mpsc_queue_push(mpsc_queue_t *q, const void *elem);
+
+/**
+  * @brief  Copy the oldest element out. Only one task may pop.
+  * @retval true, false if the queue is empty
+  */
+bool mpsc_queue_pop(mpsc_queue_t *q, void *elem);
+
+/**
+  * @brief  Elements claimed but not yet popped (a snapshot, may be stale at once).
+  */
+size_t mpsc_queue_depth(const mpsc_queue_t *q);
+
+/**
+  * @brief  Number of elements the queue holds when full.
+  */
+size_t mpsc_queue_capacity(const mpsc_queue_t *q);
+
+/* ***** END OF FILE ******************************************************** */
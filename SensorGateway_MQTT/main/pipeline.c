@@ -0,0 +1,277 @@
+/*
+ ******************************************************************************
+ * @file           : pipeline.c
+ * @brief          : Gateway pipeline: sample queue, serializer and MQTT publisher
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Sample queue: mpsc_queue.c, so producers on either core never take a lock.
+ *   Each push gives the serializer a task notification.
+ * - Batches live in a fixed pool of CONFIG_GATEWAY_BATCH_BUFFERS buffers that
+ *   circulate between a free queue and a full queue. If the publisher falls
+ *   behind, the serializer waits for a free buffer, the sample queue fills and
+ *   producers start dropping: the stage stats show where it backed up.
+ * - A batch is sealed CONFIG_GATEWAY_BATCH_WINDOW_MS after its first sample
+ *   was pushed, or when it holds CONFIG_GATEWAY_BATCH_MAX_SAMPLES samples.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "pipeline.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "mpsc_queue.h"
+#include "stage_stats.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BATCH_VERSION           1
+#define BATCH_HEADER_SIZE       8
+#define BATCH_SAMPLE_SIZE       7
+#define BATCH_BUF_SIZE          (BATCH_HEADER_SIZE + CONFIG_GATEWAY_BATCH_MAX_SAMPLES * BATCH_SAMPLE_SIZE)
+#define SERIALIZER_PRIORITY     5
+#define PUBLISHER_PRIORITY      4
+#define CORE_ID(core)           ((core) < 0 ? tskNO_AFFINITY : (core))
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    int64_t t_us;               /* time of the push */
+    int32_t value;
+    uint8_t channel;
+} pipeline_sample_t;
+
+typedef struct {
+    uint8_t buf[BATCH_BUF_SIZE];
+    uint16_t count;
+    uint32_t base_ms;
+    int64_t oldest_us;          /* push time of the first sample */
+    int64_t sealed_us;
+} pipeline_batch_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "pipeline";
+static const char *const s_stage_names[PIPELINE_STAGE_COUNT] = {
+    "dht11", "adc", "sample_q", "batch_q", "publish", "end2end",
+};
+
+static stage_stats_t s_stages[PIPELINE_STAGE_COUNT];
+static mpsc_queue_t s_samples;
+static pipeline_batch_t *s_batches;
+static QueueHandle_t s_free_batches;        /* pipeline_batch_t * */
+static QueueHandle_t s_full_batches;        /* pipeline_batch_t * */
+static TaskHandle_t s_serializer_task;
+static esp_mqtt_client_handle_t s_client;
+static atomic_bool s_connected;
+
+/* Private function prototypes -----------------------------------------------*/
+static void batch_append(pipeline_batch_t *batch, const pipeline_sample_t *sample);
+static void batch_seal(pipeline_batch_t *batch);
+static void serializer_task(void *param);
+static void publisher_task(void *param);
+
+
+esp_err_t pipeline_start(esp_mqtt_client_handle_t client)
+{
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; i++) {
+        stage_stats_init(&s_stages[i], s_stage_names[i]);
+    }
+
+    esp_err_t err = mpsc_queue_init(&s_samples, CONFIG_GATEWAY_SAMPLE_QUEUE_LEN, sizeof(pipeline_sample_t));
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Sample queue (%d entries): %s", CONFIG_GATEWAY_SAMPLE_QUEUE_LEN, esp_err_to_name(err));
+        return err;
+    }
+
+    s_client = client;
+    s_batches = calloc(CONFIG_GATEWAY_BATCH_BUFFERS, sizeof(pipeline_batch_t));
+    s_free_batches = xQueueCreate(CONFIG_GATEWAY_BATCH_BUFFERS, sizeof(pipeline_batch_t *));
+    s_full_batches = xQueueCreate(CONFIG_GATEWAY_BATCH_BUFFERS, sizeof(pipeline_batch_t *));
+    if (s_batches == NULL || s_free_batches == NULL || s_full_batches == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < CONFIG_GATEWAY_BATCH_BUFFERS; i++) {
+        pipeline_batch_t *batch = &s_batches[i];
+        xQueueSend(s_free_batches, &batch, 0);
+    }
+
+    if (xTaskCreatePinnedToCore(serializer_task, "gw_serializer", 3072, NULL, SERIALIZER_PRIORITY,
+                                &s_serializer_task, CORE_ID(CONFIG_GATEWAY_SERIALIZER_CORE)) != pdPASS ||
+        xTaskCreatePinnedToCore(publisher_task, "gw_publisher", 3072, NULL, PUBLISHER_PRIORITY,
+                                NULL, CORE_ID(CONFIG_GATEWAY_PUBLISHER_CORE)) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void pipeline_set_connected(bool connected)
+{
+    atomic_store(&s_connected, connected);
+}
+
+bool pipeline_push(pipeline_stage_t producer, uint8_t channel, int32_t value)
+{
+    const pipeline_sample_t sample = {
+        .t_us = esp_timer_get_time(),
+        .value = value,
+        .channel = channel,
+    };
+    if (!mpsc_queue_push(&s_samples, &sample)) {
+        stage_stats_drop(&s_stages[producer]);
+        return false;
+    }
+    stage_stats_depth(&s_stages[PIPELINE_STAGE_SAMPLE_QUEUE], mpsc_queue_depth(&s_samples));
+    xTaskNotifyGive(s_serializer_task);
+    return true;
+}
+
+void pipeline_observe(pipeline_stage_t stage, uint32_t latency_us)
+{
+    stage_stats_observe(&s_stages[stage], latency_us);
+}
+
+void pipeline_drop(pipeline_stage_t stage)
+{
+    stage_stats_drop(&s_stages[stage]);
+}
+
+void pipeline_log_stats(void)
+{
+    for (int i = 0; i < PIPELINE_STAGE_COUNT; i++) {
+        stage_stats_window_t w;
+        stage_stats_read(&s_stages[i], &w);
+        if (i == PIPELINE_STAGE_SAMPLE_QUEUE || i == PIPELINE_STAGE_BATCH_QUEUE) {
+            unsigned int depth = (i == PIPELINE_STAGE_SAMPLE_QUEUE) ? (unsigned int)mpsc_queue_depth(&s_samples)
+                                 : (unsigned int)uxQueueMessagesWaiting(s_full_batches);
+            unsigned int capacity = (i == PIPELINE_STAGE_SAMPLE_QUEUE) ? CONFIG_GATEWAY_SAMPLE_QUEUE_LEN
+                                    : CONFIG_GATEWAY_BATCH_BUFFERS;
+            ESP_LOGI(TAG, "%-8s n=%u drop=%u depth=%u max=%u/%u wait p50=%u p99=%u max=%u us (mean %u)",
+                     s_stages[i].name, (unsigned int)w.count, (unsigned int)w.dropped, depth,
+                     (unsigned int)w.depth_max, capacity, (unsigned int)w.p50_us, (unsigned int)w.p99_us,
+                     (unsigned int)w.max_us, (unsigned int)w.mean_us);
+        } else {
+            ESP_LOGI(TAG, "%-8s n=%u drop=%u time p50=%u p99=%u max=%u us (mean %u)",
+                     s_stages[i].name, (unsigned int)w.count, (unsigned int)w.dropped, (unsigned int)w.p50_us,
+                     (unsigned int)w.p99_us, (unsigned int)w.max_us, (unsigned int)w.mean_us);
+        }
+    }
+    ESP_LOGI(TAG, "outbox=%d bytes", esp_mqtt_client_get_outbox_size(s_client));
+}
+
+static void batch_append(pipeline_batch_t *batch, const pipeline_sample_t *sample)
+{
+    uint32_t t_ms = (uint32_t)(sample->t_us / 1000);
+    if (batch->count == 0) {
+        batch->base_ms = t_ms;
+        batch->oldest_us = sample->t_us;
+    }
+    uint32_t dt_ms = t_ms - batch->base_ms;
+    uint8_t *p = &batch->buf[BATCH_HEADER_SIZE + batch->count * BATCH_SAMPLE_SIZE];
+    p[0] = (uint8_t)(dt_ms > 0xFFFF ? 0xFF : dt_ms);
+    p[1] = (uint8_t)(dt_ms > 0xFFFF ? 0xFF : dt_ms >> 8);
+    p[2] = sample->channel;
+    p[3] = (uint8_t)sample->value;
+    p[4] = (uint8_t)(sample->value >> 8);
+    p[5] = (uint8_t)(sample->value >> 16);
+    p[6] = (uint8_t)(sample->value >> 24);
+    batch->count++;
+}
+
+static void batch_seal(pipeline_batch_t *batch)
+{
+    batch->buf[0] = BATCH_VERSION;
+    batch->buf[1] = 0;
+    batch->buf[2] = (uint8_t)batch->count;
+    batch->buf[3] = (uint8_t)(batch->count >> 8);
+    batch->buf[4] = (uint8_t)batch->base_ms;
+    batch->buf[5] = (uint8_t)(batch->base_ms >> 8);
+    batch->buf[6] = (uint8_t)(batch->base_ms >> 16);
+    batch->buf[7] = (uint8_t)(batch->base_ms >> 24);
+    batch->sealed_us = esp_timer_get_time();
+
+    // The pool is no larger than the queue, so this never blocks
+    xQueueSend(s_full_batches, &batch, portMAX_DELAY);
+    stage_stats_depth(&s_stages[PIPELINE_STAGE_BATCH_QUEUE], uxQueueMessagesWaiting(s_full_batches));
+}
+
+/**
+  * @brief  Serializer stage: drain the sample queue into batches.
+  */
+static void serializer_task(void *param)
+{
+    pipeline_batch_t *batch = NULL;
+    int64_t deadline_us = 0;
+
+    for (;;) {
+        TickType_t wait = portMAX_DELAY;
+        if (batch != NULL && batch->count > 0) {
+            int64_t left_us = deadline_us - esp_timer_get_time();
+            wait = left_us > 0 ? pdMS_TO_TICKS(left_us / 1000) + 1 : 0;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        pipeline_sample_t sample;
+        while (mpsc_queue_pop(&s_samples, &sample)) {
+            stage_stats_observe(&s_stages[PIPELINE_STAGE_SAMPLE_QUEUE], (uint32_t)(esp_timer_get_time() - sample.t_us));
+            if (batch == NULL) {
+                // Blocks while every buffer waits for the publisher (back-pressure)
+                xQueueReceive(s_free_batches, &batch, portMAX_DELAY);
+                batch->count = 0;
+            }
+            if (batch->count == 0) {
+                deadline_us = sample.t_us + (int64_t)CONFIG_GATEWAY_BATCH_WINDOW_MS * 1000;
+            }
+            batch_append(batch, &sample);
+            if (batch->count == CONFIG_GATEWAY_BATCH_MAX_SAMPLES) {
+                batch_seal(batch);
+                batch = NULL;
+            }
+        }
+
+        if (batch != NULL && batch->count > 0 && esp_timer_get_time() >= deadline_us) {
+            batch_seal(batch);
+            batch = NULL;
+        }
+    }
+}
+
+/**
+  * @brief  Publisher stage: hand sealed batches to the MQTT outbox.
+  */
+static void publisher_task(void *param)
+{
+    for (;;) {
+        pipeline_batch_t *batch;
+        xQueueReceive(s_full_batches, &batch, portMAX_DELAY);
+        int64_t start_us = esp_timer_get_time();
+        stage_stats_observe(&s_stages[PIPELINE_STAGE_BATCH_QUEUE], (uint32_t)(start_us - batch->sealed_us));
+
+        int msg_id = -1;
+        if (atomic_load(&s_connected) && esp_mqtt_client_get_outbox_size(s_client) <= CONFIG_GATEWAY_OUTBOX_LIMIT) {
+            msg_id = esp_mqtt_client_enqueue(s_client, CONFIG_GATEWAY_TOPIC, (const char *)batch->buf,
+                                             BATCH_HEADER_SIZE + batch->count * BATCH_SAMPLE_SIZE,
+                                             CONFIG_GATEWAY_QOS, 0, true);
+        }
+        int64_t done_us = esp_timer_get_time();
+        if (msg_id >= 0) {
+            stage_stats_observe(&s_stages[PIPELINE_STAGE_PUBLISH], (uint32_t)(done_us - start_us));
+            stage_stats_observe(&s_stages[PIPELINE_STAGE_END_TO_END], (uint32_t)(done_us - batch->oldest_us));
+        } else {
+            stage_stats_drop(&s_stages[PIPELINE_STAGE_PUBLISH]);    // offline or outbox over its limit
+        }
+
+        xQueueSend(s_free_batches, &batch, 0);
+    }
+}
+
+/* ***** END OF FILE ******************************************************** */
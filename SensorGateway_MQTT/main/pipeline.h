@@ -0,0 +1,79 @@
+/*
+ ******************************************************************************
+ * @file           : pipeline.h
+ * @brief          : Header for pipeline.c (sample queue, serializer, publisher)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - producers --(lock-free sample queue)--> serializer --(batch queue)--> publisher --> MQTT
+ * - Producers call pipeline_push() from their own tasks. The serializer packs
+ *   samples into batches in the MQTTClient_Simple telemetry format:
+ *     header (8 bytes) : u8 version (=1), u8 reserved, u16 count, u32 base_ms
+ *     sample (7 bytes) : u16 dt_ms (since base_ms), u8 channel, i32 value
+ * - Every stage records latency, drops and queue depth (stage_stats.h);
+ *   pipeline_log_stats() prints one line per stage.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "mqtt_client.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define GATEWAY_CH_TEMPERATURE      0       /* degC * 10 */
+#define GATEWAY_CH_HUMIDITY         1       /* %RH * 10 */
+#define GATEWAY_CH_ADC              2       /* raw 12-bit reading */
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+    PIPELINE_STAGE_DHT11,           /* latency: sensor read */
+    PIPELINE_STAGE_ADC,             /* latency: conversion */
+    PIPELINE_STAGE_SAMPLE_QUEUE,    /* latency: push to serializer pop; depth: sample queue */
+    PIPELINE_STAGE_BATCH_QUEUE,     /* latency: batch sealed to publisher pick-up; depth: batch queue */
+    PIPELINE_STAGE_PUBLISH,         /* latency: esp_mqtt_client_enqueue() call */
+    PIPELINE_STAGE_END_TO_END,      /* latency: oldest sample of a batch to enqueued */
+    PIPELINE_STAGE_COUNT
+} pipeline_stage_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Create the queues and start the serializer and publisher tasks.
+  * @param  client  MQTT client used for publishing (may not be connected yet)
+  * @retval ESP_OK, ESP_ERR_INVALID_ARG (sample queue length not a power of two), ESP_ERR_NO_MEM
+  */
+esp_err_t pipeline_start(esp_mqtt_client_handle_t client);
+
+/**
+  * @brief  Tell the publisher whether the client is connected (call from the MQTT event handler).
+  */
+void pipeline_set_connected(bool connected);
+
+/**
+  * @brief  Queue one sample without blocking. Safe from any task.
+  * @param  producer  stage the sample comes from; a drop is counted there
+  * @retval true, false if the sample queue was full (sample dropped)
+  */
+bool pipeline_push(pipeline_stage_t producer, uint8_t channel, int32_t value);
+
+/**
+  * @brief  Record a latency for a stage (used by the producers for their read time).
+  */
+void pipeline_observe(pipeline_stage_t stage, uint32_t latency_us);
+
+/**
+  * @brief  Count a sample a producer lost before pushing it (e.g. a missed sampling tick).
+  */
+void pipeline_drop(pipeline_stage_t stage);
+
+/**
+  * @brief  Log the window since the previous call, one line per stage.
+  */
+void pipeline_log_stats(void);
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,150 @@
+/*
+ ******************************************************************************
+ * @file           : producers.c
+ * @brief          : DHT11 and ADC sample producers for the gateway pipeline
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Read times are recorded in the dht11/adc stage stats, samples the queue
+ *   could not take are counted there as drops.
+ * - ADC ticks the task did not get to in time are merged (counting task
+ *   notification) and counted as drops, so a too high rate shows up in the stats.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "producers.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_adc/adc_oneshot.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "dht11.h"
+#include "pipeline.h"
+
+/* Private define ------------------------------------------------------------*/
+#define DHT11_RETRIES           5
+#define PRODUCER_PRIORITY       6
+#define CORE_ID(core)           ((core) < 0 ? tskNO_AFFINITY : (core))
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "producers";
+#if CONFIG_GATEWAY_ADC
+static adc_oneshot_unit_handle_t s_adc;
+static TaskHandle_t s_adc_task;
+static esp_timer_handle_t s_adc_timer;
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+#if CONFIG_GATEWAY_DHT11
+static void dht11_task(void *param);
+#endif
+#if CONFIG_GATEWAY_ADC
+static void adc_timer_cb(void *arg);
+static void adc_task(void *param);
+#endif
+
+
+esp_err_t producers_start(void)
+{
+#if CONFIG_GATEWAY_DHT11
+    gpio_set_pull_mode(CONFIG_GATEWAY_DHT11_GPIO, GPIO_PULLUP_ONLY);
+    if (xTaskCreatePinnedToCore(dht11_task, "gw_dht11", 3072, NULL, PRODUCER_PRIORITY, NULL,
+                                CORE_ID(CONFIG_GATEWAY_DHT11_CORE)) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "DHT11 on GPIO %d every %d ms", CONFIG_GATEWAY_DHT11_GPIO, CONFIG_GATEWAY_DHT11_PERIOD_MS);
+#endif
+
+#if CONFIG_GATEWAY_ADC
+    const adc_oneshot_unit_init_cfg_t unit_cfg = {
+        .unit_id = ADC_UNIT_1,
+    };
+    const adc_oneshot_chan_cfg_t chan_cfg = {
+        .bitwidth = ADC_BITWIDTH_12,
+        .atten = ADC_ATTEN_DB_12,       // full 0..3.3 V range of the potentiometer
+    };
+    esp_err_t err = adc_oneshot_new_unit(&unit_cfg, &s_adc);
+    if (err == ESP_OK) {
+        err = adc_oneshot_config_channel(s_adc, CONFIG_GATEWAY_ADC_CHANNEL, &chan_cfg);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "ADC setup failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    if (xTaskCreatePinnedToCore(adc_task, "gw_adc", 2560, NULL, PRODUCER_PRIORITY, &s_adc_task,
+                                CORE_ID(CONFIG_GATEWAY_ADC_CORE)) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    const esp_timer_create_args_t timer_args = {
+        .callback = adc_timer_cb,
+        .name = "gw_adc",
+    };
+    err = esp_timer_create(&timer_args, &s_adc_timer);
+    if (err == ESP_OK) {
+        err = esp_timer_start_periodic(s_adc_timer, 1000000 / CONFIG_GATEWAY_ADC_RATE_HZ);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    ESP_LOGI(TAG, "ADC1 channel %d at %d Hz", CONFIG_GATEWAY_ADC_CHANNEL, CONFIG_GATEWAY_ADC_RATE_HZ);
+#endif
+
+    return ESP_OK;
+}
+
+#if CONFIG_GATEWAY_DHT11
+/**
+  * @brief  DHT11 producer: temperature and humidity every CONFIG_GATEWAY_DHT11_PERIOD_MS.
+  */
+static void dht11_task(void *param)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;) {
+        dht11_reading_t reading;
+        int64_t start_us = esp_timer_get_time();
+        if (dht11_read(CONFIG_GATEWAY_DHT11_GPIO, DHT11_RETRIES, &reading) == ESP_OK) {
+            pipeline_observe(PIPELINE_STAGE_DHT11, (uint32_t)(esp_timer_get_time() - start_us));
+            pipeline_push(PIPELINE_STAGE_DHT11, GATEWAY_CH_TEMPERATURE, reading.temperature_x10);
+            pipeline_push(PIPELINE_STAGE_DHT11, GATEWAY_CH_HUMIDITY, reading.humidity_x10);
+        }
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(CONFIG_GATEWAY_DHT11_PERIOD_MS));
+    }
+}
+#endif
+
+#if CONFIG_GATEWAY_ADC
+/* esp_timer task: only wakes the ADC task, the conversion runs there */
+static void adc_timer_cb(void *arg)
+{
+    xTaskNotifyGive(s_adc_task);
+}
+
+/**
+  * @brief  ADC producer: one conversion per timer tick.
+  */
+static void adc_task(void *param)
+{
+    for (;;) {
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (uint32_t missed = 1; missed < ticks; missed++) {
+            pipeline_drop(PIPELINE_STAGE_ADC);      // tick merged into this one: that sample was never taken
+        }
+
+        int raw = 0;
+        int64_t start_us = esp_timer_get_time();
+        if (adc_oneshot_read(s_adc, CONFIG_GATEWAY_ADC_CHANNEL, &raw) == ESP_OK) {
+            pipeline_observe(PIPELINE_STAGE_ADC, (uint32_t)(esp_timer_get_time() - start_us));
+            pipeline_push(PIPELINE_STAGE_ADC, GATEWAY_CH_ADC, raw);
+        }
+    }
+}
+#endif
+
+/* ***** END OF FILE ******************************************************** */
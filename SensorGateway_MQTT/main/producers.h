@@ -0,0 +1,31 @@
+/*
+ ******************************************************************************
+ * @file           : producers.h
+ * @brief          : Header for producers.c (DHT11 and ADC sample producers)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - DHT11: one task reads the sensor every CONFIG_GATEWAY_DHT11_PERIOD_MS and
+ *   pushes temperature and humidity (tenths) as two samples.
+ * - ADC: an esp_timer ticks at CONFIG_GATEWAY_ADC_RATE_HZ and wakes the ADC
+ *   task, which converts one channel and pushes the raw value.
+ * - Each producer runs on its own configured core and pushes straight into
+ *   the lock-free sample queue (pipeline_push()).
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include "esp_err.h"
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Start the enabled producers. Call after pipeline_start().
+  * @retval ESP_OK, ESP_ERR_NO_MEM, or the ADC driver error
+  */
+esp_err_t producers_start(void);
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,114 @@
+/*
+ ******************************************************************************
+ * @file           : stage_stats.c
+ * @brief          : Per-stage latency histograms and queue depth for the gateway
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Same bucket layout as the /metrics histograms of WebServer_HTTPD, with a
+ *   finer first bucket because queue hand-offs take microseconds.
+ * - Maxima are reset by the reader with an exchange; a value recorded between
+ *   the exchange and the next window is kept for the next one.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "stage_stats.h"
+
+#include <string.h>
+
+/* Private functions ---------------------------------------------------------*/
+static void atomic_max(atomic_uint *target, unsigned int value)
+{
+    unsigned int cur = atomic_load_explicit(target, memory_order_relaxed);
+    while (value > cur &&
+           !atomic_compare_exchange_weak_explicit(target, &cur, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/* Upper bound of bucket i in microseconds */
+static uint32_t bucket_bound_us(int i)
+{
+    return 1U << (STAGE_STATS_FIRST_BUCKET_LOG2 + i);
+}
+
+/* Upper bound of the bucket holding the pct-th percentile of the window */
+static uint32_t window_percentile(const uint32_t *delta, uint32_t count, unsigned int pct, uint32_t max_us)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)count * pct + 99) / 100);
+    uint32_t seen = 0;
+    for (int i = 0; i < STAGE_STATS_NUM_BUCKETS; i++) {
+        seen += delta[i];
+        if (seen >= rank) {
+            uint32_t bound = bucket_bound_us(i);
+            return (max_us != 0 && max_us < bound) ? max_us : bound;
+        }
+    }
+    return max_us;      // in the +Inf bucket
+}
+
+
+void stage_stats_init(stage_stats_t *stats, const char *name)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->name = name;
+}
+
+void stage_stats_observe(stage_stats_t *stats, uint32_t latency_us)
+{
+    int bucket = 0;
+    if (latency_us > (1U << STAGE_STATS_FIRST_BUCKET_LOG2)) {
+        // smallest i with latency_us <= 2^(FIRST + i)
+        bucket = 32 - __builtin_clz(latency_us - 1) - STAGE_STATS_FIRST_BUCKET_LOG2;
+        if (bucket > STAGE_STATS_NUM_BUCKETS) {
+            bucket = STAGE_STATS_NUM_BUCKETS;
+        }
+    }
+
+    atomic_fetch_add_explicit(&stats->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats->latency_sum_us, latency_us, memory_order_relaxed);
+    atomic_max(&stats->latency_max_us, latency_us);
+    atomic_fetch_add_explicit(&stats->count, 1, memory_order_relaxed);
+}
+
+void stage_stats_drop(stage_stats_t *stats)
+{
+    atomic_fetch_add_explicit(&stats->dropped, 1, memory_order_relaxed);
+}
+
+void stage_stats_depth(stage_stats_t *stats, uint32_t depth)
+{
+    atomic_max(&stats->depth_max, depth);
+}
+
+void stage_stats_read(stage_stats_t *stats, stage_stats_window_t *window)
+{
+    uint32_t delta[STAGE_STATS_NUM_BUCKETS + 1];
+    uint32_t count = 0;
+    for (int i = 0; i <= STAGE_STATS_NUM_BUCKETS; i++) {
+        uint32_t total = atomic_load_explicit(&stats->buckets[i], memory_order_relaxed);
+        delta[i] = total - stats->last_buckets[i];
+        stats->last_buckets[i] = total;
+        count += delta[i];
+    }
+    uint64_t sum = atomic_load_explicit(&stats->latency_sum_us, memory_order_relaxed);
+    uint32_t dropped = atomic_load_explicit(&stats->dropped, memory_order_relaxed);
+
+    memset(window, 0, sizeof(*window));
+    window->count = count;      // from the buckets, so the percentiles add up even if 'count' moved on
+    window->dropped = dropped - stats->last_dropped;
+    window->max_us = atomic_exchange_explicit(&stats->latency_max_us, 0, memory_order_relaxed);
+    window->depth_max = atomic_exchange_explicit(&stats->depth_max, 0, memory_order_relaxed);
+    if (count > 0) {
+        window->mean_us = (uint32_t)((sum - stats->last_sum_us) / count);
+        window->p50_us = window_percentile(delta, count, 50, window->max_us);
+        window->p99_us = window_percentile(delta, count, 99, window->max_us);
+    }
+
+    stats->last_dropped = dropped;
+    stats->last_sum_us = sum;
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,81 @@
+/*
+ ******************************************************************************
+ * @file           : stage_stats.h
+ * @brief          : Header for stage_stats.c (per-stage latency and depth counters)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - One stage_stats_t per pipeline stage. The stage task records latencies,
+ *   drops and the depth of the queue it feeds; all counters are atomics, so
+ *   any task may record and the report task reads without locking.
+ * - Latencies go into power-of-two buckets (<= 16 us, <= 32 us, ...), so
+ *   percentiles are reported as the bucket's upper bound.
+ * - stage_stats_read() returns the window since the previous read.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define STAGE_STATS_FIRST_BUCKET_LOG2   4       /* first bucket: <= 16 us */
+#define STAGE_STATS_NUM_BUCKETS         20      /* last finite bucket: <= 2^23 us (~8 s) */
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct {
+    const char *name;
+    atomic_uint count;
+    atomic_uint dropped;
+    _Atomic uint64_t latency_sum_us;
+    atomic_uint latency_max_us;                     /* since the last read */
+    atomic_uint depth_max;                          /* since the last read */
+    atomic_uint buckets[STAGE_STATS_NUM_BUCKETS + 1];   /* last one is +Inf */
+    /* reader state: totals at the previous stage_stats_read() */
+    uint32_t last_dropped;
+    uint64_t last_sum_us;
+    uint32_t last_buckets[STAGE_STATS_NUM_BUCKETS + 1];
+} stage_stats_t;
+
+typedef struct {
+    uint32_t count;             /* latencies recorded in the window */
+    uint32_t dropped;
+    uint32_t mean_us;
+    uint32_t p50_us;            /* upper bound of the bucket */
+    uint32_t p99_us;
+    uint32_t max_us;
+    uint32_t depth_max;         /* highest queue depth reported in the window */
+} stage_stats_window_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Zero the counters. 'name' is kept by reference.
+  */
+void stage_stats_init(stage_stats_t *stats, const char *name);
+
+/**
+  * @brief  Record one item that went through the stage.
+  */
+void stage_stats_observe(stage_stats_t *stats, uint32_t latency_us);
+
+/**
+  * @brief  Record one item the stage had to drop.
+  */
+void stage_stats_drop(stage_stats_t *stats);
+
+/**
+  * @brief  Report the current depth of the stage's queue (the window keeps the maximum).
+  */
+void stage_stats_depth(stage_stats_t *stats, uint32_t depth);
+
+/**
+  * @brief  Summarize the window since the previous call. One reader only.
+  */
+void stage_stats_read(stage_stats_t *stats, stage_stats_window_t *window);
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,168 @@
+/*
+ ******************************************************************************
+ * @file           : test_captive_dns.c
+ * @brief          : Host test feeding crafted queries to captive_dns_build_response()
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "captive_dns.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TYPE_A      1
+#define TYPE_AAAA   28
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t s_query[CAPTIVE_DNS_MAX_PACKET];
+static uint8_t s_resp[CAPTIVE_DNS_MAX_PACKET];
+static const uint8_t s_softap_ip[4] = { 192, 168, 4, 1 };
+static uint32_t s_softap_ip_n;     /* s_softap_ip in network byte order */
+
+/* Private functions ---------------------------------------------------------*/
+/* Build a query with one question for 'name' (dotted) and return its length */
+static size_t make_query(uint16_t id, uint16_t flags, const char *name, uint16_t qtype)
+{
+    uint8_t *p = s_query;
+    memset(s_query, 0, sizeof(s_query));
+    *p++ = id >> 8; *p++ = id & 0xFF;
+    *p++ = flags >> 8; *p++ = flags & 0xFF;
+    *p++ = 0; *p++ = 1;                 // QDCOUNT
+    p += 6;                             // AN/NS/AR = 0
+    while (*name) {
+        const char *dot = strchr(name, '.');
+        size_t len = dot ? (size_t)(dot - name) : strlen(name);
+        *p++ = len;
+        memcpy(p, name, len);
+        p += len;
+        name += len + (dot ? 1 : 0);
+    }
+    *p++ = 0;
+    *p++ = qtype >> 8; *p++ = qtype & 0xFF;
+    *p++ = 0; *p++ = 1;                 // class IN
+    return p - s_query;
+}
+
+static uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void test_a_query_is_answered_with_softap_ip(void)
+{
+    size_t qlen = make_query(0xBEEF, 0x0100, "connectivitycheck.gstatic.com", TYPE_A);
+    size_t rlen = captive_dns_build_response(s_query, qlen, s_resp, sizeof(s_resp), s_softap_ip_n);
+
+    TEST_ASSERT_EQUAL(qlen + 16, rlen);
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, rd16(s_resp));
+    TEST_ASSERT_EQUAL_HEX16(0x8500, rd16(s_resp + 2));     // QR | AA | RD, NOERROR
+    TEST_ASSERT_EQUAL(1, rd16(s_resp + 4));
+    TEST_ASSERT_EQUAL(1, rd16(s_resp + 6));
+    TEST_ASSERT_EQUAL_MEMORY(s_query + 12, s_resp + 12, qlen - 12);
+
+    const uint8_t *ans = s_resp + qlen;
+    TEST_ASSERT_EQUAL_HEX16(0xC00C, rd16(ans));
+    TEST_ASSERT_EQUAL(TYPE_A, rd16(ans + 2));
+    TEST_ASSERT_EQUAL(1, rd16(ans + 4));
+    TEST_ASSERT_EQUAL(CAPTIVE_DNS_TTL_S, rd16(ans + 8));
+    TEST_ASSERT_EQUAL(4, rd16(ans + 10));
+    TEST_ASSERT_EQUAL_MEMORY(s_softap_ip, ans + 12, 4);
+}
+
+static void test_aaaa_query_gets_empty_answer(void)
+{
+    size_t qlen = make_query(1, 0x0100, "example.com", TYPE_AAAA);
+    size_t rlen = captive_dns_build_response(s_query, qlen, s_resp, sizeof(s_resp), s_softap_ip_n);
+
+    TEST_ASSERT_EQUAL(qlen, rlen);
+    TEST_ASSERT_EQUAL_HEX16(0x8500, rd16(s_resp + 2));
+    TEST_ASSERT_EQUAL(0, rd16(s_resp + 6));
+}
+
+static void test_extra_questions_are_dropped(void)
+{
+    size_t qlen = make_query(2, 0, "a.b", TYPE_A);
+    s_query[5] = 2;                                         // claims QDCOUNT = 2
+    memcpy(s_query + qlen, s_query + 12, qlen - 12);        // second question
+    size_t rlen = captive_dns_build_response(s_query, 2 * qlen - 12, s_resp, sizeof(s_resp), s_softap_ip_n);
+
+    TEST_ASSERT_EQUAL(qlen + 16, rlen);
+    TEST_ASSERT_EQUAL(1, rd16(s_resp + 4));
+    TEST_ASSERT_EQUAL_HEX16(0x8400, rd16(s_resp + 2));     // RD was not set
+}
+
+static void test_responses_and_other_opcodes_are_ignored(void)
+{
+    size_t qlen = make_query(3, 0x8000, "example.com", TYPE_A);
+    TEST_ASSERT_EQUAL(0, captive_dns_build_response(s_query, qlen, s_resp, sizeof(s_resp), s_softap_ip_n));
+
+    qlen = make_query(3, 0x2800, "example.com", TYPE_A);   // opcode UPDATE
+    TEST_ASSERT_EQUAL(0, captive_dns_build_response(s_query, qlen, s_resp, sizeof(s_resp), s_softap_ip_n));
+
+    qlen = make_query(3, 0, "example.com", TYPE_A);
+    s_query[5] = 0;                                         // QDCOUNT = 0
+    TEST_ASSERT_EQUAL(0, captive_dns_build_response(s_query, qlen, s_resp, sizeof(s_resp), s_softap_ip_n));
+}
+
+static void test_malformed_queries_are_dropped(void)
+{
+    size_t qlen = make_query(4, 0, "example.com", TYPE_A);
+
+    for (size_t len = 0; len < qlen; len++) {               // every truncation
+        TEST_ASSERT_EQUAL(0, captive_dns_build_response(s_query, len, s_resp, sizeof(s_resp), s_softap_ip_n));
+    }
+
+    s_query[12] = 0xC0;                                     // compression pointer in question
+    TEST_ASSERT_EQUAL(0, captive_dns_build_response(s_query, qlen, s_resp, sizeof(s_resp), s_softap_ip_n));
+
+    qlen = make_query(4, 0, "example.com", TYPE_A);
+    s_query[12] = 63;                                       // label runs past the packet end
+    TEST_ASSERT_EQUAL(0, captive_dns_build_response(s_query, qlen, s_resp, sizeof(s_resp), s_softap_ip_n));
+
+    TEST_ASSERT_EQUAL(0, captive_dns_build_response(s_query, CAPTIVE_DNS_MAX_PACKET + 1, s_resp,
+                                                    sizeof(s_resp), s_softap_ip_n));
+}
+
+static void test_small_output_buffer_is_rejected(void)
+{
+    size_t qlen = make_query(5, 0, "example.com", TYPE_A);
+    TEST_ASSERT_EQUAL(0, captive_dns_build_response(s_query, qlen, s_resp, qlen + 15, s_softap_ip_n));
+    TEST_ASSERT_EQUAL(qlen + 16, captive_dns_build_response(s_query, qlen, s_resp, qlen + 16, s_softap_ip_n));
+}
+
+static void test_random_packets_never_overrun(void)
+{
+    srand(1234);
+    for (int i = 0; i < 20000; i++) {
+        size_t len = rand() % 64;
+        for (size_t j = 0; j < len; j++) {
+            s_query[j] = rand();
+        }
+        size_t rlen = captive_dns_build_response(s_query, len, s_resp, sizeof(s_resp), s_softap_ip_n);
+        TEST_ASSERT_TRUE(rlen <= len + 16);
+    }
+}
+
+void app_main(void)
+{
+    memcpy(&s_softap_ip_n, s_softap_ip, sizeof(s_softap_ip_n));
+
+    UNITY_BEGIN();
+    RUN_TEST(test_a_query_is_answered_with_softap_ip);
+    RUN_TEST(test_aaaa_query_gets_empty_answer);
+    RUN_TEST(test_extra_questions_are_dropped);
+    RUN_TEST(test_responses_and_other_opcodes_are_ignored);
+    RUN_TEST(test_malformed_queries_are_dropped);
+    RUN_TEST(test_small_output_buffer_is_rejected);
+    RUN_TEST(test_random_packets_never_overrun);
+    UNITY_END();
+    exit(0);
+}
+
+/* ***** END OF FILE ******************************************************** */
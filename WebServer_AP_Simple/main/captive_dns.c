@@ -0,0 +1,221 @@
+/*
+ ******************************************************************************
+ * @file           : captive_dns.c
+ * @brief          : Captive-portal DNS responder (all A queries -> softAP IP)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Phones and laptops probe a well-known URL after joining a network. Answering
+ *   every name with the softAP address sends that probe to our HTTP server,
+ *   which redirects it to the provisioning page, so the UI opens by itself.
+ * - One task, one non-blocking UDP socket; select() with a timeout lets
+ *   captive_dns_stop() end the task without closing the socket under it.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "captive_dns.h"
+
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define DNS_HEADER_LEN      12
+#define DNS_FLAG_QR         0x8000
+#define DNS_FLAG_AA         0x0400
+#define DNS_FLAG_TC         0x0200
+#define DNS_FLAG_RD         0x0100
+#define DNS_OPCODE_MASK     0x7800
+#define DNS_TYPE_A          1
+#define DNS_TYPE_ANY        255
+#define DNS_CLASS_IN        1
+#define DNS_ANSWER_LEN      16      /* name ptr(2) type(2) class(2) ttl(4) rdlen(2) rdata(4) */
+
+/* Private functions ---------------------------------------------------------*/
+static inline uint16_t read_u16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline void write_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+
+size_t captive_dns_build_response(const uint8_t *query, size_t query_len,
+                                  uint8_t *resp, size_t resp_size, uint32_t ip_addr)
+{
+    if (query_len < DNS_HEADER_LEN || query_len > CAPTIVE_DNS_MAX_PACKET) {
+        return 0;
+    }
+
+    uint16_t flags = read_u16(query + 2);
+    // only answer standard queries, never responses (avoids loops between responders)
+    if ((flags & DNS_FLAG_QR) || (flags & DNS_OPCODE_MASK) || read_u16(query + 4) == 0) {
+        return 0;
+    }
+
+    // walk the first question name; queries never use compression pointers
+    size_t pos = DNS_HEADER_LEN;
+    while (pos < query_len && query[pos] != 0) {
+        if (query[pos] & 0xC0) {
+            return 0;
+        }
+        pos += query[pos] + 1;
+    }
+    pos++; // terminating zero label
+    if (pos + 4 > query_len) {
+        return 0;
+    }
+    uint16_t qtype = read_u16(query + pos);
+    uint16_t qclass = read_u16(query + pos + 2);
+    size_t question_end = pos + 4;
+
+    int answer = (qtype == DNS_TYPE_A || qtype == DNS_TYPE_ANY) && qclass == DNS_CLASS_IN;
+    size_t resp_len = question_end + (answer ? DNS_ANSWER_LEN : 0);
+    if (resp_len > resp_size) {
+        return 0;
+    }
+
+    // header + first question, further questions/records are dropped
+    memmove(resp, query, question_end);
+    write_u16(resp + 2, DNS_FLAG_QR | DNS_FLAG_AA | (flags & DNS_FLAG_RD));
+    write_u16(resp + 4, 1);                 // QDCOUNT
+    write_u16(resp + 6, answer ? 1 : 0);    // ANCOUNT
+    write_u16(resp + 8, 0);                 // NSCOUNT
+    write_u16(resp + 10, 0);                // ARCOUNT
+
+    if (answer) {
+        uint8_t *ans = resp + question_end;
+        write_u16(ans, 0xC000 | DNS_HEADER_LEN);    // pointer to the question name
+        write_u16(ans + 2, DNS_TYPE_A);
+        write_u16(ans + 4, DNS_CLASS_IN);
+        write_u16(ans + 6, 0);
+        write_u16(ans + 8, CAPTIVE_DNS_TTL_S);
+        write_u16(ans + 10, 4);
+        memcpy(ans + 12, &ip_addr, 4);
+    }
+    return resp_len;
+}
+
+#ifndef CAPTIVE_DNS_HOST_TEST
+/* Includes ------------------------------------------------------------------*/
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include "esp_log.h"
+#include "lwip/sockets.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CAPTIVE_DNS_TASK_STACK      3072
+#define CAPTIVE_DNS_TASK_PRIORITY   5
+#define CAPTIVE_DNS_POLL_MS         500
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "captive_dns";
+
+static volatile bool s_running;
+static uint32_t s_ip_addr;
+static SemaphoreHandle_t s_stopped;
+
+/* Private function prototypes -----------------------------------------------*/
+static void captive_dns_task(void *param);
+
+
+esp_err_t captive_dns_start(uint32_t ip_addr)
+{
+    if (s_running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_stopped == NULL) {
+        s_stopped = xSemaphoreCreateBinary();
+        if (s_stopped == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    // drop a stale signal left by a task that exited on its own (socket error)
+    xSemaphoreTake(s_stopped, 0);
+    s_ip_addr = ip_addr;
+    s_running = true;
+    if (xTaskCreate(captive_dns_task, "captive_dns", CAPTIVE_DNS_TASK_STACK, NULL,
+                    CAPTIVE_DNS_TASK_PRIORITY, NULL) != pdPASS) {
+        s_running = false;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void captive_dns_stop(void)
+{
+    if (!s_running) {
+        return;
+    }
+    s_running = false;
+    xSemaphoreTake(s_stopped, portMAX_DELAY);
+}
+
+static void captive_dns_task(void *param)
+{
+    uint8_t rx_buf[CAPTIVE_DNS_MAX_PACKET];
+    uint8_t tx_buf[CAPTIVE_DNS_MAX_PACKET];
+
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "Unable to create socket: errno %d", errno);
+        goto exit;
+    }
+    struct sockaddr_in bind_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CAPTIVE_DNS_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) < 0) {
+        ESP_LOGE(TAG, "Socket unable to bind: errno %d", errno);
+        goto exit;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    ESP_LOGI(TAG, "DNS responder started");
+
+    while (s_running) {
+        fd_set read_set;
+        FD_ZERO(&read_set);
+        FD_SET(sock, &read_set);
+        struct timeval timeout = { .tv_sec = 0, .tv_usec = CAPTIVE_DNS_POLL_MS * 1000 };
+        if (select(sock + 1, &read_set, NULL, NULL, &timeout) <= 0) {
+            continue;
+        }
+
+        // drain everything that arrived, the socket never blocks
+        while (true) {
+            struct sockaddr_in src_addr;
+            socklen_t src_len = sizeof(src_addr);
+            int len = recvfrom(sock, rx_buf, sizeof(rx_buf), 0, (struct sockaddr *)&src_addr, &src_len);
+            if (len < 0) {
+                break;
+            }
+            size_t resp_len = captive_dns_build_response(rx_buf, len, tx_buf, sizeof(tx_buf), s_ip_addr);
+            if (resp_len > 0) {
+                sendto(sock, tx_buf, resp_len, 0, (struct sockaddr *)&src_addr, src_len);
+            }
+        }
+    }
+    ESP_LOGI(TAG, "DNS responder stopped");
+
+exit:
+    if (sock >= 0) {
+        close(sock);
+    }
+    s_running = false;
+    xSemaphoreGive(s_stopped);
+    vTaskDelete(NULL);
+}
+#endif /* CAPTIVE_DNS_HOST_TEST */
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,66 @@
+/*
+ ******************************************************************************
+ * @file           : captive_dns.h
+ * @brief          : Header for captive_dns.c (captive-portal DNS responder)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - captive_dns_build_response() is plain packet processing without any
+ *   ESP-IDF dependency, so it is also built by the host test in '../host_test'.
+ * - captive_dns_start()/captive_dns_stop() run the UDP responder task.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Exported constants --------------------------------------------------------*/
+#define CAPTIVE_DNS_PORT            53
+#define CAPTIVE_DNS_MAX_PACKET      512     /* classic DNS over UDP limit */
+#define CAPTIVE_DNS_TTL_S           60
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Build the answer to a DNS query, resolving every A query to ip_addr.
+  *         AAAA and other types get an empty NOERROR answer, so clients fall back to IPv4.
+  * @param  query       received packet
+  * @param  query_len   length of the received packet
+  * @param  resp        output buffer
+  * @param  resp_size   size of the output buffer
+  * @param  ip_addr     IPv4 address to answer with, in network byte order
+  * @retval length of the response, 0 if the packet must be dropped (not a
+  *         standard query, malformed, or the response does not fit)
+  */
+size_t captive_dns_build_response(const uint8_t *query, size_t query_len,
+                                  uint8_t *resp, size_t resp_size, uint32_t ip_addr);
+
+#ifndef CAPTIVE_DNS_HOST_TEST
+#include "esp_err.h"
+
+/**
+  * @brief  Start the responder task on UDP port 53.
+  * @param  ip_addr  IPv4 address to answer with, in network byte order (e.g. softAP IP)
+  * @retval ESP_OK, ESP_ERR_INVALID_STATE if already running, ESP_ERR_NO_MEM
+  */
+esp_err_t captive_dns_start(uint32_t ip_addr);
+
+/**
+  * @brief  Stop the responder task; returns once the socket is closed.
+  */
+void captive_dns_stop(void);
+#endif /* CAPTIVE_DNS_HOST_TEST */
+
+#ifdef __cplusplus
+}
+#endif
+
+/* ***** END OF FILE ******************************************************** */
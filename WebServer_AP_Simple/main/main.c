@@ -15,10 +15,20 @@
  * 		3. Open sdkconfig
  * 			|- Go to Example Configuration
  * 			|- Set WiFi SSID and WiFi Password
+ * - Provisioning:
+ * 		- Without stored station credentials the softAP runs a captive portal:
+ * 		  a DNS responder answers every name with 192.168.4.1 and every unknown
+ * 		  URL is redirected to the Wi-Fi setup page.
+ * 		- Saved credentials go to NVS; once the station gets an IP the portal
+ * 		  is stopped and the device runs in STA mode (also on later boots).
+ * 		- If the stored network cannot be joined, the portal is started again.
+ * - Wi-Fi bring-up is done by the shared wifi_manager component, which caches
+ *   channel/BSSID/IP of the last connection for a fast reconnect on the next boot.
  ******************************************************************************
 */
 
 /* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -26,11 +36,14 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
-#include "nvs_flash.h"
 
 #include "lwip/err.h"
 #include "lwip/sys.h"
 
+#include "wifi_manager.h"
+#include "captive_dns.h"
+#include "provisioning.h"
+
 /* Private variables ---------------------------------------------------------*/
 #define EXAMPLE_ESP_WIFI_SSID      CONFIG_ESP_WIFI_SSID
 #define EXAMPLE_ESP_WIFI_PASS      CONFIG_ESP_WIFI_PASSWORD
@@ -39,9 +52,22 @@
 
 static const char *TAG = "wifi softAP";
 
+static bool s_portal_running;
+
+static const char *s_path_names[] = {
+    [WIFI_MANAGER_PATH_AP]         = "softAP",
+    [WIFI_MANAGER_PATH_STA_SCAN]   = "station (full scan + DHCP)",
+    [WIFI_MANAGER_PATH_STA_CACHED] = "station (cached channel/BSSID/IP)",
+};
+
 /* Private function prototypes -----------------------------------------------*/
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
                                     int32_t event_id, void* event_data);
+static void on_wifi_ready(esp_netif_t *netif, wifi_manager_path_t path, uint32_t ready_ms, void *ctx);
+static void on_sta_failed(void *ctx);
+static void start_portal(void);
+static void stop_portal(void);
+static void on_credentials_saved(const wifi_config_t *sta_config);
 void wifi_init_softap(void);
 
 /*
@@ -49,16 +75,25 @@ void wifi_init_softap(void);
  */
 void app_main(void)
 {
-    //Initialize NVS
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-      ESP_ERROR_CHECK(nvs_flash_erase());
-      ret = nvs_flash_init();
-    }
-    ESP_ERROR_CHECK(ret);
+    wifi_manager_config_t wifi_manager_config = {
+        .on_ready = on_wifi_ready,
+        .on_sta_failed = on_sta_failed,
+    };
+    ESP_ERROR_CHECK(wifi_manager_init(&wifi_manager_config));
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
+                                                        ESP_EVENT_ANY_ID,
+                                                        &wifi_event_handler,
+                                                        NULL,
+                                                        NULL));
 
-    ESP_LOGI(TAG, "ESP_WIFI_MODE_AP");
-    wifi_init_softap();
+    wifi_config_t sta_config;
+    if (provisioning_load_credentials(&sta_config) == ESP_OK) {
+        ESP_LOGI(TAG, "ESP_WIFI_MODE_STA, SSID:%s", (char *)sta_config.sta.ssid);
+        ESP_ERROR_CHECK(wifi_manager_start_sta(&sta_config));
+    } else {
+        ESP_LOGI(TAG, "ESP_WIFI_MODE_AP");
+        wifi_init_softap();
+    }
 }
 
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
@@ -75,21 +110,31 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
     }
 }
 
-void wifi_init_softap(void)
+/* Interface is up: start the portal right away on the AP, drop it once the station is online */
+static void on_wifi_ready(esp_netif_t *netif, wifi_manager_path_t path, uint32_t ready_ms, void *ctx)
 {
-    ESP_ERROR_CHECK(esp_netif_init());
-    ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_ap();
-
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    ESP_LOGI(TAG, "boot-to-ready %lu ms via %s", (unsigned long)ready_ms, s_path_names[path]);
+    if (path == WIFI_MANAGER_PATH_AP) {
+        if (!s_portal_running) {
+            start_portal();
+        }
+    } else if (s_portal_running) {
+        stop_portal();
+        ESP_ERROR_CHECK(wifi_manager_stop_ap());
+    }
+}
 
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
-                                                        ESP_EVENT_ANY_ID,
-                                                        &wifi_event_handler,
-                                                        NULL,
-                                                        NULL));
+static void on_sta_failed(void *ctx)
+{
+    if (!s_portal_running) {
+        ESP_LOGW(TAG, "connect to the AP failed, starting provisioning portal");
+        wifi_init_softap();
+    }
+}
 
+/* Bring up the softAP (the station keeps running when it is already started) */
+void wifi_init_softap(void)
+{
     wifi_config_t wifi_config = {
         .ap = {
             .ssid = EXAMPLE_ESP_WIFI_SSID,
@@ -107,12 +152,37 @@ void wifi_init_softap(void)
         wifi_config.ap.authmode = WIFI_AUTH_OPEN;
     }
 
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_AP));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_AP, &wifi_config));
-    ESP_ERROR_CHECK(esp_wifi_start());
+    ESP_ERROR_CHECK(wifi_manager_start_ap(&wifi_config));
 
     ESP_LOGI(TAG, "wifi_init_softap finished. SSID:%s password:%s channel:%d",
              EXAMPLE_ESP_WIFI_SSID, EXAMPLE_ESP_WIFI_PASS, EXAMPLE_ESP_WIFI_CHANNEL);
 }
 
+static void start_portal(void)
+{
+    static char portal_url[32];
+    esp_netif_ip_info_t ip_info;
+
+    ESP_ERROR_CHECK(esp_netif_get_ip_info(wifi_manager_get_ap_netif(), &ip_info));
+    snprintf(portal_url, sizeof(portal_url), "http://" IPSTR "/", IP2STR(&ip_info.ip));
+
+    ESP_ERROR_CHECK(captive_dns_start(ip_info.ip.addr));
+    ESP_ERROR_CHECK(provisioning_start(portal_url, on_credentials_saved));
+    s_portal_running = true;
+}
+
+static void stop_portal(void)
+{
+    provisioning_stop();
+    captive_dns_stop();
+    s_portal_running = false;
+    ESP_LOGI(TAG, "provisioning portal stopped");
+}
+
+/* Called from the HTTP server task: join the new network, the AP stays up meanwhile */
+static void on_credentials_saved(const wifi_config_t *sta_config)
+{
+    ESP_ERROR_CHECK(wifi_manager_start_sta(sta_config));
+}
+
 /* ***** END OF FILE ******************************************************** */
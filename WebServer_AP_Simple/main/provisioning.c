@@ -0,0 +1,236 @@
+/*
+ ******************************************************************************
+ * @file           : provisioning.c
+ * @brief          : Captive-portal Wi-Fi provisioning page with NVS storage
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - GET  /      -> form asking for the station SSID and password
+ * - POST /save  -> stores them in NVS (namespace "wifi_prov") and calls saved_cb
+ * - anything else -> "302 Found" to the portal URL (captive-portal probes)
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "provisioning.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include <esp_http_server.h>
+#include "esp_log.h"
+#include "nvs.h"
+
+/* Private define ------------------------------------------------------------*/
+#define PROV_NVS_NAMESPACE  "wifi_prov"
+#define PROV_NVS_KEY_SSID   "ssid"
+#define PROV_NVS_KEY_PASS   "pass"
+#define PROV_MAX_BODY_LEN   256
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "provisioning";
+
+static httpd_handle_t s_server;
+static const char *s_portal_url;
+static provisioning_saved_cb_t s_saved_cb;
+
+static const char s_form_page[] = "<!DOCTYPE html>\
+<html>\
+<head>\
+<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">\
+</head>\
+<body>\
+<h1>ESP32 Wi-Fi Setup</h1>\
+<form method=\"post\" action=\"/save\">\
+<p>SSID<br><input name=\"ssid\" maxlength=\"32\"></p>\
+<p>Password<br><input name=\"password\" type=\"password\" maxlength=\"64\"></p>\
+<p><input type=\"submit\" value=\"Save and connect\"></p>\
+</form>\
+</body>\
+</html>";
+
+/* Private function prototypes -----------------------------------------------*/
+static esp_err_t form_get_handler(httpd_req_t *req);
+static esp_err_t save_post_handler(httpd_req_t *req);
+static esp_err_t redirect_handler(httpd_req_t *req, httpd_err_code_t err);
+static void url_decode(char *str);
+
+
+esp_err_t provisioning_load_credentials(wifi_config_t *sta_config)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(PROV_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    memset(sta_config, 0, sizeof(*sta_config));
+    size_t ssid_len = sizeof(sta_config->sta.ssid);
+    size_t pass_len = sizeof(sta_config->sta.password);
+    err = nvs_get_blob(nvs, PROV_NVS_KEY_SSID, sta_config->sta.ssid, &ssid_len);
+    if (err == ESP_OK) {
+        err = nvs_get_blob(nvs, PROV_NVS_KEY_PASS, sta_config->sta.password, &pass_len);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+esp_err_t provisioning_erase_credentials(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(PROV_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_erase_all(nvs);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+static esp_err_t save_credentials(const wifi_config_t *sta_config)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(PROV_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_blob(nvs, PROV_NVS_KEY_SSID, sta_config->sta.ssid, sizeof(sta_config->sta.ssid));
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, PROV_NVS_KEY_PASS, sta_config->sta.password, sizeof(sta_config->sta.password));
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+esp_err_t provisioning_start(const char *portal_url, provisioning_saved_cb_t saved_cb)
+{
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.lru_purge_enable = true;
+
+    s_portal_url = portal_url;
+    s_saved_cb = saved_cb;
+
+    esp_err_t err = httpd_start(&s_server, &config);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error starting server!");
+        return err;
+    }
+
+    static const httpd_uri_t form = {
+        .uri       = "/",
+        .method    = HTTP_GET,
+        .handler   = form_get_handler,
+    };
+    static const httpd_uri_t save = {
+        .uri       = "/save",
+        .method    = HTTP_POST,
+        .handler   = save_post_handler,
+    };
+    httpd_register_uri_handler(s_server, &form);
+    httpd_register_uri_handler(s_server, &save);
+    httpd_register_err_handler(s_server, HTTPD_404_NOT_FOUND, redirect_handler);
+    ESP_LOGI(TAG, "Provisioning page at %s", portal_url);
+    return ESP_OK;
+}
+
+void provisioning_stop(void)
+{
+    if (s_server) {
+        httpd_stop(s_server);
+        s_server = NULL;
+    }
+}
+
+static esp_err_t form_get_handler(httpd_req_t *req)
+{
+    return httpd_resp_send(req, s_form_page, sizeof(s_form_page) - 1);
+}
+
+static esp_err_t save_post_handler(httpd_req_t *req)
+{
+    char body[PROV_MAX_BODY_LEN + 1];
+    wifi_config_t sta_config = { 0 };
+
+    if (req->content_len > PROV_MAX_BODY_LEN) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Request too long");
+        return ESP_FAIL;
+    }
+    int received = 0;
+    while (received < req->content_len) {
+        int ret = httpd_req_recv(req, body + received, req->content_len - received);
+        if (ret <= 0) {
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                continue;
+            }
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+    body[received] = '\0';
+
+    // form values are at most 32/64 chars, but may be up to 3x longer url-encoded
+    char ssid[3 * sizeof(sta_config.sta.ssid) + 1] = { 0 };
+    char password[3 * sizeof(sta_config.sta.password) + 1] = { 0 };
+    if (httpd_query_key_value(body, "ssid", ssid, sizeof(ssid)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "SSID missing");
+        return ESP_FAIL;
+    }
+    httpd_query_key_value(body, "password", password, sizeof(password));
+    url_decode(ssid);
+    url_decode(password);
+    if (strlen(ssid) == 0 || strlen(ssid) > sizeof(sta_config.sta.ssid) ||
+        strlen(password) > sizeof(sta_config.sta.password)) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid SSID or password length");
+        return ESP_FAIL;
+    }
+    memcpy(sta_config.sta.ssid, ssid, strlen(ssid));
+    memcpy(sta_config.sta.password, password, strlen(password));
+
+    if (save_credentials(&sta_config) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to store credentials");
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "Credentials for '%s' stored", ssid);
+
+    httpd_resp_sendstr(req, "<html><body><h1>Saved</h1><p>Connecting to the network...</p></body></html>");
+    if (s_saved_cb) {
+        s_saved_cb(&sta_config);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t redirect_handler(httpd_req_t *req, httpd_err_code_t err)
+{
+    httpd_resp_set_status(req, "302 Found");
+    httpd_resp_set_hdr(req, "Location", s_portal_url);
+    return httpd_resp_send(req, NULL, 0);
+}
+
+/* Decode application/x-www-form-urlencoded text in place */
+static void url_decode(char *str)
+{
+    char *out = str;
+    for (char *in = str; *in; in++) {
+        if (*in == '+') {
+            *out++ = ' ';
+        } else if (*in == '%' && isxdigit((unsigned char)in[1]) && isxdigit((unsigned char)in[2])) {
+            char hex[3] = { in[1], in[2], '\0' };
+            *out++ = (char)strtol(hex, NULL, 16);
+            in += 2;
+        } else {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+}
+
+/* ***** END OF FILE ******************************************************** */
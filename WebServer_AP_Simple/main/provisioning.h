@@ -0,0 +1,47 @@
+/*
+ ******************************************************************************
+ * @file           : provisioning.h
+ * @brief          : Header for provisioning.c (captive-portal Wi-Fi provisioning)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include "esp_err.h"
+#include "esp_wifi.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Called from the HTTP server task once new station credentials were stored */
+typedef void (*provisioning_saved_cb_t)(const wifi_config_t *sta_config);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Read the station credentials stored by the provisioning page.
+  * @param  sta_config  filled with SSID/password on success
+  * @retval ESP_OK, ESP_ERR_NVS_NOT_FOUND if nothing was provisioned yet
+  */
+esp_err_t provisioning_load_credentials(wifi_config_t *sta_config);
+
+/**
+  * @brief  Forget the stored station credentials.
+  */
+esp_err_t provisioning_erase_credentials(void);
+
+/**
+  * @brief  Start the provisioning web server. Every unknown URI is redirected to
+  *         portal_url, which makes OS captive-portal probes open the form.
+  * @param  portal_url  e.g. "http://192.168.4.1/"
+  * @param  saved_cb    called after credentials were saved
+  */
+esp_err_t provisioning_start(const char *portal_url, provisioning_saved_cb_t saved_cb);
+
+/**
+  * @brief  Stop the provisioning web server (must not be called from an HTTP handler).
+  */
+void provisioning_stop(void);
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,150 @@
+/*
+ ******************************************************************************
+ * @file           : test_http_metrics.c
+ * @brief          : Host test for the request/error counters of the URI handler wrapper
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - httpd_register_uri_handler() and http_workers_dispatch() are replaced by
+ *   fakes: the first keeps the wrapped handler so the test can call it, the
+ *   second returns whatever dispatch result the test case asks for.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "http_metrics.h"
+#include "http_workers.h"
+
+/* Private variables ---------------------------------------------------------*/
+static int s_server_dummy;
+static httpd_uri_t s_wrapped;                       /* last handler passed to httpd */
+static http_workers_dispatch_t s_dispatch_result;   /* what the fake dispatch reports */
+static esp_err_t s_handler_ret;
+static int s_handler_calls;
+static void *s_handler_ctx;                         /* user_ctx the handler was called with */
+static int s_user_ctx;
+
+/* Fakes ---------------------------------------------------------------------*/
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    s_wrapped = *uri_handler;
+    return ESP_OK;
+}
+
+esp_err_t http_workers_dispatch(httpd_req_t *req, http_workers_handler_t handler, http_workers_dispatch_t *result)
+{
+    *result = s_dispatch_result;
+    return ESP_OK;
+}
+
+/* Private functions ---------------------------------------------------------*/
+static esp_err_t fake_handler(httpd_req_t *req)
+{
+    s_handler_calls++;
+    s_handler_ctx = req->user_ctx;
+    return s_handler_ret;
+}
+
+static void register_endpoint(const char *uri)
+{
+    const httpd_uri_t desc = {
+        .uri = uri,
+        .method = HTTP_GET,
+        .handler = fake_handler,
+        .user_ctx = &s_user_ctx,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, http_metrics_register_uri_handler(&s_server_dummy, &desc));
+}
+
+/* Call the wrapped handler once, as httpd would for an incoming request */
+static esp_err_t serve(http_workers_dispatch_t dispatch, esp_err_t handler_ret)
+{
+    httpd_req_t req;
+    memset(&req, 0, sizeof(req));
+    req.user_ctx = s_wrapped.user_ctx;
+    s_dispatch_result = dispatch;
+    s_handler_ret = handler_ret;
+    s_handler_calls = 0;
+    s_handler_ctx = NULL;
+    return s_wrapped.handler(&req);
+}
+
+static void assert_counts(const char *uri, unsigned int requests, unsigned int errors)
+{
+    unsigned int got_requests, got_errors;
+    TEST_ASSERT_TRUE(http_metrics_get_counts(uri, HTTP_GET, &got_requests, &got_errors));
+    TEST_ASSERT_EQUAL_UINT(requests, got_requests);
+    TEST_ASSERT_EQUAL_UINT(errors, got_errors);
+}
+
+static void test_handled_request_is_counted(void)
+{
+    register_endpoint("/ok");
+
+    TEST_ASSERT_EQUAL(ESP_OK, serve(HTTP_WORKERS_RUN_HERE, ESP_OK));
+    TEST_ASSERT_EQUAL(1, s_handler_calls);
+    TEST_ASSERT_EQUAL_PTR(&s_user_ctx, s_handler_ctx);
+    assert_counts("/ok", 1, 0);
+}
+
+static void test_handler_error_is_counted(void)
+{
+    register_endpoint("/fail");
+
+    TEST_ASSERT_EQUAL(ESP_FAIL, serve(HTTP_WORKERS_RUN_HERE, ESP_FAIL));
+    assert_counts("/fail", 1, 1);
+}
+
+static void test_busy_rejection_is_counted_as_error(void)
+{
+    register_endpoint("/busy");
+
+    TEST_ASSERT_EQUAL(ESP_OK, serve(HTTP_WORKERS_REJECTED, ESP_OK));
+    TEST_ASSERT_EQUAL(0, s_handler_calls);
+    assert_counts("/busy", 1, 1);
+
+    TEST_ASSERT_EQUAL(ESP_OK, serve(HTTP_WORKERS_RUN_HERE, ESP_OK));
+    assert_counts("/busy", 2, 1);
+}
+
+static void test_queued_request_is_counted_once_by_the_worker(void)
+{
+    register_endpoint("/async");
+
+    // httpd task: handed to a worker, nothing recorded yet
+    TEST_ASSERT_EQUAL(ESP_OK, serve(HTTP_WORKERS_QUEUED, ESP_OK));
+    TEST_ASSERT_EQUAL(0, s_handler_calls);
+    assert_counts("/async", 0, 0);
+
+    // worker task: the same wrapper runs the handler
+    TEST_ASSERT_EQUAL(ESP_OK, serve(HTTP_WORKERS_RUN_HERE, ESP_OK));
+    TEST_ASSERT_EQUAL(1, s_handler_calls);
+    assert_counts("/async", 1, 0);
+}
+
+static void test_register_again_keeps_counters(void)
+{
+    register_endpoint("/ok");
+
+    TEST_ASSERT_EQUAL(ESP_OK, serve(HTTP_WORKERS_REJECTED, ESP_OK));
+    assert_counts("/ok", 2, 1);
+}
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_handled_request_is_counted);
+    RUN_TEST(test_handler_error_is_counted);
+    RUN_TEST(test_busy_rejection_is_counted_as_error);
+    RUN_TEST(test_queued_request_is_counted_once_by_the_worker);
+    RUN_TEST(test_register_again_keeps_counters);
+    UNITY_END();
+    exit(0);
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,9 @@
+# SPDX-License-Identifier: CC0-1.0
+import pytest
+from pytest_embedded_idf.dut import IdfDut
+
+
+@pytest.mark.linux
+@pytest.mark.host_test
+def test_http_metrics_linux(dut: IdfDut) -> None:
+    dut.expect(r'\d+ Tests 0 Failures 0 Ignored', timeout=30)
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: CC0-1.0
+"""
+Small wrk/ab-style load generator for the WebServer_HTTPD example.
+
+Runs N concurrent client connections against the board (or the IDF linux
+target build) for a fixed duration and prints throughput, latency
+percentiles and error counts. Only the Python standard library is used.
+
+Example:
+    python load_test.py --host 192.168.4.1 --path /ledoff -c 4 -d 20
+    python load_test.py --host 192.168.4.1 --no-keep-alive -c 4 -d 20
+"""
+import argparse
+import http.client
+import threading
+import time
+
+
+class Worker(threading.Thread):
+    def __init__(self, args, deadline):
+        super().__init__(daemon=True)
+        self.args = args
+        self.deadline = deadline
+        self.latencies = []
+        self.errors = 0
+        self.busy = 0
+        self.bytes = 0
+
+    def _connect(self):
+        return http.client.HTTPConnection(self.args.host, self.args.port, timeout=self.args.timeout)
+
+    def run(self):
+        headers = {} if self.args.keep_alive else {'Connection': 'close'}
+        conn = None
+        while time.monotonic() < self.deadline:
+            if conn is None:
+                conn = self._connect()
+            start = time.perf_counter()
+            try:
+                conn.request('GET', self.args.path, headers=headers)
+                resp = conn.getresponse()
+                body = resp.read()
+            except (OSError, http.client.HTTPException):
+                self.errors += 1
+                conn.close()
+                conn = None
+                continue
+            self.latencies.append(time.perf_counter() - start)
+            self.bytes += len(body)
+            if resp.status == 503:
+                self.busy += 1
+            elif resp.status != 200:
+                self.errors += 1
+            if not self.args.keep_alive or resp.will_close:
+                conn.close()
+                conn = None
+        if conn is not None:
+            conn.close()
+
+
+def percentile(sorted_values, pct):
+    if not sorted_values:
+        return 0.0
+    idx = min(len(sorted_values) - 1, int(round(pct / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[idx]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--host', default='192.168.4.1')
+    parser.add_argument('--port', type=int, default=80)
+    parser.add_argument('--path', default='/')
+    parser.add_argument('-c', '--connections', type=int, default=4)
+    parser.add_argument('-d', '--duration', type=float, default=10.0, help='test duration in seconds')
+    parser.add_argument('--timeout', type=float, default=5.0, help='per-request socket timeout in seconds')
+    parser.add_argument('--no-keep-alive', dest='keep_alive', action='store_false',
+                        help='open a new connection for every request')
+    parser.add_argument('--label', default='', help='profile name printed with the results')
+    args = parser.parse_args()
+
+    deadline = time.monotonic() + args.duration
+    workers = [Worker(args, deadline) for _ in range(args.connections)]
+    started = time.monotonic()
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    elapsed = time.monotonic() - started
+
+    latencies = sorted(l for w in workers for l in w.latencies)
+    errors = sum(w.errors for w in workers)
+    busy = sum(w.busy for w in workers)
+    total_bytes = sum(w.bytes for w in workers)
+
+    print('profile      : {}'.format(args.label or '-'))
+    print('target       : http://{}:{}{} ({} connections, keep-alive {})'.format(
+        args.host, args.port, args.path, args.connections, 'on' if args.keep_alive else 'off'))
+    print('requests     : {} in {:.1f}s, {} errors, {} busy (503)'.format(len(latencies), elapsed, errors, busy))
+    print('throughput   : {:.1f} req/s, {:.1f} KB/s'.format(len(latencies) / elapsed, total_bytes / 1024.0 / elapsed))
+    print('latency (ms) : p50 {:.1f}  p90 {:.1f}  p99 {:.1f}  max {:.1f}'.format(
+        percentile(latencies, 50) * 1000, percentile(latencies, 90) * 1000,
+        percentile(latencies, 99) * 1000, (latencies[-1] if latencies else 0) * 1000))
+
+
+if __name__ == '__main__':
+    main()
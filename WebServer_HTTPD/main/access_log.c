@@ -0,0 +1,137 @@
+/*
+ ******************************************************************************
+ * @file           : access_log.c
+ * @brief          : Sampled in-RAM HTTP access log
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Replaces the ESP_LOGI calls in the request path: writing a record costs a
+ *   few stores instead of a synchronous UART print.
+ * - Writers claim a slot with an atomic increment of the head index and publish
+ *   it with a per-slot sequence number, so any number of handler/worker tasks
+ *   can record without a lock. The reader skips slots that are being written
+ *   or were overwritten while being copied.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "access_log.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "esp_timer.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ACCESS_LOG_SIZE         CONFIG_WEBSERVER_ACCESS_LOG_SIZE
+#define ACCESS_LOG_MASK         (ACCESS_LOG_SIZE - 1)
+#define ACCESS_LOG_SAMPLE_RATE  CONFIG_WEBSERVER_ACCESS_LOG_SAMPLE_RATE
+
+_Static_assert((ACCESS_LOG_SIZE & ACCESS_LOG_MASK) == 0, "CONFIG_WEBSERVER_ACCESS_LOG_SIZE must be a power of 2");
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    atomic_uint seq;        /*!< index + 1 once published, 0 while being written */
+    uint32_t timestamp_ms;
+    uint32_t bytes;
+    uint32_t latency_us;
+    uint16_t status;
+    uint8_t uri;
+} access_log_entry_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char *s_uri_names[ACCESS_LOG_URI_MAX] = {
+    [ACCESS_LOG_URI_ROOT]      = "/",
+    [ACCESS_LOG_URI_LEDON]     = "/ledon",
+    [ACCESS_LOG_URI_LEDOFF]    = "/ledoff",
+    [ACCESS_LOG_URI_ACCESSLOG] = "/api/accesslog",
+};
+
+static access_log_entry_t s_entries[ACCESS_LOG_SIZE];
+static atomic_uint s_head;
+static atomic_uint s_sample_count;
+
+
+void access_log_record(access_log_uri_t uri, uint16_t status, uint32_t bytes, int64_t start_us)
+{
+    int64_t now_us = esp_timer_get_time();
+    bool is_ok = (status >= 200 && status < 300);
+
+    if (is_ok && (atomic_fetch_add_explicit(&s_sample_count, 1, memory_order_relaxed) % ACCESS_LOG_SAMPLE_RATE) != 0) {
+        return;
+    }
+
+    unsigned int idx = atomic_fetch_add_explicit(&s_head, 1, memory_order_relaxed);
+    access_log_entry_t *entry = &s_entries[idx & ACCESS_LOG_MASK];
+
+    atomic_store_explicit(&entry->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    entry->timestamp_ms = (uint32_t)(now_us / 1000);
+    entry->bytes = bytes;
+    entry->latency_us = (uint32_t)(now_us - start_us);
+    entry->status = status;
+    entry->uri = uri;
+    atomic_store_explicit(&entry->seq, idx + 1, memory_order_release);
+}
+
+access_log_uri_t access_log_uri_from_path(const char *uri)
+{
+    size_t len = strcspn(uri, "?");
+    for (int i = 0; i < ACCESS_LOG_URI_MAX; i++) {
+        if (strlen(s_uri_names[i]) == len && strncmp(uri, s_uri_names[i], len) == 0) {
+            return (access_log_uri_t)i;
+        }
+    }
+    return ACCESS_LOG_URI_MAX;
+}
+
+esp_err_t access_log_get_handler(httpd_req_t *req)
+{
+    int64_t start_us = esp_timer_get_time();
+    char line[128];
+    uint32_t sent = 0;
+    uint32_t bytes = 2;
+
+    unsigned int head = atomic_load_explicit(&s_head, memory_order_acquire);
+    unsigned int first = (head > ACCESS_LOG_SIZE) ? head - ACCESS_LOG_SIZE : 0;
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr_chunk(req, "[");
+    for (unsigned int idx = first; idx < head; idx++) {
+        const access_log_entry_t *slot = &s_entries[idx & ACCESS_LOG_MASK];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != idx + 1) {
+            continue;
+        }
+        access_log_entry_t entry = {
+            .timestamp_ms = slot->timestamp_ms,
+            .bytes = slot->bytes,
+            .latency_us = slot->latency_us,
+            .status = slot->status,
+            .uri = slot->uri,
+        };
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != idx + 1) {
+            continue; // overwritten while copying
+        }
+
+        int len = snprintf(line, sizeof(line),
+                           "%s{\"t_ms\":%lu,\"uri\":\"%s\",\"status\":%u,\"bytes\":%lu,\"latency_us\":%lu}",
+                           sent ? "," : "", (unsigned long)entry.timestamp_ms,
+                           entry.uri < ACCESS_LOG_URI_MAX ? s_uri_names[entry.uri] : "?",
+                           entry.status, (unsigned long)entry.bytes, (unsigned long)entry.latency_us);
+        httpd_resp_send_chunk(req, line, len);
+        bytes += len;
+        sent++;
+    }
+    httpd_resp_sendstr_chunk(req, "]");
+    esp_err_t err = httpd_resp_sendstr_chunk(req, NULL);
+
+    access_log_record(ACCESS_LOG_URI_ACCESSLOG, err == ESP_OK ? 200 : 0, bytes, start_us);
+    return err;
+}
+
+/* ***** END OF FILE ******************************************************** */
@@ -0,0 +1,54 @@
+/*
+ ******************************************************************************
+ * @file           : access_log.h
+ * @brief          : Header for access_log.c (sampled in-RAM HTTP access log)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Fixed-size ring of access records, written lock-free from any task.
+ * - Read back as JSON via the /api/accesslog URI handler.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <esp_http_server.h>
+
+/* Exported types ------------------------------------------------------------*/
+/* Endpoint ids stored in the log instead of the URI string */
+typedef enum {
+    ACCESS_LOG_URI_ROOT = 0,
+    ACCESS_LOG_URI_LEDON,
+    ACCESS_LOG_URI_LEDOFF,
+    ACCESS_LOG_URI_ACCESSLOG,
+    ACCESS_LOG_URI_MAX,
+} access_log_uri_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Record one request (subject to sampling; non-2xx is always recorded).
+  * @param  uri        endpoint id
+  * @param  status     HTTP status sent, 0 if the response could not be sent
+  * @param  bytes      response body length
+  * @param  start_us   esp_timer_get_time() taken when the handler started
+  * @retval None
+  */
+void access_log_record(access_log_uri_t uri, uint16_t status, uint32_t bytes, int64_t start_us);
+
+/**
+  * @brief  Endpoint id of a request URI (a query string is ignored).
+  * @param  uri        req->uri
+  * @retval the id, ACCESS_LOG_URI_MAX for a URI the log doesn't know
+  */
+access_log_uri_t access_log_uri_from_path(const char *uri);
+
+/**
+  * @brief  URI handler returning the buffered records as a JSON array (oldest first).
+  */
+esp_err_t access_log_get_handler(httpd_req_t *req);
+
+/* ***** END OF FILE ******************************************************** */
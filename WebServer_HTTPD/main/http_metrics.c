@@ -0,0 +1,233 @@
+/*
+ ******************************************************************************
+ * @file           : http_metrics.c
+ * @brief          : Per-endpoint latency histograms and Prometheus /metrics page
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Each endpoint gets a fixed set of log2-scale latency buckets (64 us .. 2 s).
+ *   The bucket index is computed with a count-leading-zeros, so recording one
+ *   request is two timer reads and a handful of atomic adds.
+ * - Buckets are stored non-cumulative and summed up when /metrics is served.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "http_metrics.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#ifndef HTTP_METRICS_HOST_TEST
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+#include "http_workers.h"
+
+/* Private define ------------------------------------------------------------*/
+#define METRICS_MAX_ENDPOINTS   CONFIG_WEBSERVER_METRICS_MAX_ENDPOINTS
+#define METRICS_FIRST_BUCKET_LOG2   6       /* first bucket: <= 64 us */
+#define METRICS_NUM_BUCKETS     16          /* last finite bucket: <= 2^21 us (~2 s) */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    const char *uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t *req);
+    void *user_ctx;
+    atomic_uint requests;
+    atomic_uint errors;
+    _Atomic uint64_t latency_sum_us;
+    atomic_uint buckets[METRICS_NUM_BUCKETS + 1]; /* last one is +Inf */
+} http_metrics_endpoint_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "http_metrics";
+
+static http_metrics_endpoint_t s_endpoints[METRICS_MAX_ENDPOINTS];
+static int s_num_endpoints;
+
+/* Private function prototypes -----------------------------------------------*/
+static http_metrics_endpoint_t *http_metrics_find(const httpd_uri_t *uri);
+static esp_err_t http_metrics_wrapper(httpd_req_t *req);
+static void http_metrics_observe(http_metrics_endpoint_t *ep, uint32_t latency_us, esp_err_t err);
+#ifndef HTTP_METRICS_HOST_TEST
+static void send_line(httpd_req_t *req, char *buf, size_t size, const char *fmt, ...);
+#endif
+
+
+esp_err_t http_metrics_register_uri_handler(httpd_handle_t server, const httpd_uri_t *uri)
+{
+    http_metrics_endpoint_t *ep = http_metrics_find(uri);
+    if (ep == NULL) {
+        if (s_num_endpoints >= METRICS_MAX_ENDPOINTS) {
+            ESP_LOGE(TAG, "No metrics slot left for %s", uri->uri);
+            return ESP_ERR_NO_MEM;
+        }
+        ep = &s_endpoints[s_num_endpoints++];
+    }
+    ep->uri = uri->uri;
+    ep->method = uri->method;
+    ep->handler = uri->handler;
+    ep->user_ctx = uri->user_ctx;
+
+    httpd_uri_t wrapped = *uri;
+    wrapped.handler = http_metrics_wrapper;
+    wrapped.user_ctx = ep;
+    return httpd_register_uri_handler(server, &wrapped);
+}
+
+/* A server restart registers the same endpoints again: keep their slot and counters */
+static http_metrics_endpoint_t *http_metrics_find(const httpd_uri_t *uri)
+{
+    for (int i = 0; i < s_num_endpoints; i++) {
+        if (s_endpoints[i].method == uri->method && strcmp(s_endpoints[i].uri, uri->uri) == 0) {
+            return &s_endpoints[i];
+        }
+    }
+    return NULL;
+}
+
+static esp_err_t http_metrics_wrapper(httpd_req_t *req)
+{
+    http_metrics_endpoint_t *ep = (http_metrics_endpoint_t *) req->user_ctx;
+    http_workers_dispatch_t dispatched;
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = http_workers_dispatch(req, http_metrics_wrapper, &dispatched);
+    if (dispatched == HTTP_WORKERS_REJECTED) {
+        // Answered with 503 Busy: a request the endpoint failed to serve
+        http_metrics_observe(ep, (uint32_t)(esp_timer_get_time() - start_us), ESP_FAIL);
+    }
+    if (dispatched != HTTP_WORKERS_RUN_HERE) {
+        return err;
+    }
+
+    req->user_ctx = ep->user_ctx;
+    err = ep->handler(req);
+    http_metrics_observe(ep, (uint32_t)(esp_timer_get_time() - start_us), err);
+    return err;
+}
+
+static void http_metrics_observe(http_metrics_endpoint_t *ep, uint32_t latency_us, esp_err_t err)
+{
+    int bucket = 0;
+    if (latency_us > (1u << METRICS_FIRST_BUCKET_LOG2)) {
+        // smallest i with latency_us <= 2^(FIRST + i)
+        bucket = 32 - __builtin_clz(latency_us - 1) - METRICS_FIRST_BUCKET_LOG2;
+        if (bucket > METRICS_NUM_BUCKETS) {
+            bucket = METRICS_NUM_BUCKETS;
+        }
+    }
+
+    atomic_fetch_add_explicit(&ep->requests, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ep->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ep->latency_sum_us, latency_us, memory_order_relaxed);
+    if (err != ESP_OK) {
+        atomic_fetch_add_explicit(&ep->errors, 1, memory_order_relaxed);
+    }
+}
+
+#ifndef HTTP_METRICS_HOST_TEST
+static void send_line(httpd_req_t *req, char *buf, size_t size, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, size, fmt, args);
+    va_end(args);
+    if (len > 0) {
+        httpd_resp_send_chunk(req, buf, len < (int)size ? len : (int)size - 1);
+    }
+}
+
+esp_err_t http_metrics_get_handler(httpd_req_t *req)
+{
+    char line[160];
+
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+
+    httpd_resp_sendstr_chunk(req, "# TYPE http_requests_total counter\n");
+    for (int i = 0; i < s_num_endpoints; i++) {
+        send_line(req, line, sizeof(line), "http_requests_total{uri=\"%s\"} %u\n",
+                  s_endpoints[i].uri, atomic_load(&s_endpoints[i].requests));
+    }
+    httpd_resp_sendstr_chunk(req, "# TYPE http_request_errors_total counter\n");
+    for (int i = 0; i < s_num_endpoints; i++) {
+        send_line(req, line, sizeof(line), "http_request_errors_total{uri=\"%s\"} %u\n",
+                  s_endpoints[i].uri, atomic_load(&s_endpoints[i].errors));
+    }
+
+    httpd_resp_sendstr_chunk(req, "# TYPE http_request_duration_seconds histogram\n");
+    for (int i = 0; i < s_num_endpoints; i++) {
+        http_metrics_endpoint_t *ep = &s_endpoints[i];
+        unsigned int cumulative = 0;
+        for (int b = 0; b < METRICS_NUM_BUCKETS; b++) {
+            cumulative += atomic_load(&ep->buckets[b]);
+            send_line(req, line, sizeof(line), "http_request_duration_seconds_bucket{uri=\"%s\",le=\"%.6f\"} %u\n",
+                      ep->uri, (double)(1u << (METRICS_FIRST_BUCKET_LOG2 + b)) / 1e6, cumulative);
+        }
+        cumulative += atomic_load(&ep->buckets[METRICS_NUM_BUCKETS]);
+        send_line(req, line, sizeof(line), "http_request_duration_seconds_bucket{uri=\"%s\",le=\"+Inf\"} %u\n",
+                  ep->uri, cumulative);
+        send_line(req, line, sizeof(line), "http_request_duration_seconds_sum{uri=\"%s\"} %.6f\n",
+                  ep->uri, (double)atomic_load(&ep->latency_sum_us) / 1e6);
+        send_line(req, line, sizeof(line), "http_request_duration_seconds_count{uri=\"%s\"} %u\n",
+                  ep->uri, cumulative);
+    }
+
+    send_line(req, line, sizeof(line), "# TYPE heap_free_bytes gauge\nheap_free_bytes %lu\n",
+              (unsigned long)esp_get_free_heap_size());
+    send_line(req, line, sizeof(line), "# TYPE heap_min_free_bytes gauge\nheap_min_free_bytes %lu\n",
+              (unsigned long)esp_get_minimum_free_heap_size());
+    send_line(req, line, sizeof(line), "# TYPE heap_largest_free_block_bytes gauge\nheap_largest_free_block_bytes %u\n",
+              (unsigned int)heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT));
+    send_line(req, line, sizeof(line), "# TYPE uptime_seconds counter\nuptime_seconds %lld\n",
+              (long long)(esp_timer_get_time() / 1000000));
+    send_line(req, line, sizeof(line), "# TYPE freertos_tasks gauge\nfreertos_tasks %u\n",
+              (unsigned int)uxTaskGetNumberOfTasks());
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    UBaseType_t num_tasks = uxTaskGetNumberOfTasks();
+    TaskStatus_t *tasks = malloc(num_tasks * sizeof(TaskStatus_t));
+    if (tasks != NULL) {
+        num_tasks = uxTaskGetSystemState(tasks, num_tasks, NULL);
+        httpd_resp_sendstr_chunk(req, "# TYPE freertos_task_stack_high_water_bytes gauge\n");
+        for (UBaseType_t i = 0; i < num_tasks; i++) {
+            send_line(req, line, sizeof(line), "freertos_task_stack_high_water_bytes{task=\"%s\"} %lu\n",
+                      tasks[i].pcTaskName, (unsigned long)tasks[i].usStackHighWaterMark * sizeof(StackType_t));
+        }
+        free(tasks);
+    }
+#endif
+
+    return httpd_resp_sendstr_chunk(req, NULL);
+}
+
+#else /* HTTP_METRICS_HOST_TEST */
+
+bool http_metrics_get_counts(const char *uri, httpd_method_t method, unsigned int *requests, unsigned int *errors)
+{
+    const httpd_uri_t key = { .uri = uri, .method = method };
+    http_metrics_endpoint_t *ep = http_metrics_find(&key);
+    if (ep == NULL) {
+        return false;
+    }
+    *requests = atomic_load(&ep->requests);
+    *errors = atomic_load(&ep->errors);
+    return true;
+}
+
+#endif /* HTTP_METRICS_HOST_TEST */
+
+/* ***** END OF FILE ******************************************************** */
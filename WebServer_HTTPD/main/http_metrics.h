@@ -0,0 +1,49 @@
+/*
+ ******************************************************************************
+ * @file           : http_metrics.h
+ * @brief          : Header for http_metrics.c (per-endpoint latency histograms)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Register URI handlers through http_metrics_register_uri_handler() instead of
+ *   httpd_register_uri_handler(); the handler is wrapped to count requests/errors
+ *   and record its latency.
+ * - http_metrics_get_handler serves everything in Prometheus text format.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <esp_http_server.h>
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Register a URI handler wrapped with latency/counter instrumentation.
+  *         Requests are also handed to the async workers (see http_workers.h) here.
+  *         Registering the same URI and method again (server restart) reuses its slot and counters.
+  * @param  server  running server
+  * @param  uri     handler description, copied
+  * @retval ESP_ERR_NO_MEM when all CONFIG_WEBSERVER_METRICS_MAX_ENDPOINTS slots are used,
+  *         otherwise the result of httpd_register_uri_handler()
+  */
+esp_err_t http_metrics_register_uri_handler(httpd_handle_t server, const httpd_uri_t *uri);
+
+#ifndef HTTP_METRICS_HOST_TEST
+/**
+  * @brief  URI handler returning all metrics in Prometheus text exposition format.
+  */
+esp_err_t http_metrics_get_handler(httpd_req_t *req);
+#else
+#include <stdbool.h>
+
+/**
+  * @brief  Read the request and error counters of a registered endpoint (host test only).
+  * @retval false if the URI and method were never registered
+  */
+bool http_metrics_get_counts(const char *uri, httpd_method_t method, unsigned int *requests, unsigned int *errors);
+#endif /* HTTP_METRICS_HOST_TEST */
+
+/* ***** END OF FILE ******************************************************** */
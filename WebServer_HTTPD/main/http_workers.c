@@ -0,0 +1,153 @@
+/*
+ ******************************************************************************
+ * @file           : http_workers.c
+ * @brief          : Async HTTP request worker pool (based on the IDF async_handlers example)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - CONFIG_WEBSERVER_ASYNC_WORKERS tasks wait on a queue of detached requests.
+ * - A counting semaphore tracks idle workers, so the httpd task never blocks:
+ *   if no worker is free the request is answered with "503 Busy" immediately.
+ * - The pool is started once and kept across server restarts.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "http_workers.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "access_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+/* Private define ------------------------------------------------------------*/
+#define HTTP_WORKERS_NUM        CONFIG_WEBSERVER_ASYNC_WORKERS
+#define HTTP_WORKERS_PRIORITY   CONFIG_WEBSERVER_TASK_PRIORITY
+#define HTTP_WORKERS_CORE_ID    (CONFIG_WEBSERVER_TASK_CORE_ID < 0 ? tskNO_AFFINITY : CONFIG_WEBSERVER_TASK_CORE_ID)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    httpd_req_t *req;
+    http_workers_handler_t handler;
+} http_workers_req_t;
+
+#if HTTP_WORKERS_NUM > 0
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "http_workers";
+static QueueHandle_t s_req_queue;
+static SemaphoreHandle_t s_workers_idle;
+static TaskHandle_t s_worker_handles[HTTP_WORKERS_NUM];
+
+/* Private function prototypes -----------------------------------------------*/
+static bool is_on_worker_task(void);
+static void http_worker_task(void *param);
+
+
+esp_err_t http_workers_start(void)
+{
+    // The pool outlives the server: a restart finds it running and only
+    // creates what a failed start left out
+    if (s_workers_idle == NULL) {
+        s_workers_idle = xSemaphoreCreateCounting(HTTP_WORKERS_NUM, 0);
+    }
+    if (s_req_queue == NULL) {
+        s_req_queue = xQueueCreate(HTTP_WORKERS_NUM, sizeof(http_workers_req_t));
+    }
+    if (s_workers_idle == NULL || s_req_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create worker queue/semaphore");
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < HTTP_WORKERS_NUM; i++) {
+        if (s_worker_handles[i] != NULL) {
+            continue;
+        }
+        if (xTaskCreatePinnedToCore(http_worker_task, "http_worker", CONFIG_WEBSERVER_ASYNC_WORKER_STACK_SIZE,
+                                    NULL, HTTP_WORKERS_PRIORITY, &s_worker_handles[i], HTTP_WORKERS_CORE_ID) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to start worker %d", i);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    ESP_LOGI(TAG, "%d async workers running", HTTP_WORKERS_NUM);
+    return ESP_OK;
+}
+
+esp_err_t http_workers_dispatch(httpd_req_t *req, http_workers_handler_t handler, http_workers_dispatch_t *result)
+{
+    *result = HTTP_WORKERS_RUN_HERE;
+    if (is_on_worker_task()) {
+        return ESP_OK;
+    }
+
+    // Reserve a worker first so the httpd task never waits on a full queue
+    if (xSemaphoreTake(s_workers_idle, 0) == pdFALSE) {
+        static const char busy_msg[] = "No workers available, server busy.";
+        *result = HTTP_WORKERS_REJECTED;
+        int64_t start_us = esp_timer_get_time();
+        httpd_resp_set_status(req, "503 Busy");
+        esp_err_t err = httpd_resp_sendstr(req, busy_msg);
+        access_log_record(access_log_uri_from_path(req->uri), err == ESP_OK ? 503 : 0, sizeof(busy_msg) - 1, start_us);
+        return ESP_OK;
+    }
+
+    *result = HTTP_WORKERS_QUEUED;
+    http_workers_req_t async_req = { .handler = handler };
+    esp_err_t err = httpd_req_async_handler_begin(req, &async_req.req);
+    if (err != ESP_OK) {
+        xSemaphoreGive(s_workers_idle);
+        return err;
+    }
+    // Cannot fail: one queue slot per worker and a worker was reserved above
+    xQueueSend(s_req_queue, &async_req, 0);
+    return ESP_OK;
+}
+
+static bool is_on_worker_task(void)
+{
+    TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < HTTP_WORKERS_NUM; i++) {
+        if (s_worker_handles[i] == handle) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void http_worker_task(void *param)
+{
+    http_workers_req_t async_req;
+
+    while (true) {
+        xSemaphoreGive(s_workers_idle);
+        if (xQueueReceive(s_req_queue, &async_req, portMAX_DELAY) == pdTRUE) {
+            async_req.handler(async_req.req);
+            if (httpd_req_async_handler_complete(async_req.req) != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to complete async request");
+            }
+        }
+    }
+}
+
+#else /* HTTP_WORKERS_NUM == 0 */
+
+esp_err_t http_workers_start(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t http_workers_dispatch(httpd_req_t *req, http_workers_handler_t handler, http_workers_dispatch_t *result)
+{
+    *result = HTTP_WORKERS_RUN_HERE;
+    return ESP_OK;
+}
+
+#endif /* HTTP_WORKERS_NUM > 0 */
+
+/* ***** END OF FILE ******************************************************** */
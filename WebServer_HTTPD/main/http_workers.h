@@ -0,0 +1,50 @@
+/*
+ ******************************************************************************
+ * @file           : http_workers.h
+ * @brief          : Header for http_workers.c (async HTTP request worker pool)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - The URI handler wrapper (http_metrics.c) calls http_workers_dispatch() first.
+ *   When called from the httpd task the request is detached
+ *   (httpd_req_async_handler_begin) and handed to a worker task, which calls the
+ *   same handler again to produce the response.
+ * - With CONFIG_WEBSERVER_ASYNC_WORKERS = 0 the dispatch is a no-op and all
+ *   requests run in the httpd task as before.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include <esp_http_server.h>
+
+/* Exported types ------------------------------------------------------------*/
+typedef esp_err_t (*http_workers_handler_t)(httpd_req_t *req);
+
+typedef enum {
+    HTTP_WORKERS_RUN_HERE = 0,  /* the caller has to process the request itself */
+    HTTP_WORKERS_QUEUED,        /* handed over to a worker */
+    HTTP_WORKERS_REJECTED,      /* no worker free, answered with 503 Busy */
+} http_workers_dispatch_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Create the worker tasks and the request queue. Calling it again
+  *         (server restart) keeps the running pool.
+  * @retval ESP_OK on success, ESP_ERR_NO_MEM if a task or queue could not be created
+  */
+esp_err_t http_workers_start(void);
+
+/**
+  * @brief  Hand a request over to a worker.
+  * @param  req      request received in the httpd task
+  * @param  handler  handler the worker shall run for the detached request
+  * @param  result   set to what happened with the request
+  * @retval the value the calling URI handler shall return unless *result is HTTP_WORKERS_RUN_HERE
+  */
+esp_err_t http_workers_dispatch(httpd_req_t *req, http_workers_handler_t handler, http_workers_dispatch_t *result);
+
+/* ***** END OF FILE ******************************************************** */
@@ -42,11 +42,16 @@
 #include "lwip/err.h"
 #include "lwip/sys.h"
 #include "esp_tls.h"
-#include "nvs_flash.h"
+#include "wifi_manager.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+#include "http_workers.h"
+#include "access_log.h"
+#include "http_metrics.h"
+#include "esp_timer.h"
+
 
 /* Private define ------------------------------------------------------------*/
 #define EXAMPLE_ESP_WIFI_SSID      CONFIG_ESP_WIFI_SSID
@@ -58,16 +63,19 @@
 #define HTTPD_401      "401 UNAUTHORIZED"           /*!< HTTP Response 401 */
 #define LED_ONBOARD GPIO_NUM_2
 
+/* httpd keeps 3 sockets for itself (listen, ctrl send/recv) */
+#define WEBSERVER_MAX_SOCKETS_AVAILABLE (CONFIG_LWIP_MAX_SOCKETS - 3)
+
 
 /* Private function prototypes -----------------------------------------------*/
 static void init_led(void);
 void wifi_init_softap(void);
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
                                     int32_t event_id, void* event_data);
-static void connect_handler(void* arg, esp_event_base_t event_base,
-                            int32_t event_id, void* event_data);
+static void on_wifi_ready(esp_netif_t *netif, wifi_manager_path_t path, uint32_t ready_ms, void *ctx);
 static void disconnect_handler(void* arg, esp_event_base_t event_base,
                                int32_t event_id, void* event_data);
+static void apply_server_profile(httpd_config_t *config);
 static httpd_handle_t start_webserver(void);
 static esp_err_t stop_webserver(httpd_handle_t server);
 static esp_err_t ledon_handler(httpd_req_t *req);
@@ -193,6 +201,21 @@ static const httpd_uri_t ledoff = {
 };
 
 
+static const httpd_uri_t accesslog = {
+    .uri       = "/api/accesslog",
+    .method    = HTTP_GET,
+    .handler   = access_log_get_handler,
+    .user_ctx  = NULL
+};
+
+static const httpd_uri_t metrics = {
+    .uri       = "/metrics",
+    .method    = HTTP_GET,
+    .handler   = http_metrics_get_handler,
+    .user_ctx  = NULL
+};
+
+
 /**
   * @brief  The application entry point.
   * @retval int
@@ -203,20 +226,17 @@ void app_main(void)
 
 	init_led();
 
-    //Initialize NVS
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-      ESP_ERROR_CHECK(nvs_flash_erase());
-      ret = nvs_flash_init();
-    }
-    ESP_ERROR_CHECK(ret);
-
-    ESP_ERROR_CHECK(esp_netif_init());
+    // NVS, netif, event loop and Wi-Fi driver; the server is started from on_wifi_ready
+    // as soon as the softAP is up instead of waiting for the first client
+    wifi_manager_config_t wifi_manager_config = {
+        .on_ready = on_wifi_ready,
+        .ctx = &server,
+    };
+    ESP_ERROR_CHECK(wifi_manager_init(&wifi_manager_config));
 
     ESP_LOGI(TAG, "ESP_WIFI_MODE_AP");
     wifi_init_softap();
 
-    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, IP_EVENT_AP_STAIPASSIGNED, &connect_handler, &server));
 	// ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &disconnect_handler, &server));
 }
 
@@ -229,13 +249,6 @@ static void init_led(void)
 
 void wifi_init_softap(void)
 {
-    ESP_ERROR_CHECK(esp_netif_init());
-    ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_ap();
-
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
-
     ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
                                                         ESP_EVENT_ANY_ID,
                                                         &wifi_event_handler,
@@ -259,9 +272,7 @@ void wifi_init_softap(void)
         wifi_config.ap.authmode = WIFI_AUTH_OPEN;
     }
 
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_AP));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_AP, &wifi_config));
-    ESP_ERROR_CHECK(esp_wifi_start());
+    ESP_ERROR_CHECK(wifi_manager_start_ap(&wifi_config));
 
     ESP_LOGI(TAG, "wifi_init_softap finished. SSID:%s password:%s channel:%d",
              EXAMPLE_ESP_WIFI_SSID, EXAMPLE_ESP_WIFI_PASS, EXAMPLE_ESP_WIFI_CHANNEL);
@@ -281,13 +292,14 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
     }
 }
 
-static void connect_handler(void* arg, esp_event_base_t event_base,
-                            int32_t event_id, void* event_data)
+static void on_wifi_ready(esp_netif_t *netif, wifi_manager_path_t path, uint32_t ready_ms, void *ctx)
 {
-    httpd_handle_t* server = (httpd_handle_t*) arg;
+    httpd_handle_t* server = (httpd_handle_t*) ctx;
     if (*server == NULL) {
         ESP_LOGI(TAG, "Starting webserver");
         *server = start_webserver();
+        ESP_LOGI(TAG, "Webserver ready %lu ms after boot (netif up at %lu ms)",
+                 (unsigned long)(esp_timer_get_time() / 1000), (unsigned long)ready_ms);
     }
 }
 
@@ -305,20 +317,52 @@ static void disconnect_handler(void* arg, esp_event_base_t event_base,
     }
 }
 
+/* Apply the socket/task settings of the selected CONFIG_WEBSERVER_PROFILE_* */
+static void apply_server_profile(httpd_config_t *config)
+{
+    config->max_open_sockets = CONFIG_WEBSERVER_MAX_OPEN_SOCKETS;
+    if (config->max_open_sockets > WEBSERVER_MAX_SOCKETS_AVAILABLE) {
+        ESP_LOGW(TAG, "max_open_sockets %d exceeds LWIP_MAX_SOCKETS - 3, using %d",
+                 config->max_open_sockets, WEBSERVER_MAX_SOCKETS_AVAILABLE);
+        config->max_open_sockets = WEBSERVER_MAX_SOCKETS_AVAILABLE;
+    }
+    config->backlog_conn = CONFIG_WEBSERVER_BACKLOG_CONN;
+    config->recv_wait_timeout = CONFIG_WEBSERVER_RECV_WAIT_TIMEOUT;
+    config->send_wait_timeout = CONFIG_WEBSERVER_SEND_WAIT_TIMEOUT;
+    config->stack_size = CONFIG_WEBSERVER_TASK_STACK_SIZE;
+    config->task_priority = CONFIG_WEBSERVER_TASK_PRIORITY;
+    config->core_id = CONFIG_WEBSERVER_TASK_CORE_ID < 0 ? tskNO_AFFINITY : CONFIG_WEBSERVER_TASK_CORE_ID;
+#if CONFIG_WEBSERVER_KEEP_ALIVE
+    config->keep_alive_enable = true;
+#endif
+
+    ESP_LOGI(TAG, "Server profile: sockets=%d backlog=%d timeouts=%d/%ds stack=%d prio=%d core=%d workers=%d",
+             config->max_open_sockets, config->backlog_conn, config->recv_wait_timeout, config->send_wait_timeout,
+             (int)config->stack_size, (int)config->task_priority, (int)config->core_id, CONFIG_WEBSERVER_ASYNC_WORKERS);
+}
+
 static httpd_handle_t start_webserver(void)
 {
     httpd_handle_t server = NULL;
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.lru_purge_enable = true;
+    apply_server_profile(&config);
+
+    if (http_workers_start() != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start async workers");
+        return NULL;
+    }
 
     // Start the httpd server
     ESP_LOGI(TAG, "Starting server on port: '%d'", config.server_port);
     if (httpd_start(&server, &config) == ESP_OK) {
         // Set URI handlers
         ESP_LOGI(TAG, "Registering URI handlers");
-        httpd_register_uri_handler(server, &ledoff);
-        httpd_register_uri_handler(server, &ledon);
-        httpd_register_uri_handler(server, &root);
+        http_metrics_register_uri_handler(server, &ledoff);
+        http_metrics_register_uri_handler(server, &ledon);
+        http_metrics_register_uri_handler(server, &root);
+        http_metrics_register_uri_handler(server, &accesslog);
+        httpd_register_uri_handler(server, &metrics);
         return server;
     }
 
@@ -336,15 +380,12 @@ static esp_err_t stop_webserver(httpd_handle_t server)
 static esp_err_t ledon_handler(httpd_req_t *req)
 {
 	esp_err_t error;
-	ESP_LOGI(TAG, "LED turned On.");
+	int64_t start_us = esp_timer_get_time();
 	gpio_set_level(LED_ONBOARD, 1);
 	const char *response = (const char *) req->user_ctx;
-	error = httpd_resp_send(req, response, strlen(response));
-	if (error!=ESP_OK)
-	{
-		ESP_LOGI(TAG, "Error %d while sending response.", error);
-	}
-	else ESP_LOGI(TAG, "Response sent successfully.");
+	size_t len = strlen(response);
+	error = httpd_resp_send(req, response, len);
+	access_log_record(ACCESS_LOG_URI_LEDON, error == ESP_OK ? 200 : 0, len, start_us);
 	return error;
 }
 
@@ -352,15 +393,13 @@ static esp_err_t ledon_handler(httpd_req_t *req)
 static esp_err_t ledoff_handler(httpd_req_t *req)
 {
 	esp_err_t error;
-	ESP_LOGI(TAG, "LED turned Off.");
+	int64_t start_us = esp_timer_get_time();
 	gpio_set_level(LED_ONBOARD, 0);
 	const char *response = (const char *) req->user_ctx;
-	error = httpd_resp_send(req, response, strlen(response));
-	if (error!=ESP_OK)
-	{
-		ESP_LOGI(TAG, "Error %d while sending response.", error);
-	}
-	else ESP_LOGI(TAG, "Response sent successfully.");
+	size_t len = strlen(response);
+	error = httpd_resp_send(req, response, len);
+	// root shares this handler, tell them apart by their URI
+	access_log_record(access_log_uri_from_path(req->uri), error == ESP_OK ? 200 : 0, len, start_us);
 	return error;
 }
 
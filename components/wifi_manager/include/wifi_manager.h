@@ -0,0 +1,81 @@
+/*
+ ******************************************************************************
+ * @file           : wifi_manager.h
+ * @brief          : Header for wifi_manager.c (Wi-Fi bring-up with fast reconnect)
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - Shared by the web server examples and SensorGateway_MQTT (added via
+ *   EXTRA_COMPONENT_DIRS).
+ * - One call initialises NVS, netif, the default event loop and the Wi-Fi driver.
+ * - on_ready is reported as soon as an interface can serve: AP started, or
+ *   station got its IP. Servers should be started from there instead of
+ *   waiting for the first client.
+ ******************************************************************************
+*/
+
+#pragma once
+
+/* Includes ------------------------------------------------------------------*/
+#include "esp_err.h"
+#include "esp_netif.h"
+#include "esp_wifi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+/* How the interface reported by on_ready came up */
+typedef enum {
+    WIFI_MANAGER_PATH_AP,           /*!< softAP started */
+    WIFI_MANAGER_PATH_STA_SCAN,     /*!< station, full scan + DHCP */
+    WIFI_MANAGER_PATH_STA_CACHED,   /*!< station, cached channel/BSSID (+ cached IP) */
+} wifi_manager_path_t;
+
+typedef struct {
+    /* Interface is up; ready_ms is the time since boot */
+    void (*on_ready)(esp_netif_t *netif, wifi_manager_path_t path, uint32_t ready_ms, void *ctx);
+    /* Station could not connect, even after the full-scan fallback and all retries */
+    void (*on_sta_failed)(void *ctx);
+    void *ctx;
+} wifi_manager_config_t;
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Initialise NVS (erasing it on version/full errors), netif, default event
+  *         loop, the AP and STA netifs and the Wi-Fi driver.
+  */
+esp_err_t wifi_manager_init(const wifi_manager_config_t *config);
+
+/**
+  * @brief  Start the softAP; the station keeps running if it was started (AP+STA).
+  */
+esp_err_t wifi_manager_start_ap(const wifi_config_t *ap_config);
+
+/**
+  * @brief  Stop the softAP and keep only the station.
+  */
+esp_err_t wifi_manager_stop_ap(void);
+
+/**
+  * @brief  Connect the station, using the cached channel/BSSID/IP when they belong
+  *         to the same SSID. The AP keeps running if it was started (AP+STA).
+  */
+esp_err_t wifi_manager_start_sta(const wifi_config_t *sta_config);
+
+/**
+  * @brief  Drop the cached connection parameters (RTC memory and NVS).
+  */
+esp_err_t wifi_manager_forget_cache(void);
+
+esp_netif_t *wifi_manager_get_ap_netif(void);
+esp_netif_t *wifi_manager_get_sta_netif(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* ***** END OF FILE ******************************************************** */
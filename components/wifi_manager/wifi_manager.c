@@ -0,0 +1,356 @@
+/*
+ ******************************************************************************
+ * @file           : wifi_manager.c
+ * @brief          : Wi-Fi bring-up with cached fast reconnect
+ ******************************************************************************
+ * @author         : Jabed-Akhtar (Github)
+ * @date           : 19.10.2026
+ ******************************************************************************
+ * Description:
+ * - After each successful station connection the channel, BSSID, IP, gateway
+ *   and DNS are cached in RTC memory (survives soft resets and deep sleep)
+ *   and in NVS (survives power loss; only written when something changed).
+ * - The next connect to the same SSID scans only the cached channel, locks on
+ *   the cached BSSID and, with CONFIG_WIFI_MANAGER_REUSE_LAST_IP, configures the
+ *   cached address statically so the DHCP exchange is skipped. Once the IP is
+ *   up, DHCP is started again to renew the lease; the static address is never
+ *   cached as a lease itself.
+ * - If that fast attempt fails, the cache is dropped and the station retries
+ *   with a full scan and DHCP. Every later reconnect scans fully as well, so a
+ *   moved or roamed AP is found again.
+ * - Wi-Fi driver config is kept in RAM only (the application passes it on
+ *   every boot), so set_config does not cost a flash write.
+ ******************************************************************************
+*/
+
+/* Includes ------------------------------------------------------------------*/
+#include "wifi_manager.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+
+/* Private define ------------------------------------------------------------*/
+#define WIFI_MANAGER_NVS_NAMESPACE  "wifi_mgr"
+#define WIFI_MANAGER_NVS_KEY_CACHE  "cache"
+#define WIFI_MANAGER_CACHE_MAGIC    0x57494D31  /* "WIM1" */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint32_t magic;
+    uint8_t ssid[32];
+    uint8_t bssid[6];
+    uint8_t channel;
+    esp_netif_ip_info_t ip_info;
+    esp_ip4_addr_t dns;
+    uint32_t crc;               /* over all fields above */
+} wifi_manager_cache_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char *TAG = "wifi_manager";
+
+static wifi_manager_config_t s_config;
+static esp_netif_t *s_ap_netif;
+static esp_netif_t *s_sta_netif;
+static wifi_config_t s_sta_config;
+static bool s_ap_enabled;
+static bool s_sta_enabled;
+static bool s_started;
+static bool s_fast_attempt;
+static bool s_static_ip;        /* cached address set statically, DHCP to be restarted once it is up */
+static bool s_lease_pending;    /* DHCP restarted after a static start, its first lease is a renewal */
+static int s_retry_num;
+static int64_t s_connect_start_us;
+
+static RTC_NOINIT_ATTR wifi_manager_cache_t s_rtc_cache;
+
+/* Private function prototypes -----------------------------------------------*/
+static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data);
+static void ip_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data);
+static esp_err_t apply_mode(void);
+static uint32_t cache_crc(const wifi_manager_cache_t *cache);
+static bool cache_load(const uint8_t *ssid, wifi_manager_cache_t *cache);
+static void cache_store(const wifi_manager_cache_t *cache);
+static esp_err_t sta_connect(bool use_cache);
+
+
+esp_err_t wifi_manager_init(const wifi_manager_config_t *config)
+{
+    s_config = *config;
+
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_RETURN_ON_ERROR(nvs_flash_erase(), TAG, "nvs erase failed");
+        ret = nvs_flash_init();
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "nvs init failed");
+
+    ESP_RETURN_ON_ERROR(esp_netif_init(), TAG, "netif init failed");
+    ESP_RETURN_ON_ERROR(esp_event_loop_create_default(), TAG, "create event loop failed");
+    s_ap_netif = esp_netif_create_default_wifi_ap();
+    s_sta_netif = esp_netif_create_default_wifi_sta();
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_RETURN_ON_ERROR(esp_wifi_init(&cfg), TAG, "wifi init failed");
+    ESP_RETURN_ON_ERROR(esp_wifi_set_storage(WIFI_STORAGE_RAM), TAG, "set wifi storage failed");
+
+    ESP_RETURN_ON_ERROR(esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID,
+                                                                  &wifi_event_handler, NULL, NULL), TAG, "register event handler failed");
+    ESP_RETURN_ON_ERROR(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP,
+                                                                  &ip_event_handler, NULL, NULL), TAG, "register event handler failed");
+    return ESP_OK;
+}
+
+esp_err_t wifi_manager_start_ap(const wifi_config_t *ap_config)
+{
+    wifi_config_t config = *ap_config;
+
+    s_ap_enabled = true;
+    ESP_RETURN_ON_ERROR(apply_mode(), TAG, "set wifi mode failed");
+    ESP_RETURN_ON_ERROR(esp_wifi_set_config(WIFI_IF_AP, &config), TAG, "set AP config failed");
+    if (!s_started) {
+        ESP_RETURN_ON_ERROR(esp_wifi_start(), TAG, "wifi start failed");
+        s_started = true;
+    }
+    return ESP_OK;
+}
+
+esp_err_t wifi_manager_stop_ap(void)
+{
+    s_ap_enabled = false;
+    return apply_mode();
+}
+
+esp_err_t wifi_manager_start_sta(const wifi_config_t *sta_config)
+{
+    s_sta_config = *sta_config;
+    s_sta_enabled = true;
+    s_retry_num = 0;
+    ESP_RETURN_ON_ERROR(apply_mode(), TAG, "set wifi mode failed");
+    return sta_connect(true);
+}
+
+esp_err_t wifi_manager_forget_cache(void)
+{
+    memset(&s_rtc_cache, 0, sizeof(s_rtc_cache));
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_erase_key(nvs, WIFI_MANAGER_NVS_KEY_CACHE);
+    if (err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+esp_netif_t *wifi_manager_get_ap_netif(void)
+{
+    return s_ap_netif;
+}
+
+esp_netif_t *wifi_manager_get_sta_netif(void)
+{
+    return s_sta_netif;
+}
+
+static esp_err_t apply_mode(void)
+{
+    wifi_mode_t mode = WIFI_MODE_NULL;
+    if (s_ap_enabled && s_sta_enabled) {
+        mode = WIFI_MODE_APSTA;
+    } else if (s_ap_enabled) {
+        mode = WIFI_MODE_AP;
+    } else if (s_sta_enabled) {
+        mode = WIFI_MODE_STA;
+    }
+    return esp_wifi_set_mode(mode);
+}
+
+static esp_err_t sta_connect(bool use_cache)
+{
+    wifi_config_t config = s_sta_config;
+    wifi_manager_cache_t cache = { 0 };
+
+    s_fast_attempt = false;
+    s_static_ip = false;
+    s_lease_pending = false;
+#if CONFIG_WIFI_MANAGER_FAST_RECONNECT
+    if (use_cache && cache_load(config.sta.ssid, &cache)) {
+        config.sta.channel = cache.channel;
+        config.sta.bssid_set = true;
+        memcpy(config.sta.bssid, cache.bssid, sizeof(config.sta.bssid));
+        config.sta.scan_method = WIFI_FAST_SCAN;
+        s_fast_attempt = true;
+    }
+#endif
+
+#if CONFIG_WIFI_MANAGER_REUSE_LAST_IP
+    if (s_fast_attempt && cache.ip_info.ip.addr != 0) {
+        esp_netif_dhcpc_stop(s_sta_netif);
+        esp_netif_set_ip_info(s_sta_netif, &cache.ip_info);
+        esp_netif_dns_info_t dns = { .ip.u_addr.ip4 = cache.dns, .ip.type = ESP_IPADDR_TYPE_V4 };
+        esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+        s_static_ip = true;
+    } else
+#endif
+    {
+        esp_err_t err = esp_netif_dhcpc_start(s_sta_netif);
+        if (err != ESP_OK && err != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED) {
+            return err;
+        }
+    }
+
+    ESP_LOGI(TAG, "connecting to '%s' (%s)", (char *)config.sta.ssid,
+             s_fast_attempt ? "cached channel/BSSID" : "full scan");
+    ESP_RETURN_ON_ERROR(esp_wifi_set_config(WIFI_IF_STA, &config), TAG, "set STA config failed");
+    s_connect_start_us = esp_timer_get_time();
+    if (!s_started) {
+        s_started = true;
+        return esp_wifi_start(); // connects on WIFI_EVENT_STA_START
+    }
+    return esp_wifi_connect();
+}
+
+static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    if (event_id == WIFI_EVENT_AP_START) {
+        uint32_t ready_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        ESP_LOGI(TAG, "softAP up, boot-to-ready %lu ms", (unsigned long)ready_ms);
+        if (s_config.on_ready) {
+            s_config.on_ready(s_ap_netif, WIFI_MANAGER_PATH_AP, ready_ms, s_config.ctx);
+        }
+    } else if (event_id == WIFI_EVENT_STA_START) {
+        if (s_sta_enabled) {
+            esp_wifi_connect();
+        }
+    } else if (event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        wifi_event_sta_disconnected_t *event = (wifi_event_sta_disconnected_t *) event_data;
+        if (!s_sta_enabled || event->reason == WIFI_REASON_ASSOC_LEAVE) {
+            return; // we disconnected on purpose
+        }
+        if (s_fast_attempt) {
+            ESP_LOGW(TAG, "fast reconnect failed (reason %d), falling back to full scan", event->reason);
+            wifi_manager_forget_cache();
+            sta_connect(false);
+        } else if (s_retry_num < CONFIG_WIFI_MANAGER_MAX_RETRY) {
+            s_retry_num++;
+            ESP_LOGI(TAG, "retry to connect to the AP (%d/%d)", s_retry_num, CONFIG_WIFI_MANAGER_MAX_RETRY);
+            // the driver may still hold the cached BSSID and channel of the last connect: scan fully
+            sta_connect(false);
+        } else if (s_config.on_sta_failed) {
+            s_config.on_sta_failed(s_config.ctx);
+        }
+    }
+}
+
+static void ip_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    ip_event_got_ip_t *event = (ip_event_got_ip_t *) event_data;
+    bool was_static = s_static_ip;
+    wifi_manager_path_t path = s_fast_attempt ? WIFI_MANAGER_PATH_STA_CACHED : WIFI_MANAGER_PATH_STA_SCAN;
+    int64_t now_us = esp_timer_get_time();
+    uint32_t ready_ms = (uint32_t)(now_us / 1000);
+
+    ESP_LOGI(TAG, "got ip:" IPSTR " via %s, connect %lu ms, boot-to-ready %lu ms", IP2STR(&event->ip_info.ip),
+             path == WIFI_MANAGER_PATH_STA_CACHED ? "cache" : "scan",
+             (unsigned long)((now_us - s_connect_start_us) / 1000), (unsigned long)ready_ms);
+    s_fast_attempt = false;
+    s_static_ip = false;
+    s_retry_num = 0;
+
+#if CONFIG_WIFI_MANAGER_REUSE_LAST_IP
+    if (was_static) {
+        // the cached address may have expired: renew it, the lease comes as another IP_EVENT_STA_GOT_IP
+        esp_err_t err = esp_netif_dhcpc_start(s_sta_netif);
+        if (err != ESP_OK && err != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED) {
+            ESP_LOGW(TAG, "restarting DHCP failed (%s)", esp_err_to_name(err));
+        }
+    }
+#endif
+
+#if CONFIG_WIFI_MANAGER_FAST_RECONNECT
+    wifi_ap_record_t ap_info;
+    esp_netif_dns_info_t dns;
+    // a static address is not a lease, only the one DHCP hands out is cached
+    if (!was_static && esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK &&
+        esp_netif_get_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &dns) == ESP_OK) {
+        wifi_manager_cache_t cache;
+        memset(&cache, 0, sizeof(cache)); // padding is part of the CRC/compare
+        cache.magic = WIFI_MANAGER_CACHE_MAGIC;
+        cache.channel = ap_info.primary;
+        cache.ip_info = event->ip_info;
+        cache.dns = dns.ip.u_addr.ip4;
+        memcpy(cache.ssid, s_sta_config.sta.ssid, sizeof(cache.ssid));
+        memcpy(cache.bssid, ap_info.bssid, sizeof(cache.bssid));
+        cache_store(&cache);
+    }
+#endif
+
+    // the lease that follows a static start keeps the address: the interface was reported already
+    bool renewed = s_lease_pending && !event->ip_changed;
+    s_lease_pending = was_static;
+    if (s_config.on_ready && !renewed) {
+        s_config.on_ready(s_sta_netif, path, ready_ms, s_config.ctx);
+    }
+}
+
+static uint32_t cache_crc(const wifi_manager_cache_t *cache)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)cache, offsetof(wifi_manager_cache_t, crc));
+}
+
+/* RTC copy first (no flash access), NVS otherwise */
+static bool cache_load(const uint8_t *ssid, wifi_manager_cache_t *cache)
+{
+    if (s_rtc_cache.magic != WIFI_MANAGER_CACHE_MAGIC || s_rtc_cache.crc != cache_crc(&s_rtc_cache)) {
+        nvs_handle_t nvs;
+        size_t len = sizeof(s_rtc_cache);
+        memset(&s_rtc_cache, 0, sizeof(s_rtc_cache));
+        if (nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+            nvs_get_blob(nvs, WIFI_MANAGER_NVS_KEY_CACHE, &s_rtc_cache, &len);
+            nvs_close(nvs);
+        }
+        if (s_rtc_cache.magic != WIFI_MANAGER_CACHE_MAGIC || s_rtc_cache.crc != cache_crc(&s_rtc_cache)) {
+            memset(&s_rtc_cache, 0, sizeof(s_rtc_cache));
+            return false;
+        }
+    }
+    if (memcmp(s_rtc_cache.ssid, ssid, sizeof(s_rtc_cache.ssid)) != 0) {
+        return false;
+    }
+    *cache = s_rtc_cache;
+    return true;
+}
+
+static void cache_store(const wifi_manager_cache_t *cache)
+{
+    wifi_manager_cache_t new_cache = *cache;
+    new_cache.crc = cache_crc(&new_cache);
+    if (memcmp(&new_cache, &s_rtc_cache, sizeof(new_cache)) == 0) {
+        return; // unchanged, spare the flash
+    }
+    s_rtc_cache = new_cache;
+
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+        if (nvs_set_blob(nvs, WIFI_MANAGER_NVS_KEY_CACHE, &new_cache, sizeof(new_cache)) == ESP_OK) {
+            nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+}
+
+/* ***** END OF FILE ******************************************************** */